@@ -0,0 +1,95 @@
+#include <atomic>
+#include <thread>
+#include "core/list.hpp"
+#include "core/os/async_file_io.hpp"
+#include "bench.hpp"
+
+// 4 KB random reads of a 256 MB file at queue depths from 1 to 128, through io_uring and through
+// the thread pool fallback. Every slot of the queue submits its next read from the completion callback,
+// so the depth stays constant. The file is freshly written and mostly in page cache, so this measures
+// submission and completion overhead rather than the device
+
+static const char *s_Filename = "sx_async_file_io_bench.bin";
+
+static constexpr u64 FileSize = 256 * 1024 * 1024;
+static constexpr u64 BlockSize = 4096;
+static constexpr u32 MaxDepth = 128;
+
+struct ReadSlot{
+    AsyncFileIO *IO = nullptr;
+    const File *Source = nullptr;
+    std::atomic<u32> *Finished = nullptr;
+    AsyncFileRequest Request;
+    alignas(BlockSize) u8 Buffer[BlockSize];
+    u32 RandomState = 0;
+    u32 Remaining = 0;
+
+    u64 NextOffset(){
+        RandomState ^= RandomState << 13;
+        RandomState ^= RandomState >> 17;
+        RandomState ^= RandomState << 5;
+        return u64(RandomState % (FileSize / BlockSize)) * BlockSize;
+    }
+
+    void Submit(){
+        (void)IO->Read(Request, *Source, NextOffset(), {Buffer, BlockSize}, {this, &ReadSlot::OnRead});
+    }
+
+    void OnRead(AsyncFileRequest &request){
+        Bench::DoNotOptimize(request.Transferred());
+        if(--Remaining){
+            Submit();
+            IO->Flush();
+        }else{
+            (*Finished)++;
+        }
+    }
+};
+
+static void RandomReads(bool force_fallback, u32 depth, u32 reads){
+    static ReadSlot slots[MaxDepth];
+    File file(s_Filename, File::Mode::Read, false);
+    std::atomic<u32> finished{0};
+
+    AsyncFileIO io(depth, force_fallback);
+    const Time time = Bench::Measure([&](){
+        finished = 0;
+        for(u32 i = 0; i<depth; i++){
+            slots[i].IO = &io;
+            slots[i].Source = &file;
+            slots[i].Finished = &finished;
+            slots[i].RandomState = 0x2545F491 + i * 0x9E3779B9;
+            slots[i].Remaining = reads / depth;
+            slots[i].Submit();
+        }
+        io.Flush();
+
+        while(finished != depth)
+            std::this_thread::yield();
+    }, 3);
+
+    const double count = double(reads / depth) * depth;
+    // io_uring may be unavailable in containers, what actually ran is reported
+    Println("%, QD %: % IOPS, % MB/s", io.IsUsingIoUring() ? "io_uring" : "thread pool", depth, Bench::PerSecond(count, time), Bench::PerSecond(count * BlockSize, time) / (1024 * 1024));
+}
+
+int main(){
+    {
+        List<u8> block;
+        block.Resize(1024 * 1024);
+        for(size_t i = 0; i<block.Size(); i++)
+            block[i] = u8(i * 31);
+
+        File file(s_Filename, File::Mode::Write);
+        for(u64 written = 0; written<FileSize; written += block.Size())
+            file.Write(block.Data(), block.Size());
+    }
+
+    constexpr u32 Reads = 100000;
+    for(u32 depth = 1; depth<=MaxDepth; depth *= 2)
+        RandomReads(false, depth, Reads);
+    for(u32 depth = 1; depth<=MaxDepth; depth *= 2)
+        RandomReads(true, depth, Reads);
+
+    File::Delete(s_Filename);
+}
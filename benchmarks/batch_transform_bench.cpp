@@ -0,0 +1,99 @@
+#include "core/list.hpp"
+#include "core/math/batch_transform.hpp"
+#include "core/os/thread_pool.hpp"
+#include "bench.hpp"
+
+// Batch kernels over 1M elements against a loop over the single element operator*,
+// and the ThreadPool overloads on every hardware thread
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector4f RandomVector(){
+    return {Random(), Random(), Random(), Random()};
+}
+
+static Matrix4f RandomMatrix(){
+    return {RandomVector(), RandomVector(), RandomVector(), RandomVector()};
+}
+
+int main(){
+    constexpr size_t Count = 1000000;
+    constexpr size_t MatricesCount = Count / 4;
+
+    ThreadPool pool;
+    const Matrix4f matrix = RandomMatrix();
+
+    List<Vector3f> points, points_result;
+    List<Vector4f> vectors, vectors_result;
+    List<Matrix4f> left, right, matrices_result;
+    for(size_t i = 0; i<Count; i++){
+        points.Add(RandomVector().XYZ());
+        vectors.Add(RandomVector());
+    }
+    for(size_t i = 0; i<MatricesCount; i++){
+        left.Add(RandomMatrix());
+        right.Add(RandomMatrix());
+    }
+    points_result.Resize(Count);
+    vectors_result.Resize(Count);
+    matrices_result.Resize(MatricesCount);
+
+    const ConstSpan<Vector3f> points_span(points.Data(), Count);
+    const Span<Vector3f> points_result_span(points_result.Data(), Count);
+    const ConstSpan<Vector4f> vectors_span(vectors.Data(), Count);
+    const Span<Vector4f> vectors_result_span(vectors_result.Data(), Count);
+    const ConstSpan<Matrix4f> left_span(left.Data(), MatricesCount), right_span(right.Data(), MatricesCount);
+    const Span<Matrix4f> matrices_result_span(matrices_result.Data(), MatricesCount);
+
+    Bench::Report("points, operator*", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            points_result[i] = (matrix * Vector4f(points[i], 1.f)).XYZ();
+    }), Count, "points");
+    Bench::Report("points, TransformPoints", Bench::Measure([&](){
+        Math::TransformPoints(matrix, points_span, points_result_span);
+    }), Count, "points");
+    Bench::Report("points, TransformPoints parallel", Bench::Measure([&](){
+        Math::TransformPoints(matrix, points_span, points_result_span, pool);
+    }), Count, "points");
+
+    Bench::Report("directions, operator*", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            points_result[i] = (matrix * Vector4f(points[i], 0.f)).XYZ();
+    }), Count, "directions");
+    Bench::Report("directions, TransformDirections", Bench::Measure([&](){
+        Math::TransformDirections(matrix, points_span, points_result_span);
+    }), Count, "directions");
+
+    Bench::Report("vectors, operator*", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            vectors_result[i] = matrix * vectors[i];
+    }), Count, "vectors");
+    Bench::Report("vectors, TransformVectors", Bench::Measure([&](){
+        Math::TransformVectors(matrix, vectors_span, vectors_result_span);
+    }), Count, "vectors");
+    Bench::Report("vectors, TransformVectors parallel", Bench::Measure([&](){
+        Math::TransformVectors(matrix, vectors_span, vectors_result_span, pool);
+    }), Count, "vectors");
+
+    Bench::Report("matrices, operator*", Bench::Measure([&](){
+        for(size_t i = 0; i<MatricesCount; i++)
+            matrices_result[i] = left[i] * right[i];
+    }), MatricesCount, "matrices");
+    Bench::Report("matrices, MultiplyMatrices", Bench::Measure([&](){
+        Math::MultiplyMatrices(left_span, right_span, matrices_result_span);
+    }), MatricesCount, "matrices");
+    Bench::Report("matrices, MultiplyMatrices parallel", Bench::Measure([&](){
+        Math::MultiplyMatrices(left_span, right_span, matrices_result_span, pool);
+    }), MatricesCount, "matrices");
+
+    Bench::DoNotOptimize(points_result[Count - 1]);
+    Bench::DoNotOptimize(vectors_result[Count - 1]);
+    Bench::DoNotOptimize(matrices_result[MatricesCount - 1]);
+}
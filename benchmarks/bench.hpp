@@ -0,0 +1,49 @@
+#ifndef STRAITX_BENCH_HPP
+#define STRAITX_BENCH_HPP
+
+#include "core/print.hpp"
+#include "core/algorithm.hpp"
+#include "core/os/clock.hpp"
+#include "core/env/compiler.hpp"
+
+// Benchmarks are plain executables printing one line per measurement,
+// every measurement is the best of several runs to filter out scheduling noise
+
+namespace Bench{
+
+constexpr u32 DefaultRuns = 5;
+
+template<typename FunctionType>
+Time Measure(FunctionType function, u32 runs = DefaultRuns){
+    Time best = Seconds(3600);
+    for(u32 i = 0; i<runs; i++){
+        Clock clock;
+        function();
+        best = Min(best, clock.GetElapsedTime());
+    }
+    // clock has microsecond resolution, runs are expected to be much longer anyway
+    return Max(best, Microseconds(1));
+}
+
+inline double PerSecond(double count, Time time){
+    return count * 1000000.0 / (double)time.AsMicroseconds();
+}
+
+inline void Report(const char *name, Time time, double count, const char *unit){
+    Println("%: % ms, % %/s", name, time.AsMicroseconds() / 1000.0, PerSecond(count, time), unit);
+}
+
+// keeps the compiler from dropping the computation of a value, which is not used otherwise
+template<typename Type>
+SX_INLINE void DoNotOptimize(const Type &value){
+#if defined(SX_COMPILER_MSVC)
+    const volatile char *volatile sink = (const volatile char*)&value;
+    (void)sink;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+}//namespace Bench::
+
+#endif//STRAITX_BENCH_HPP
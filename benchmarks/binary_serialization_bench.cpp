@@ -0,0 +1,131 @@
+#include <cstring>
+#include "core/serialization/binary_serialization.hpp"
+#include "bench.hpp"
+
+// Encoding and decoding of 1M structs through SX_BINARY_SERIALIZABLE against the same layout packed by hand
+
+struct Particle{
+    u32 Id = 0;
+    float X = 0, Y = 0, Z = 0;
+    u16 Flags = 0;
+    s32 Health = 0;
+    u64 Time = 0;
+
+    SX_BINARY_SERIALIZABLE(Id, X, Y, Z, Flags, Health, Time)
+};
+
+constexpr size_t ParticleSize = 4 + 3 * 4 + 2 + 4 + 8;
+
+template<typename Type>
+static u8 *Pack(u8 *pointer, Type value){
+    value = ToNetByteOrder(value);
+    memcpy(pointer, &value, sizeof(value));
+    return pointer + sizeof(value);
+}
+
+static u8 *PackFloat(u8 *pointer, float value){
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return Pack(pointer, bits);
+}
+
+template<typename Type>
+static const u8 *Unpack(const u8 *pointer, Type &value){
+    memcpy(&value, pointer, sizeof(value));
+    value = ToHostByteOrder(value);
+    return pointer + sizeof(value);
+}
+
+static const u8 *UnpackFloat(const u8 *pointer, float &value){
+    u32 bits;
+    pointer = Unpack(pointer, bits);
+    memcpy(&value, &bits, sizeof(value));
+    return pointer;
+}
+
+// baseline, the buffer is known to fit everything
+static void EncodeByHand(const List<Particle> &particles, List<u8> &buffer){
+    buffer.Resize(particles.Size() * ParticleSize);
+    u8 *pointer = buffer.Data();
+
+    for(const Particle &particle: particles){
+        pointer = Pack(pointer, particle.Id);
+        pointer = PackFloat(pointer, particle.X);
+        pointer = PackFloat(pointer, particle.Y);
+        pointer = PackFloat(pointer, particle.Z);
+        pointer = Pack(pointer, particle.Flags);
+        pointer = Pack(pointer, (u32)particle.Health);
+        pointer = Pack(pointer, particle.Time);
+    }
+}
+
+static void DecodeByHand(const List<u8> &buffer, List<Particle> &particles){
+    const u8 *pointer = buffer.Data();
+
+    for(Particle &particle: particles){
+        u32 health;
+        pointer = Unpack(pointer, particle.Id);
+        pointer = UnpackFloat(pointer, particle.X);
+        pointer = UnpackFloat(pointer, particle.Y);
+        pointer = UnpackFloat(pointer, particle.Z);
+        pointer = Unpack(pointer, particle.Flags);
+        pointer = Unpack(pointer, health);
+        pointer = Unpack(pointer, particle.Time);
+        particle.Health = (s32)health;
+    }
+}
+
+static void EncodeIntoSpan(const List<Particle> &particles, List<u8> &buffer){
+    buffer.Resize(particles.Size() * ParticleSize);
+    BinaryWriter writer(Span<u8>(buffer.Data(), buffer.Size()));
+
+    for(const Particle &particle: particles)
+        (void)BinarySerialize(writer, particle);
+}
+
+static void EncodeIntoList(const List<Particle> &particles, List<u8> &buffer){
+    buffer.Clear();
+    BinaryWriter writer(buffer);
+
+    for(const Particle &particle: particles)
+        (void)BinarySerialize(writer, particle);
+}
+
+static void Decode(const List<u8> &buffer, List<Particle> &particles){
+    BinaryReader reader({buffer.Data(), buffer.Size()});
+
+    for(Particle &particle: particles)
+        (void)BinaryDeserialize(reader, particle);
+}
+
+int main(){
+    constexpr size_t Count = 1000000;
+
+    List<Particle> particles;
+    particles.Resize(Count);
+    for(size_t i = 0; i<Count; i++){
+        Particle &particle = particles[i];
+        particle.Id = (u32)i;
+        particle.X = i * 0.5f;
+        particle.Y = i * 0.25f;
+        particle.Z = -(float)i;
+        particle.Flags = u16(i * 7);
+        particle.Health = s32(i) - 500000;
+        particle.Time = i * 1000003;
+    }
+
+    List<u8> buffer;
+    List<Particle> decoded;
+    decoded.Resize(Count);
+
+    Bench::Report("encode, by hand", Bench::Measure([&](){ EncodeByHand(particles, buffer); }), Count, "structs");
+    Bench::Report("encode, BinaryWriter over Span", Bench::Measure([&](){ EncodeIntoSpan(particles, buffer); }), Count, "structs");
+    Bench::Report("encode, BinaryWriter over List", Bench::Measure([&](){ EncodeIntoList(particles, buffer); }), Count, "structs");
+
+    Bench::Report("decode, by hand", Bench::Measure([&](){ DecodeByHand(buffer, decoded); }), Count, "structs");
+    Bench::Report("decode, BinaryReader", Bench::Measure([&](){ Decode(buffer, decoded); }), Count, "structs");
+
+    Bench::DoNotOptimize(decoded[Count - 1].Time);
+    if(decoded[Count - 1].Time != particles[Count - 1].Time)
+        return Errorln("decoded data doesn't match");
+}
@@ -0,0 +1,129 @@
+#include "core/list.hpp"
+#include "core/math/bvh.hpp"
+#include "core/os/thread_pool.hpp"
+#include "bench.hpp"
+
+// Build and queries over 1M boxes scattered in a 1000 units cube. Camera rays are coherent,
+// going from one point through a grid, random rays go between random points. Brute force is
+// measured over a thousand rays, which is enough to see the difference
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector3f RandomVector(){
+    return {Random(), Random(), Random()};
+}
+
+static bool IntersectRay(const AABB3f &box, const Ray3f &ray, float max_distance){
+    float near = 0.f, far = max_distance;
+    for(size_t i = 0; i<3; i++){
+        const float inverse = 1.f / ray.Direction().Data[i];
+        const float t0 = (box.Min.Data[i] - ray.Origin().Data[i]) * inverse;
+        const float t1 = (box.Max.Data[i] - ray.Origin().Data[i]) * inverse;
+        near = Max(near, Min(t0, t1));
+        far = Min(far, Max(t0, t1));
+    }
+    return near <= far;
+}
+
+int main(){
+    constexpr size_t Count = 1000000;
+    constexpr size_t RaysCount = 256 * 256;
+    constexpr float MaxDistance = 5000.f;
+
+    List<AABB3f> boxes;
+    for(size_t i = 0; i<Count; i++)
+        boxes.Add(AABB3f(RandomVector() * 500.f, {Random() + 2, Random() + 2, Random() + 2}));
+
+    const ConstSpan<AABB3f> boxes_span(boxes.Data(), Count);
+    ThreadPool pool;
+    Bvh bvh;
+
+    Bench::Report("build", Bench::Measure([&](){ bvh.Build(boxes_span); }, 1), Count, "boxes");
+    Bench::Report("build, ThreadPool", Bench::Measure([&](){ bvh.Build(boxes_span, pool); }, 1), Count, "boxes");
+    Bench::Report("refit", Bench::Measure([&](){ bvh.Refit(boxes_span); }), Count, "boxes");
+    Println("nodes: %", bvh.Nodes().Size());
+
+    List<Ray3f> camera_rays, random_rays;
+    const Vector3f eye(0, 0, -800);
+    for(size_t y = 0; y<256; y++){
+        for(size_t x = 0; x<256; x++)
+            camera_rays.Add(Ray3f(eye, Vector3f(x / 128.f - 1.f, y / 128.f - 1.f, 2.f)));
+    }
+    for(size_t i = 0; i<RaysCount; i++){
+        const Vector3f from = RandomVector() * 600.f;
+        random_rays.Add(Ray3f(from, RandomVector() * 600.f - from));
+    }
+
+    List<RayHit> hits;
+    List<u8> any_hits;
+    hits.Resize(RaysCount);
+    any_hits.Resize(RaysCount);
+
+    for(const List<Ray3f> *rays: {&camera_rays, &random_rays}){
+        const char *kind = rays == &camera_rays ? "camera" : "random";
+        const ConstSpan<Ray3f> rays_span(rays->Data(), RaysCount);
+
+        size_t hits_count = 0;
+        const Time single = Bench::Measure([&](){
+            hits_count = 0;
+            for(size_t i = 0; i<RaysCount; i++)
+                hits_count += bvh.RayClosest((*rays)[i], MaxDistance, hits[i]);
+        });
+        Println("% rays, RayClosest: % rays/s, % hit", kind, Bench::PerSecond(RaysCount, single), hits_count);
+
+        const Time packets = Bench::Measure([&](){
+            bvh.RayClosest(rays_span, MaxDistance, {hits.Data(), RaysCount});
+        });
+        Println("% rays, RayClosest packets: % rays/s", kind, Bench::PerSecond(RaysCount, packets));
+
+        const Time any = Bench::Measure([&](){
+            for(size_t i = 0; i<RaysCount; i++)
+                any_hits[i] = bvh.RayAny((*rays)[i], MaxDistance);
+        });
+        Println("% rays, RayAny: % rays/s", kind, Bench::PerSecond(RaysCount, any));
+
+        const Time any_packets = Bench::Measure([&](){
+            bvh.RayAny(rays_span, MaxDistance, {any_hits.Data(), RaysCount});
+        });
+        Println("% rays, RayAny packets: % rays/s", kind, Bench::PerSecond(RaysCount, any_packets));
+    }
+
+    constexpr size_t BruteForceRays = 1000;
+    size_t brute_force_hits = 0;
+    const Time brute_force = Bench::Measure([&](){
+        brute_force_hits = 0;
+        for(size_t i = 0; i<BruteForceRays; i++){
+            for(size_t j = 0; j<Count; j++){
+                if(IntersectRay(boxes[j], random_rays[i], MaxDistance)){
+                    brute_force_hits++;
+                    break;
+                }
+            }
+        }
+    }, 1);
+    Println("random rays, brute force any hit: % rays/s", Bench::PerSecond(BruteForceRays, brute_force));
+
+    constexpr size_t QueriesCount = 100000;
+    List<AABB3f> queries;
+    for(size_t i = 0; i<QueriesCount; i++)
+        queries.Add(AABB3f(RandomVector() * 500.f, {10, 10, 10}));
+
+    List<u32> indices;
+    const Time overlaps = Bench::Measure([&](){
+        indices.Clear();
+        for(const AABB3f &query: queries)
+            bvh.Overlaps(query, indices);
+    });
+    Println("Overlaps, 10 units boxes: % queries/s, % found", Bench::PerSecond(QueriesCount, overlaps), indices.Size());
+
+    Bench::DoNotOptimize(hits[RaysCount - 1]);
+    Bench::DoNotOptimize(any_hits[RaysCount - 1]);
+    Bench::DoNotOptimize(brute_force_hits);
+}
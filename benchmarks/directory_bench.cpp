@@ -0,0 +1,119 @@
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "core/string.hpp"
+#include "core/format.hpp"
+#include "core/os/directory.hpp"
+#include "core/os/thread_pool.hpp"
+#include "bench.hpp"
+
+// A tree of 1M empty files in 1000 directories, two levels deep, is enumerated by recursion over
+// DirectoryIterator, which reads batches with getdents64, by Directory::Walk on 1 to 8 threads and by
+// opendir/readdir recursion, with d_type and with a stat per entry. Directory entries are in dentry
+// cache after the first pass, so this measures the syscalls and the traversal itself
+
+static const char *s_Root = "sx_directory_bench";
+
+static constexpr u32 TopDirectories = 10;
+static constexpr u32 SubDirectories = 100;
+static constexpr u32 FilesPerDirectory = 1000;
+
+static void CreateTree(){
+    mkdir(s_Root, 0755);
+    for(u32 top = 0; top<TopDirectories; top++){
+        const String top_path = Format("%/%", s_Root, top);
+        mkdir(top_path.Data(), 0755);
+        for(u32 sub = 0; sub<SubDirectories; sub++){
+            const String sub_path = Format("%/%", top_path, sub);
+            mkdir(sub_path.Data(), 0755);
+            for(u32 file = 0; file<FilesPerDirectory; file++){
+                const String file_path = Format("%/asset_%.bin", sub_path, file);
+                close(open(file_path.Data(), O_CREAT | O_WRONLY, 0644));
+            }
+        }
+    }
+}
+
+static u64 IterateRecursive(const String &path){
+    u64 count = 0;
+    for(const DirectoryEntry &entry: Directory(path)){
+        count++;
+        if(entry.IsDirectory)
+            count += IterateRecursive(Format("%/%", path, entry.Name));
+    }
+    return count;
+}
+
+static u64 ReaddirRecursive(const String &path, bool is_stat){
+    DIR *directory = opendir(path.Data());
+    if(!directory)
+        return 0;
+
+    u64 count = 0;
+    while(dirent *entry = readdir(directory)){
+        if(entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0')))
+            continue;
+        count++;
+
+        const String entry_path = Format("%/%", path, entry->d_name);
+        bool is_directory = entry->d_type == DT_DIR;
+        if(is_stat){
+            struct stat info;
+            is_directory = lstat(entry_path.Data(), &info) == 0 && S_ISDIR(info.st_mode);
+        }
+        if(is_directory)
+            count += ReaddirRecursive(entry_path, is_stat);
+    }
+    closedir(directory);
+    return count;
+}
+
+struct WalkCounter{
+    std::atomic<u64> Count{0};
+
+    void OnEntry(const DirectoryWalkEntry &){
+        Count.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+template<typename FunctionType>
+static void Enumerate(const char *name, FunctionType function){
+    u64 count = 0;
+    const Time time = Bench::Measure([&](){
+        count = function();
+    }, 3);
+    Println("%: % ms, % entries/s, % entries", name, time.AsMicroseconds() / 1000.0, Bench::PerSecond(double(count), time), count);
+}
+
+int main(){
+    {
+        Clock clock;
+        CreateTree();
+        Bench::Report("creating the tree", clock.GetElapsedTime(), double(TopDirectories) * SubDirectories * FilesPerDirectory, "files");
+    }
+    const String root = s_Root;
+
+    Enumerate("DirectoryIterator recursion", [&](){
+        return IterateRecursive(root);
+    });
+
+    for(u32 threads: {1u, 2u, 4u, 8u}){
+        Enumerate(Format("Directory::Walk, % threads", threads).Data(), [&](){
+            WalkCounter counter;
+            Directory::Walk(root, {&counter, &WalkCounter::OnEntry}, {}, threads);
+            return counter.Count.load();
+        });
+    }
+
+    Enumerate("readdir recursion, d_type", [&](){
+        return ReaddirRecursive(root, false);
+    });
+    Enumerate("readdir recursion, lstat per entry", [&](){
+        return ReaddirRecursive(root, true);
+    });
+    Println("hardware threads: %", ThreadPool::HardwareThreadsCount());
+
+    Directory::Delete(root);
+}
@@ -0,0 +1,197 @@
+#include <atomic>
+#include <thread>
+#include "core/list.hpp"
+#include "core/unique_ptr.hpp"
+#include "core/os/sleep.hpp"
+#include "core/net/tcp_socket.hpp"
+#include "core/net/tcp_listener.hpp"
+#include "core/net/event_loop.hpp"
+#include "bench.hpp"
+
+// Echo server on a single EventLoop thread over loopback. Client threads keep connections open and do
+// rounds of a 64 B message on every connection followed by the echoes, measured in messages per second
+// at 1 to 512 connections. Then clients connect, exchange one message and disconnect in a loop,
+// measured in connections per second, which includes accept and close on the loop
+
+static constexpr u32 MessageSize = 64;
+static constexpr u32 ClientThreads = 4;
+static constexpr Time Duration = Seconds(1);
+
+struct EchoServer;
+
+struct EchoConnection{
+	TcpSocket Socket;
+	EchoServer *Server = nullptr;
+
+	void OnEvent(u32 events);
+};
+
+struct EchoServer{
+	EventLoop Loop;
+	TcpListener Listener;
+	// stable addresses for the callbacks, closed connections are reused
+	List<UniquePtr<EchoConnection>> Connections;
+	List<EchoConnection*> FreeConnections;
+	u8 Buffer[16 * 1024];
+
+	void OnAccept(u32){
+		// edge-triggered, so everything pending is accepted
+		for(;;){
+			TcpSocket socket = Listener.Accept();
+			if(!socket.IsConnected())
+				break;
+
+			if(!FreeConnections.Size()){
+				Connections.Add(new EchoConnection());
+				FreeConnections.Add(Connections.Last().Get());
+			}
+			EchoConnection *connection = FreeConnections.Last();
+			FreeConnections.RemoveLast();
+
+			connection->Socket = Move(socket);
+			connection->Socket.SetNoDelay(true);
+			connection->Server = this;
+			Loop.Watch(connection->Socket, IoEvent::Readable, EventLoop::IoCallback(connection, &EchoConnection::OnEvent));
+		}
+	}
+
+	void Run(){
+		Loop.Run();
+	}
+};
+
+void EchoConnection::OnEvent(u32 events){
+	for(;;){
+		const u32 received = Socket.ReceiveSome(Server->Buffer, sizeof(Server->Buffer));
+		if(!received)
+			break;
+		// clients wait for the echo before sending more, so the send buffer doesn't fill up
+		(void)Socket.Send(Server->Buffer, received);
+	}
+
+	if((events & IoEvent::Closed) || !Socket.IsConnected()){
+		Server->Loop.Unwatch(Socket);
+		Socket.Disconnect();
+		Server->FreeConnections.Add(this);
+	}
+}
+
+struct EchoClient{
+	List<TcpSocket> Sockets;
+	u16 Port = 0;
+	const std::atomic<bool> *IsStopped = nullptr;
+	u64 Count = 0;
+
+	void RunMessages(){
+		u8 message[MessageSize] = {};
+		while(!IsStopped->load(std::memory_order_relaxed)){
+			for(TcpSocket &socket: Sockets)
+				(void)socket.Send(message, MessageSize);
+			for(TcpSocket &socket: Sockets){
+				if(socket.Receive(message, MessageSize) != MessageSize)
+					return;
+			}
+			Count += Sockets.Size();
+		}
+		for(TcpSocket &socket: Sockets)
+			socket.Disconnect();
+	}
+
+	void RunConnections(){
+		u8 message[MessageSize] = {};
+		while(!IsStopped->load(std::memory_order_relaxed)){
+			TcpSocket socket;
+			socket.SetNoDelay(true);
+			if(!socket.Connect(IpAddress::Loopback, Port))
+				break;
+			if(socket.Send(message, MessageSize) != MessageSize || socket.Receive(message, MessageSize) != MessageSize)
+				break;
+			Count++;
+		}
+	}
+};
+
+static u16 Listen(TcpListener &listener){
+	listener.SetReuseAddress(true);
+
+	for(u16 port = 42500; port < 42600; port++){
+		if(listener.Bind(IpAddress::Loopback, port))
+			return port;
+	}
+	return 0;
+}
+
+// counts done by the clients and the time they took, which includes finishing the last round
+static u64 RunClients(List<EchoClient> &clients, void (EchoClient::*run)(), Time &time){
+	std::atomic<bool> is_stopped{false};
+	Clock clock;
+	List<std::thread> threads;
+	for(EchoClient &client: clients){
+		client.IsStopped = &is_stopped;
+		threads.Emplace(run, &client);
+	}
+
+	Sleep(Duration);
+	is_stopped = true;
+	for(std::thread &thread: threads)
+		thread.join();
+	time = clock.GetElapsedTime();
+
+	u64 count = 0;
+	for(const EchoClient &client: clients)
+		count += client.Count;
+	return count;
+}
+
+static bool Echo(u16 port, u32 connections){
+	List<EchoClient> clients;
+	clients.Resize(Min(connections, ClientThreads));
+	for(u32 i = 0; i<connections; i++){
+		TcpSocket socket;
+		socket.SetNoDelay(true);
+		if(!socket.Connect(IpAddress::Loopback, port))
+			return false;
+		clients[i % clients.Size()].Sockets.Add(Move(socket));
+	}
+
+	Time time;
+	const u64 messages = RunClients(clients, &EchoClient::RunMessages, time);
+	Println("echo, % connections: % messages/s", connections, Bench::PerSecond(messages, time));
+	return true;
+}
+
+static void ConnectEcho(u16 port){
+	List<EchoClient> clients;
+	clients.Resize(ClientThreads);
+	for(EchoClient &client: clients)
+		client.Port = port;
+
+	// every connection leaves a socket in TIME_WAIT, a second is far from exhausting ephemeral ports
+	Time time;
+	const u64 connections = RunClients(clients, &EchoClient::RunConnections, time);
+	Println("connect, echo, disconnect: % connections/s", Bench::PerSecond(connections, time));
+}
+
+int main(){
+	EchoServer server;
+	const u16 port = Listen(server.Listener);
+	if(!port || !server.Loop.IsValid())
+		return Errorln("can't listen on loopback");
+	server.Loop.Watch(server.Listener, {&server, &EchoServer::OnAccept});
+
+	std::thread serving(&EchoServer::Run, &server);
+
+	bool is_connected = true;
+	for(u32 connections: {1u, 16u, 64u, 512u}){
+		is_connected = Echo(port, connections);
+		if(!is_connected){
+			Errorln("can't connect over loopback");
+			break;
+		}
+	}
+	if(is_connected)
+		ConnectEcho(port);
+
+	server.Loop.Stop();
+	serving.join();
+}
@@ -0,0 +1,137 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/fast_math.hpp"
+#include "bench.hpp"
+
+// Math::Fast batch and scalar versions against a libm loop over 1M floats, in the ranges
+// where their error bounds hold. Pow is measured on exponents below 1 in magnitude
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static void Report(const char *name, Time libm, Time scalar, Time batch, size_t count){
+    Println("%: libm % ms, scalar % ms, batch % ms, % values/s, %x libm", name,
+        libm.AsMicroseconds() / 1000.0, scalar.AsMicroseconds() / 1000.0, batch.AsMicroseconds() / 1000.0,
+        Bench::PerSecond(count, batch), double(libm.AsMicroseconds()) / batch.AsMicroseconds());
+}
+
+int main(){
+    constexpr size_t Count = 1000000;
+
+    List<float> angles, positive, exponents, y, result, cos;
+    for(size_t i = 0; i<Count; i++){
+        angles.Add(Random() * 100.f);
+        positive.Add(std::exp2(Random() * 30.f));
+        exponents.Add(Random() * 80.f);
+        y.Add(Random());
+    }
+    result.Resize(Count);
+    cos.Resize(Count);
+
+    const ConstSpan<float> angles_span(angles.Data(), Count), positive_span(positive.Data(), Count);
+    const ConstSpan<float> exponents_span(exponents.Data(), Count), y_span(y.Data(), Count);
+    const Span<float> result_span(result.Data(), Count);
+    Time libm, scalar, batch;
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++){
+            result[i] = std::sin(angles[i]);
+            cos[i] = std::cos(angles[i]);
+        }
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            Math::Fast::SinCos(angles[i], result[i], cos[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::SinCos(angles_span, result_span, {cos.Data(), Count});
+    });
+    Report("sincos", libm, scalar, batch, Count);
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = std::sin(angles[i]);
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = Math::Fast::Sin(angles[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::Sin(angles_span, result_span);
+    });
+    Report("sin", libm, scalar, batch, Count);
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = std::atan2(y[i], angles[i]);
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = Math::Fast::Atan2(y[i], angles[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::Atan2(y_span, angles_span, result_span);
+    });
+    Report("atan2", libm, scalar, batch, Count);
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = std::exp(exponents[i]);
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = Math::Fast::Exp(exponents[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::Exp(exponents_span, result_span);
+    });
+    Report("exp", libm, scalar, batch, Count);
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = std::log(positive[i]);
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = Math::Fast::Log(positive[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::Log(positive_span, result_span);
+    });
+    Report("log", libm, scalar, batch, Count);
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = std::pow(positive[i], y[i]);
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = Math::Fast::Pow(positive[i], y[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::Pow(positive_span, y_span, result_span);
+    });
+    Report("pow", libm, scalar, batch, Count);
+
+    libm = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = 1.f / std::sqrt(positive[i]);
+    });
+    scalar = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            result[i] = Math::Fast::Rsqrt(positive[i]);
+    });
+    batch = Bench::Measure([&](){
+        Math::Fast::Rsqrt(positive_span, result_span);
+    });
+    Report("rsqrt", libm, scalar, batch, Count);
+
+    Bench::DoNotOptimize(result[Count - 1]);
+    Bench::DoNotOptimize(cos[Count - 1]);
+}
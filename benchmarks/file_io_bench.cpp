@@ -0,0 +1,55 @@
+#include "core/list.hpp"
+#include "core/os/file.hpp"
+#include "core/os/thread_pool.hpp"
+#include "bench.hpp"
+
+// A 512 MB file is read into memory by a single File::Read, and in 1 MB chunks with ReadAt from
+// pools of 1 to 8 threads sharing one File. The file is freshly written and in page cache,
+// so this measures copying out of it and how well positional reads scale across threads
+
+static const char *s_Filename = "sx_file_io_bench.bin";
+
+static constexpr u64 FileSize = 512 * 1024 * 1024;
+static constexpr u64 ChunkSize = 1024 * 1024;
+
+int main(){
+    List<u8> content;
+    content.Resize(FileSize);
+    for(size_t i = 0; i<content.Size(); i += 4096)
+        content[i] = u8(i >> 12);
+    {
+        File file(s_Filename, File::Mode::Write);
+        file.Write(content.Data(), content.Size());
+    }
+
+    File file(s_Filename, File::Mode::Read, false);
+    Time time;
+
+    time = Bench::Measure([&](){
+        file.Seek(File::Begin, 0);
+        Bench::DoNotOptimize(file.Read(content.Data(), content.Size()));
+    });
+    Bench::Report("File::Read, single call", time, double(FileSize) / (1024 * 1024), "MB");
+
+    time = Bench::Measure([&](){
+        file.Seek(File::Begin, 0);
+        for(u64 offset = 0; offset<FileSize; offset += ChunkSize)
+            Bench::DoNotOptimize(file.Read(content.Data() + offset, ChunkSize));
+    });
+    Bench::Report("File::Read, 1 MB chunks", time, double(FileSize) / (1024 * 1024), "MB");
+
+    for(u32 threads: {1u, 2u, 4u, 8u}){
+        ThreadPool pool(threads);
+        time = Bench::Measure([&](){
+            pool.ParallelFor(FileSize / ChunkSize, 1, [&](size_t begin, size_t end){
+                for(size_t chunk = begin; chunk<end; chunk++)
+                    Bench::DoNotOptimize(file.ReadAt(content.Data() + chunk * ChunkSize, ChunkSize, chunk * ChunkSize));
+            });
+        });
+        Println("File::ReadAt, 1 MB chunks, % threads: % ms, % MB/s", threads, time.AsMicroseconds() / 1000.0, Bench::PerSecond(double(FileSize) / (1024 * 1024), time));
+    }
+    Println("hardware threads: %", ThreadPool::HardwareThreadsCount());
+
+    file.Close();
+    File::Delete(s_Filename);
+}
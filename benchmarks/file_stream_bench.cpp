@@ -0,0 +1,90 @@
+#include "core/list.hpp"
+#include "core/string.hpp"
+#include "core/os/file.hpp"
+#include "core/os/file_reader.hpp"
+#include "core/os/file_writer.hpp"
+#include "bench.hpp"
+
+// A 1 GB text file of lines from 10 to 150 characters is written through FileWriter, then read
+// line by line with FileReader at several buffer sizes. The same lines read a byte per File::Read,
+// which is what parsing code did without the reader, are measured on the first 8 MB only
+
+static const char *s_Filename = "sx_file_stream_bench.txt";
+
+static u32 s_RandomState = 0x2545F491;
+
+static u32 RandomIndex(u32 count){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return s_RandomState % count;
+}
+
+static void ReadLines(size_t buffer_size, u64 size){
+    u64 lines = 0, bytes = 0;
+    const Time time = Bench::Measure([&](){
+        File file(s_Filename, File::Mode::Read, false);
+        FileReader reader(file, buffer_size);
+        String line;
+        lines = 0;
+        bytes = 0;
+        while(reader.ReadLine(line)){
+            lines++;
+            bytes += line.Size() + 1;
+        }
+    }, 3);
+    Println("FileReader::ReadLine, % KB buffer: % MB/s, % lines/s", buffer_size / 1024, Bench::PerSecond(double(size) / (1024 * 1024), time), Bench::PerSecond(lines, time));
+    Bench::DoNotOptimize(bytes);
+}
+
+int main(){
+    constexpr u64 FileSize = 1024ull * 1024 * 1024;
+    constexpr u64 UnbufferedSize = 8 * 1024 * 1024;
+
+    // random printable lines, cycled through a pool so generation doesn't dominate writing
+    List<String> pool;
+    for(u32 i = 0; i<4096; i++){
+        String line;
+        const u32 length = 10 + RandomIndex(141);
+        for(u32 j = 0; j<length; j++)
+            line.Append(StringView(&"abcdefghijklmnopqrstuvwxyz0123456789 ,.;"[RandomIndex(40)], 1));
+        line.Append(StringView("\n", 1));
+        pool.Add(Move(line));
+    }
+
+    u64 written = 0;
+    {
+        File file(s_Filename, File::Mode::Write);
+        FileWriter writer(file);
+        Clock clock;
+        for(size_t i = 0; written<FileSize; i++){
+            const String &line = pool[i % pool.Size()];
+            writer.Write(line.Data(), line.Size());
+            written += line.Size();
+        }
+        writer.Flush();
+        Bench::Report("FileWriter, 64 KB buffer", clock.GetElapsedTime(), double(written) / (1024 * 1024), "MB");
+    }
+
+    for(size_t buffer_size: {size_t(4 * 1024), size_t(64 * 1024), size_t(1024 * 1024)})
+        ReadLines(buffer_size, written);
+
+    u64 lines = 0;
+    const Time time = Bench::Measure([&](){
+        File file(s_Filename, File::Mode::Read, false);
+        String line;
+        lines = 0;
+        char byte;
+        for(u64 offset = 0; offset<UnbufferedSize && file.Read(&byte, 1) == 1; offset++){
+            if(byte == '\n'){
+                lines++;
+                line.Clear();
+            }else{
+                line.Append(StringView(&byte, 1));
+            }
+        }
+    }, 1);
+    Println("File::Read per byte: % MB/s, % lines/s", Bench::PerSecond(double(UnbufferedSize) / (1024 * 1024), time), Bench::PerSecond(lines, time));
+
+    File::Delete(s_Filename);
+}
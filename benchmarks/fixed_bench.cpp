@@ -0,0 +1,108 @@
+#include "core/list.hpp"
+#include "core/math/fixed.hpp"
+#include "core/math/vector3.hpp"
+#include "bench.hpp"
+
+// A physics step over 100K bodies with gravity, damping and a ground bounce, the same kernel
+// on float, Fixed32 and Fixed64. Then the functions lockstep code calls per body, against libm
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+template<typename T>
+struct Bodies{
+    List<Vector3<T>> Positions;
+    List<Vector3<T>> Velocities;
+
+    Bodies(size_t count){
+        for(size_t i = 0; i<count; i++){
+            Positions.Add(Vector3<T>(T(Random() * 100), T(Random() * 10 + 10), T(Random() * 100)));
+            Velocities.Add(Vector3<T>(T(Random()), T(0), T(Random())));
+        }
+    }
+
+    void Step(){
+        const T step = T(1.f / 64), damping = T(0.995f), bounce = T(-0.8f), zero = T(0);
+        const Vector3<T> gravity(zero, T(-10), zero);
+
+        for(size_t i = 0; i<Positions.Size(); i++){
+            Vector3<T> velocity = (Velocities[i] + gravity * step) * damping;
+            Vector3<T> position = Positions[i] + velocity * step;
+            if(position.y < zero){
+                position.y = -position.y;
+                velocity.y = velocity.y * bounce;
+            }
+            Positions[i] = position;
+            Velocities[i] = velocity;
+        }
+    }
+};
+
+template<typename T>
+static void Physics(const char *name, size_t count){
+    Bodies<T> bodies(count);
+    constexpr u32 Steps = 10;
+
+    const Time time = Bench::Measure([&](){
+        for(u32 i = 0; i<Steps; i++)
+            bodies.Step();
+    });
+    Bench::Report(name, time, double(count) * Steps, "bodies");
+    Bench::DoNotOptimize(bodies.Positions[count - 1]);
+}
+
+template<typename T>
+static void Functions(const char *name, size_t count){
+    List<T> x, y, result;
+    for(size_t i = 0; i<count; i++){
+        x.Add(T(Random() * 10));
+        y.Add(T(Random() * 10 + 10.5f));
+    }
+    result.Resize(count);
+    Time time;
+
+    time = Bench::Measure([&](){
+        for(size_t i = 0; i<count; i++)
+            result[i] = Math::Sin(x[i]);
+    });
+    Println("%: sin % values/s", name, Bench::PerSecond(count, time));
+
+    time = Bench::Measure([&](){
+        for(size_t i = 0; i<count; i++)
+            result[i] = Math::Atan2(x[i], y[i]);
+    });
+    Println("%: atan2 % values/s", name, Bench::PerSecond(count, time));
+
+    time = Bench::Measure([&](){
+        for(size_t i = 0; i<count; i++)
+            result[i] = Math::Sqrt(y[i]);
+    });
+    Println("%: sqrt % values/s", name, Bench::PerSecond(count, time));
+
+    time = Bench::Measure([&](){
+        for(size_t i = 0; i<count; i++)
+            result[i] = x[i] / y[i];
+    });
+    Println("%: divide % values/s", name, Bench::PerSecond(count, time));
+
+    Bench::DoNotOptimize(result[count - 1]);
+}
+
+int main(){
+    constexpr size_t Count = 100000;
+
+    Physics<float>("physics step, float", Count);
+    Physics<Fixed32>("physics step, Fixed32", Count);
+    Physics<Fixed64>("physics step, Fixed64", Count);
+
+    constexpr size_t FunctionsCount = 1000000;
+    Functions<float>("float", FunctionsCount);
+    Functions<Fixed32>("Fixed32", FunctionsCount);
+    Functions<Fixed64>("Fixed64", FunctionsCount);
+}
@@ -0,0 +1,105 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/frustum.hpp"
+#include "bench.hpp"
+
+// Culling of 200K boxes and spheres scattered around a perspective camera, about a quarter of them
+// visible. Scalar loop over Frustum::Intersects against the batch versions, in culled elements per millisecond
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+// visible elements are counted outside of the measurement
+static void Report(const char *name, const char *unit, Time time, size_t count, size_t visible){
+    Println("%: % ms, % %/ms, % visible", name, time.AsMicroseconds() / 1000.0, Bench::PerSecond(count, time) / 1000.0, unit, visible);
+}
+
+static size_t VisibleCount(const List<u8> &visibility){
+    size_t visible = 0;
+    for(u8 is_visible: visibility)
+        visible += is_visible;
+    return visible;
+}
+
+int main(){
+    constexpr size_t Count = 200000;
+
+    const float fov = 1.2f, aspect = 16.f / 9.f, near = 0.1f, far = 500.f;
+    const float f = 1.f / std::tan(fov / 2);
+    const Frustum frustum(Matrix4f(
+        {f / aspect, 0, 0, 0},
+        {0, f, 0, 0},
+        {0, 0, far / (near - far), near * far / (near - far)},
+        {0, 0, -1, 0}
+    ));
+
+    List<AABB3f> boxes;
+    List<Spheref> spheres;
+    for(size_t i = 0; i<Count; i++){
+        const Vector3f center(Random() * 400, Random() * 100, Random() * 400);
+        boxes.Add(AABB3f(center, {Random() + 2, Random() + 2, Random() + 2}));
+        spheres.Add(Spheref(center, Random() + 2));
+    }
+
+    AABB3Stream stream;
+    stream.FromAoS({boxes.Data(), Count});
+
+    List<u8> visibility;
+    visibility.Resize(Count);
+    List<u32> indices;
+    indices.Reserve(Count);
+    Time time;
+
+    time = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            visibility[i] = frustum.Intersects(boxes[i]);
+    });
+    Report("boxes, Intersects loop", "boxes", time, Count, VisibleCount(visibility));
+
+    time = Bench::Measure([&](){
+        Math::CullAABBs(frustum, {boxes.Data(), Count}, {visibility.Data(), Count});
+    });
+    Report("boxes, CullAABBs", "boxes", time, Count, VisibleCount(visibility));
+
+    time = Bench::Measure([&](){
+        indices.Clear();
+        Math::CullAABBs(frustum, {boxes.Data(), Count}, indices);
+    });
+    Report("boxes, CullAABBs indices", "boxes", time, Count, indices.Size());
+
+    time = Bench::Measure([&](){
+        Math::CullAABBs(frustum, stream, {visibility.Data(), Count});
+    });
+    Report("boxes, CullAABBs stream", "boxes", time, Count, VisibleCount(visibility));
+
+    time = Bench::Measure([&](){
+        indices.Clear();
+        Math::CullAABBs(frustum, stream, indices);
+    });
+    Report("boxes, CullAABBs stream indices", "boxes", time, Count, indices.Size());
+
+    time = Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            visibility[i] = frustum.Intersects(spheres[i]);
+    });
+    Report("spheres, Intersects loop", "spheres", time, Count, VisibleCount(visibility));
+
+    time = Bench::Measure([&](){
+        Math::CullSpheres(frustum, {spheres.Data(), Count}, {visibility.Data(), Count});
+    });
+    Report("spheres, CullSpheres", "spheres", time, Count, VisibleCount(visibility));
+
+    time = Bench::Measure([&](){
+        indices.Clear();
+        Math::CullSpheres(frustum, {spheres.Data(), Count}, indices);
+    });
+    Report("spheres, CullSpheres indices", "spheres", time, Count, indices.Size());
+
+    Bench::DoNotOptimize(visibility[Count - 1]);
+}
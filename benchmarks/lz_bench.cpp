@@ -0,0 +1,127 @@
+#include <cmath>
+#include <cstring>
+#include "core/list.hpp"
+#include "core/compression/lz_block.hpp"
+#include "core/compression/lz_frame.hpp"
+#include "core/os/thread_pool.hpp"
+#include "bench.hpp"
+
+// 16 MB corpora of text, mesh vertices with indices and an RGBA texture are compressed into frames
+// of 64 KB blocks with the fast and the high level, on one thread and on the pool, and decompressed
+// back. Throughput counts uncompressed bytes, ratio is uncompressed size over compressed size
+
+static constexpr size_t CorpusSize = 16 * 1024 * 1024;
+
+static u32 s_RandomState = 0x2545F491;
+
+static u32 RandomIndex(u32 count){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return s_RandomState % count;
+}
+
+static float Random(){
+    return RandomIndex(0x1000000) / float(0x800000) - 1.f;
+}
+
+template<typename Type>
+static void Append(List<u8> &corpus, const Type &value){
+    const size_t size = corpus.Size();
+    corpus.Resize(size + sizeof(value));
+    memcpy(corpus.Data() + size, &value, sizeof(value));
+}
+
+// words of a shader like source, with lines of varying length
+static List<u8> TextCorpus(){
+    static const char *const s_Words[] = {"float", "vec3", "vec4", "position", "normal", "texture", "uniform", "return",
+        "material", "light", "color", "if", "for", "0.5", "1.0", "mix", "dot", "normalize", "sampler2D", "main"};
+    static const char *const s_Separators[] = {" ", " ", " ", " = ", ", ", "(", ");\n", ";\n    ", ".", " * "};
+
+    List<u8> corpus;
+    while(corpus.Size() < CorpusSize){
+        for(const char *string: {s_Words[RandomIndex(20)], s_Separators[RandomIndex(10)]}){
+            const size_t size = corpus.Size();
+            corpus.Resize(size + strlen(string));
+            memcpy(corpus.Data() + size, string, strlen(string));
+        }
+    }
+    corpus.Resize(CorpusSize);
+    return corpus;
+}
+
+// interleaved position, normal and uv of a noisy grid, followed by triangle indices
+static List<u8> MeshCorpus(){
+    constexpr u32 GridSize = 512;
+
+    List<u8> corpus;
+    for(u32 y = 0; y<GridSize; y++){
+        for(u32 x = 0; x<GridSize; x++){
+            const float height = std::sin(x * 0.05f) * std::cos(y * 0.05f) + Random() * 0.01f;
+            for(float value: {float(x), height, float(y), Random() * 0.1f, 1.f, Random() * 0.1f, x / float(GridSize), y / float(GridSize)})
+                Append(corpus, value);
+        }
+    }
+    for(u32 y = 0; y + 1<GridSize && corpus.Size() < CorpusSize; y++){
+        for(u32 x = 0; x + 1<GridSize; x++){
+            const u32 index = y * GridSize + x;
+            for(u32 vertex: {index, index + 1, index + GridSize, index + 1, index + GridSize + 1, index + GridSize})
+                Append(corpus, vertex);
+        }
+    }
+    corpus.Resize(CorpusSize);
+    return corpus;
+}
+
+// smooth gradients with noise in the low bits and an opaque alpha
+static List<u8> TextureCorpus(){
+    List<u8> corpus;
+    corpus.Resize(CorpusSize);
+    for(size_t i = 0; i<CorpusSize / 4; i++){
+        const u32 x = i % 2048, y = u32(i / 2048);
+        corpus[i * 4 + 0] = u8((x / 8 + RandomIndex(4)) & 0xFF);
+        corpus[i * 4 + 1] = u8((y / 8 + RandomIndex(4)) & 0xFF);
+        corpus[i * 4 + 2] = u8(((x + y) / 16) & 0xFF);
+        corpus[i * 4 + 3] = 0xFF;
+    }
+    return corpus;
+}
+
+static void Corpus(const char *name, const List<u8> &corpus, ThreadPool &pool){
+    const ConstSpan<u8> source(corpus.Data(), corpus.Size());
+    const double megabytes = double(corpus.Size()) / (1024 * 1024);
+
+    for(LzBlock::Level level: {LzBlock::Level::Fast, LzBlock::Level::High}){
+        const char *level_name = level == LzBlock::Level::Fast ? "fast" : "high";
+        // high level is meant for offline cooking and takes much longer
+        const u32 runs = level == LzBlock::Level::Fast ? Bench::DefaultRuns : 1;
+
+        List<u8> frame;
+        const Time compress = Bench::Measure([&](){
+            frame.Clear();
+            LzFrame::Compress(source, frame, level);
+        }, runs);
+        const Time parallel_compress = Bench::Measure([&](){
+            frame.Clear();
+            LzFrame::Compress(source, frame, pool, level);
+        }, runs);
+
+        List<u8> content;
+        const Time decompress = Bench::Measure([&](){
+            content.Clear();
+            Bench::DoNotOptimize(LzFrame::Decompress({frame.Data(), frame.Size()}, content));
+        });
+
+        Println("%, %: ratio %, compress % MB/s, compress on % threads % MB/s, decompress % MB/s", name, level_name,
+            double(corpus.Size()) / double(frame.Size()), Bench::PerSecond(megabytes, compress),
+            pool.ThreadsCount(), Bench::PerSecond(megabytes, parallel_compress), Bench::PerSecond(megabytes, decompress));
+    }
+}
+
+int main(){
+    ThreadPool pool;
+
+    Corpus("text", TextCorpus(), pool);
+    Corpus("mesh", MeshCorpus(), pool);
+    Corpus("texture", TextureCorpus(), pool);
+}
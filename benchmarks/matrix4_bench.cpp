@@ -0,0 +1,85 @@
+#include "core/list.hpp"
+#include "core/math/matrix4.hpp"
+#include "bench.hpp"
+
+// Float specializations of Matrix4 against the generic templates over 100K random matrices.
+// Templates are reached through explicit template arguments, inverse through Details::ScalarInverse
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector4f RandomVector(){
+    return {Random(), Random(), Random(), Random()};
+}
+
+int main(){
+    constexpr size_t Count = 100000;
+
+    List<Matrix4f> matrices, affine, results;
+    List<Vector4f> vectors, transformed;
+    matrices.Resize(Count);
+    affine.Resize(Count);
+    results.Resize(Count);
+    vectors.Resize(Count);
+    transformed.Resize(Count);
+
+    for(size_t i = 0; i<Count; i++){
+        matrices[i] = {RandomVector(), RandomVector(), RandomVector(), RandomVector()};
+        for(size_t j = 0; j<4; j++)
+            matrices[i][j][j] += 4.f;
+
+        affine[i] = matrices[i];
+        affine[i][3] = {0, 0, 0, 1};
+        vectors[i] = RandomVector();
+    }
+
+    // every matrix by the next one, so products can't be hoisted out
+    Bench::Report("multiply, template", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = operator*<float>(matrices[i], matrices[(i + 1) % Count]);
+    }), Count, "products");
+    Bench::Report("multiply, Matrix4f", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = matrices[i] * matrices[(i + 1) % Count];
+    }), Count, "products");
+
+    Bench::Report("matrix * vector, template", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            transformed[i] = operator*<float>(matrices[i], vectors[i]);
+    }), Count, "products");
+    Bench::Report("matrix * vector, Matrix4f", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            transformed[i] = matrices[i] * vectors[i];
+    }), Count, "products");
+
+    Bench::Report("transpose, Matrix4f", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = matrices[i].GetTransposed();
+    }), Count, "matrices");
+
+    Bench::Report("inverse, template", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = Details::ScalarInverse(matrices[i]);
+    }), Count, "matrices");
+    Bench::Report("inverse, Matrix4f general", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = matrices[i].GetInverse();
+    }), Count, "matrices");
+    Bench::Report("inverse, template affine", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = Details::ScalarInverse(affine[i]);
+    }), Count, "matrices");
+    Bench::Report("inverse, Matrix4f affine", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            results[i] = affine[i].GetInverse();
+    }), Count, "matrices");
+
+    Bench::DoNotOptimize(results[Count - 1]);
+    Bench::DoNotOptimize(transformed[Count - 1]);
+}
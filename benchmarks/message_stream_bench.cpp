@@ -0,0 +1,103 @@
+#include <thread>
+#include "core/net/message_stream.hpp"
+#include "core/net/tcp_listener.hpp"
+#include "bench.hpp"
+
+// Small message throughput of MessageStream over loopback, the sender flushes every FlushInterval messages
+// and the receiver runs on a thread of its own. Time is from the first Send until the last message is received
+
+static constexpr u32 FlushInterval = 64;
+
+static bool ConnectPair(TcpSocket &client, TcpSocket &server){
+	TcpListener listener;
+	listener.SetReuseAddress(true);
+
+	for(u16 port = 42400; port < 42500; port++){
+		if(!listener.Bind(IpAddress::Loopback, port))
+			continue;
+		if(!client.Connect(IpAddress::Loopback, port))
+			return false;
+		server = listener.Accept();
+		return server.IsConnected();
+	}
+	return false;
+}
+
+struct Receiver{
+	TcpSocket *Socket = nullptr;
+	SlabPool *Pool = nullptr;
+	MessageStreamConfig Config;
+	u32 MessagesCount = 0;
+	u32 Received = 0;
+	u64 Checksum = 0;
+
+	void Run(){
+		MessageStream stream(*Socket, *Pool, Config);
+
+		while(Received < MessagesCount){
+			if(!stream.Receive() && !Socket->IsConnected())
+				break;
+
+			ConstSpan<u8> message;
+			while(stream.NextMessage(message)){
+				Checksum += message[0];
+				Received++;
+			}
+		}
+	}
+};
+
+static void Run(MessageFraming framing, u32 size, u32 count){
+	TcpSocket client, server;
+	if(!ConnectPair(client, server)){
+		Errorln("can't connect over loopback");
+		return;
+	}
+	client.SetNoDelay(true);
+
+	SlabPool pool;
+	MessageStreamConfig config;
+	config.Framing = framing;
+
+	List<u8> message;
+	message.Resize(size);
+	for(u32 i = 0; i<size; i++)
+		message[i] = 'a' + i % 26;
+
+	Receiver receiver;
+	receiver.Socket = &server;
+	receiver.Pool = &pool;
+	receiver.Config = config;
+	receiver.MessagesCount = count;
+
+	Clock clock;
+	std::thread receiving(&Receiver::Run, &receiver);
+	{
+		MessageStream stream(client, pool, config);
+
+		for(u32 i = 0; i<count; i++){
+			stream.Send({message.Data(), message.Size()});
+			if(i % FlushInterval == FlushInterval - 1)
+				stream.Flush();
+		}
+		stream.Flush();
+	}
+	receiving.join();
+	const Time time = clock.GetElapsedTime();
+
+	Println("%, % B: % messages/s, % MB/s, received %/%",
+		framing == MessageFraming::LengthPrefix ? "length prefix" : "delimiter", size,
+		Bench::PerSecond(count, time), Bench::PerSecond((double)count * size, time) / 1000000.0,
+		receiver.Received, count);
+}
+
+int main(){
+	const u32 sizes[] = {64, 1024, 64 * 1024};
+	// 128 to 256MB per run
+	const u32 counts[] = {2000000, 250000, 4000};
+
+	for(MessageFraming framing: {MessageFraming::LengthPrefix, MessageFraming::Delimiter}){
+		for(size_t i = 0; i<3; i++)
+			Run(framing, sizes[i], counts[i]);
+	}
+}
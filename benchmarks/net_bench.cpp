@@ -0,0 +1,690 @@
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "core/print.hpp"
+#include "core/list.hpp"
+#include "core/string_view.hpp"
+#include "core/unique_ptr.hpp"
+#include "core/net/tcp_socket.hpp"
+#include "core/net/tcp_listener.hpp"
+#include "core/net/udp_socket.hpp"
+#include "core/net/event_loop.hpp"
+
+// Usage: StraitXNetBench [--payload-sizes 64,1024,65536] [--udp-batch-sizes 1,8,32,64] [--threads 4] [--connections 256] [--duration-ms 1000]
+//
+// Loopback benchmark of core/net, every scenario runs for the duration with every payload size:
+//   tcp_stream  - threads pairs of connections streaming payload sized sends, bytes per second at the receivers
+//   tcp_rtt     - threads connections doing request/response of payload size, round trip latencies
+//   udp_rate    - threads senders with a receiver each, datagrams of payload size (capped to the maximum)
+//                 sent by SendBatch with every udp batch size, runs of them are segmented with GSO where supported
+//   tcp_accept  - threads clients connecting and waiting for the server to close, connect latencies
+//   tcp_fan_in  - connections spread over threads senders, a single EventLoop thread receives from all of them
+// Results are printed to stdout as JSON, progress goes to stderr. Latencies are in microseconds
+
+using BenchClock = std::chrono::steady_clock;
+
+struct BenchConfig{
+	List<u32> PayloadSizes;
+	List<u32> UdpBatchSizes;
+	u32 Threads = 4;
+	u32 Connections = 256;
+	u32 DurationMs = 1000;
+};
+
+struct BenchResult{
+	const char *Name = "";
+	u32 PayloadSize = 0;
+	u32 Threads = 0;
+	u32 Connections = 0;
+	// datagrams per SendBatch call, udp only
+	u32 BatchSize = 0;
+	double Seconds = 0;
+	u64 Operations = 0;
+	u64 Bytes = 0;
+	// datagrams sent but not received, udp only
+	s64 Dropped = -1;
+	bool HasLatency = false;
+	double P50 = 0;
+	double P99 = 0;
+	double P999 = 0;
+};
+
+static double SecondsSince(BenchClock::time_point start){
+	return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+static u32 NanosecondsSince(BenchClock::time_point start){
+	return (u32)Min<s64>(std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - start).count(), 0xFFFFFFFF);
+}
+
+static void SleepFor(u32 milliseconds){
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+// merges per thread samples, percentiles are in microseconds
+static void ComputeLatency(BenchResult &result, const List<List<u32>> &samples){
+	List<u32> all;
+	for(const List<u32> &thread_samples: samples){
+		for(u32 sample: thread_samples)
+			all.Add(sample);
+	}
+	if(!all.Size())
+		return;
+
+	std::sort(all.begin(), all.end());
+
+	auto percentile = [&all](double fraction){
+		return all[Min<size_t>(size_t(fraction * all.Size()), all.Size() - 1)] / 1000.0;
+	};
+
+	result.HasLatency = true;
+	result.P50 = percentile(0.5);
+	result.P99 = percentile(0.99);
+	result.P999 = percentile(0.999);
+}
+
+static u16 s_NextPort = 43000;
+
+// takes the first free port after the previously used ones, so sockets in TIME_WAIT don't get in the way
+static u16 BindListener(TcpListener &listener){
+	listener.SetReuseAddress(true);
+
+	for(; s_NextPort < 44000; s_NextPort++){
+		if(listener.Bind(IpAddress::Loopback, s_NextPort))
+			return s_NextPort++;
+	}
+	return 0;
+}
+
+static u16 BindUdp(UdpSocket &socket){
+	for(; s_NextPort < 44000; s_NextPort++){
+		if(socket.Bind(IpAddress::Loopback, s_NextPort))
+			return s_NextPort++;
+	}
+	return 0;
+}
+
+static bool ConnectPair(TcpSocket &client, TcpSocket &server){
+	TcpListener listener;
+	const u16 port = BindListener(listener);
+
+	if(!port || !client.Connect(IpAddress::Loopback, port))
+		return false;
+
+	server = listener.Accept();
+	return server.IsConnected();
+}
+
+struct StreamSender{
+	TcpSocket Socket;
+	const std::atomic<bool> *IsStopped = nullptr;
+	List<u8> Payload;
+
+	void Run(){
+		while(!IsStopped->load(std::memory_order_relaxed)){
+			if(Socket.Send(Payload.Data(), Payload.Size()) != Payload.Size())
+				break;
+		}
+		Socket.Disconnect();
+	}
+};
+
+struct StreamReceiver{
+	TcpSocket Socket;
+	std::atomic<u64> Bytes{0};
+
+	void Run(){
+		static constexpr u32 BufferSize = 256 * 1024;
+		List<u8> buffer;
+		buffer.Resize(BufferSize);
+
+		for(;;){
+			const u32 received = Socket.ReceiveSome(buffer.Data(), BufferSize);
+			if(!received)
+				break;
+			Bytes.fetch_add(received, std::memory_order_relaxed);
+		}
+	}
+};
+
+static BenchResult TcpStream(const BenchConfig &config, u32 payload_size){
+	BenchResult result;
+	result.Name = "tcp_stream";
+	result.PayloadSize = payload_size;
+	result.Threads = config.Threads;
+	result.Connections = config.Threads;
+
+	std::atomic<bool> is_stopped{false};
+	List<StreamSender> senders;
+	// atomic counters are not movable, so receivers are not stored inline
+	List<UniquePtr<StreamReceiver>> receivers;
+	senders.Resize(config.Threads);
+
+	for(u32 i = 0; i<config.Threads; i++){
+		receivers.Add(new StreamReceiver());
+		if(!ConnectPair(senders[i].Socket, receivers[i]->Socket))
+			return result;
+		senders[i].IsStopped = &is_stopped;
+		senders[i].Payload.Resize(payload_size);
+	}
+
+	List<std::thread> threads;
+	const BenchClock::time_point start = BenchClock::now();
+	for(u32 i = 0; i<config.Threads; i++){
+		threads.Emplace(&StreamReceiver::Run, receivers[i].Get());
+		threads.Emplace(&StreamSender::Run, &senders[i]);
+	}
+
+	SleepFor(config.DurationMs);
+	// only bytes received within the duration count
+	for(UniquePtr<StreamReceiver> &receiver: receivers)
+		result.Bytes += receiver->Bytes.load();
+	result.Seconds = SecondsSince(start);
+
+	is_stopped = true;
+	for(std::thread &thread: threads)
+		thread.join();
+
+	result.Operations = result.Bytes / payload_size;
+	return result;
+}
+
+struct RttClient{
+	TcpSocket Socket;
+	const std::atomic<bool> *IsStopped = nullptr;
+	List<u8> Payload;
+	List<u32> Samples;
+
+	void Run(){
+		while(!IsStopped->load(std::memory_order_relaxed)){
+			const BenchClock::time_point start = BenchClock::now();
+
+			if(Socket.Send(Payload.Data(), Payload.Size()) != Payload.Size())
+				break;
+			if(Socket.Receive(Payload.Data(), Payload.Size()) != Payload.Size())
+				break;
+
+			Samples.Add(NanosecondsSince(start));
+		}
+		Socket.Disconnect();
+	}
+};
+
+struct EchoServer{
+	TcpSocket Socket;
+	List<u8> Buffer;
+
+	void Run(){
+		while(Socket.Receive(Buffer.Data(), Buffer.Size()) == Buffer.Size()){
+			if(Socket.Send(Buffer.Data(), Buffer.Size()) != Buffer.Size())
+				break;
+		}
+	}
+};
+
+static BenchResult TcpRtt(const BenchConfig &config, u32 payload_size){
+	BenchResult result;
+	result.Name = "tcp_rtt";
+	result.PayloadSize = payload_size;
+	result.Threads = config.Threads;
+	result.Connections = config.Threads;
+
+	std::atomic<bool> is_stopped{false};
+	List<RttClient> clients;
+	List<EchoServer> servers;
+	clients.Resize(config.Threads);
+	servers.Resize(config.Threads);
+
+	for(u32 i = 0; i<config.Threads; i++){
+		if(!ConnectPair(clients[i].Socket, servers[i].Socket))
+			return result;
+		clients[i].Socket.SetNoDelay(true);
+		servers[i].Socket.SetNoDelay(true);
+		clients[i].IsStopped = &is_stopped;
+		clients[i].Payload.Resize(payload_size);
+		servers[i].Buffer.Resize(payload_size);
+	}
+
+	List<std::thread> threads;
+	const BenchClock::time_point start = BenchClock::now();
+	for(u32 i = 0; i<config.Threads; i++){
+		threads.Emplace(&EchoServer::Run, &servers[i]);
+		threads.Emplace(&RttClient::Run, &clients[i]);
+	}
+
+	SleepFor(config.DurationMs);
+	is_stopped = true;
+	for(std::thread &thread: threads)
+		thread.join();
+	result.Seconds = SecondsSince(start);
+
+	List<List<u32>> samples;
+	for(RttClient &client: clients){
+		result.Operations += client.Samples.Size();
+		samples.Add(Move(client.Samples));
+	}
+	result.Bytes = result.Operations * payload_size * 2;
+	ComputeLatency(result, samples);
+	return result;
+}
+
+struct UdpSender{
+	static constexpr u32 MaxBatchSize = 64;
+
+	UdpSocket Socket;
+	u32 BatchSize = MaxBatchSize;
+	u16 DestinationPort = 0;
+	const std::atomic<bool> *IsStopped = nullptr;
+	List<u8> Payload;
+	u64 Sent = 0;
+
+	void Run(){
+		UdpOutDatagram batch[MaxBatchSize];
+		for(UdpOutDatagram &datagram: batch)
+			datagram = {{Payload.Data(), Payload.Size()}, IpAddress::Loopback, DestinationPort};
+
+		while(!IsStopped->load(std::memory_order_relaxed))
+			Sent += Socket.SendBatch({batch, BatchSize});
+	}
+};
+
+struct UdpReceiver{
+	static constexpr u32 BatchSize = 64;
+
+	UdpSocket Socket;
+	std::atomic<u64> Received{0};
+	std::atomic<bool> IsDone{false};
+
+	void Run(){
+		List<u8> storage;
+		storage.Resize(BatchSize * Udp::MaxDatagramSize);
+
+		UdpInDatagram batch[BatchSize];
+		for(u32 i = 0; i<BatchSize; i++)
+			batch[i].Buffer = {storage.Data() + i * Udp::MaxDatagramSize, Udp::MaxDatagramSize};
+
+		// empty datagram is the end of the run
+		for(;;){
+			const u32 count = Socket.ReceiveBatch({batch, BatchSize});
+
+			for(u32 i = 0; i<count; i++){
+				if(!batch[i].Size){
+					IsDone = true;
+					return;
+				}
+			}
+			Received.fetch_add(count, std::memory_order_relaxed);
+		}
+	}
+};
+
+static BenchResult UdpRate(const BenchConfig &config, u32 payload_size, u32 batch_size){
+	BenchResult result;
+	result.Name = "udp_rate";
+	result.PayloadSize = Max<u32>(Min(payload_size, Udp::MaxDatagramSize), 1);
+	result.BatchSize = Min(batch_size, UdpSender::MaxBatchSize);
+	result.Threads = config.Threads;
+	result.Connections = config.Threads;
+
+	std::atomic<bool> is_stopped{false};
+	List<UdpSender> senders;
+	List<UniquePtr<UdpReceiver>> receivers;
+	senders.Resize(config.Threads);
+
+	for(u32 i = 0; i<config.Threads; i++){
+		receivers.Add(new UdpReceiver());
+		senders[i].DestinationPort = BindUdp(receivers[i]->Socket);
+		if(!senders[i].DestinationPort)
+			return result;
+		senders[i].IsStopped = &is_stopped;
+		senders[i].BatchSize = result.BatchSize;
+		senders[i].Payload.Resize(result.PayloadSize);
+	}
+
+	List<std::thread> receiving, sending;
+	for(u32 i = 0; i<config.Threads; i++)
+		receiving.Emplace(&UdpReceiver::Run, receivers[i].Get());
+
+	const BenchClock::time_point start = BenchClock::now();
+	for(u32 i = 0; i<config.Threads; i++)
+		sending.Emplace(&UdpSender::Run, &senders[i]);
+
+	SleepFor(config.DurationMs);
+	is_stopped = true;
+	for(std::thread &thread: sending)
+		thread.join();
+	result.Seconds = SecondsSince(start);
+
+	// end markers may be dropped while receive buffers are still full, so they are repeated
+	UdpSocket control;
+	for(bool is_done = false; !is_done; SleepFor(1)){
+		is_done = true;
+		for(u32 i = 0; i<config.Threads; i++){
+			if(receivers[i]->IsDone)
+				continue;
+			is_done = false;
+			control.Send(nullptr, 0, IpAddress::Loopback, senders[i].DestinationPort);
+		}
+	}
+	for(std::thread &thread: receiving)
+		thread.join();
+
+	u64 sent = 0;
+	for(u32 i = 0; i<config.Threads; i++){
+		sent += senders[i].Sent;
+		result.Operations += receivers[i]->Received;
+	}
+	result.Bytes = result.Operations * result.PayloadSize;
+	result.Dropped = s64(sent - result.Operations);
+	return result;
+}
+
+struct AcceptServer{
+	TcpListener *Listener = nullptr;
+	// set once every client has exited, so no client is left waiting for its connection to be accepted
+	const std::atomic<bool> *IsClientsExited = nullptr;
+	u64 Accepted = 0;
+
+	// the listener is non-blocking, so the server doesn't get stuck in Accept after the last client is gone
+	void Run(){
+		for(;;){
+			TcpSocket socket = Listener->Accept();
+			if(socket.IsConnected()){
+				Accepted++;
+				// closed here, so the server side keeps TIME_WAIT and clients don't run out of ephemeral ports
+				continue;
+			}
+			if(IsClientsExited->load(std::memory_order_acquire))
+				break;
+			std::this_thread::yield();
+		}
+	}
+};
+
+struct AcceptClient{
+	u16 Port = 0;
+	const std::atomic<bool> *IsStopped = nullptr;
+	List<u32> Samples;
+
+	void Run(){
+		while(!IsStopped->load(std::memory_order_relaxed)){
+			const BenchClock::time_point start = BenchClock::now();
+
+			TcpSocket socket;
+			if(!socket.Connect(IpAddress::Loopback, Port))
+				break;
+			Samples.Add(NanosecondsSince(start));
+
+			// waits for the server to close
+			u8 byte;
+			(void)socket.Receive(&byte, 1);
+		}
+	}
+};
+
+static BenchResult TcpAccept(const BenchConfig &config){
+	BenchResult result;
+	result.Name = "tcp_accept";
+	result.Threads = config.Threads;
+
+	TcpListener listener;
+	const u16 port = BindListener(listener);
+	if(!port)
+		return result;
+
+	listener.SetBlocking(false);
+
+	std::atomic<bool> is_stopped{false};
+	std::atomic<bool> is_clients_exited{false};
+	AcceptServer server;
+	server.Listener = &listener;
+	server.IsClientsExited = &is_clients_exited;
+
+	List<AcceptClient> clients;
+	clients.Resize(config.Threads);
+	for(AcceptClient &client: clients){
+		client.Port = port;
+		client.IsStopped = &is_stopped;
+	}
+
+	const BenchClock::time_point start = BenchClock::now();
+	std::thread accepting(&AcceptServer::Run, &server);
+	List<std::thread> connecting;
+	for(AcceptClient &client: clients)
+		connecting.Emplace(&AcceptClient::Run, &client);
+
+	// clients stop first and the server keeps accepting and closing, a client in the backlog
+	// waits for its connection to be closed by the server before it can see the stop
+	SleepFor(config.DurationMs);
+	is_stopped = true;
+	for(std::thread &thread: connecting)
+		thread.join();
+	result.Seconds = SecondsSince(start);
+
+	is_clients_exited.store(true, std::memory_order_release);
+	accepting.join();
+
+	List<List<u32>> samples;
+	for(AcceptClient &client: clients)
+		samples.Add(Move(client.Samples));
+
+	result.Operations = server.Accepted;
+	result.Connections = (u32)Min<u64>(server.Accepted, 0xFFFFFFFF);
+	ComputeLatency(result, samples);
+	return result;
+}
+
+struct FanInServer;
+
+struct FanInConnection{
+	TcpSocket Socket;
+	FanInServer *Server = nullptr;
+
+	void OnEvent(u32 events);
+};
+
+struct FanInServer{
+	EventLoop Loop;
+	List<u8> Buffer;
+	std::atomic<u64> Bytes{0};
+	u32 OpenConnections = 0;
+
+	void Run(){
+		while(OpenConnections && Loop.RunOnce(Milliseconds(10))){}
+	}
+};
+
+void FanInConnection::OnEvent(u32 events){
+	// edge-triggered, so everything is read until it would block
+	for(;;){
+		const u32 received = Socket.ReceiveSome(Server->Buffer.Data(), Server->Buffer.Size());
+		if(!received)
+			break;
+		Server->Bytes.fetch_add(received, std::memory_order_relaxed);
+	}
+
+	if((events & IoEvent::Closed) || !Socket.IsConnected()){
+		Server->Loop.Unwatch(Socket);
+		Socket.Disconnect();
+		Server->OpenConnections--;
+	}
+}
+
+struct FanInClient{
+	List<TcpSocket> Sockets;
+	const std::atomic<bool> *IsStopped = nullptr;
+	List<u8> Payload;
+
+	void Run(){
+		while(!IsStopped->load(std::memory_order_relaxed)){
+			for(TcpSocket &socket: Sockets)
+				(void)socket.Send(Payload.Data(), Payload.Size());
+		}
+		for(TcpSocket &socket: Sockets)
+			socket.Disconnect();
+	}
+};
+
+static BenchResult TcpFanIn(const BenchConfig &config, u32 payload_size){
+	BenchResult result;
+	result.Name = "tcp_fan_in";
+	result.PayloadSize = payload_size;
+	result.Threads = config.Threads;
+	result.Connections = config.Connections;
+
+	TcpListener listener;
+	const u16 port = BindListener(listener);
+	if(!port)
+		return result;
+
+	FanInServer server;
+	server.Buffer.Resize(256 * 1024);
+
+	std::atomic<bool> is_stopped{false};
+	List<FanInClient> clients;
+	clients.Resize(config.Threads);
+	for(FanInClient &client: clients){
+		client.IsStopped = &is_stopped;
+		client.Payload.Resize(payload_size);
+	}
+
+	// stable addresses for the callbacks
+	List<FanInConnection> connections;
+	connections.Resize(config.Connections);
+
+	for(u32 i = 0; i<config.Connections; i++){
+		TcpSocket socket;
+		if(!socket.Connect(IpAddress::Loopback, port))
+			return result;
+		clients[i % config.Threads].Sockets.Add(Move(socket));
+
+		connections[i].Socket = listener.Accept();
+		connections[i].Server = &server;
+		server.Loop.Watch(connections[i].Socket, IoEvent::Readable, EventLoop::IoCallback(&connections[i], &FanInConnection::OnEvent));
+		server.OpenConnections++;
+	}
+
+	const BenchClock::time_point start = BenchClock::now();
+	std::thread receiving(&FanInServer::Run, &server);
+	List<std::thread> sending;
+	for(FanInClient &client: clients)
+		sending.Emplace(&FanInClient::Run, &client);
+
+	SleepFor(config.DurationMs);
+	result.Bytes = server.Bytes.load();
+	result.Seconds = SecondsSince(start);
+
+	is_stopped = true;
+	for(std::thread &thread: sending)
+		thread.join();
+	receiving.join();
+
+	result.Operations = result.Bytes / payload_size;
+	return result;
+}
+
+static void PrintResult(const BenchResult &result, bool is_last){
+	Print("    {\"name\": \"%\", \"payload_size\": %, \"threads\": %, \"connections\": %, \"seconds\": %, ",
+		result.Name, result.PayloadSize, result.Threads, result.Connections, result.Seconds);
+	Print("\"operations\": %, \"operations_per_second\": %, \"bytes_per_second\": %",
+		result.Operations, result.Seconds > 0 ? result.Operations / result.Seconds : 0.0, result.Seconds > 0 ? result.Bytes / result.Seconds : 0.0);
+	if(result.BatchSize)
+		Print(", \"batch_size\": %", result.BatchSize);
+	if(result.Dropped >= 0)
+		Print(", \"dropped\": %", result.Dropped);
+	if(result.HasLatency)
+		Print(", \"latency_us\": {\"p50\": %, \"p99\": %, \"p999\": %}", result.P50, result.P99, result.P999);
+	Println("}%", is_last ? "" : ",");
+}
+
+static void Report(List<BenchResult> &results, const BenchResult &result){
+	if(!result.Seconds)
+		Errorln("%, % B: failed to set up loopback sockets", result.Name, result.PayloadSize);
+	else if(result.BatchSize)
+		Errorln("%, % B, batch %: % ops/s, % MB/s", result.Name, result.PayloadSize, result.BatchSize, result.Operations / result.Seconds, result.Bytes / result.Seconds / 1000000.0);
+	else if(result.HasLatency)
+		Errorln("%, % B: % ops/s, p50 % us, p99 % us, p999 % us", result.Name, result.PayloadSize, result.Operations / result.Seconds, result.P50, result.P99, result.P999);
+	else
+		Errorln("%, % B: % ops/s, % MB/s", result.Name, result.PayloadSize, result.Operations / result.Seconds, result.Bytes / result.Seconds / 1000000.0);
+
+	results.Add(result);
+}
+
+static bool ParseSizes(const char *argument, List<u32> &sizes){
+	sizes.Clear();
+	while(*argument){
+		char *end = nullptr;
+		const unsigned long size = strtoul(argument, &end, 10);
+		if(end == argument || !size || (*end && *end != ','))
+			return false;
+		sizes.Add((u32)size);
+		argument = *end ? end + 1 : end;
+	}
+	return sizes.Size() != 0;
+}
+
+static bool ParseNumber(const char *argument, u32 &number){
+	char *end = nullptr;
+	const unsigned long value = strtoul(argument, &end, 10);
+	if(end == argument || *end || !value)
+		return false;
+	number = (u32)value;
+	return true;
+}
+
+int main(int argc, char **argv){
+	BenchConfig config;
+	config.PayloadSizes = {64, 1024, 65536};
+	config.UdpBatchSizes = {1, 8, 32, 64};
+
+	for(int i = 1; i<argc; i++){
+		const StringView option = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		bool is_valid = value != nullptr;
+		if(is_valid && option == StringView("--payload-sizes"))
+			is_valid = ParseSizes(value, config.PayloadSizes);
+		else if(is_valid && option == StringView("--udp-batch-sizes"))
+			is_valid = ParseSizes(value, config.UdpBatchSizes);
+		else if(is_valid && option == StringView("--threads"))
+			is_valid = ParseNumber(value, config.Threads);
+		else if(is_valid && option == StringView("--connections"))
+			is_valid = ParseNumber(value, config.Connections);
+		else if(is_valid && option == StringView("--duration-ms"))
+			is_valid = ParseNumber(value, config.DurationMs);
+		else
+			is_valid = false;
+
+		if(!is_valid)
+			return Errorln("Usage: StraitXNetBench [--payload-sizes 64,1024,65536] [--udp-batch-sizes 1,8,32,64] [--threads 4] [--connections 256] [--duration-ms 1000]");
+		i++;
+	}
+	config.Connections = Max(config.Connections, config.Threads);
+
+	List<BenchResult> results;
+	for(u32 size: config.PayloadSizes){
+		Report(results, TcpStream(config, size));
+		Report(results, TcpRtt(config, size));
+		for(u32 batch_size: config.UdpBatchSizes)
+			Report(results, UdpRate(config, size, batch_size));
+		Report(results, TcpFanIn(config, size));
+	}
+	Report(results, TcpAccept(config));
+
+	Println("{");
+	Println("  \"benchmark\": \"StraitXNetBench\",");
+	Print("  \"config\": {\"payload_sizes\": [");
+	for(size_t i = 0; i<config.PayloadSizes.Size(); i++)
+		Print("%%", i ? ", " : "", config.PayloadSizes[i]);
+	Print("], \"udp_batch_sizes\": [");
+	for(size_t i = 0; i<config.UdpBatchSizes.Size(); i++)
+		Print("%%", i ? ", " : "", config.UdpBatchSizes[i]);
+	Println("], \"threads\": %, \"connections\": %, \"duration_ms\": %},", config.Threads, config.Connections, config.DurationMs);
+	Println("  \"results\": [");
+	for(size_t i = 0; i<results.Size(); i++)
+		PrintResult(results[i], i + 1 == results.Size());
+	Println("  ]");
+	Println("}");
+}
@@ -0,0 +1,122 @@
+#include <sys/stat.h>
+#include "core/list.hpp"
+#include "core/string.hpp"
+#include "core/format.hpp"
+#include "core/os/file.hpp"
+#include "core/os/directory.hpp"
+#include "core/vfs/pack.hpp"
+#include "bench.hpp"
+
+// 100K small assets from 256 bytes to 4 KB are read in random order as loose files, one open and read
+// per file, and from packs of the same files, uncompressed and LZ compressed, found by path in the
+// table of contents. Everything is freshly written and in page cache, so this measures per file
+// overhead of the file system against a lookup in a mapping
+
+static const char *s_Root = "sx_pack_bench";
+static const char *s_Pack = "sx_pack_bench.sxpk";
+static const char *s_CompressedPack = "sx_pack_bench_lz.sxpk";
+
+static constexpr u32 DirectoriesCount = 100;
+static constexpr u32 FilesPerDirectory = 1000;
+static constexpr u32 FilesCount = DirectoriesCount * FilesPerDirectory;
+
+static u32 s_RandomState = 0x2545F491;
+
+static u32 RandomIndex(u32 count){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return s_RandomState % count;
+}
+
+static String PathOf(u32 index){
+    return Format("%/%/asset_%.txt", s_Root, index / FilesPerDirectory, index);
+}
+
+// text of words from a small dictionary, compresses like typical configs and shaders
+static String Content(){
+    static const char *const s_Words[] = {"float ", "vec3 ", "position", " = ", "normal", "texture(", "uniform ", ");\n", "0.5", "material."};
+    String content;
+    const u32 size = 256 + RandomIndex(4096 - 256);
+    while(content.Size() < size)
+        content.Append(StringView(s_Words[RandomIndex(10)]));
+    return content;
+}
+
+static void Build(const List<String> &paths){
+    mkdir(s_Root, 0755);
+    for(u32 i = 0; i<DirectoriesCount; i++)
+        mkdir(Format("%/%", s_Root, i).Data(), 0755);
+
+    PackWriter pack, compressed_pack;
+    (void)pack.Open(s_Pack);
+    (void)compressed_pack.Open(s_CompressedPack);
+
+    u64 size = 0;
+    for(const String &path: paths){
+        const String content = Content();
+        const ConstSpan<u8> bytes((const u8*)content.Data(), content.Size());
+        size += content.Size();
+
+        File::WriteEntire(path, content);
+        (void)pack.Add(path, bytes);
+        (void)compressed_pack.Add(path, bytes, PackCompression::Lz);
+    }
+    (void)pack.Finish();
+    (void)compressed_pack.Finish();
+
+    Println("% files, % MB, pack % MB, compressed pack % MB", paths.Size(), size / (1024 * 1024),
+        File(s_Pack, File::Mode::Read, false).Size() / (1024 * 1024), File(s_CompressedPack, File::Mode::Read, false).Size() / (1024 * 1024));
+}
+
+static void ReadPack(const char *name, const char *filename, const List<String> &order){
+    u64 bytes = 0;
+    const Time time = Bench::Measure([&](){
+        PackArchive archive;
+        (void)archive.Open(filename);
+        List<u8> storage;
+        bytes = 0;
+        for(const String &path: order){
+            const PackEntry *entry = archive.Find(path);
+            if(!entry)
+                continue;
+            const Optional<ConstSpan<u8>> content = archive.Read(*entry, storage);
+            if(content.HasValue())
+                bytes += content.Value().Size();
+        }
+    }, 3);
+    Println("%: % ms, % files/s, % MB/s", name, time.AsMicroseconds() / 1000.0, Bench::PerSecond(order.Size(), time), Bench::PerSecond(double(bytes) / (1024 * 1024), time));
+}
+
+int main(){
+    List<String> paths;
+    for(u32 i = 0; i<FilesCount; i++)
+        paths.Add(PathOf(i));
+    Build(paths);
+
+    // shuffled, so neither side gets sequential locality from the order files were written in
+    List<String> order;
+    for(const String &path: paths)
+        order.Add(path);
+    for(u32 i = FilesCount - 1; i>0; i--)
+        Swap(order[i], order[RandomIndex(i + 1)]);
+
+    u64 bytes = 0;
+    const Time time = Bench::Measure([&](){
+        List<u8> storage;
+        bytes = 0;
+        for(const String &path: order){
+            File file(path, File::Mode::Read, false);
+            storage.Resize(file.Size());
+            bytes += file.Read(storage.Data(), storage.Size());
+        }
+    }, 3);
+    Println("loose files: % ms, % files/s, % MB/s", time.AsMicroseconds() / 1000.0, Bench::PerSecond(FilesCount, time), Bench::PerSecond(double(bytes) / (1024 * 1024), time));
+
+    ReadPack("pack", s_Pack, order);
+    ReadPack("LZ compressed pack", s_CompressedPack, order);
+
+    File::Delete(s_Pack);
+    File::Delete(s_CompressedPack);
+    Directory::Delete(s_Root);
+}
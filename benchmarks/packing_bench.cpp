@@ -0,0 +1,223 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/packing.hpp"
+#include "core/math/simd.hpp"
+#include "bench.hpp"
+
+// Batch conversions over 4M values, throughput counts bytes read plus bytes written. Scalar loops
+// are measured next to half float batches, which go through F16C or NEON with SX_SIMD_HALF.
+// Errors are max and mean over the same data, in the units each encoding is documented in
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector3f RandomNormal(){
+    Vector3f normal;
+    do{
+        normal = Vector3f(Random(), Random(), Random());
+    }while(normal.Length() < 0.1f);
+    return normal / normal.Length();
+}
+
+template<typename FunctionType>
+static void Throughput(const char *name, size_t count, size_t element_size, FunctionType function){
+    const Time time = Bench::Measure(function);
+    Println("%: % GB/s, % values/s", name, Bench::PerSecond(double(count) * element_size, time) / 1e9, Bench::PerSecond(count, time));
+}
+
+struct ErrorStatistics{
+    double MaxError = 0.0;
+    double SumError = 0.0;
+    size_t Count = 0;
+
+    void Add(double error){
+        MaxError = Max(MaxError, error);
+        SumError += error;
+        Count++;
+    }
+
+    void Print(const char *name, const char *unit)const{
+        Println("%: max % %, mean % %", name, MaxError, unit, SumError / double(Count), unit);
+    }
+};
+
+static double Degrees(const Vector3f &left, const Vector3f &right){
+    const double cos = double(left.x) * right.x + double(left.y) * right.y + double(left.z) * right.z;
+    return std::acos(Min(cos / (double(left.Length()) * right.Length()), 1.0)) * 180.0 / 3.14159265358979324;
+}
+
+static double Degrees(const Quaternionf &left, const Quaternionf &right){
+    const double cos = std::fabs(double(left.x) * right.x + double(left.y) * right.y + double(left.z) * right.z + double(left.w) * right.w);
+    return 2.0 * std::acos(Min(cos, 1.0)) * 180.0 / 3.14159265358979324;
+}
+
+static void Half(size_t count){
+    List<float> values, unpacked;
+    List<u16> packed;
+    for(size_t i = 0; i<count; i++)
+        values.Add(Random() * 1000.f);
+    packed.Resize(count);
+    unpacked.Resize(count);
+
+#if defined(SX_SIMD_HALF)
+    Println("half float batches: hardware conversions");
+#else
+    Println("half float batches: software conversions");
+#endif
+    Throughput("FloatToHalf, scalar", count, sizeof(float) + sizeof(u16), [&](){
+        for(size_t i = 0; i<count; i++)
+            packed[i] = Math::FloatToHalf(values[i]);
+    });
+    Throughput("FloatToHalf, batch", count, sizeof(float) + sizeof(u16), [&](){
+        Math::FloatToHalf(values, packed);
+    });
+    Throughput("HalfToFloat, scalar", count, sizeof(float) + sizeof(u16), [&](){
+        for(size_t i = 0; i<count; i++)
+            unpacked[i] = Math::HalfToFloat(packed[i]);
+    });
+    Throughput("HalfToFloat, batch", count, sizeof(float) + sizeof(u16), [&](){
+        Math::HalfToFloat(packed, unpacked);
+    });
+
+    // relative error is bounded by 2^-11 for normal halves
+    ErrorStatistics error;
+    for(size_t i = 0; i<count; i++){
+        if(std::fabs(values[i]) >= 0x1p-14f)
+            error.Add(std::fabs(double(unpacked[i]) - values[i]) / std::fabs(values[i]) * 2048.0);
+    }
+    error.Print("half float error", "units of 2^-11 relative");
+    Bench::DoNotOptimize(unpacked[count - 1]);
+}
+
+template<typename IntegerType, typename PackType, typename UnpackType>
+static void Normalized(const char *name, size_t count, PackType pack, UnpackType unpack){
+    constexpr bool IsSigned = std::numeric_limits<IntegerType>::is_signed;
+    List<float> values, unpacked;
+    List<IntegerType> packed;
+    for(size_t i = 0; i<count; i++)
+        values.Add(IsSigned ? Random() : (Random() + 1.f) * 0.5f);
+    packed.Resize(count);
+    unpacked.Resize(count);
+
+    Println("%", name);
+    Throughput("  pack", count, sizeof(float) + sizeof(IntegerType), [&](){
+        pack(values, packed);
+    });
+    Throughput("  unpack", count, sizeof(float) + sizeof(IntegerType), [&](){
+        unpack(packed, unpacked);
+    });
+
+    ErrorStatistics error;
+    for(size_t i = 0; i<count; i++)
+        error.Add(std::fabs(double(unpacked[i]) - values[i]) * std::numeric_limits<IntegerType>::max());
+    error.Print("  error", "steps");
+    Bench::DoNotOptimize(unpacked[count - 1]);
+}
+
+template<typename PackedType, typename PackType, typename UnpackType>
+static void Octahedral(const char *name, size_t count, PackType pack, UnpackType unpack){
+    List<Vector3f> normals, unpacked;
+    List<PackedType> packed;
+    for(size_t i = 0; i<count; i++)
+        normals.Add(RandomNormal());
+    packed.Resize(count);
+    unpacked.Resize(count);
+
+    Println("%", name);
+    Throughput("  pack", count, sizeof(Vector3f) + sizeof(PackedType), [&](){
+        pack(normals, packed);
+    });
+    Throughput("  unpack", count, sizeof(Vector3f) + sizeof(PackedType), [&](){
+        unpack(packed, unpacked);
+    });
+
+    ErrorStatistics error;
+    for(size_t i = 0; i<count; i++)
+        error.Add(Degrees(normals[i], unpacked[i]));
+    error.Print("  error", "degrees");
+    Bench::DoNotOptimize(unpacked[count - 1]);
+}
+
+static void Rotations(size_t count){
+    List<Quaternionf> rotations, unpacked;
+    List<u32> packed;
+    for(size_t i = 0; i<count; i++)
+        rotations.Add(Quaternionf(Random(), Random(), Random(), Random()).GetNormalized());
+    packed.Resize(count);
+    unpacked.Resize(count);
+
+    Println("smallest three quaternions");
+    Throughput("  pack", count, sizeof(Quaternionf) + sizeof(u32), [&](){
+        Math::PackQuaternion(rotations, packed);
+    });
+    Throughput("  unpack", count, sizeof(Quaternionf) + sizeof(u32), [&](){
+        Math::UnpackQuaternion(packed, unpacked);
+    });
+
+    ErrorStatistics error;
+    for(size_t i = 0; i<count; i++)
+        error.Add(Degrees(rotations[i], unpacked[i]));
+    error.Print("  error", "degrees");
+    Bench::DoNotOptimize(unpacked[count - 1]);
+}
+
+static void Positions(size_t count){
+    const AABB3f bounds({-500.f, -20.f, -500.f}, {1000.f, 100.f, 1000.f});
+    List<Vector3f> positions, unpacked;
+    List<Vector3<u16>> packed;
+    for(size_t i = 0; i<count; i++)
+        positions.Add(bounds.Center() + Vector3f(Random(), Random(), Random()) * bounds.Size() * 0.5f);
+    packed.Resize(count);
+    unpacked.Resize(count);
+
+    Println("positions against AABB3");
+    Throughput("  quantize", count, sizeof(Vector3f) + sizeof(Vector3<u16>), [&](){
+        Math::QuantizePosition(positions, bounds, packed);
+    });
+    Throughput("  dequantize", count, sizeof(Vector3f) + sizeof(Vector3<u16>), [&](){
+        Math::DequantizePosition(packed, bounds, unpacked);
+    });
+
+    // in steps of the widest axis, half a step is the bound
+    const double step = double(bounds.Size().x) / 65535.0;
+    ErrorStatistics error;
+    for(size_t i = 0; i<count; i++)
+        error.Add(std::fabs(double(unpacked[i].x) - positions[i].x) / step);
+    error.Print("  error", "steps");
+    Bench::DoNotOptimize(unpacked[count - 1]);
+}
+
+int main(){
+    constexpr size_t Count = 4 * 1024 * 1024;
+
+    Half(Count);
+
+    Normalized<u8>("unorm8", Count,
+        [](ConstSpan<float> values, Span<u8> result){ Math::PackUnorm8(values, result); },
+        [](ConstSpan<u8> values, Span<float> result){ Math::UnpackUnorm8(values, result); });
+    Normalized<s8>("snorm8", Count,
+        [](ConstSpan<float> values, Span<s8> result){ Math::PackSnorm8(values, result); },
+        [](ConstSpan<s8> values, Span<float> result){ Math::UnpackSnorm8(values, result); });
+    Normalized<u16>("unorm16", Count,
+        [](ConstSpan<float> values, Span<u16> result){ Math::PackUnorm16(values, result); },
+        [](ConstSpan<u16> values, Span<float> result){ Math::UnpackUnorm16(values, result); });
+    Normalized<s16>("snorm16", Count,
+        [](ConstSpan<float> values, Span<s16> result){ Math::PackSnorm16(values, result); },
+        [](ConstSpan<s16> values, Span<float> result){ Math::UnpackSnorm16(values, result); });
+
+    Octahedral<u16>("octahedral normals, 8 bit", Count,
+        [](ConstSpan<Vector3f> normals, Span<u16> result){ Math::PackOctahedral8(normals, result); },
+        [](ConstSpan<u16> packed, Span<Vector3f> result){ Math::UnpackOctahedral8(packed, result); });
+    Octahedral<u32>("octahedral normals, 16 bit", Count,
+        [](ConstSpan<Vector3f> normals, Span<u32> result){ Math::PackOctahedral16(normals, result); },
+        [](ConstSpan<u32> packed, Span<Vector3f> result){ Math::UnpackOctahedral16(packed, result); });
+
+    Rotations(Count);
+    Positions(Count);
+}
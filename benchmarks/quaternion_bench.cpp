@@ -0,0 +1,96 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/quaternion.hpp"
+#include "core/math/transform.hpp"
+#include "bench.hpp"
+
+// Batch slerp against scalar Slerp over 1M pairs, and composition of 1M rotation pairs
+// through quaternions against Matrix4f products. Drift is how far 100K accumulated
+// small rotations are from a rotation: unit length for quaternions, orthonormality for matrices
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Quaternionf RandomRotation(){
+    return Quaternionf(Random(), Random(), Random(), Random()).GetNormalized();
+}
+
+// largest deviation of the upper 3x3 times its transpose from identity
+static float Orthonormality(const Matrix4f &matrix){
+    float error = 0;
+    for(size_t i = 0; i<3; i++){
+        for(size_t j = 0; j<3; j++){
+            const float dot = matrix[i][0] * matrix[j][0] + matrix[i][1] * matrix[j][1] + matrix[i][2] * matrix[j][2];
+            error = Max(error, std::fabs(dot - (i == j ? 1.f : 0.f)));
+        }
+    }
+    return error;
+}
+
+int main(){
+    constexpr size_t Count = 1000000;
+
+    List<Quaternionf> left, right, quaternions;
+    List<Matrix4f> left_matrices, right_matrices, matrices;
+    for(size_t i = 0; i<Count; i++){
+        left.Add(RandomRotation());
+        right.Add(RandomRotation());
+        left_matrices.Add(left[i].ToMatrix());
+        right_matrices.Add(right[i].ToMatrix());
+    }
+    quaternions.Resize(Count);
+    matrices.Resize(Count);
+
+    Bench::Report("slerp, scalar", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            quaternions[i] = Math::Slerp(left[i], right[i], 0.3f);
+    }), Count, "quaternions");
+    Bench::Report("slerp, batch", Bench::Measure([&](){
+        Math::Slerp({left.Data(), Count}, {right.Data(), Count}, 0.3f, {quaternions.Data(), Count});
+    }), Count, "quaternions");
+
+    Bench::Report("compose, Quaternionf", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            quaternions[i] = left[i] * right[i];
+    }), Count, "rotations");
+    Bench::Report("compose, Matrix4f", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            matrices[i] = left_matrices[i] * right_matrices[i];
+    }), Count, "rotations");
+
+    // building a rotation from Euler angles, Math::Rotate multiplies three axis matrices
+    Bench::Report("from angles, Quaternionf", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++){
+            const float angle = i * 1e-6f;
+            quaternions[i] = Quaternionf::FromAxisAngle({1, 0, 0}, angle)
+                           * Quaternionf::FromAxisAngle({0, 1, 0}, -angle)
+                           * Quaternionf::FromAxisAngle({0, 0, 1}, angle);
+        }
+    }), Count, "rotations");
+    Bench::Report("from angles, Math::Rotate", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++){
+            const float angle = i * 1e-6f;
+            matrices[i] = Math::Rotate<float>(Vector3f(angle, angle, angle));
+        }
+    }), Count, "rotations");
+
+    constexpr size_t Steps = 100000;
+    const Quaternionf step = Quaternionf::FromAxisAngle(Vector3f(1, 2, 3) / Vector3f(1, 2, 3).Length(), 0.001f);
+    const Matrix4f step_matrix = step.ToMatrix();
+    Quaternionf accumulated;
+    Matrix4f accumulated_matrix;
+    for(size_t i = 0; i<Steps; i++){
+        accumulated = step * accumulated;
+        accumulated_matrix = step_matrix * accumulated_matrix;
+    }
+    Println("drift after % steps: quaternion %, matrix %", Steps, std::fabs(accumulated.Length() - 1.f), Orthonormality(accumulated_matrix));
+
+    Bench::DoNotOptimize(quaternions[Count - 1]);
+    Bench::DoNotOptimize(matrices[Count - 1]);
+}
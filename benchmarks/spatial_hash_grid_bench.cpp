@@ -0,0 +1,92 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/spatial_hash_grid.hpp"
+#include "bench.hpp"
+
+// A 2D world at constant density, about one entity of 1 to 3 units per 16 square units, so pairs
+// per entity stay the same at every size. A tick moves every entity a bit and then finds all pairs.
+// Brute force tests every pair with AABB2::Intersects. At 500K only a slice of rows is measured
+// and the full pass is extrapolated from it, as the whole of it takes minutes
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+// pairs of the rows from begin to end against all the rows after them
+static size_t BruteForcePairs(const List<AABB2f> &boxes, size_t begin, size_t end){
+    size_t pairs = 0;
+    for(size_t i = begin; i<end; i++){
+        for(size_t j = i + 1; j<boxes.Size(); j++)
+            pairs += boxes[i].Intersects(boxes[j]);
+    }
+    return pairs;
+}
+
+static void Run(size_t count){
+    const float extent = std::sqrt(count * 16.f);
+
+    List<AABB2f> boxes;
+    List<Vector2f> velocities;
+    for(size_t i = 0; i<count; i++){
+        boxes.Add(AABB2f({(Random() + 1.f) * 0.5f * extent, (Random() + 1.f) * 0.5f * extent}, {Random() + 2.f, Random() + 2.f}));
+        velocities.Add({Random() * 0.2f, Random() * 0.2f});
+    }
+
+    SpatialHashGrid2D grid(4.f);
+    List<u32> handles;
+    const Time insert = Bench::Measure([&](){
+        grid.Clear();
+        handles.Clear();
+        for(const AABB2f &box: boxes)
+            handles.Add(grid.Insert(box));
+    }, 1);
+    Println("%: insert % ms, % cells", count, insert.AsMicroseconds() / 1000.0, grid.CellsCount());
+
+    const Time update = Bench::Measure([&](){
+        for(size_t i = 0; i<count; i++){
+            boxes[i].Min += velocities[i];
+            boxes[i].Max += velocities[i];
+            grid.Update(handles[i], boxes[i]);
+        }
+    });
+    Println("%: update % ms, % entities/s", count, update.AsMicroseconds() / 1000.0, Bench::PerSecond(count, update));
+
+    List<Pair<u32, u32>> pairs;
+    const Time find_pairs = Bench::Measure([&](){
+        pairs.Clear();
+        grid.FindPairs(pairs);
+    });
+    Println("%: FindPairs % ms, % pairs", count, find_pairs.AsMicroseconds() / 1000.0, pairs.Size());
+
+    // a slice of rows taken evenly from the whole triangle has the average amount of work per row
+    const size_t rows = count <= 50000 ? count : 10000;
+    size_t brute_force_pairs = 0;
+    const Time brute_force = Bench::Measure([&](){
+        brute_force_pairs = 0;
+        for(size_t block = 0; block<count; block += count / rows * 100)
+            brute_force_pairs += BruteForcePairs(boxes, block, Min(block + 100, count));
+    }, 1);
+    if(rows == count){
+        Println("%: brute force % ms, % pairs", count, brute_force.AsMicroseconds() / 1000.0, brute_force_pairs);
+    }else{
+        // measured rows are scaled up to the count of pair tests of the whole triangle
+        const double measured_tests = double(rows) * count / 2.0;
+        const double total_tests = double(count) * (count - 1) / 2.0;
+        Println("%: brute force % ms, extrapolated from % rows", count, brute_force.AsMicroseconds() / 1000.0 * total_tests / measured_tests, rows);
+    }
+
+    Println("%: tick, update and FindPairs, % ms", count, (update + find_pairs).AsMicroseconds() / 1000.0);
+
+    Bench::DoNotOptimize(brute_force_pairs);
+}
+
+int main(){
+    Run(1000);
+    Run(50000);
+    Run(500000);
+}
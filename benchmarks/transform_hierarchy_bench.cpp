@@ -0,0 +1,134 @@
+#include "core/list.hpp"
+#include "core/math/transform.hpp"
+#include "core/math/transform_hierarchy.hpp"
+#include "core/os/thread_pool.hpp"
+#include "bench.hpp"
+
+// A 100K node scene of 1000 objects, 5 percent of them move every frame. Frames are measured with
+// edits included, against moving every object, which recomputes the whole scene, and against
+// walking the parent chain of every node, which is what the scene did before
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static u32 RandomIndex(size_t count){
+    return u32((Random() + 1.f) * 0.5f * count) % u32(count);
+}
+
+static Vector3f RandomVector(){
+    return {Random(), Random(), Random()};
+}
+
+static Quaternionf RandomRotation(){
+    return Quaternionf(Random(), Random(), Random(), Random()).GetNormalized();
+}
+
+// what the scene did before, every node every frame
+static void WalkParentChains(const TransformHierarchy &hierarchy, const List<u32> &handles, List<Matrix4f> &worlds){
+    for(size_t i = 0; i<handles.Size(); i++){
+        Matrix4f world = Matrix4f(1.f);
+        for(u32 node = handles[i]; node != TransformHierarchy::InvalidHandle; node = hierarchy.Parent(node))
+            world = Math::Translate(hierarchy.Position(node)) * hierarchy.Rotation(node).ToMatrix() * Math::Scale(hierarchy.Scale(node)) * world;
+        worlds[i] = world;
+    }
+}
+
+// edits of a frame go before its Update, both are measured
+template<typename UpdateType>
+static void Frames(const char *name, TransformHierarchy &hierarchy, const List<u32> &moved, const List<Vector3f> &positions, u32 frames, UpdateType update){
+    const size_t moved_per_frame = moved.Size() / frames;
+
+    const Time time = Bench::Measure([&](){
+        for(u32 frame = 0; frame<frames; frame++){
+            for(size_t i = frame * moved_per_frame; i<(frame + 1) * moved_per_frame; i++)
+                hierarchy.SetPosition(moved[i], positions[i]);
+            update();
+        }
+    });
+    Println("%: % ms/frame, % scene nodes/s", name, time.AsMicroseconds() / 1000.0 / frames, Bench::PerSecond(double(hierarchy.Size()) * frames, time));
+}
+
+// nodes with a moved ancestor or moved themselves, the ones a frame recomputes
+static size_t RecomputedCount(const TransformHierarchy &hierarchy, const List<u32> &handles, const List<u32> &moved, size_t count){
+    List<u8> is_moved;
+    is_moved.Resize(handles.Size());
+    for(size_t i = 0; i<count; i++)
+        is_moved[moved[i]] = 1;
+
+    size_t recomputed = 0;
+    for(u32 handle: handles){
+        bool is_dirty = false;
+        for(u32 node = handle; node != TransformHierarchy::InvalidHandle && !is_dirty; node = hierarchy.Parent(node))
+            is_dirty = is_moved[node];
+        recomputed += is_dirty;
+    }
+    return recomputed;
+}
+
+int main(){
+    constexpr size_t Objects = 1000;
+    constexpr size_t ObjectSize = 100;
+    constexpr size_t Count = Objects * ObjectSize;
+    constexpr u32 FramesCount = 10;
+
+    // an object is a root with a random tree under it, about five levels deep
+    TransformHierarchy hierarchy;
+    List<u32> handles;
+    for(size_t object = 0; object<Objects; object++){
+        const u32 root = hierarchy.Create(RandomVector() * 100.f, RandomRotation(), Vector3f(1.f));
+        handles.Add(root);
+        for(size_t i = 1; i<ObjectSize; i++){
+            const u32 parent = handles[object * ObjectSize + RandomIndex(i)];
+            handles.Add(hierarchy.Create(RandomVector(), RandomRotation(), Vector3f(1.f), parent));
+        }
+    }
+    hierarchy.Update();
+
+    // 5 percent of objects move as a whole, or 5 percent of nodes anywhere in the scene move on their own
+    List<u32> moved_objects, moved_nodes;
+    List<Vector3f> positions;
+    for(u32 frame = 0; frame<FramesCount; frame++){
+        for(size_t i = 0; i<Objects / 20; i++)
+            moved_objects.Add(handles[RandomIndex(Objects) * ObjectSize]);
+    }
+    for(size_t i = 0; i<Count / 20 * FramesCount; i++){
+        moved_nodes.Add(handles[RandomIndex(Count)]);
+        positions.Add(RandomVector());
+    }
+    Println("recomputed per frame: % when 5 percent of objects move, % when 5 percent of nodes do",
+        RecomputedCount(hierarchy, handles, moved_objects, Objects / 20), RecomputedCount(hierarchy, handles, moved_nodes, Count / 20));
+
+    ThreadPool pool;
+    const auto update = [&](){ hierarchy.Update(); };
+    const auto update_parallel = [&](){ hierarchy.Update(pool); };
+
+    Frames("objects moved, Update", hierarchy, moved_objects, positions, FramesCount, update);
+    Frames("objects moved, Update ThreadPool", hierarchy, moved_objects, positions, FramesCount, update_parallel);
+    Frames("nodes moved, Update", hierarchy, moved_nodes, positions, FramesCount, update);
+    Frames("nodes moved, Update ThreadPool", hierarchy, moved_nodes, positions, FramesCount, update_parallel);
+
+    // every root moves, so the whole scene is recomputed
+    List<u32> roots;
+    for(u32 frame = 0; frame<FramesCount; frame++){
+        for(size_t i = 0; i<Objects; i++)
+            roots.Add(handles[i * ObjectSize]);
+    }
+    Frames("everything moved, Update", hierarchy, roots, positions, FramesCount, update);
+    Frames("everything moved, Update ThreadPool", hierarchy, roots, positions, FramesCount, update_parallel);
+
+    List<Matrix4f> worlds;
+    worlds.Resize(Count);
+    const Time time = Bench::Measure([&](){
+        WalkParentChains(hierarchy, handles, worlds);
+    });
+    Println("parent chain walk: % ms/frame, % scene nodes/s", time.AsMicroseconds() / 1000.0, Bench::PerSecond(Count, time));
+
+    Bench::DoNotOptimize(worlds[Count - 1]);
+    Bench::DoNotOptimize(hierarchy.WorldMatrices()[0]);
+}
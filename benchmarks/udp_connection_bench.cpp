@@ -0,0 +1,104 @@
+#include <cstring>
+#include <algorithm>
+#include "core/net/udp_connection.hpp"
+#include "bench.hpp"
+#include "../tests/lossy_link.hpp"
+
+// Two connections over a simulated link with delay, jitter and random loss, time is simulated as well.
+// Reports delivery latency percentiles and goodput of a reliable ordered stream at several loss rates,
+// with and without reordering jitter, messages out of send order, and how much wall clock time the connections spent on it
+
+struct LatencyRecorder{
+	const List<Time> *SendTimes = nullptr;
+	const Time *Now = nullptr;
+	List<s64> Latencies;
+	u64 Bytes = 0;
+	u32 NextIndex = 0;
+	u32 OutOfOrder = 0;
+
+	void OnMessage(UdpChannel, ConstSpan<u8> message){
+		u32 index = 0;
+		memcpy(&index, message.Pointer(), sizeof(index));
+
+		OutOfOrder += index != NextIndex++;
+		Latencies.Add((*Now - (*SendTimes)[index]).AsMicroseconds());
+		Bytes += message.Size();
+	}
+};
+
+static double Percentile(const List<s64> &sorted, double percentile){
+	if(!sorted.Size())
+		return 0;
+	return sorted[size_t(percentile * (sorted.Size() - 1))] / 1000.0;
+}
+
+static void RunStream(u32 loss_permille, Time jitter, u32 message_size, Time duration){
+	constexpr u32 MessagesPerTick = 32;
+
+	LossyLink to_a, to_b;
+	to_a.LossPermille = loss_permille;
+	to_b.LossPermille = loss_permille;
+	to_a.Jitter = jitter;
+	to_b.Jitter = jitter;
+
+	UdpConnection a(UdpConnection::PacketSender(&to_b, &LossyLink::Send));
+	UdpConnection b(UdpConnection::PacketSender(&to_a, &LossyLink::Send));
+	to_a.Receiver = &a;
+	to_b.Receiver = &b;
+
+	Time now;
+	List<Time> send_times;
+	LatencyRecorder recorder;
+	recorder.SendTimes = &send_times;
+	recorder.Now = &now;
+	b.OnMessage.Bind(&recorder, &LatencyRecorder::OnMessage);
+
+	List<u8> message;
+	message.Resize(message_size);
+
+	Clock clock;
+	for(; now < duration; now += Milliseconds(1)){
+		to_a.Deliver(now);
+		to_b.Deliver(now);
+
+		// 60Hz ticks
+		if(now.AsMilliseconds() % 16)
+			continue;
+
+		for(u32 i = 0; i<MessagesPerTick; i++){
+			const u32 index = send_times.Size();
+			memcpy(message.Data(), &index, sizeof(index));
+
+			if(!a.Send(UdpChannel::ReliableOrdered, {message.Data(), message.Size()}))
+				break;
+			send_times.Add(now);
+		}
+
+		a.Update(now);
+		b.Update(now);
+	}
+	const Time cpu_time = clock.GetElapsedTime();
+
+	std::sort(recorder.Latencies.begin(), recorder.Latencies.end());
+
+	Println("loss %/1000, jitter % ms, % B messages: latency ms p50 % p99 % p999 %, goodput % KB/s, delivered %/%, out of order %, reordered packets %, resent %, cpu % ms",
+		loss_permille, jitter.AsMilliseconds(), message_size,
+		Percentile(recorder.Latencies, 0.5), Percentile(recorder.Latencies, 0.99), Percentile(recorder.Latencies, 0.999),
+		recorder.Bytes / 1024.0 / duration.AsSeconds(),
+		recorder.Latencies.Size(), send_times.Size(), recorder.OutOfOrder, to_b.Reordered, a.Stats().FragmentsResent,
+		cpu_time.AsMicroseconds() / 1000.0);
+}
+
+int main(){
+	Println("simulated link: 30 ms one way delay, 60 Hz updates, 20 s per run, reordering within % packets", LossyLink::ReorderWindow);
+
+	const u32 loss_rates[] = {0, 10, 50, 100, 200};
+	const u32 message_sizes[] = {64, 1024, 4096};
+
+	for(Time jitter: {Time(), Milliseconds(10)}){
+		for(u32 size: message_sizes){
+			for(u32 loss: loss_rates)
+				RunStream(loss, jitter, size, Seconds(20));
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#include "core/list.hpp"
+#include "core/math/vector_stream.hpp"
+#include "core/math/linear.hpp"
+#include "bench.hpp"
+
+// Particle integration step over 1M particles, SoA streams against an array of structs.
+// Step is velocity += acceleration * dt, position += velocity * dt. Normalize and Dot are compared the same way
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector3f RandomVector(){
+    return {Random(), Random(), Random()};
+}
+
+struct Particle{
+    Vector3f Position;
+    Vector3f Velocity;
+    Vector3f Acceleration;
+};
+
+int main(){
+    constexpr size_t Count = 1000000;
+    constexpr float TimeStep = 1.f / 60.f;
+
+    List<Particle> particles;
+    Vector3Stream positions(Count), velocities(Count), accelerations(Count);
+    for(size_t i = 0; i<Count; i++){
+        particles.Add({RandomVector(), RandomVector(), RandomVector()});
+        positions.Set(i, particles[i].Position);
+        velocities.Set(i, particles[i].Velocity);
+        accelerations.Set(i, particles[i].Acceleration);
+    }
+
+    Bench::Report("particle step, AoS", Bench::Measure([&](){
+        for(Particle &particle: particles){
+            particle.Velocity += particle.Acceleration * TimeStep;
+            particle.Position += particle.Velocity * TimeStep;
+        }
+    }), Count, "particles");
+    Bench::Report("particle step, SoA", Bench::Measure([&](){
+        Math::MultiplyAdd(accelerations, TimeStep, velocities, velocities);
+        Math::MultiplyAdd(velocities, TimeStep, positions, positions);
+    }), Count, "particles");
+
+    List<Vector3f> normalized;
+    normalized.Resize(Count);
+    Vector3Stream normalized_stream;
+
+    Bench::Report("normalize, AoS", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            normalized[i] = Normalize(particles[i].Velocity);
+    }), Count, "vectors");
+    Bench::Report("normalize, SoA", Bench::Measure([&](){
+        Math::Normalize(velocities, normalized_stream);
+    }), Count, "vectors");
+
+    List<float> dots;
+    dots.Resize(Count);
+
+    Bench::Report("dot, AoS", Bench::Measure([&](){
+        for(size_t i = 0; i<Count; i++)
+            dots[i] = Dot(particles[i].Position, particles[i].Velocity);
+    }), Count, "vectors");
+    Bench::Report("dot, SoA", Bench::Measure([&](){
+        Math::Dot(positions, velocities, {dots.Data(), Count});
+    }), Count, "vectors");
+
+    Bench::DoNotOptimize(particles[Count - 1]);
+    Bench::DoNotOptimize(normalized[Count - 1]);
+    Bench::DoNotOptimize(dots[Count - 1]);
+    Bench::DoNotOptimize(positions.Get(Count - 1));
+    Bench::DoNotOptimize(normalized_stream.Get(Count - 1));
+}
@@ -0,0 +1,62 @@
+#include "core/allocators/slab_pool.hpp"
+#include "core/os/memory.hpp"
+#include "core/assert.hpp"
+
+SlabPool::SlabPool(size_t slab_size, size_t slabs_per_chunk):
+	m_SlabSize((slab_size + SlabAlignment - 1) / SlabAlignment * SlabAlignment),
+	m_SlabsPerChunk(slabs_per_chunk)
+{
+	SX_CORE_ASSERT(m_SlabSize && m_SlabsPerChunk, "SlabPool: Slab size and slabs per chunk should be non-zero");
+}
+
+SlabPool::~SlabPool(){
+	SX_CORE_ASSERT(m_UsedCount == 0, "SlabPool: Not all the slabs were freed");
+
+	for(void *chunk: m_Chunks)
+		Memory::AlignedFree(chunk);
+}
+
+void *SlabPool::Alloc(){
+	std::lock_guard<std::mutex> guard(m_Lock);
+
+	if(!m_FreeList){
+		u8 *chunk = (u8*)Memory::AlignedAlloc(m_SlabSize * m_SlabsPerChunk, SlabAlignment);
+		if(!chunk)
+			return nullptr;
+		m_Chunks.Add(chunk);
+
+		// push in reverse, so slabs are handed out in address order
+		for(size_t i = m_SlabsPerChunk; i--;){
+			FreeSlab *slab = (FreeSlab*)(chunk + i * m_SlabSize);
+			slab->Next = m_FreeList;
+			m_FreeList = slab;
+		}
+	}
+
+	FreeSlab *slab = m_FreeList;
+	m_FreeList = slab->Next;
+	m_UsedCount++;
+	return slab;
+}
+
+void SlabPool::Free(void *slab){
+	if(!slab)
+		return;
+
+	std::lock_guard<std::mutex> guard(m_Lock);
+
+	FreeSlab *free_slab = (FreeSlab*)slab;
+	free_slab->Next = m_FreeList;
+	m_FreeList = free_slab;
+	m_UsedCount--;
+}
+
+size_t SlabPool::UsedCount()const{
+	std::lock_guard<std::mutex> guard(m_Lock);
+	return m_UsedCount;
+}
+
+size_t SlabPool::CapacityCount()const{
+	std::lock_guard<std::mutex> guard(m_Lock);
+	return m_Chunks.Size() * m_SlabsPerChunk;
+}
@@ -0,0 +1,49 @@
+#ifndef STRAITX_SLAB_POOL_HPP
+#define STRAITX_SLAB_POOL_HPP
+
+#include <mutex>
+#include "core/types.hpp"
+#include "core/list.hpp"
+#include "core/noncopyable.hpp"
+#include "core/env/compiler.hpp"
+
+// Hands out fixed size blocks carved from bigger chunks, freed slabs are kept on a free list
+// and chunks are returned only when the pool is destroyed. Thread safe, so it can be shared between
+// connections running on different threads
+class SlabPool: public NonCopyable{
+public:
+	static constexpr size_t SlabAlignment = 64;
+private:
+	struct FreeSlab{
+		FreeSlab *Next;
+	};
+
+	const size_t m_SlabSize;
+	const size_t m_SlabsPerChunk;
+
+	mutable std::mutex m_Lock;
+	FreeSlab *m_FreeList = nullptr;
+	List<void*> m_Chunks;
+	size_t m_UsedCount = 0;
+public:
+	// slab_size is rounded up to SlabAlignment
+	SlabPool(size_t slab_size = 64 * 1024, size_t slabs_per_chunk = 16);
+	// all the slabs should be freed by then
+	~SlabPool();
+
+	void *Alloc();
+
+	void Free(void *slab);
+
+	size_t SlabSize()const;
+
+	size_t UsedCount()const;
+
+	size_t CapacityCount()const;
+};
+
+SX_INLINE size_t SlabPool::SlabSize()const{
+	return m_SlabSize;
+}
+
+#endif//STRAITX_SLAB_POOL_HPP
@@ -0,0 +1,376 @@
+#include <cstring>
+#include "core/compression/lz_block.hpp"
+#include "core/os/memory.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+#include "core/env/compiler.hpp"
+
+#if defined(SX_COMPILER_MSVC)
+    #include <intrin.h>
+#endif
+
+static constexpr size_t MinMatch = 4;
+// last sequence is literals only and ends with at least that much of them
+static constexpr size_t LastLiterals = 5;
+// match can't start closer than that to the end of the input
+static constexpr size_t MatchFindLimit = 12;
+static constexpr size_t MaxOffset = 65535;
+
+static constexpr u32 FastHashBits = 14;
+static constexpr u32 HighHashBits = 15;
+static constexpr u32 HighMaxAttempts = 256;
+
+static u32 Read32(const u8 *pointer){
+    u32 value;
+    memcpy(&value, pointer, sizeof(value));
+    return value;
+}
+
+static u64 Read64(const u8 *pointer){
+    u64 value;
+    memcpy(&value, pointer, sizeof(value));
+    return value;
+}
+
+static u32 Hash(u32 sequence, u32 bits){
+    return (sequence * 2654435761u) >> (32 - bits);
+}
+
+static u32 TrailingZeros(u64 value){
+#if defined(SX_COMPILER_MSVC)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// length of the common prefix, second range should not go past the limit
+static size_t CommonLength(const u8 *first, const u8 *second, const u8 *limit){
+    const u8 *start = second;
+
+    while(second + sizeof(u64) <= limit){
+        u64 diff = Read64(first) ^ Read64(second);
+        if(diff)
+            return second - start + TrailingZeros(diff) / 8;
+
+        first += sizeof(u64);
+        second += sizeof(u64);
+    }
+
+    while(second < limit && *first == *second){
+        first++;
+        second++;
+    }
+    return second - start;
+}
+
+static constexpr size_t WildCopySize = 16;
+
+// copies in fixed size chunks and can write up to WildCopySize - 1 bytes past the end
+static void WildCopy(u8 *destination, const u8 *source, u8 *end){
+    do{
+        memcpy(destination, source, WildCopySize);
+        destination += WildCopySize;
+        source += WildCopySize;
+    }while(destination < end);
+}
+
+struct SequenceWriter{
+    u8 *Out;
+    u8 *End;
+
+    static size_t LengthBytes(size_t length){
+        return length >= 15 ? (length - 15) / 255 + 1 : 0;
+    }
+
+    static void WriteLength(u8 *&out, size_t length){
+        length -= 15;
+        while(length >= 255){
+            *out++ = 255;
+            length -= 255;
+        }
+        *out++ = (u8)length;
+    }
+
+    // match_length of zero writes the last literals only sequence
+    bool Write(const u8 *literals, size_t literals_size, size_t offset, size_t match_length){
+        const size_t match_code = match_length ? match_length - MinMatch : 0;
+        const size_t needed = 1 + LengthBytes(literals_size) + literals_size + (match_length ? 2 + LengthBytes(match_code) : 0);
+
+        if((size_t)(End - Out) < needed)
+            return false;
+
+        u8 *token = Out++;
+        *token = (u8)(Min<size_t>(literals_size, 15) << 4);
+        if(literals_size >= 15)
+            WriteLength(Out, literals_size);
+
+        memcpy(Out, literals, literals_size);
+        Out += literals_size;
+
+        if(!match_length)
+            return true;
+
+        Out[0] = (u8)offset;
+        Out[1] = (u8)(offset >> 8);
+        Out += 2;
+
+        *token |= (u8)Min<size_t>(match_code, 15);
+        if(match_code >= 15)
+            WriteLength(Out, match_code);
+
+        return true;
+    }
+};
+
+static size_t CompressFast(const u8 *source, size_t size, u8 *destination, size_t capacity){
+    SequenceWriter writer{destination, destination + capacity};
+
+    const u8 *ip = source;
+    const u8 *anchor = source;
+    const u8 *const end = source + size;
+
+    if(size > MatchFindLimit){
+        const u8 *const match_limit = end - MatchFindLimit;
+        const u8 *const match_end = end - LastLiterals;
+
+        u32 table[1 << FastHashBits] = {};
+
+        while(ip < match_limit){
+            const u32 sequence = Read32(ip);
+            const u32 hash = Hash(sequence, FastHashBits);
+            const u8 *reference = source + table[hash];
+            table[hash] = (u32)(ip - source);
+
+            if(reference >= ip || (size_t)(ip - reference) > MaxOffset || Read32(reference) != sequence){
+                // step grows on incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            while(ip > anchor && reference > source && ip[-1] == reference[-1]){
+                ip--;
+                reference--;
+            }
+
+            const size_t length = MinMatch + CommonLength(reference + MinMatch, ip + MinMatch, match_end);
+
+            if(!writer.Write(anchor, ip - anchor, ip - reference, length))
+                return LzBlock::InvalidSize;
+
+            ip += length;
+            anchor = ip;
+
+            if(ip < match_limit)
+                table[Hash(Read32(ip - 2), FastHashBits)] = (u32)(ip - 2 - source);
+        }
+    }
+
+    if(!writer.Write(anchor, end - anchor, 0, 0))
+        return LzBlock::InvalidSize;
+
+    return writer.Out - destination;
+}
+
+struct HashChain{
+    static constexpr u32 None = 0xFFFFFFFF;
+
+    const u8 *Source;
+    u32 *Heads;
+    // distance to the previous position with the same hash, zero if there is none in the window
+    u16 *Chain;
+    u32 NextToInsert = 0;
+
+    HashChain(const u8 *source):
+        Source(source),
+        Heads((u32*)Memory::Alloc(sizeof(u32) << HighHashBits)),
+        Chain((u16*)Memory::Alloc(sizeof(u16) * (MaxOffset + 1)))
+    {
+        memset(Heads, 0xFF, sizeof(u32) << HighHashBits);
+    }
+
+    ~HashChain(){
+        Memory::Free(Heads);
+        Memory::Free(Chain);
+    }
+
+    void InsertUntil(const u8 *ip){
+        const u32 target = (u32)(ip - Source);
+
+        for(; NextToInsert < target; NextToInsert++){
+            const u32 hash = Hash(Read32(Source + NextToInsert), HighHashBits);
+            const u32 head = Heads[hash];
+            const u32 distance = head == None ? 0 : NextToInsert - head;
+
+            Chain[NextToInsert & MaxOffset] = (u16)(distance > MaxOffset ? 0 : distance);
+            Heads[hash] = NextToInsert;
+        }
+    }
+
+    // returns length of the longest match, zero if there is none
+    size_t FindLongest(const u8 *ip, const u8 *match_end, const u8 *&reference){
+        InsertUntil(ip);
+
+        const u32 position = (u32)(ip - Source);
+        u32 candidate = Heads[Hash(Read32(ip), HighHashBits)];
+        size_t best = 0;
+
+        for(u32 attempts = HighMaxAttempts; attempts && candidate != None && position - candidate <= MaxOffset; attempts--){
+            const u8 *match = Source + candidate;
+
+            // checking the byte after the current best rejects most of the candidates early
+            if(match[best] == ip[best] && Read32(match) == Read32(ip)){
+                const size_t length = MinMatch + CommonLength(match + MinMatch, ip + MinMatch, match_end);
+                if(length > best){
+                    best = length;
+                    reference = match;
+                    if(ip + length == match_end)
+                        break;
+                }
+            }
+
+            const u16 distance = Chain[candidate & MaxOffset];
+            if(!distance || distance > candidate)
+                break;
+            candidate -= distance;
+        }
+        return best >= MinMatch ? best : 0;
+    }
+};
+
+static size_t CompressHigh(const u8 *source, size_t size, u8 *destination, size_t capacity){
+    SequenceWriter writer{destination, destination + capacity};
+
+    const u8 *ip = source;
+    const u8 *anchor = source;
+    const u8 *const end = source + size;
+
+    if(size > MatchFindLimit){
+        const u8 *const match_limit = end - MatchFindLimit;
+        const u8 *const match_end = end - LastLiterals;
+
+        HashChain chain(source);
+
+        while(ip < match_limit){
+            const u8 *reference = nullptr;
+            size_t length = chain.FindLongest(ip, match_end, reference);
+
+            if(!length){
+                ip++;
+                continue;
+            }
+
+            // one step lazy evaluation, literal is cheaper than a shorter match
+            while(ip + 1 < match_limit){
+                const u8 *next_reference = nullptr;
+                const size_t next_length = chain.FindLongest(ip + 1, match_end, next_reference);
+                if(next_length <= length)
+                    break;
+
+                ip++;
+                length = next_length;
+                reference = next_reference;
+            }
+
+            if(!writer.Write(anchor, ip - anchor, ip - reference, length))
+                return LzBlock::InvalidSize;
+
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    if(!writer.Write(anchor, end - anchor, 0, 0))
+        return LzBlock::InvalidSize;
+
+    return writer.Out - destination;
+}
+
+size_t LzBlock::Compress(ConstSpan<u8> source, Span<u8> destination, Level level){
+    SX_CORE_ASSERT(source.Size() <= MaxInputSize, "LzBlock: Input is too big for a single block");
+
+    if(level == Level::High)
+        return CompressHigh(source.Pointer(), source.Size(), destination.Pointer(), destination.Size());
+    return CompressFast(source.Pointer(), source.Size(), destination.Pointer(), destination.Size());
+}
+
+size_t LzBlock::Decompress(ConstSpan<u8> source, Span<u8> destination){
+    const u8 *ip = source.Pointer();
+    const u8 *const input_end = ip + source.Size();
+    u8 *op = destination.Pointer();
+    u8 *const output_end = op + destination.Size();
+
+    auto read_length = [&ip, input_end](size_t &length)->bool{
+        u8 byte;
+        do{
+            if(ip == input_end)
+                return false;
+            byte = *ip++;
+            length += byte;
+        }while(byte == 255);
+        return true;
+    };
+
+    for(;;){
+        if(ip == input_end)
+            return InvalidSize;
+
+        const u8 token = *ip++;
+
+        size_t literals = token >> 4;
+        if(literals == 15 && !read_length(literals))
+            return InvalidSize;
+
+        if(literals > (size_t)(input_end - ip) || literals > (size_t)(output_end - op))
+            return InvalidSize;
+
+        if((size_t)(input_end - ip) >= literals + WildCopySize && (size_t)(output_end - op) >= literals + WildCopySize)
+            WildCopy(op, ip, op + literals);
+        else
+            memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        // last sequence has no match
+        if(ip == input_end)
+            break;
+
+        if(input_end - ip < 2)
+            return InvalidSize;
+
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if(!offset || offset > (size_t)(op - destination.Pointer()))
+            return InvalidSize;
+
+        size_t length = token & 15;
+        if(length == 15 && !read_length(length))
+            return InvalidSize;
+        length += MinMatch;
+
+        if(length > (size_t)(output_end - op))
+            return InvalidSize;
+
+        const u8 *match = op - offset;
+        u8 *const match_end = op + length;
+
+        // chunks don't overlap when offset is at least chunk size
+        if(offset >= WildCopySize && (size_t)(output_end - match_end) >= WildCopySize){
+            WildCopy(op, match, match_end);
+            op = match_end;
+            continue;
+        }
+
+        if(offset >= sizeof(u64)){
+            for(; op + sizeof(u64) <= match_end; op += sizeof(u64), match += sizeof(u64))
+                memcpy(op, match, sizeof(u64));
+        }
+        while(op < match_end)
+            *op++ = *match++;
+    }
+
+    return op - destination.Pointer();
+}
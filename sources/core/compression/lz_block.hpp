@@ -0,0 +1,33 @@
+#ifndef STRAITX_LZ_BLOCK_HPP
+#define STRAITX_LZ_BLOCK_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+
+// LZ77 block codec, byte compatible with LZ4 block format:
+// sequences of [token][literals length][literals][offset][match length] with 64K window.
+// Fast level is a single probe hash table, High level searches hash chains with lazy matching
+// and is meant for offline cooking, both are decoded by the same fast decoder
+class LzBlock{
+public:
+    enum class Level{
+        Fast,
+        High
+    };
+
+    static constexpr size_t InvalidSize = -1;
+    // blocks are limited by 32 bit positions
+    static constexpr size_t MaxInputSize = 0x7E000000;
+public:
+    static constexpr size_t CompressBound(size_t size);
+    // returns compressed size, or InvalidSize if destination is smaller than needed
+    static size_t Compress(ConstSpan<u8> source, Span<u8> destination, Level level = Level::Fast);
+    // returns decompressed size, or InvalidSize on corrupted input or too small destination
+    static size_t Decompress(ConstSpan<u8> source, Span<u8> destination);
+};
+
+constexpr size_t LzBlock::CompressBound(size_t size){
+    return size + size / 255 + 16;
+}
+
+#endif//STRAITX_LZ_BLOCK_HPP
@@ -0,0 +1,333 @@
+#include <cstring>
+#include "core/compression/lz_frame.hpp"
+#include "core/os/thread_pool.hpp"
+#include "core/algorithm.hpp"
+#include "core/env/endianness.hpp"
+#include "core/assert.hpp"
+
+static constexpr size_t SizeWordSize = sizeof(u32);
+
+static bool IsValidBlockSize(size_t block_size){
+    return block_size >= LzFrame::MinBlockSize
+        && block_size <= LzFrame::MaxBlockSize
+        && (block_size & (block_size - 1)) == 0;
+}
+
+static u8 Log2(size_t value){
+    u8 log = 0;
+    while(value >>= 1)
+        log++;
+    return log;
+}
+
+// frame values are little endian, so a frame written on one machine decodes on any other
+template<typename Type>
+static Type ToLittleEndian(Type value){
+    return IsLittleEndian() ? value : SwapEndianness(value);
+}
+
+static void WriteSizeWord(u8 *destination, u32 word){
+    word = ToLittleEndian(word);
+    memcpy(destination, &word, sizeof(word));
+}
+
+static u32 ReadSizeWord(const u8 *source){
+    u32 word;
+    memcpy(&word, source, sizeof(word));
+    return ToLittleEndian(word);
+}
+
+static void EncodeHeader(u8 *destination, size_t block_size){
+    LzFrameHeader header;
+    header.Magic = ToLittleEndian(header.Magic);
+    header.BlockSizeLog2 = Log2(block_size);
+    memcpy(destination, &header, sizeof(header));
+}
+
+// returns block size of the frame, or 0 if header is not valid
+static size_t DecodeHeader(const u8 *source){
+    LzFrameHeader header;
+    memcpy(&header, source, sizeof(header));
+
+    const size_t block_size = (size_t)1 << Min<u8>(header.BlockSizeLog2, 63);
+    if(ToLittleEndian(header.Magic) != LzFrameHeader::MagicValue || header.Version != LzFrameHeader::CurrentVersion || !IsValidBlockSize(block_size))
+        return 0;
+    return block_size;
+}
+
+// destination should have space for SizeWordSize + block size, returns amount of bytes written
+static size_t EncodeBlock(ConstSpan<u8> block, u8 *destination, LzBlock::Level level){
+    // compressed block is only kept when it is smaller than the stored one
+    size_t compressed = LzBlock::Compress(block, {destination + SizeWordSize, block.Size() - 1}, level);
+
+    if(compressed != LzBlock::InvalidSize){
+        WriteSizeWord(destination, (u32)compressed);
+        return SizeWordSize + compressed;
+    }
+
+    WriteSizeWord(destination, (u32)block.Size() | LzFrame::StoredBlockFlag);
+    memcpy(destination + SizeWordSize, block.Pointer(), block.Size());
+    return SizeWordSize + block.Size();
+}
+
+static u8 *AppendFrameStart(List<u8> &frame, size_t source_size, size_t block_size, size_t &blocks_count){
+    blocks_count = (source_size + block_size - 1) / block_size;
+
+    const size_t begin = frame.Size();
+    frame.Resize(begin + sizeof(LzFrameHeader) + blocks_count * (SizeWordSize + block_size) + SizeWordSize);
+
+    EncodeHeader(frame.Data() + begin, block_size);
+
+    return frame.Data() + begin + sizeof(LzFrameHeader);
+}
+
+static void AppendFrameEnd(List<u8> &frame, u8 *end){
+    WriteSizeWord(end, 0);
+    frame.Resize(end + SizeWordSize - frame.Data());
+}
+
+void LzFrame::Compress(ConstSpan<u8> source, List<u8> &frame, LzBlock::Level level, size_t block_size){
+    SX_CORE_ASSERT(IsValidBlockSize(block_size), "LzFrame: Block size should be a power of two within the limits");
+
+    size_t blocks_count = 0;
+    u8 *out = AppendFrameStart(frame, source.Size(), block_size, blocks_count);
+
+    for(size_t offset = 0; offset < source.Size(); offset += block_size){
+        ConstSpan<u8> block(source.Pointer() + offset, Min(block_size, source.Size() - offset));
+        out += EncodeBlock(block, out, level);
+    }
+
+    AppendFrameEnd(frame, out);
+}
+
+void LzFrame::Compress(ConstSpan<u8> source, List<u8> &frame, ThreadPool &pool, LzBlock::Level level, size_t block_size){
+    SX_CORE_ASSERT(IsValidBlockSize(block_size), "LzFrame: Block size should be a power of two within the limits");
+
+    size_t blocks_count = 0;
+    u8 *const blocks = AppendFrameStart(frame, source.Size(), block_size, blocks_count);
+    const size_t slot_size = SizeWordSize + block_size;
+
+    // every block is encoded into its own slot and then slots are packed together
+    List<size_t> encoded_sizes;
+    encoded_sizes.Resize(blocks_count);
+
+    pool.ParallelFor(blocks_count, 1, [&](size_t begin, size_t end){
+        for(size_t i = begin; i<end; i++){
+            const size_t offset = i * block_size;
+            ConstSpan<u8> block(source.Pointer() + offset, Min(block_size, source.Size() - offset));
+            encoded_sizes[i] = EncodeBlock(block, blocks + i * slot_size, level);
+        }
+    });
+
+    u8 *out = blocks;
+    for(size_t i = 0; i<blocks_count; i++){
+        Memory::Move(blocks + i * slot_size, out, encoded_sizes[i]);
+        out += encoded_sizes[i];
+    }
+
+    AppendFrameEnd(frame, out);
+}
+
+bool LzFrame::Decompress(ConstSpan<u8> frame, List<u8> &content){
+    if(frame.Size() < sizeof(LzFrameHeader))
+        return false;
+
+    const size_t block_size = DecodeHeader(frame.Pointer());
+    if(!block_size)
+        return false;
+
+    const u8 *ip = frame.Pointer() + sizeof(LzFrameHeader);
+    const u8 *const end = frame.Pointer() + frame.Size();
+
+    for(;;){
+        if((size_t)(end - ip) < SizeWordSize)
+            return false;
+
+        const u32 word = ReadSizeWord(ip);
+        ip += SizeWordSize;
+
+        if(!word)
+            return true;
+
+        const size_t size = word & ~StoredBlockFlag;
+        if(size > block_size || size > (size_t)(end - ip))
+            return false;
+
+        const size_t begin = content.Size();
+
+        if(word & StoredBlockFlag){
+            content.Resize(begin + size);
+            memcpy(content.Data() + begin, ip, size);
+        }else{
+            content.Resize(begin + block_size);
+            const size_t decompressed = LzBlock::Decompress({ip, size}, {content.Data() + begin, block_size});
+            if(decompressed == LzBlock::InvalidSize)
+                return false;
+            content.Resize(begin + decompressed);
+        }
+        ip += size;
+    }
+}
+
+LzFrameWriter::LzFrameWriter(StringWriter &output, LzBlock::Level level, size_t block_size):
+    m_Output(output),
+    m_Level(level),
+    m_Block((u8*)Memory::Alloc(block_size)),
+    m_Compressed((u8*)Memory::Alloc(SizeWordSize + block_size)),
+    m_BlockSize(block_size)
+{
+    SX_CORE_ASSERT(IsValidBlockSize(block_size), "LzFrameWriter: Block size should be a power of two within the limits");
+
+    u8 header[sizeof(LzFrameHeader)];
+    EncodeHeader(header, block_size);
+    m_Output.Write((const char*)header, sizeof(header));
+}
+
+LzFrameWriter::~LzFrameWriter(){
+    if(!m_IsFinished)
+        Finish();
+
+    Memory::Free(m_Block);
+    Memory::Free(m_Compressed);
+}
+
+void LzFrameWriter::Write(const void *data, size_t size){
+    SX_CORE_ASSERT(!m_IsFinished, "LzFrameWriter: Can't write to finished frame");
+
+    const u8 *source = (const u8*)data;
+    while(size){
+        const size_t chunk = Min(size, m_BlockSize - m_Size);
+        memcpy(m_Block + m_Size, source, chunk);
+
+        m_Size += chunk;
+        source += chunk;
+        size -= chunk;
+
+        if(m_Size == m_BlockSize)
+            WriteBlock();
+    }
+}
+
+void LzFrameWriter::Finish(){
+    SX_CORE_ASSERT(!m_IsFinished, "LzFrameWriter: Frame is already finished");
+
+    WriteBlock();
+
+    u8 end_mark[SizeWordSize] = {};
+    m_Output.Write((const char*)end_mark, sizeof(end_mark));
+    m_IsFinished = true;
+}
+
+void LzFrameWriter::WriteBlock(){
+    if(!m_Size)
+        return;
+
+    const size_t size = EncodeBlock({m_Block, m_Size}, m_Compressed, m_Level);
+    m_Output.Write((const char*)m_Compressed, size);
+    m_Size = 0;
+}
+
+LzFrameReader::LzFrameReader(FileReader &input):
+    m_Input(input)
+{}
+
+LzFrameReader::~LzFrameReader(){
+    Memory::Free(m_Block);
+    Memory::Free(m_Compressed);
+}
+
+size_t LzFrameReader::Read(void *data, size_t size){
+    u8 *destination = (u8*)data;
+    size_t done = 0;
+
+    while(done < size){
+        if(m_Begin == m_End && !Refill())
+            break;
+
+        const size_t chunk = Min(size - done, m_End - m_Begin);
+        memcpy(destination + done, m_Block + m_Begin, chunk);
+
+        m_Begin += chunk;
+        done += chunk;
+    }
+    return done;
+}
+
+bool LzFrameReader::IsEnd(){
+    return m_Begin == m_End && !Refill();
+}
+
+bool LzFrameReader::Refill(){
+    if(m_IsFrameEnd || m_IsFailed)
+        return false;
+
+    if(!m_IsHeaderRead && !ReadHeader()){
+        m_IsFailed = true;
+        return false;
+    }
+
+    while(ReadBlock()){
+        if(m_End)
+            return true;
+    }
+    return false;
+}
+
+bool LzFrameReader::ReadHeader(){
+    u8 header[sizeof(LzFrameHeader)];
+    if(!m_Input.ReadExact(header, sizeof(header)))
+        return false;
+
+    const size_t block_size = DecodeHeader(header);
+    if(!block_size)
+        return false;
+
+    m_BlockSize = block_size;
+    m_Block = (u8*)Memory::Alloc(block_size);
+    m_Compressed = (u8*)Memory::Alloc(block_size);
+    m_IsHeaderRead = true;
+    return true;
+}
+
+bool LzFrameReader::ReadBlock(){
+    m_Begin = 0;
+    m_End = 0;
+
+    u8 word_bytes[SizeWordSize];
+    if(!m_Input.ReadExact(word_bytes, sizeof(word_bytes))){
+        m_IsFailed = true;
+        return false;
+    }
+
+    const u32 word = ReadSizeWord(word_bytes);
+    if(!word){
+        m_IsFrameEnd = true;
+        return false;
+    }
+
+    const size_t size = word & ~LzFrame::StoredBlockFlag;
+    if(size > m_BlockSize){
+        m_IsFailed = true;
+        return false;
+    }
+
+    if(word & LzFrame::StoredBlockFlag){
+        if(!m_Input.ReadExact(m_Block, size)){
+            m_IsFailed = true;
+            return false;
+        }
+        m_End = size;
+        return true;
+    }
+
+    const size_t decompressed = m_Input.ReadExact(m_Compressed, size)
+        ? LzBlock::Decompress({m_Compressed, size}, {m_Block, m_BlockSize})
+        : LzBlock::InvalidSize;
+
+    if(decompressed == LzBlock::InvalidSize){
+        m_IsFailed = true;
+        return false;
+    }
+    m_End = decompressed;
+    return true;
+}
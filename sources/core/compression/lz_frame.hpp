@@ -0,0 +1,111 @@
+#ifndef STRAITX_LZ_FRAME_HPP
+#define STRAITX_LZ_FRAME_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/noncopyable.hpp"
+#include "core/string_writer.hpp"
+#include "core/os/memory.hpp"
+#include "core/os/file_reader.hpp"
+#include "core/compression/lz_block.hpp"
+
+class ThreadPool;
+
+// Frame is a header followed by independently compressed blocks:
+//     LzFrameHeader | [u32 size word][block data] ... | u32 zero end mark
+// High bit of the size word marks a block that is stored uncompressed, header and size words are little endian
+struct LzFrameHeader{
+    static constexpr u32 MagicValue = 0x5A4C5853; // "SXLZ"
+    static constexpr u8 CurrentVersion = 1;
+
+    u32 Magic = MagicValue;
+    u8 Version = CurrentVersion;
+    u8 BlockSizeLog2 = 0;
+    u16 Reserved = 0;
+};
+static_assert(sizeof(LzFrameHeader) == 8, "LzFrameHeader is a part of the frame format");
+
+struct LzFrame{
+    static constexpr size_t DefaultBlockSize = 64 * Memory::Kilobyte;
+    static constexpr size_t MinBlockSize = 1 * Memory::Kilobyte;
+    static constexpr size_t MaxBlockSize = 64 * Memory::Megabyte;
+
+    static constexpr u32 StoredBlockFlag = 0x80000000;
+
+    // frame is appended to the output
+    static void Compress(ConstSpan<u8> source, List<u8> &frame, LzBlock::Level level = LzBlock::Level::Fast, size_t block_size = DefaultBlockSize);
+    // Blocks are compressed on the pool, calling thread participates as well,
+    // produced frame is the same as of the single threaded Compress
+    static void Compress(ConstSpan<u8> source, List<u8> &frame, ThreadPool &pool, LzBlock::Level level = LzBlock::Level::Fast, size_t block_size = DefaultBlockSize);
+    // content is appended to the output, returns false on corrupted frame
+    static bool Decompress(ConstSpan<u8> frame, List<u8> &content);
+};
+
+// Streams frame into any StringWriter, so it can be stacked on top of FileWriter
+class LzFrameWriter: public StringWriter, public NonCopyable{
+private:
+    StringWriter &m_Output;
+    LzBlock::Level m_Level;
+    u8 *m_Block = nullptr;
+    u8 *m_Compressed = nullptr;
+    size_t m_BlockSize = 0;
+    size_t m_Size = 0;
+    bool m_IsFinished = false;
+public:
+    // block_size should be a power of two
+    LzFrameWriter(StringWriter &output, LzBlock::Level level = LzBlock::Level::Fast, size_t block_size = LzFrame::DefaultBlockSize);
+    // finishes the frame if it was not finished yet
+    ~LzFrameWriter();
+
+    using StringWriter::Write;
+
+    void Write(const char *string, size_t size)override;
+
+    void Write(const void *data, size_t size);
+    // compresses what is left and writes the end mark, nothing can be written after that
+    void Finish();
+private:
+    void WriteBlock();
+};
+
+// Decompresses frame read through FileReader
+class LzFrameReader: public NonCopyable{
+private:
+    FileReader &m_Input;
+    u8 *m_Block = nullptr;
+    u8 *m_Compressed = nullptr;
+    size_t m_BlockSize = 0;
+    size_t m_Begin = 0;
+    size_t m_End = 0;
+    bool m_IsHeaderRead = false;
+    bool m_IsFrameEnd = false;
+    bool m_IsFailed = false;
+public:
+    LzFrameReader(FileReader &input);
+
+    ~LzFrameReader();
+
+    size_t Read(void *data, size_t size);
+
+    bool IsEnd();
+    // frame is corrupted or has ended unexpectedly
+    bool IsFailed()const;
+private:
+    // reads the next block, returns false if there is nothing left to read
+    bool Refill();
+
+    bool ReadHeader();
+
+    bool ReadBlock();
+};
+
+SX_INLINE void LzFrameWriter::Write(const char *string, size_t size){
+    Write((const void*)string, size);
+}
+
+SX_INLINE bool LzFrameReader::IsFailed()const{
+    return m_IsFailed;
+}
+
+#endif//STRAITX_LZ_FRAME_HPP
@@ -36,6 +36,14 @@
 
 
 
+// true while the enclosing constexpr function is evaluated by the compiler, lets it pick
+// a constexpr implementation over intrinsics, which can't be constant evaluated
+#if defined(SX_COMPILER_GCC) || defined(SX_COMPILER_CLANG) || defined(SX_COMPILER_MSVC)
+    #define SX_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+    #error Your compiler is not supported yet
+#endif
+
 #ifdef NDEBUG
     #define SX_RELEASE
     #define SX_BUILD_TYPE_NAME "Release"
@@ -117,6 +117,21 @@ public:
         m_Capacity = capacity;
     }
 
+    // new elements are value initialized
+    void Resize(size_t size){
+        if(size > m_Capacity)
+            Reserve(Max(size, m_Capacity * 2));
+
+        // plain loop lets compiler turn it into memset for trivial types
+        for(size_t i = m_Size; i<size; i++)
+            new(&m_Elements[i]) Type();
+        if(size > m_Size)
+            m_Size = size;
+
+        while(m_Size > size)
+            RemoveLast();
+    }
+
     void Swap(List<Type> &other) {
         ::Swap(m_Elements, other.m_Elements);
         ::Swap(m_Size, other.m_Size);
@@ -0,0 +1,157 @@
+#include "core/math/batch_transform.hpp"
+#include "core/math/simd.hpp"
+#include "core/os/thread_pool.hpp"
+#include "core/assert.hpp"
+
+static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f is expected to be tightly packed");
+static_assert(sizeof(Vector4f) == 4 * sizeof(float), "Vector4f is expected to be tightly packed");
+
+namespace Math{
+
+// Four Vector3f are loaded as three registers, deinterleaved into x, y, z lanes,
+// transformed with splatted matrix elements and interleaved back.
+// Sums go in Dot order, so points are bit exact with operator*
+template<bool IsPoint>
+static void TransformVector3Range(const Matrix4f &matrix, const Vector3f *source, Vector3f *destination, size_t count){
+    size_t i = 0;
+
+#if defined(SX_SIMD)
+    Float4 m[3][4];
+    for(size_t row = 0; row < 3; row++)
+        for(size_t column = 0; column < 4; column++)
+            m[row][column] = Float4::Splat(matrix.Rows[row].Data[column]);
+
+    for(; i + 4 <= count; i += 4){
+        const float *in = source[i].Data;
+        const Float4 a = Float4::Load(in + 0);
+        const Float4 b = Float4::Load(in + 4);
+        const Float4 c = Float4::Load(in + 8);
+
+        const Float4 yz = Shuffle<1, 2, 0, 1>(a, b);
+        const Float4 x = Shuffle<0, 3, 0, 3>(a, Shuffle<2, 3, 0, 1>(b, c));
+        const Float4 y = Shuffle<0, 2, 0, 2>(yz, Shuffle<3, 3, 2, 2>(b, c));
+        const Float4 z = Shuffle<1, 3, 0, 3>(yz, c);
+
+        Float4 out_x = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+        Float4 out_y = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+        Float4 out_z = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+
+        if(IsPoint){
+            out_x = out_x + m[0][3];
+            out_y = out_y + m[1][3];
+            out_z = out_z + m[2][3];
+        }
+
+        const Float4 xy = Shuffle<0, 1, 0, 1>(out_x, out_y);
+
+        float *out = destination[i].Data;
+        Shuffle<0, 2, 0, 2>(xy, Shuffle<0, 0, 1, 1>(out_z, out_x)).Store(out + 0);
+        Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 1, 1>(out_y, out_z), Shuffle<2, 2, 2, 2>(out_x, out_y)).Store(out + 4);
+        Shuffle<0, 2, 0, 2>(Shuffle<2, 2, 3, 3>(out_z, out_x), Shuffle<3, 3, 3, 3>(out_y, out_z)).Store(out + 8);
+    }
+#endif
+
+    for(; i < count; i++){
+        const Vector3f vector = source[i];
+
+        for(size_t row = 0; row < 3; row++){
+            const float *m = matrix.Rows[row].Data;
+            float value = m[0] * vector.x + m[1] * vector.y + m[2] * vector.z;
+            if(IsPoint)
+                value += m[3];
+            destination[i].Data[row] = value;
+        }
+    }
+}
+
+static void TransformVector4Range(const Matrix4f &matrix, const Vector4f *source, Vector4f *destination, size_t count){
+    size_t i = 0;
+
+#if defined(SX_SIMD)
+    Float4 m[4][4];
+    for(size_t row = 0; row < 4; row++)
+        for(size_t column = 0; column < 4; column++)
+            m[row][column] = Float4::Splat(matrix.Rows[row].Data[column]);
+
+    for(; i + 4 <= count; i += 4){
+        Float4 x = Float4::Load(source[i + 0].Data);
+        Float4 y = Float4::Load(source[i + 1].Data);
+        Float4 z = Float4::Load(source[i + 2].Data);
+        Float4 w = Float4::Load(source[i + 3].Data);
+
+        Transpose(x, y, z, w);
+
+        Float4 out[4];
+        for(size_t row = 0; row < 4; row++)
+            out[row] = m[row][0] * x + m[row][1] * y + m[row][2] * z + m[row][3] * w;
+
+        Transpose(out[0], out[1], out[2], out[3]);
+
+        for(size_t j = 0; j < 4; j++)
+            out[j].Store(destination[i + j].Data);
+    }
+#endif
+
+    for(; i < count; i++)
+        destination[i] = matrix * source[i];
+}
+
+static void MultiplyMatricesRange(const Matrix4f *left, const Matrix4f *right, Matrix4f *result, size_t count){
+    for(size_t i = 0; i < count; i++)
+        result[i] = left[i] * right[i];
+}
+
+void TransformPoints(const Matrix4f &matrix, ConstSpan<Vector3f> points, Span<Vector3f> result){
+    SX_CORE_ASSERT(points.Size() == result.Size(), "Math: TransformPoints spans should be the same size");
+    TransformVector3Range<true>(matrix, points.Pointer(), result.Pointer(), points.Size());
+}
+
+void TransformPoints(const Matrix4f &matrix, ConstSpan<Vector3f> points, Span<Vector3f> result, ThreadPool &pool){
+    SX_CORE_ASSERT(points.Size() == result.Size(), "Math: TransformPoints spans should be the same size");
+
+    pool.ParallelFor(points.Size(), ParallelGrain, [&](size_t begin, size_t end){
+        TransformVector3Range<true>(matrix, points.Pointer() + begin, result.Pointer() + begin, end - begin);
+    });
+}
+
+void TransformDirections(const Matrix4f &matrix, ConstSpan<Vector3f> directions, Span<Vector3f> result){
+    SX_CORE_ASSERT(directions.Size() == result.Size(), "Math: TransformDirections spans should be the same size");
+    TransformVector3Range<false>(matrix, directions.Pointer(), result.Pointer(), directions.Size());
+}
+
+void TransformDirections(const Matrix4f &matrix, ConstSpan<Vector3f> directions, Span<Vector3f> result, ThreadPool &pool){
+    SX_CORE_ASSERT(directions.Size() == result.Size(), "Math: TransformDirections spans should be the same size");
+
+    pool.ParallelFor(directions.Size(), ParallelGrain, [&](size_t begin, size_t end){
+        TransformVector3Range<false>(matrix, directions.Pointer() + begin, result.Pointer() + begin, end - begin);
+    });
+}
+
+void TransformVectors(const Matrix4f &matrix, ConstSpan<Vector4f> vectors, Span<Vector4f> result){
+    SX_CORE_ASSERT(vectors.Size() == result.Size(), "Math: TransformVectors spans should be the same size");
+    TransformVector4Range(matrix, vectors.Pointer(), result.Pointer(), vectors.Size());
+}
+
+void TransformVectors(const Matrix4f &matrix, ConstSpan<Vector4f> vectors, Span<Vector4f> result, ThreadPool &pool){
+    SX_CORE_ASSERT(vectors.Size() == result.Size(), "Math: TransformVectors spans should be the same size");
+
+    pool.ParallelFor(vectors.Size(), ParallelGrain, [&](size_t begin, size_t end){
+        TransformVector4Range(matrix, vectors.Pointer() + begin, result.Pointer() + begin, end - begin);
+    });
+}
+
+void MultiplyMatrices(ConstSpan<Matrix4f> left, ConstSpan<Matrix4f> right, Span<Matrix4f> result){
+    SX_CORE_ASSERT(left.Size() == right.Size() && left.Size() == result.Size(), "Math: MultiplyMatrices spans should be the same size");
+    MultiplyMatricesRange(left.Pointer(), right.Pointer(), result.Pointer(), left.Size());
+}
+
+void MultiplyMatrices(ConstSpan<Matrix4f> left, ConstSpan<Matrix4f> right, Span<Matrix4f> result, ThreadPool &pool){
+    SX_CORE_ASSERT(left.Size() == right.Size() && left.Size() == result.Size(), "Math: MultiplyMatrices spans should be the same size");
+
+    // matrices are heavier than vectors, so chunks are smaller
+    pool.ParallelFor(left.Size(), ParallelGrain / 4, [&](size_t begin, size_t end){
+        MultiplyMatricesRange(left.Pointer() + begin, right.Pointer() + begin, result.Pointer() + begin, end - begin);
+    });
+}
+
+}//namespace Math::
@@ -0,0 +1,41 @@
+#ifndef STRAITX_BATCH_TRANSFORM_HPP
+#define STRAITX_BATCH_TRANSFORM_HPP
+
+#include "core/span.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/vector4.hpp"
+#include "core/math/matrix4.hpp"
+
+class ThreadPool;
+
+namespace Math{
+
+// Batch versions of Matrix4f * Vector and Matrix4f * Matrix4f. Elements are processed four at a time
+// across SIMD lanes, the rest with scalar code. Points and vectors are bit exact with the single element operator*.
+// Result may alias the source, otherwise spans should not overlap and should be the same size.
+// ThreadPool overloads split arrays above ParallelGrain elements between the workers
+
+constexpr size_t ParallelGrain = 16 * 1024;
+
+// as if by matrix * Vector4f(point, 1), without perspective divide
+void TransformPoints(const Matrix4f &matrix, ConstSpan<Vector3f> points, Span<Vector3f> result);
+
+void TransformPoints(const Matrix4f &matrix, ConstSpan<Vector3f> points, Span<Vector3f> result, ThreadPool &pool);
+
+// as if by matrix * Vector4f(direction, 0), translation is ignored
+void TransformDirections(const Matrix4f &matrix, ConstSpan<Vector3f> directions, Span<Vector3f> result);
+
+void TransformDirections(const Matrix4f &matrix, ConstSpan<Vector3f> directions, Span<Vector3f> result, ThreadPool &pool);
+
+void TransformVectors(const Matrix4f &matrix, ConstSpan<Vector4f> vectors, Span<Vector4f> result);
+
+void TransformVectors(const Matrix4f &matrix, ConstSpan<Vector4f> vectors, Span<Vector4f> result, ThreadPool &pool);
+
+// result[i] = left[i] * right[i]
+void MultiplyMatrices(ConstSpan<Matrix4f> left, ConstSpan<Matrix4f> right, Span<Matrix4f> result);
+
+void MultiplyMatrices(ConstSpan<Matrix4f> left, ConstSpan<Matrix4f> right, Span<Matrix4f> result, ThreadPool &pool);
+
+}//namespace Math::
+
+#endif//STRAITX_BATCH_TRANSFORM_HPP
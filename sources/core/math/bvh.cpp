@@ -0,0 +1,735 @@
+#include <atomic>
+#include <float.h>
+#include "core/math/bvh.hpp"
+#include "core/math/linear.hpp"
+#include "core/os/thread_pool.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+
+using Box = Bvh::Box;
+using Node = Bvh::Node;
+
+static constexpr size_t BinsCount = 16;
+// deeper nodes are split in the middle, so the depth and traversal stack stay bounded
+static constexpr u32 MaxSahDepth = 64;
+static constexpr size_t StackSize = 128;
+static constexpr size_t ParallelBinningGrain = 16 * 1024;
+
+// Ternaries instead of Min/Max, so the packet loops turn into min/max instructions
+SX_INLINE float MinFloat(float a, float b){
+    return a < b ? a : b;
+}
+
+SX_INLINE float MaxFloat(float a, float b){
+    return a > b ? a : b;
+}
+
+SX_INLINE Box EmptyBox(){
+    return {Vector3f(FLT_MAX), Vector3f(-FLT_MAX)};
+}
+
+SX_INLINE void Grow(Box &box, const Vector3f &min, const Vector3f &max){
+    for(size_t i = 0; i < 3; i++){
+        box.Min.Data[i] = MinFloat(box.Min.Data[i], min.Data[i]);
+        box.Max.Data[i] = MaxFloat(box.Max.Data[i], max.Data[i]);
+    }
+}
+
+SX_INLINE void Grow(Box &box, const Box &other){
+    Grow(box, other.Min, other.Max);
+}
+
+SX_INLINE void Grow(Box &box, const Vector3f &point){
+    Grow(box, point, point);
+}
+
+SX_INLINE float HalfArea(const Box &box){
+    const Vector3f size = box.Max - box.Min;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+SX_INLINE Vector3f Center(const Box &box){
+    return (box.Min + box.Max) * 0.5f;
+}
+
+SX_INLINE Box ToBox(const AABB3f &box){
+    return {box.Min, box.Max};
+}
+
+namespace Details{
+
+struct BvhBuildJob{
+    u32 Node;
+    u32 Begin;
+    u32 End;
+    u32 Depth;
+    Box Bounds;
+    Box Centroids;
+};
+
+struct BvhBin{
+    Box Bounds;
+    u32 Count;
+};
+
+// Small nodes use as many bins as they have elements, so the deep levels,
+// that have most of the nodes, don't pay for initializing and sweeping all of them
+struct BvhBins{
+    u32 Count = 0;
+    BvhBin Axes[3][BinsCount];
+
+    static u32 CountFor(u32 elements){
+        return Min<u32>(BinsCount, Max<u32>(elements, 2));
+    }
+
+    void Reset(u32 count){
+        Count = count;
+        for(size_t axis = 0; axis < 3; axis++){
+            for(size_t i = 0; i < Count; i++)
+                Axes[axis][i] = {EmptyBox(), 0};
+        }
+    }
+
+    void Merge(const BvhBins &other){
+        for(size_t axis = 0; axis < 3; axis++){
+            for(size_t i = 0; i < Count; i++){
+                BvhBin &bin = Axes[axis][i];
+                const BvhBin &other_bin = other.Axes[axis][i];
+
+                Grow(bin.Bounds, other_bin.Bounds);
+                bin.Count += other_bin.Count;
+            }
+        }
+    }
+};
+
+struct BvhSplit{
+    int Axis = -1;
+    u32 BinsCount = 0;
+    u32 Bin = 0;
+    float Cost = FLT_MAX;
+    Box Left = EmptyBox();
+    Box Right = EmptyBox();
+};
+
+class BvhBuilder{
+private:
+    Span<Node> m_Nodes;
+    Span<Box> m_Boxes;
+    Span<u32> m_Indices;
+    std::atomic<u32> m_NextNode{1};
+public:
+    BvhBuilder(Span<Node> nodes, Span<Box> boxes, Span<u32> indices):
+        m_Nodes(nodes),
+        m_Boxes(boxes),
+        m_Indices(indices)
+    {}
+
+    u32 NodesCount()const{
+        return m_NextNode.load();
+    }
+
+    // Centroid to bin mapping of a node, zero scale marks axes all the centroids are at the same point of.
+    // Binning and partitioning go through the same operations, so they agree on every element
+    struct BinMapping{
+        Vector3f Origin;
+        Vector3f Scale;
+        u32 LastBin;
+
+        BinMapping(const Box &centroids, u32 bins_count):
+            Origin(centroids.Min),
+            LastBin(bins_count - 1)
+        {
+            for(size_t axis = 0; axis < 3; axis++){
+                const float extent = centroids.Max.Data[axis] - centroids.Min.Data[axis];
+                Scale.Data[axis] = extent > 0.f ? float(bins_count) * (1.f - 1e-6f) / extent : 0.f;
+            }
+        }
+
+        u32 Bin(const Vector3f &centroid, int axis)const{
+            return Min<u32>(u32((centroid.Data[axis] - Origin.Data[axis]) * Scale.Data[axis]), LastBin);
+        }
+    };
+
+    void Bin(const Box &centroids, u32 begin, u32 end, BvhBins &bins)const{
+        const BinMapping mapping(centroids, bins.Count);
+
+        for(u32 i = begin; i < end; i++){
+            const Box &box = m_Boxes[i];
+            const Vector3f centroid = Center(box);
+
+            for(int axis = 0; axis < 3; axis++){
+                BvhBin &bin = bins.Axes[axis][mapping.Bin(centroid, axis)];
+                Grow(bin.Bounds, box);
+                bin.Count++;
+            }
+        }
+    }
+
+    // cost is the sum of children areas multiplied by their sizes
+    static BvhSplit FindSplit(const Box &centroids, const BvhBins &bins){
+        BvhSplit best;
+
+        for(int axis = 0; axis < 3; axis++){
+            if(centroids.Max.Data[axis] <= centroids.Min.Data[axis])
+                continue;
+
+            const BvhBin *axis_bins = bins.Axes[axis];
+
+            float right_costs[BinsCount] = {};
+            u32 right_counts[BinsCount] = {};
+            Box right = EmptyBox();
+            u32 right_count = 0;
+            for(size_t i = bins.Count - 1; i > 0; i--){
+                Grow(right, axis_bins[i].Bounds);
+                right_count += axis_bins[i].Count;
+                right_counts[i] = right_count;
+                right_costs[i] = right_count ? HalfArea(right) * right_count : 0.f;
+            }
+
+            Box left = EmptyBox();
+            u32 left_count = 0;
+            for(size_t i = 1; i < bins.Count; i++){
+                Grow(left, axis_bins[i - 1].Bounds);
+                left_count += axis_bins[i - 1].Count;
+
+                if(!left_count || !right_counts[i])
+                    continue;
+
+                const float cost = HalfArea(left) * left_count + right_costs[i];
+                if(cost < best.Cost){
+                    best.Axis = axis;
+                    best.Bin = u32(i);
+                    best.Cost = cost;
+                }
+            }
+        }
+
+        if(best.Axis < 0)
+            return best;
+
+        best.BinsCount = bins.Count;
+        for(size_t i = 0; i < bins.Count; i++){
+            const BvhBin &bin = bins.Axes[best.Axis][i];
+            if(!bin.Count)
+                continue;
+
+            Grow(i < best.Bin ? best.Left : best.Right, bin.Bounds);
+        }
+        return best;
+    }
+
+    // Splits the job into children or makes it a leaf, returns false for a leaf
+    bool Process(const BvhBuildJob &job, const BvhSplit &split, BvhBuildJob children[2]){
+        const u32 count = job.End - job.Begin;
+        Node &node = m_Nodes[job.Node];
+        node.Min = job.Bounds.Min;
+        node.Max = job.Bounds.Max;
+
+        const bool can_split = split.Axis >= 0 && job.Depth < MaxSahDepth;
+        const float leaf_cost = HalfArea(job.Bounds) * count;
+
+        if(count == 1 || (count <= Bvh::MaxLeafSize && (!can_split || split.Cost + HalfArea(job.Bounds) >= leaf_cost))){
+            node.Index = job.Begin;
+            node.Count = count;
+            return false;
+        }
+
+        u32 middle = job.Begin;
+        if(can_split){
+            // children centroid bounds are gathered here rather than in every bin of every axis
+            const BinMapping mapping(job.Centroids, split.BinsCount);
+            Box left_centroids = EmptyBox(), right_centroids = EmptyBox();
+            u32 end = job.End;
+            while(middle < end){
+                const Vector3f centroid = Center(m_Boxes[middle]);
+                if(mapping.Bin(centroid, split.Axis) < split.Bin){
+                    Grow(left_centroids, centroid);
+                    middle++;
+                }else{
+                    Grow(right_centroids, centroid);
+                    end--;
+                    Swap(m_Boxes[middle], m_Boxes[end]);
+                    Swap(m_Indices[middle], m_Indices[end]);
+                }
+            }
+            children[0] = {0, job.Begin, middle, job.Depth + 1, split.Left, left_centroids};
+            children[1] = {0, middle, job.End, job.Depth + 1, split.Right, right_centroids};
+        }else{
+            // identical centroids or too deep, any split is as good as another
+            middle = job.Begin + count / 2;
+            children[0] = {0, job.Begin, middle, job.Depth + 1, Bounds(job.Begin, middle), Centroids(job.Begin, middle)};
+            children[1] = {0, middle, job.End, job.Depth + 1, Bounds(middle, job.End), Centroids(middle, job.End)};
+        }
+
+        const u32 first_child = m_NextNode.fetch_add(2, std::memory_order_relaxed);
+        children[0].Node = first_child;
+        children[1].Node = first_child + 1;
+
+        node.Index = first_child;
+        node.Count = 0;
+        return true;
+    }
+
+    void BuildSubtree(const BvhBuildJob &root){
+        List<BvhBuildJob> stack;
+        stack.Add(root);
+
+        while(stack.Size()){
+            const BvhBuildJob job = stack.Last();
+            stack.RemoveLast();
+
+            BvhBins bins;
+            bins.Reset(BvhBins::CountFor(job.End - job.Begin));
+            Bin(job.Centroids, job.Begin, job.End, bins);
+
+            BvhBuildJob children[2];
+            if(Process(job, FindSplit(job.Centroids, bins), children)){
+                stack.Add(children[1]);
+                stack.Add(children[0]);
+            }
+        }
+    }
+
+    Box Bounds(u32 begin, u32 end)const{
+        Box bounds = EmptyBox();
+        for(u32 i = begin; i < end; i++)
+            Grow(bounds, m_Boxes[i]);
+        return bounds;
+    }
+
+    Box Centroids(u32 begin, u32 end)const{
+        Box centroids = EmptyBox();
+        for(u32 i = begin; i < end; i++)
+            Grow(centroids, Center(m_Boxes[i]));
+        return centroids;
+    }
+};
+
+}//namespace Details::
+
+Bvh::Bvh(ConstSpan<AABB3f> boxes){
+    Build(boxes);
+}
+
+Bvh::Bvh(Bvh &&other){
+    *this = Move(other);
+}
+
+Bvh &Bvh::operator=(Bvh &&other){
+    m_Nodes = Move(other.m_Nodes);
+    m_Boxes = Move(other.m_Boxes);
+    m_Indices = Move(other.m_Indices);
+    return *this;
+}
+
+void Bvh::Build(ConstSpan<AABB3f> boxes){
+    Clear();
+    if(!boxes.Size())
+        return;
+
+    m_Boxes.Resize(boxes.Size());
+    m_Indices.Resize(boxes.Size());
+    m_Nodes.Resize(boxes.Size() * 2 - 1);
+
+    Details::BvhBuildJob root{0, 0, (u32)boxes.Size(), 0, EmptyBox(), EmptyBox()};
+    for(size_t i = 0; i < boxes.Size(); i++){
+        m_Boxes[i] = ToBox(boxes[i]);
+        m_Indices[i] = u32(i);
+        Grow(root.Bounds, m_Boxes[i]);
+        Grow(root.Centroids, Center(m_Boxes[i]));
+    }
+
+    Details::BvhBuilder builder({m_Nodes.Data(), m_Nodes.Size()}, {m_Boxes.Data(), m_Boxes.Size()}, {m_Indices.Data(), m_Indices.Size()});
+    builder.BuildSubtree(root);
+
+    m_Nodes.Resize(builder.NodesCount());
+}
+
+// Nodes above the subtree size are split one at a time with binning spread over the threads,
+// then the subtrees below them are built in parallel, each by a single thread
+void Bvh::Build(ConstSpan<AABB3f> boxes, ThreadPool &pool){
+    if(boxes.Size() < ParallelBuildThreshold || !pool.ThreadsCount()){
+        Build(boxes);
+        return;
+    }
+
+    Clear();
+    m_Boxes.Resize(boxes.Size());
+    m_Indices.Resize(boxes.Size());
+    m_Nodes.Resize(boxes.Size() * 2 - 1);
+
+    const size_t chunks = (boxes.Size() + ParallelBinningGrain - 1) / ParallelBinningGrain;
+    List<Box> chunk_bounds, chunk_centroids;
+    chunk_bounds.Resize(chunks);
+    chunk_centroids.Resize(chunks);
+
+    pool.ParallelFor(boxes.Size(), ParallelBinningGrain, [&](size_t begin, size_t end){
+        Box bounds = EmptyBox(), centroids = EmptyBox();
+        for(size_t i = begin; i < end; i++){
+            m_Boxes[i] = ToBox(boxes[i]);
+            m_Indices[i] = u32(i);
+            Grow(bounds, m_Boxes[i]);
+            Grow(centroids, Center(m_Boxes[i]));
+        }
+        chunk_bounds[begin / ParallelBinningGrain] = bounds;
+        chunk_centroids[begin / ParallelBinningGrain] = centroids;
+    });
+
+    Details::BvhBuildJob root{0, 0, (u32)boxes.Size(), 0, EmptyBox(), EmptyBox()};
+    for(size_t i = 0; i < chunks; i++){
+        Grow(root.Bounds, chunk_bounds[i]);
+        Grow(root.Centroids, chunk_centroids[i]);
+    }
+
+    Details::BvhBuilder builder({m_Nodes.Data(), m_Nodes.Size()}, {m_Boxes.Data(), m_Boxes.Size()}, {m_Indices.Data(), m_Indices.Size()});
+
+    const size_t subtree_size = Max<size_t>(boxes.Size() / (8 * (pool.ThreadsCount() + 1)), ParallelBinningGrain);
+
+    List<Details::BvhBuildJob> large_jobs, subtree_jobs;
+    large_jobs.Add(root);
+
+    List<Details::BvhBins> chunk_bins;
+    while(large_jobs.Size()){
+        const Details::BvhBuildJob job = large_jobs.Last();
+        large_jobs.RemoveLast();
+
+        if(job.End - job.Begin <= subtree_size){
+            subtree_jobs.Add(job);
+            continue;
+        }
+
+        const size_t job_chunks = (job.End - job.Begin + ParallelBinningGrain - 1) / ParallelBinningGrain;
+        chunk_bins.Clear();
+        chunk_bins.Resize(job_chunks);
+        for(Details::BvhBins &bins: chunk_bins)
+            bins.Reset(BinsCount);
+
+        pool.ParallelFor(job.End - job.Begin, ParallelBinningGrain, [&](size_t begin, size_t end){
+            builder.Bin(job.Centroids, u32(job.Begin + begin), u32(job.Begin + end), chunk_bins[begin / ParallelBinningGrain]);
+        });
+
+        for(size_t i = 1; i < job_chunks; i++)
+            chunk_bins[0].Merge(chunk_bins[i]);
+
+        Details::BvhBuildJob children[2];
+        if(builder.Process(job, builder.FindSplit(job.Centroids, chunk_bins[0]), children)){
+            large_jobs.Add(children[0]);
+            large_jobs.Add(children[1]);
+        }
+    }
+
+    pool.ParallelFor(subtree_jobs.Size(), 1, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++)
+            builder.BuildSubtree(subtree_jobs[i]);
+    });
+
+    m_Nodes.Resize(builder.NodesCount());
+}
+
+// children are always allocated after their parent, so a reverse pass sees them first
+void Bvh::Refit(ConstSpan<AABB3f> boxes){
+    SX_CORE_ASSERT(boxes.Size() == m_Boxes.Size(), "Bvh: Refit span should be the same size as the built one");
+
+    for(size_t i = 0; i < m_Boxes.Size(); i++)
+        m_Boxes[i] = ToBox(boxes[m_Indices[i]]);
+
+    for(size_t i = m_Nodes.Size(); i-- > 0;){
+        Node &node = m_Nodes[i];
+
+        Box bounds = EmptyBox();
+        if(node.Count){
+            for(u32 j = node.Index; j < node.Index + node.Count; j++)
+                Grow(bounds, m_Boxes[j]);
+        }else{
+            const Node &left = m_Nodes[node.Index];
+            const Node &right = m_Nodes[node.Index + 1];
+            bounds = {left.Min, left.Max};
+            Grow(bounds, right.Min, right.Max);
+        }
+        node.Min = bounds.Min;
+        node.Max = bounds.Max;
+    }
+}
+
+void Bvh::Clear(){
+    m_Nodes.Clear();
+    m_Boxes.Clear();
+    m_Indices.Clear();
+}
+
+struct RayData{
+    Vector3f Origin;
+    // infinite for zero direction components, slabs parallel to the ray then cut nothing or everything
+    Vector3f Inverse;
+
+    RayData(const Ray3f &ray):
+        Origin(ray.Origin()),
+        Inverse(1.f / ray.Direction().x, 1.f / ray.Direction().y, 1.f / ray.Direction().z)
+    {}
+};
+
+// Slab test, entry is clamped to zero for rays starting inside the box
+SX_INLINE bool IntersectRay(const Vector3f &min, const Vector3f &max, const RayData &ray, float max_distance, float &entry){
+    float near = 0.f, far = max_distance;
+    for(size_t i = 0; i < 3; i++){
+        const float t0 = (min.Data[i] - ray.Origin.Data[i]) * ray.Inverse.Data[i];
+        const float t1 = (max.Data[i] - ray.Origin.Data[i]) * ray.Inverse.Data[i];
+        near = MaxFloat(near, MinFloat(t0, t1));
+        far = MinFloat(far, MaxFloat(t0, t1));
+    }
+    entry = near;
+    return near <= far;
+}
+
+SX_INLINE bool Overlap(const Vector3f &min, const Vector3f &max, const AABB3f &box){
+    return min.x <= box.Max.x && max.x >= box.Min.x
+        && min.y <= box.Max.y && max.y >= box.Min.y
+        && min.z <= box.Max.z && max.z >= box.Min.z;
+}
+
+// Nearer child is visited first, the other one is stacked with its entry distance
+// and dropped once something closer has been hit
+bool Bvh::RayClosest(const Ray3f &ray, float max_distance, RayHit &hit)const{
+    hit = {InvalidIndex, max_distance};
+
+    struct StackEntry{
+        u32 Node;
+        float Entry;
+    };
+    StackEntry stack[StackSize];
+    size_t top = 0;
+
+    const RayData data(ray);
+    float entry;
+    if(!m_Nodes.Size() || !IntersectRay(m_Nodes[0].Min, m_Nodes[0].Max, data, max_distance, entry))
+        return false;
+    stack[top++] = {0, entry};
+
+    while(top){
+        const StackEntry current = stack[--top];
+        if(current.Entry > hit.Distance)
+            continue;
+
+        const Node &node = m_Nodes[current.Node];
+        if(node.Count){
+            for(u32 i = node.Index; i < node.Index + node.Count; i++){
+                const Box &box = m_Boxes[i];
+                if(IntersectRay(box.Min, box.Max, data, hit.Distance, entry) && (entry < hit.Distance || hit.Index == InvalidIndex))
+                    hit = {m_Indices[i], entry};
+            }
+            continue;
+        }
+
+        const Node &left = m_Nodes[node.Index];
+        const Node &right = m_Nodes[node.Index + 1];
+        float left_entry, right_entry;
+        const bool is_left = IntersectRay(left.Min, left.Max, data, hit.Distance, left_entry);
+        const bool is_right = IntersectRay(right.Min, right.Max, data, hit.Distance, right_entry);
+
+        if(is_left && is_right){
+            SX_CORE_ASSERT(top + 2 <= StackSize, "Bvh: traversal stack overflow");
+            if(left_entry <= right_entry){
+                stack[top++] = {node.Index + 1, right_entry};
+                stack[top++] = {node.Index, left_entry};
+            }else{
+                stack[top++] = {node.Index, left_entry};
+                stack[top++] = {node.Index + 1, right_entry};
+            }
+        }else if(is_left){
+            stack[top++] = {node.Index, left_entry};
+        }else if(is_right){
+            stack[top++] = {node.Index + 1, right_entry};
+        }
+    }
+    return hit.Index != InvalidIndex;
+}
+
+bool Bvh::RayAny(const Ray3f &ray, float max_distance)const{
+    if(!m_Nodes.Size())
+        return false;
+
+    u32 stack[StackSize];
+    size_t top = 0;
+    stack[top++] = 0;
+
+    const RayData data(ray);
+    float entry;
+    while(top){
+        const Node &node = m_Nodes[stack[--top]];
+        if(!IntersectRay(node.Min, node.Max, data, max_distance, entry))
+            continue;
+
+        if(node.Count){
+            for(u32 i = node.Index; i < node.Index + node.Count; i++){
+                if(IntersectRay(m_Boxes[i].Min, m_Boxes[i].Max, data, max_distance, entry))
+                    return true;
+            }
+            continue;
+        }
+
+        SX_CORE_ASSERT(top + 2 <= StackSize, "Bvh: traversal stack overflow");
+        stack[top++] = node.Index + 1;
+        stack[top++] = node.Index;
+    }
+    return false;
+}
+
+// Rays in structure of arrays form, lanes past the span end and finished any-hit lanes
+// have negative max distance, so they never hit anything
+struct RayPacket{
+    float Origin[3][Bvh::PacketSize];
+    float Inverse[3][Bvh::PacketSize];
+    float MaxDistance[Bvh::PacketSize];
+    u32 Index[Bvh::PacketSize];
+    // of the first ray, orders children for the whole packet
+    Vector3f Direction;
+
+    RayPacket(ConstSpan<Ray3f> rays, float max_distance){
+        for(size_t j = 0; j < Bvh::PacketSize; j++){
+            const bool is_active = j < rays.Size();
+            const RayData data(is_active ? rays[j] : rays[0]);
+
+            for(size_t i = 0; i < 3; i++){
+                Origin[i][j] = data.Origin.Data[i];
+                Inverse[i][j] = data.Inverse.Data[i];
+            }
+            MaxDistance[j] = is_active ? max_distance : -1.f;
+            Index[j] = Bvh::InvalidIndex;
+        }
+        Direction = rays[0].Direction();
+    }
+
+    // fixed size branch free loop, so all lanes are tested with a few vector instructions
+    u32 Intersect(const Vector3f &min, const Vector3f &max, float *entries)const{
+        u8 hits[Bvh::PacketSize];
+        for(size_t j = 0; j < Bvh::PacketSize; j++){
+            float near = 0.f, far = MaxDistance[j];
+            for(size_t i = 0; i < 3; i++){
+                const float t0 = (min.Data[i] - Origin[i][j]) * Inverse[i][j];
+                const float t1 = (max.Data[i] - Origin[i][j]) * Inverse[i][j];
+                near = MaxFloat(near, MinFloat(t0, t1));
+                far = MinFloat(far, MaxFloat(t0, t1));
+            }
+            entries[j] = near;
+            hits[j] = near <= far;
+        }
+
+        u32 mask = 0;
+        for(size_t j = 0; j < Bvh::PacketSize; j++)
+            mask |= u32(hits[j]) << j;
+        return mask;
+    }
+
+    bool IsFinished()const{
+        bool is_finished = true;
+        for(size_t j = 0; j < Bvh::PacketSize; j++)
+            is_finished &= MaxDistance[j] < 0.f;
+        return is_finished;
+    }
+};
+
+// Children order is decided by the first ray, that is right for coherent packets
+template<bool IsAnyHit>
+static void TraversePacket(ConstSpan<Node> nodes, ConstSpan<Box> boxes, ConstSpan<u32> indices, RayPacket &packet){
+    u32 stack[StackSize];
+    size_t top = 0;
+    stack[top++] = 0;
+
+    float entries[Bvh::PacketSize];
+    while(top){
+        const Node &node = nodes[stack[--top]];
+        if(!packet.Intersect(node.Min, node.Max, entries))
+            continue;
+
+        if(node.Count){
+            for(u32 i = node.Index; i < node.Index + node.Count; i++){
+                u32 mask = packet.Intersect(boxes[i].Min, boxes[i].Max, entries);
+
+                for(size_t j = 0; mask; j++, mask >>= 1){
+                    if(!(mask & 1))
+                        continue;
+
+                    if(IsAnyHit){
+                        packet.Index[j] = indices[i];
+                        packet.MaxDistance[j] = -1.f;
+                    }else if(entries[j] < packet.MaxDistance[j] || packet.Index[j] == Bvh::InvalidIndex){
+                        packet.Index[j] = indices[i];
+                        packet.MaxDistance[j] = entries[j];
+                    }
+                }
+            }
+            if(IsAnyHit && packet.IsFinished())
+                return;
+            continue;
+        }
+
+        const Node &left = nodes[node.Index];
+        const Node &right = nodes[node.Index + 1];
+        const Vector3f offset = (right.Min + right.Max) - (left.Min + left.Max);
+        const bool is_left_first = Dot(offset, packet.Direction) >= 0.f;
+
+        SX_CORE_ASSERT(top + 2 <= StackSize, "Bvh: traversal stack overflow");
+        stack[top++] = is_left_first ? node.Index + 1 : node.Index;
+        stack[top++] = is_left_first ? node.Index : node.Index + 1;
+    }
+}
+
+void Bvh::RayClosest(ConstSpan<Ray3f> rays, float max_distance, Span<RayHit> hits)const{
+    SX_CORE_ASSERT(rays.Size() == hits.Size(), "Bvh: RayClosest spans should be the same size");
+
+    for(size_t i = 0; i < rays.Size(); i += PacketSize){
+        const size_t count = Min(PacketSize, rays.Size() - i);
+        RayPacket packet(ConstSpan<Ray3f>(rays.Pointer() + i, count), max_distance);
+
+        if(m_Nodes.Size())
+            TraversePacket<false>(Nodes(), ConstSpan<Box>(m_Boxes.Data(), m_Boxes.Size()), ConstSpan<u32>(m_Indices.Data(), m_Indices.Size()), packet);
+
+        for(size_t j = 0; j < count; j++){
+            const bool is_hit = packet.Index[j] != InvalidIndex;
+            hits[i + j] = {packet.Index[j], is_hit ? packet.MaxDistance[j] : max_distance};
+        }
+    }
+}
+
+void Bvh::RayAny(ConstSpan<Ray3f> rays, float max_distance, Span<u8> hits)const{
+    SX_CORE_ASSERT(rays.Size() == hits.Size(), "Bvh: RayAny spans should be the same size");
+
+    for(size_t i = 0; i < rays.Size(); i += PacketSize){
+        const size_t count = Min(PacketSize, rays.Size() - i);
+        RayPacket packet(ConstSpan<Ray3f>(rays.Pointer() + i, count), max_distance);
+
+        if(m_Nodes.Size())
+            TraversePacket<true>(Nodes(), ConstSpan<Box>(m_Boxes.Data(), m_Boxes.Size()), ConstSpan<u32>(m_Indices.Data(), m_Indices.Size()), packet);
+
+        for(size_t j = 0; j < count; j++)
+            hits[i + j] = packet.Index[j] != InvalidIndex;
+    }
+}
+
+void Bvh::Overlaps(const AABB3f &box, List<u32> &indices)const{
+    if(!m_Nodes.Size())
+        return;
+
+    u32 stack[StackSize];
+    size_t top = 0;
+    stack[top++] = 0;
+
+    while(top){
+        const Node &node = m_Nodes[stack[--top]];
+        if(!Overlap(node.Min, node.Max, box))
+            continue;
+
+        if(node.Count){
+            for(u32 i = node.Index; i < node.Index + node.Count; i++){
+                if(Overlap(m_Boxes[i].Min, m_Boxes[i].Max, box))
+                    indices.Add(m_Indices[i]);
+            }
+            continue;
+        }
+
+        SX_CORE_ASSERT(top + 2 <= StackSize, "Bvh: traversal stack overflow");
+        stack[top++] = node.Index + 1;
+        stack[top++] = node.Index;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef STRAITX_BVH_HPP
+#define STRAITX_BVH_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/noncopyable.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/aabb3.hpp"
+#include "core/math/ray.hpp"
+
+class ThreadPool;
+
+struct RayHit{
+    // index of the box in the span Bvh was built from, InvalidIndex if nothing was hit
+    u32 Index;
+    // ray parameter where it enters the box, zero if it starts inside
+    float Distance;
+};
+
+// Bounding volume hierarchy over boxes, built with binned surface area heuristic.
+// Queries report indices into the span the hierarchy was built from. Rays are tested
+// against the boxes themselves, exact shapes inside them are up to the caller
+class Bvh: public NonCopyable{
+public:
+    static constexpr u32 InvalidIndex = u32(-1);
+    // rays of span queries are traversed in packets that wide
+    static constexpr size_t PacketSize = 8;
+    static constexpr u32 MaxLeafSize = 8;
+    // ThreadPool overload of Build splits work between threads above that many boxes
+    static constexpr size_t ParallelBuildThreshold = 64 * 1024;
+
+    // Count of zero means an internal node with children at Index and Index + 1,
+    // otherwise elements [Index, Index + Count) of the leaf order
+    struct Node{
+        Vector3f Min;
+        u32 Index = 0;
+        Vector3f Max;
+        u32 Count = 0;
+    };
+
+    struct Box{
+        Vector3f Min;
+        Vector3f Max;
+    };
+private:
+    List<Node> m_Nodes;
+    // boxes and their original indices in the leaf order
+    List<Box> m_Boxes;
+    List<u32> m_Indices;
+public:
+    Bvh() = default;
+
+    Bvh(ConstSpan<AABB3f> boxes);
+
+    Bvh(Bvh &&other);
+
+    Bvh &operator=(Bvh &&other);
+
+    void Build(ConstSpan<AABB3f> boxes);
+
+    void Build(ConstSpan<AABB3f> boxes, ThreadPool &pool);
+
+    // Recomputes node bounds bottom up from the moved boxes, the span should be the one
+    // the hierarchy was built from. Tree quality degrades as boxes travel, rebuild once queries slow down
+    void Refit(ConstSpan<AABB3f> boxes);
+
+    void Clear();
+
+    bool RayClosest(const Ray3f &ray, float max_distance, RayHit &hit)const;
+
+    bool RayAny(const Ray3f &ray, float max_distance)const;
+
+    // Closest hit for every ray, rays that go in similar directions, like camera or shadow rays, traverse faster
+    void RayClosest(ConstSpan<Ray3f> rays, float max_distance, Span<RayHit> hits)const;
+
+    void RayAny(ConstSpan<Ray3f> rays, float max_distance, Span<u8> hits)const;
+
+    // appends indices of the boxes that intersect the box
+    void Overlaps(const AABB3f &box, List<u32> &indices)const;
+
+    size_t Size()const;
+
+    ConstSpan<Node> Nodes()const;
+};
+
+SX_INLINE size_t Bvh::Size()const{
+    return m_Indices.Size();
+}
+
+SX_INLINE ConstSpan<Bvh::Node> Bvh::Nodes()const{
+    return ConstSpan<Node>(m_Nodes.Data(), m_Nodes.Size());
+}
+
+#endif//STRAITX_BVH_HPP
@@ -0,0 +1,95 @@
+#include "core/math/fast_math.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+
+// The tail is padded to a whole Float4 on the stack. Lanes are loaded before results are stored,
+// so results may alias arguments
+
+template<typename FunctionType>
+static void Batch(ConstSpan<float> x, Span<float> result, FunctionType function){
+    SX_CORE_ASSERT(x.Size() == result.Size(), "Math::Fast: result should be the same size as arguments");
+
+    size_t i = 0;
+    for(; i + 4 <= x.Size(); i += 4)
+        function(Float4::Load(x.Pointer() + i)).Store(result.Pointer() + i);
+
+    if(i < x.Size()){
+        float in[4] = {1.f, 1.f, 1.f, 1.f}, out[4];
+        memcpy(in, x.Pointer() + i, (x.Size() - i) * sizeof(float));
+        function(Float4::Load(in)).Store(out);
+        memcpy(result.Pointer() + i, out, (x.Size() - i) * sizeof(float));
+    }
+}
+
+template<typename FunctionType>
+static void Batch(ConstSpan<float> left, ConstSpan<float> right, Span<float> result, FunctionType function){
+    SX_CORE_ASSERT(left.Size() == result.Size() && right.Size() == result.Size(), "Math::Fast: result should be the same size as arguments");
+
+    size_t i = 0;
+    for(; i + 4 <= left.Size(); i += 4)
+        function(Float4::Load(left.Pointer() + i), Float4::Load(right.Pointer() + i)).Store(result.Pointer() + i);
+
+    if(i < left.Size()){
+        float l[4] = {1.f, 1.f, 1.f, 1.f}, r[4] = {1.f, 1.f, 1.f, 1.f}, out[4];
+        memcpy(l, left.Pointer() + i, (left.Size() - i) * sizeof(float));
+        memcpy(r, right.Pointer() + i, (left.Size() - i) * sizeof(float));
+        function(Float4::Load(l), Float4::Load(r)).Store(out);
+        memcpy(result.Pointer() + i, out, (left.Size() - i) * sizeof(float));
+    }
+}
+
+namespace Math{
+namespace Fast{
+
+void SinCos(ConstSpan<float> x, Span<float> sin, Span<float> cos){
+    SX_CORE_ASSERT(x.Size() == sin.Size() && x.Size() == cos.Size(), "Math::Fast: result should be the same size as arguments");
+
+    Float4 sin_lanes, cos_lanes;
+    size_t i = 0;
+    for(; i + 4 <= x.Size(); i += 4){
+        SinCos(Float4::Load(x.Pointer() + i), sin_lanes, cos_lanes);
+        sin_lanes.Store(sin.Pointer() + i);
+        cos_lanes.Store(cos.Pointer() + i);
+    }
+
+    if(i < x.Size()){
+        float in[4] = {}, sin_out[4], cos_out[4];
+        memcpy(in, x.Pointer() + i, (x.Size() - i) * sizeof(float));
+        SinCos(Float4::Load(in), sin_lanes, cos_lanes);
+        sin_lanes.Store(sin_out);
+        cos_lanes.Store(cos_out);
+        memcpy(sin.Pointer() + i, sin_out, (x.Size() - i) * sizeof(float));
+        memcpy(cos.Pointer() + i, cos_out, (x.Size() - i) * sizeof(float));
+    }
+}
+
+void Sin(ConstSpan<float> x, Span<float> result){
+    Batch(x, result, [](Float4 lanes){ return Sin(lanes); });
+}
+
+void Cos(ConstSpan<float> x, Span<float> result){
+    Batch(x, result, [](Float4 lanes){ return Cos(lanes); });
+}
+
+void Atan2(ConstSpan<float> y, ConstSpan<float> x, Span<float> result){
+    Batch(y, x, result, [](Float4 y_lanes, Float4 x_lanes){ return Atan2(y_lanes, x_lanes); });
+}
+
+void Exp(ConstSpan<float> x, Span<float> result){
+    Batch(x, result, [](Float4 lanes){ return Exp(lanes); });
+}
+
+void Log(ConstSpan<float> x, Span<float> result){
+    Batch(x, result, [](Float4 lanes){ return Log(lanes); });
+}
+
+void Pow(ConstSpan<float> x, ConstSpan<float> y, Span<float> result){
+    Batch(x, y, result, [](Float4 x_lanes, Float4 y_lanes){ return Pow(x_lanes, y_lanes); });
+}
+
+void Rsqrt(ConstSpan<float> x, Span<float> result){
+    Batch(x, result, [](Float4 lanes){ return Rsqrt(lanes); });
+}
+
+}//namespace Math::Fast::
+}//namespace Math::
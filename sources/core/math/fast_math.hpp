@@ -0,0 +1,430 @@
+#ifndef STRAITX_FAST_MATH_HPP
+#define STRAITX_FAST_MATH_HPP
+
+#include <cstring>
+#include <limits>
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/env/compiler.hpp"
+#include "core/math/simd.hpp"
+
+// Polynomial approximations of the libm functions for code that calls them in bulk. Errors are measured
+// against double precision libm, in units in the last place of the float result. Arguments are expected to be
+// finite, results for infinities and NaN are unspecified unless stated otherwise.
+//
+// Each function is one branch free kernel written over lanes, it runs on float for scalar and Constexpr
+// versions and on Float4 for the rest, so all of them agree bit for bit as long as the compiler
+// doesn't contract multiplies and adds into fused ones. Speed comes from Float4 and batch overloads,
+// scalar ones give matching results for odd calls but aren't faster than libm
+
+namespace Details{
+
+// Constexpr versions go through exact power of two scaling instead of bit casts,
+// they cover zero, denormals and normal numbers
+template<bool IsConstexpr>
+constexpr u32 FastToBits(float value){
+    if constexpr(!IsConstexpr){
+        u32 bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }else{
+        const u32 sign = value < 0.f ? 0x80000000u : 0u;
+        float magnitude = value < 0.f ? -value : value;
+        if(magnitude == 0.f)
+            return sign;
+
+        s32 exponent = 0;
+        while(magnitude >= 2.f){
+            magnitude *= 0.5f;
+            exponent++;
+        }
+        while(magnitude < 1.f){
+            magnitude *= 2.f;
+            exponent--;
+        }
+
+        if(exponent < -126){
+            for(s32 i = -149; i < exponent; i++)
+                magnitude *= 2.f;
+            return sign | u32(magnitude);
+        }
+        return sign | (u32(exponent + 127) << 23) | u32((magnitude - 1.f) * 8388608.f);
+    }
+}
+
+template<bool IsConstexpr>
+constexpr float FastFromBits(u32 bits){
+    if constexpr(!IsConstexpr){
+        float value = 0.f;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }else{
+        const u32 exponent = (bits >> 23) & 0xFF;
+        const u32 mantissa = bits & 0x7FFFFF;
+
+        float magnitude = 0.f;
+        if(exponent == 0xFF){
+            magnitude = mantissa ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+        }else if(exponent == 0){
+            magnitude = float(mantissa);
+            for(s32 i = 0; i < 149; i++)
+                magnitude *= 0.5f;
+        }else{
+            magnitude = 1.f + float(mantissa) / 8388608.f;
+            for(s32 i = 127; i < s32(exponent); i++)
+                magnitude *= 2.f;
+            for(s32 i = s32(exponent); i < 127; i++)
+                magnitude *= 0.5f;
+        }
+        return bits & 0x80000000u ? -magnitude : magnitude;
+    }
+}
+
+// Operations the kernels are written with. Conditions only pick operands through Select,
+// so the same kernel compiles for a single float and for Float4 lanes
+template<typename LaneType, bool IsConstexpr>
+struct FastLanes;
+
+template<bool IsConstexpr>
+struct FastLanes<float, IsConstexpr>{
+    using Int = s32;
+    using Mask = bool;
+
+    static constexpr float Splat(float value){ return value; }
+
+    static constexpr Int SplatInt(s32 value){ return value; }
+
+    static constexpr Mask Less(float left, float right){ return left < right; }
+
+    static constexpr Mask Greater(float left, float right){ return left > right; }
+
+    static constexpr Mask Equal(float left, float right){ return left == right; }
+
+    static constexpr float Select(Mask mask, float if_true, float if_false){ return mask ? if_true : if_false; }
+
+    static constexpr Int ToInt(float value){ return s32(value); }
+
+    static constexpr float ToFloat(Int value){ return float(value); }
+
+    static constexpr Int ToBits(float value){ return s32(FastToBits<IsConstexpr>(value)); }
+
+    static constexpr float FromBits(Int bits){ return FastFromBits<IsConstexpr>(u32(bits)); }
+
+    template<int Count>
+    static constexpr Int ShiftLeft(Int value){ return s32(u32(value) << Count); }
+
+    template<int Count>
+    static constexpr Int ShiftRight(Int value){ return s32(u32(value) >> Count); }
+};
+
+template<bool IsConstexpr>
+struct FastLanes<Float4, IsConstexpr>{
+    using Int = Int4;
+    using Mask = Float4;
+
+    static Float4 Splat(float value){ return Float4::Splat(value); }
+
+    static Int SplatInt(s32 value){ return Int4::Splat(value); }
+
+    static Mask Less(Float4 left, Float4 right){ return CompareLess(left, right); }
+
+    static Mask Greater(Float4 left, Float4 right){ return CompareGreater(left, right); }
+
+    static Mask Equal(Float4 left, Float4 right){ return CompareEqual(left, right); }
+
+    static Float4 Select(Mask mask, Float4 if_true, Float4 if_false){ return ::Select(mask, if_true, if_false); }
+
+    static Int ToInt(Float4 value){ return ConvertToInt4(value); }
+
+    static Float4 ToFloat(Int value){ return ConvertToFloat4(value); }
+
+    static Int ToBits(Float4 value){ return BitCastToInt4(value); }
+
+    static Float4 FromBits(Int bits){ return BitCastToFloat4(bits); }
+
+    template<int Count>
+    static Int ShiftLeft(Int value){ return ::ShiftLeft<Count>(value); }
+
+    template<int Count>
+    static Int ShiftRight(Int value){ return ::ShiftRight<Count>(value); }
+};
+
+// halves are rounded away from zero
+template<typename T, bool IsConstexpr>
+constexpr typename FastLanes<T, IsConstexpr>::Int FastRound(T value){
+    using L = FastLanes<T, IsConstexpr>;
+    return L::ToInt(value + L::Select(L::Less(value, L::Splat(0.f)), L::Splat(-0.5f), L::Splat(0.5f)));
+}
+
+template<typename T, bool IsConstexpr>
+constexpr T FastAbs(T value){
+    using L = FastLanes<T, IsConstexpr>;
+    return value * L::Select(L::Less(value, L::Splat(0.f)), L::Splat(-1.f), L::Splat(1.f));
+}
+
+// x = k * Pi / 2 + r, |r| <= Pi / 4, Pi / 2 is split into three parts so k * part stays exact while |k| < 2^13
+template<typename T, bool IsConstexpr>
+constexpr void FastSinCos(T x, T &sin, T &cos){
+    using L = FastLanes<T, IsConstexpr>;
+
+    const typename L::Int k = FastRound<T, IsConstexpr>(x * L::Splat(0.636619772f));
+    const T k_float = L::ToFloat(k);
+    const T r = ((x - k_float * L::Splat(1.5703125f)) - k_float * L::Splat(4.837512969970703125e-4f)) - k_float * L::Splat(7.54978995489188216e-8f);
+    const T z = r * r;
+
+    const T s = ((L::Splat(-1.9515295891e-4f) * z + L::Splat(8.3321608736e-3f)) * z - L::Splat(1.6666654611e-1f)) * z * r + r;
+    const T c = ((L::Splat(2.443315711809948e-5f) * z - L::Splat(1.388731625493765e-3f)) * z + L::Splat(4.166664568298827e-2f)) * z * z - L::Splat(0.5f) * z + L::Splat(1.f);
+
+    const auto is_odd = L::Equal(L::ToFloat(k & L::SplatInt(1)), L::Splat(1.f));
+    const auto is_sin_negative = L::Equal(L::ToFloat(k & L::SplatInt(2)), L::Splat(2.f));
+    const auto is_cos_negative = L::Equal(L::ToFloat((k + L::SplatInt(1)) & L::SplatInt(2)), L::Splat(2.f));
+
+    sin = L::Select(is_odd, c, s) * L::Select(is_sin_negative, L::Splat(-1.f), L::Splat(1.f));
+    cos = L::Select(is_odd, s, c) * L::Select(is_cos_negative, L::Splat(-1.f), L::Splat(1.f));
+}
+
+// Octant is folded into atan of t from [0, tan(Pi / 8)]
+template<typename T, bool IsConstexpr>
+constexpr T FastAtan2(T y, T x){
+    using L = FastLanes<T, IsConstexpr>;
+
+    const T ay = FastAbs<T, IsConstexpr>(y), ax = FastAbs<T, IsConstexpr>(x);
+    const auto is_steep = L::Greater(ay, ax);
+    const T high = L::Select(is_steep, ay, ax);
+    const T low = L::Select(is_steep, ax, ay);
+    const T a = low / L::Select(L::Greater(high, L::Splat(0.f)), high, L::Splat(1.f));
+
+    const auto is_reduced = L::Greater(a, L::Splat(0.414213562f));
+    const T t = (a - L::Select(is_reduced, L::Splat(1.f), L::Splat(0.f))) / (L::Select(is_reduced, a, L::Splat(0.f)) + L::Splat(1.f));
+    const T z = t * t;
+    const T p = (((L::Splat(8.05374449538e-2f) * z - L::Splat(1.38776856032e-1f)) * z + L::Splat(1.99777106478e-1f)) * z - L::Splat(3.33329491539e-1f)) * z * t + t;
+
+    const auto is_left = L::Less(x, L::Splat(0.f));
+    T angle = p + L::Select(is_reduced, L::Splat(0.785398163f), L::Splat(0.f));
+    angle = L::Select(is_steep, L::Splat(1.570796327f), L::Splat(0.f)) + L::Select(is_steep, L::Splat(-1.f), L::Splat(1.f)) * angle;
+    angle = L::Select(is_left, L::Splat(3.141592654f), L::Splat(0.f)) + L::Select(is_left, L::Splat(-1.f), L::Splat(1.f)) * angle;
+    return L::Select(L::Less(y, L::Splat(0.f)), L::Splat(-1.f), L::Splat(1.f)) * angle;
+}
+
+// x = n * ln(2) + r, 2^n is assembled in the exponent bits of two factors,
+// so the ends of the range, including denormal results, don't overflow the exponent
+template<typename T, bool IsConstexpr>
+constexpr T FastExp(T x){
+    using L = FastLanes<T, IsConstexpr>;
+
+    const T min = L::Splat(-103.972084f), max = L::Splat(88.7228391f);
+    const T clamped = L::Select(L::Less(x, min), min, L::Select(L::Greater(x, max), max, x));
+    const typename L::Int n = FastRound<T, IsConstexpr>(clamped * L::Splat(1.44269504088896341f));
+    const T n_float = L::ToFloat(n);
+    const T r = (clamped - n_float * L::Splat(0.693359375f)) + n_float * L::Splat(2.12194440e-4f);
+    const T z = r * r;
+
+    const T p = (((((L::Splat(1.9875691500e-4f) * r + L::Splat(1.3981999507e-3f)) * r + L::Splat(8.3334519073e-3f)) * r
+        + L::Splat(4.1665795894e-2f)) * r + L::Splat(1.6666665459e-1f)) * r + L::Splat(5.0000001201e-1f)) * z + r + L::Splat(1.f);
+
+    const typename L::Int low = L::ToInt(n_float * L::Splat(0.5f));
+    const typename L::Int high = n - low;
+    const T result = p * L::FromBits(L::template ShiftLeft<23>(low + L::SplatInt(127))) * L::FromBits(L::template ShiftLeft<23>(high + L::SplatInt(127)));
+
+    const T scale = L::Select(L::Greater(x, max), L::Splat(std::numeric_limits<float>::infinity()), L::Select(L::Less(x, min), L::Splat(0.f), L::Splat(1.f)));
+    return result * scale;
+}
+
+// x = m * 2^e with m from [sqrt(1/2), sqrt(2)], denormals are scaled up first
+template<typename T, bool IsConstexpr>
+constexpr T FastLog(T x){
+    using L = FastLanes<T, IsConstexpr>;
+
+    const auto is_denormal = L::Less(x, L::Splat(1.17549435e-38f));
+    const typename L::Int bits = L::ToBits(x * L::Select(is_denormal, L::Splat(8388608.f), L::Splat(1.f)));
+
+    T e = L::ToFloat(L::template ShiftRight<23>(bits) - L::SplatInt(127)) - L::Select(is_denormal, L::Splat(23.f), L::Splat(0.f));
+    T m = L::FromBits((bits & L::SplatInt(0x007FFFFF)) | L::SplatInt(0x3F800000));
+    const auto is_high = L::Greater(m, L::Splat(1.41421356f));
+    m = m * L::Select(is_high, L::Splat(0.5f), L::Splat(1.f));
+    e = e + L::Select(is_high, L::Splat(1.f), L::Splat(0.f));
+
+    const T t = m - L::Splat(1.f);
+    const T z = t * t;
+    const T p = ((((((((L::Splat(7.0376836292e-2f) * t - L::Splat(1.1514610310e-1f)) * t + L::Splat(1.1676998740e-1f)) * t
+        - L::Splat(1.2420140846e-1f)) * t + L::Splat(1.4249322787e-1f)) * t - L::Splat(1.6668057665e-1f)) * t
+        + L::Splat(2.0000714765e-1f)) * t - L::Splat(2.4999993993e-1f)) * t + L::Splat(3.3333331174e-1f)) * t * z;
+    const T result = t + ((p - e * L::Splat(2.12194440e-4f)) - L::Splat(0.5f) * z) + e * L::Splat(0.693359375f);
+
+    // result is finite for any bits, so special values are added to it
+    const T special = L::Select(L::Less(x, L::Splat(0.f)), L::Splat(std::numeric_limits<float>::quiet_NaN()),
+        L::Select(L::Equal(x, L::Splat(0.f)), L::Splat(-std::numeric_limits<float>::infinity()),
+        L::Select(L::Greater(x, L::Splat(3.40282347e+38f)), L::Splat(std::numeric_limits<float>::infinity()), L::Splat(0.f))));
+    return result + special;
+}
+
+template<typename T, bool IsConstexpr>
+constexpr T FastPow(T x, T y){
+    using L = FastLanes<T, IsConstexpr>;
+
+    const T log = FastLog<T, IsConstexpr>(x);
+    return FastExp<T, IsConstexpr>(y * L::Select(L::Equal(y, L::Splat(0.f)), L::Splat(0.f), log));
+}
+
+// Exponent halving guess is off by up to 3.5%, Newton steps square that, so it takes three of them
+template<typename T, bool IsConstexpr>
+constexpr T FastRsqrt(T x){
+    using L = FastLanes<T, IsConstexpr>;
+
+    T y = L::FromBits(L::SplatInt(0x5F375A86) - L::template ShiftRight<1>(L::ToBits(x)));
+    const T half = x * L::Splat(0.5f);
+    y = y * (L::Splat(1.5f) - half * y * y);
+    y = y * (L::Splat(1.5f) - half * y * y);
+    y = y * (L::Splat(1.5f) - half * y * y);
+    return y;
+}
+
+}//namespace Details::
+
+namespace Math{
+namespace Fast{
+
+// |x| <= 8192, absolute error below 8e-8 and within 2 ulp for results above 0.01 in magnitude
+
+SX_INLINE void SinCos(float x, float &sin, float &cos){
+    Details::FastSinCos<float, false>(x, sin, cos);
+}
+
+SX_INLINE float Sin(float x){
+    float sin = 0.f, cos = 0.f;
+    Details::FastSinCos<float, false>(x, sin, cos);
+    return sin;
+}
+
+SX_INLINE float Cos(float x){
+    float sin = 0.f, cos = 0.f;
+    Details::FastSinCos<float, false>(x, sin, cos);
+    return cos;
+}
+
+// within 3 ulp, Atan2(0, 0) is 0
+SX_INLINE float Atan2(float y, float x){
+    return Details::FastAtan2<float, false>(y, x);
+}
+
+// within 1 ulp, overflows to infinity above 88.72 and flushes to zero below -103.97
+SX_INLINE float Exp(float x){
+    return Details::FastExp<float, false>(x);
+}
+
+// within 1 ulp, NaN for negative x and -infinity for zero
+SX_INLINE float Log(float x){
+    return Details::FastLog<float, false>(x);
+}
+
+// Exp(y * Log(x)), so error grows with |y * Log(x)|: within 2 ulp while it is below 1, within 128 ulp up to 80.
+// x should be positive, Pow(x, 0) is 1
+SX_INLINE float Pow(float x, float y){
+    return Details::FastPow<float, false>(x, y);
+}
+
+// within 3 ulp for positive normal x
+SX_INLINE float Rsqrt(float x){
+    return Details::FastRsqrt<float, false>(x);
+}
+
+SX_INLINE void SinCos(Float4 x, Float4 &sin, Float4 &cos){
+    Details::FastSinCos<Float4, false>(x, sin, cos);
+}
+
+SX_INLINE Float4 Sin(Float4 x){
+    Float4 sin, cos;
+    Details::FastSinCos<Float4, false>(x, sin, cos);
+    return sin;
+}
+
+SX_INLINE Float4 Cos(Float4 x){
+    Float4 sin, cos;
+    Details::FastSinCos<Float4, false>(x, sin, cos);
+    return cos;
+}
+
+SX_INLINE Float4 Atan2(Float4 y, Float4 x){
+    return Details::FastAtan2<Float4, false>(y, x);
+}
+
+SX_INLINE Float4 Exp(Float4 x){
+    return Details::FastExp<Float4, false>(x);
+}
+
+SX_INLINE Float4 Log(Float4 x){
+    return Details::FastLog<Float4, false>(x);
+}
+
+SX_INLINE Float4 Pow(Float4 x, Float4 y){
+    return Details::FastPow<Float4, false>(x, y);
+}
+
+SX_INLINE Float4 Rsqrt(Float4 x){
+    return Details::FastRsqrt<Float4, false>(x);
+}
+
+// Results should be the same size as arguments and may alias them
+
+void SinCos(ConstSpan<float> x, Span<float> sin, Span<float> cos);
+
+void Sin(ConstSpan<float> x, Span<float> result);
+
+void Cos(ConstSpan<float> x, Span<float> result);
+
+void Atan2(ConstSpan<float> y, ConstSpan<float> x, Span<float> result);
+
+void Exp(ConstSpan<float> x, Span<float> result);
+
+void Log(ConstSpan<float> x, Span<float> result);
+
+void Pow(ConstSpan<float> x, ConstSpan<float> y, Span<float> result);
+
+void Rsqrt(ConstSpan<float> x, Span<float> result);
+
+// Usable in constant expressions, e.g. to build lookup tables at compile time.
+// Exact scaling loops make them slow at run time, use the ones above there
+namespace Constexpr{
+
+constexpr void SinCos(float x, float &sin, float &cos){
+    Details::FastSinCos<float, true>(x, sin, cos);
+}
+
+constexpr float Sin(float x){
+    float sin = 0.f, cos = 0.f;
+    Details::FastSinCos<float, true>(x, sin, cos);
+    return sin;
+}
+
+constexpr float Cos(float x){
+    float sin = 0.f, cos = 0.f;
+    Details::FastSinCos<float, true>(x, sin, cos);
+    return cos;
+}
+
+constexpr float Atan2(float y, float x){
+    return Details::FastAtan2<float, true>(y, x);
+}
+
+constexpr float Exp(float x){
+    return Details::FastExp<float, true>(x);
+}
+
+constexpr float Log(float x){
+    return Details::FastLog<float, true>(x);
+}
+
+constexpr float Pow(float x, float y){
+    return Details::FastPow<float, true>(x, y);
+}
+
+constexpr float Rsqrt(float x){
+    return Details::FastRsqrt<float, true>(x);
+}
+
+}//namespace Math::Fast::Constexpr::
+
+}//namespace Math::Fast::
+}//namespace Math::
+
+#endif//STRAITX_FAST_MATH_HPP
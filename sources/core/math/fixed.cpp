@@ -0,0 +1,153 @@
+#include "core/math/fixed.hpp"
+
+// Tables hold Q30 values for 1024 even steps of the argument, plus one entry past the end
+// so the last step interpolates without a check. They are built on first use with integer
+// arithmetic only, so they come out the same on every machine
+static constexpr int TableBits = 10;
+static constexpr int TableSize = (1 << TableBits) + 2;
+// Q62 arguments and series, more than enough bits to round table entries correctly
+static constexpr u64 PiOver2Q62 = 7244019458077122842ull;
+static constexpr u64 OneQ62 = u64(1) << 62;
+static constexpr s64 PiOver2Q30 = 1686629713;
+static constexpr s64 PiQ30 = 3373259426;
+// 2 / Pi in Q63
+static constexpr s64 TwoOverPiQ63 = 0x517CC1B727220A95;
+
+static u64 MultiplyQ62(u64 left, u64 right){
+    const Details::FixedUInt128 product = Details::FixedMultiplyWide(left, right);
+    return (product.High << 2) | (product.Low >> 62);
+}
+
+static u64 DivideQ62(u64 left, u64 right){
+    return Details::FixedDivideWide({left >> 2, left << 62}, right);
+}
+
+static s32 RoundToQ30(u64 value){
+    return s32((value + (u64(1) << 31)) >> 32);
+}
+
+// Taylor series of sin(x) for x from [0, Pi / 2]
+static u64 SinQ62(u64 x){
+    const u64 square = MultiplyQ62(x, x);
+    u64 sum = x, term = x;
+    for(u64 i = 2; term; i += 2){
+        term = MultiplyQ62(term, square) / (i * (i + 1));
+        sum = (i / 2) % 2 ? sum - term : sum + term;
+    }
+    return sum;
+}
+
+// Two argument halvings, atan(x) = 2 * atan(x / (1 + sqrt(1 + x^2))), bring x from [0, 1]
+// below tan(Pi / 16), where Taylor series converges in a dozen terms
+static u64 AtanQ62(u64 x){
+    for(int i = 0; i < 2; i++){
+        const u64 root = Details::FixedSqrt(Details::FixedMultiplyWide(OneQ62 + MultiplyQ62(x, x), OneQ62));
+        x = DivideQ62(x, OneQ62 + root);
+    }
+
+    const u64 square = MultiplyQ62(x, x);
+    u64 sum = x, power = x;
+    for(u64 i = 3; power; i += 2){
+        power = MultiplyQ62(power, square);
+        sum = (i / 2) % 2 ? sum - power / i : sum + power / i;
+    }
+    return sum * 4;
+}
+
+struct FixedTables{
+    s32 Sin[TableSize];
+    s32 Atan[TableSize];
+
+    FixedTables(){
+        for(int i = 0; i < TableSize - 1; i++){
+            Sin[i] = RoundToQ30(SinQ62(PiOver2Q62 / (1 << TableBits) * u64(i)));
+            Atan[i] = RoundToQ30(AtanQ62(u64(i) << (62 - TableBits)));
+        }
+        Sin[TableSize - 1] = Sin[TableSize - 2];
+        Atan[TableSize - 1] = Atan[TableSize - 2];
+    }
+};
+
+static const FixedTables &Tables(){
+    static const FixedTables tables;
+    return tables;
+}
+
+// argument is a Q32 fraction of the table range, from [0, 1]
+static s64 Interpolate(const s32 *table, u64 argument){
+    constexpr int StepBits = 32 - TableBits;
+
+    const u64 index = argument >> StepBits;
+    const s64 step = s64(argument & ((u64(1) << StepBits) - 1));
+    return table[index] + ((s64(table[index + 1] - table[index]) * step + (s64(1) << (StepBits - 1))) >> StepBits);
+}
+
+// quarter turns in Q32, only the lowest 34 bits matter
+static u64 QuarterTurns(s64 radians, int frac_bits){
+    Details::FixedUInt128 product = Details::FixedMultiplyWide(Details::FixedMagnitude(radians), u64(TwoOverPiQ63));
+    if(radians < 0)
+        product = {~product.High + (product.Low == 0), 0 - product.Low};
+
+    const int shift = frac_bits + 31;
+    return shift >= 64 ? product.High >> (shift - 64) : (product.Low >> shift) | (product.High << (64 - shift));
+}
+
+static s64 SinQuarterTurns(u64 turns){
+    const u64 quadrant = (turns >> 32) & 3;
+    const u64 fraction = turns & 0xFFFFFFFF;
+
+    const s64 value = Interpolate(Tables().Sin, quadrant & 1 ? (u64(1) << 32) - fraction : fraction);
+    return quadrant & 2 ? -value : value;
+}
+
+namespace Details{
+
+s64 FixedSin(s64 radians, int frac_bits){
+    return SinQuarterTurns(QuarterTurns(radians, frac_bits));
+}
+
+s64 FixedCos(s64 radians, int frac_bits){
+    return SinQuarterTurns(QuarterTurns(radians, frac_bits) + (u64(1) << 32));
+}
+
+s64 FixedAtan2(s64 y, s64 x){
+    u64 high = FixedMagnitude(x), low = FixedMagnitude(y);
+    const bool is_steep = low > high;
+    if(is_steep){
+        const u64 temp = high;
+        high = low;
+        low = temp;
+    }
+    if(high == 0)
+        return 0;
+
+    while(high >> 32){
+        high >>= 1;
+        low >>= 1;
+    }
+
+    s64 angle = Interpolate(Tables().Atan, (low << 32) / high);
+    if(is_steep)
+        angle = PiOver2Q30 - angle;
+    if(x < 0)
+        angle = PiQ30 - angle;
+    return y < 0 ? -angle : angle;
+}
+
+u64 FixedSqrt(FixedUInt128 value){
+    u64 root = 0;
+    for(int bit = 63; bit >= 0; bit--){
+        const u64 candidate = root | (u64(1) << bit);
+        const FixedUInt128 square = FixedMultiplyWide(candidate, candidate);
+        if(square.High < value.High || (square.High == value.High && square.Low <= value.Low))
+            root = candidate;
+    }
+
+    // root + 1/2 squared is root^2 + root + 1/4, so rounding up takes value - root^2 > root
+    const FixedUInt128 square = FixedMultiplyWide(root, root);
+    const u64 remainder = value.Low - square.Low;
+    const u64 remainder_high = value.High - square.High - (value.Low < square.Low);
+    return remainder_high || remainder > root ? root + 1 : root;
+}
+
+}//namespace Details::
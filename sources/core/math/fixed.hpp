@@ -0,0 +1,452 @@
+#ifndef STRAITX_FIXED_HPP
+#define STRAITX_FIXED_HPP
+
+#include "core/types.hpp"
+#include "core/assert.hpp"
+#include "core/printer.hpp"
+#include "core/env/compiler.hpp"
+#include "core/math/functions.hpp"
+
+#if defined(SX_COMPILER_GCC) || defined(SX_COMPILER_CLANG)
+    #define SX_FIXED_INT128
+#endif
+
+namespace Details{
+
+template<int BitsValue>
+struct FixedStorage;
+
+template<>
+struct FixedStorage<32>{
+    using Raw = s32;
+    using Unsigned = u32;
+};
+
+template<>
+struct FixedStorage<64>{
+    using Raw = s64;
+    using Unsigned = u64;
+};
+
+// Unsigned 128 bit intermediate for compilers without a native one
+struct FixedUInt128{
+    u64 High;
+    u64 Low;
+};
+
+constexpr FixedUInt128 FixedMultiplyWide(u64 left, u64 right){
+    const u64 left_low = left & 0xFFFFFFFF, left_high = left >> 32;
+    const u64 right_low = right & 0xFFFFFFFF, right_high = right >> 32;
+
+    const u64 low = left_low * right_low;
+    const u64 middle_first = left_high * right_low + (low >> 32);
+    const u64 middle_second = left_low * right_high + (middle_first & 0xFFFFFFFF);
+
+    return {left_high * right_high + (middle_first >> 32) + (middle_second >> 32), (middle_second << 32) | (low & 0xFFFFFFFF)};
+}
+
+// quotient should fit in 64 bits
+constexpr u64 FixedDivideWide(FixedUInt128 dividend, u64 divisor){
+    u64 remainder = 0, quotient = 0;
+    for(int i = 127; i >= 0; i--){
+        const u64 bit = i >= 64 ? (dividend.High >> (i - 64)) & 1 : (dividend.Low >> i) & 1;
+        const bool is_carry = remainder >> 63;
+        remainder = (remainder << 1) | bit;
+        if(is_carry || remainder >= divisor){
+            remainder -= divisor;
+            if(i < 64)
+                quotient |= u64(1) << i;
+        }
+    }
+    return quotient;
+}
+
+constexpr u64 FixedMagnitude(s64 value){
+    return value < 0 ? 0 - u64(value) : u64(value);
+}
+
+// Product rounded to nearest, wrapped to the storage. Overflow is reported, not prevented
+constexpr s32 FixedMultiply(s32 left, s32 right, int frac_bits, bool &is_overflow){
+    const s64 product = (s64(left) * right + (s64(1) << (frac_bits - 1))) >> frac_bits;
+    is_overflow = product < s64(-0x7FFFFFFF - 1) || product > s64(0x7FFFFFFF);
+    return s32(u32(u64(product)));
+}
+
+constexpr s64 FixedMultiply(s64 left, s64 right, int frac_bits, bool &is_overflow){
+#ifdef SX_FIXED_INT128
+    const __int128 product = (__int128(left) * right + (__int128(1) << (frac_bits - 1))) >> frac_bits;
+    is_overflow = product < __int128(-0x7FFFFFFFFFFFFFFFll - 1) || product > __int128(0x7FFFFFFFFFFFFFFFll);
+    return s64(u64(product));
+#else
+    // two's complement product, then the same rounding shift as above
+    FixedUInt128 product = FixedMultiplyWide(FixedMagnitude(left), FixedMagnitude(right));
+    if((left < 0) != (right < 0))
+        product = {~product.High + (product.Low == 0), 0 - product.Low};
+
+    const u64 half = u64(1) << (frac_bits - 1);
+    product.High += product.Low + half < product.Low;
+    product.Low += half;
+
+    const u64 low = (product.Low >> frac_bits) | (product.High << (64 - frac_bits));
+    const u64 high = u64(s64(product.High) >> frac_bits);
+    is_overflow = high != (low >> 63 ? ~u64(0) : 0);
+    return s64(low);
+#endif
+}
+
+// Quotient rounded toward zero
+constexpr s32 FixedDivide(s32 left, s32 right, int frac_bits, bool &is_overflow){
+    const s64 quotient = s64(left) * (s64(1) << frac_bits) / right;
+    is_overflow = quotient < s64(-0x7FFFFFFF - 1) || quotient > s64(0x7FFFFFFF);
+    return s32(u32(u64(quotient)));
+}
+
+constexpr s64 FixedDivide(s64 left, s64 right, int frac_bits, bool &is_overflow){
+#ifdef SX_FIXED_INT128
+    const __int128 quotient = __int128(left) * (__int128(1) << frac_bits) / right;
+    is_overflow = quotient < __int128(-0x7FFFFFFFFFFFFFFFll - 1) || quotient > __int128(0x7FFFFFFFFFFFFFFFll);
+    return s64(u64(quotient));
+#else
+    const u64 divisor = FixedMagnitude(right);
+    const u64 dividend = FixedMagnitude(left);
+    const FixedUInt128 shifted = {dividend >> (64 - frac_bits), dividend << frac_bits};
+    const bool is_negative = (left < 0) != (right < 0);
+
+    // long division by 64 bit digits, the high digit of the quotient only matters for overflow,
+    // the low one is what the native version wraps to
+    const u64 quotient_high = shifted.High / divisor;
+    const u64 magnitude = FixedDivideWide({shifted.High % divisor, shifted.Low}, divisor);
+    is_overflow = quotient_high || magnitude > (is_negative ? u64(1) << 63 : (u64(1) << 63) - 1);
+    return s64(is_negative ? 0 - magnitude : magnitude);
+#endif
+}
+
+// Trigonometry works in Q30, 30 fractional bits, for fixed point numbers of any format.
+// Implemented with integer arithmetic only
+
+s64 FixedSin(s64 radians, int frac_bits);
+
+s64 FixedCos(s64 radians, int frac_bits);
+
+s64 FixedAtan2(s64 y, s64 x);
+
+// square root of (High, Low) rounded to nearest
+u64 FixedSqrt(FixedUInt128 value);
+
+}//namespace Details::
+
+// Signed binary fixed point number with IntBits integer bits, sign included, and FracBits fractional ones,
+// they should add up to 32 or 64. Results depend only on integer arithmetic, so they are the same on every
+// machine and compiler, that is what lockstep simulation needs.
+//
+// Operators wrap around on overflow, like integers do, Math::Saturating* functions clamp instead.
+// Products are rounded to nearest, quotients toward zero
+template<int IntBits, int FracBits>
+class Fixed{
+    static_assert(IntBits + FracBits == 32 || IntBits + FracBits == 64, "Fixed: IntBits and FracBits should add up to 32 or 64");
+    static_assert(IntBits >= 2 && FracBits >= 1, "Fixed: there should be at least 2 integer bits and 1 fractional bit");
+public:
+    using RawType = typename Details::FixedStorage<IntBits + FracBits>::Raw;
+    using UnsignedType = typename Details::FixedStorage<IntBits + FracBits>::Unsigned;
+
+    static constexpr int IntegerBits = IntBits;
+    static constexpr int FractionalBits = FracBits;
+private:
+    static constexpr RawType RawOne = RawType(1) << FracBits;
+
+    RawType m_Raw;
+
+    static constexpr RawType RawFromDouble(double value);
+public:
+    Fixed() = default;
+
+    constexpr Fixed(int value);
+
+    explicit constexpr Fixed(float value);
+
+    explicit constexpr Fixed(double value);
+
+    static constexpr Fixed FromRaw(RawType raw);
+
+    static constexpr Fixed Max();
+
+    static constexpr Fixed Min();
+    // the smallest positive value
+    static constexpr Fixed Epsilon();
+
+    constexpr RawType Raw()const;
+    // rounds toward negative infinity
+    constexpr RawType ToInt()const;
+
+    constexpr float ToFloat()const;
+
+    constexpr double ToDouble()const;
+
+    explicit constexpr operator bool()const;
+
+    constexpr Fixed &operator+=(Fixed other);
+
+    constexpr Fixed &operator-=(Fixed other);
+
+    constexpr Fixed &operator*=(Fixed other);
+
+    constexpr Fixed &operator/=(Fixed other);
+
+    friend constexpr Fixed operator-(Fixed value){
+        return FromRaw(RawType(UnsignedType(0) - UnsignedType(value.m_Raw)));
+    }
+
+    friend constexpr Fixed operator+(Fixed left, Fixed right){
+        return FromRaw(RawType(UnsignedType(left.m_Raw) + UnsignedType(right.m_Raw)));
+    }
+
+    friend constexpr Fixed operator-(Fixed left, Fixed right){
+        return FromRaw(RawType(UnsignedType(left.m_Raw) - UnsignedType(right.m_Raw)));
+    }
+
+    friend constexpr Fixed operator*(Fixed left, Fixed right){
+        bool is_overflow = false;
+        return FromRaw(Details::FixedMultiply(left.m_Raw, right.m_Raw, FracBits, is_overflow));
+    }
+
+    friend constexpr Fixed operator/(Fixed left, Fixed right){
+        SX_CORE_ASSERT(right.m_Raw != 0, "Fixed: division by zero");
+        bool is_overflow = false;
+        return FromRaw(Details::FixedDivide(left.m_Raw, right.m_Raw, FracBits, is_overflow));
+    }
+
+    friend constexpr bool operator==(Fixed left, Fixed right){ return left.m_Raw == right.m_Raw; }
+
+    friend constexpr bool operator!=(Fixed left, Fixed right){ return left.m_Raw != right.m_Raw; }
+
+    friend constexpr bool operator<(Fixed left, Fixed right){ return left.m_Raw < right.m_Raw; }
+
+    friend constexpr bool operator>(Fixed left, Fixed right){ return left.m_Raw > right.m_Raw; }
+
+    friend constexpr bool operator<=(Fixed left, Fixed right){ return left.m_Raw <= right.m_Raw; }
+
+    friend constexpr bool operator>=(Fixed left, Fixed right){ return left.m_Raw >= right.m_Raw; }
+};
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits>::Fixed(int value):
+    m_Raw(RawType(UnsignedType(RawType(value)) << FracBits))
+{}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits>::Fixed(float value):
+    Fixed(double(value))
+{}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits>::Fixed(double value):
+    m_Raw(RawFromDouble(value))
+{}
+
+// Conversion of a double that doesn't fit the integer type is undefined, so the value is clamped
+// to the range first, NaN becomes zero. Rounding can take values within half an lsb of Max() out of range
+template<int IntBits, int FracBits>
+constexpr typename Fixed<IntBits, FracBits>::RawType Fixed<IntBits, FracBits>::RawFromDouble(double value){
+    SX_CORE_ASSERT(value >= Min().ToDouble() && value <= Max().ToDouble(), "Fixed: value is out of range");
+
+    // -Limit is the raw minimum and exact in a double, Limit is the first raw value that doesn't fit
+    constexpr double Limit = double(UnsignedType(1) << (IntBits + FracBits - 1));
+
+    const double raw = value * double(RawOne) + (value < 0 ? -0.5 : 0.5);
+    if(raw != raw)
+        return 0;
+    if(raw >= Limit)
+        return Max().m_Raw;
+    if(raw <= -Limit)
+        return Min().m_Raw;
+    return RawType(raw);
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> Fixed<IntBits, FracBits>::FromRaw(RawType raw){
+    Fixed result{};
+    result.m_Raw = raw;
+    return result;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> Fixed<IntBits, FracBits>::Max(){
+    return FromRaw(RawType(UnsignedType(-1) >> 1));
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> Fixed<IntBits, FracBits>::Min(){
+    return FromRaw(RawType(~(UnsignedType(-1) >> 1)));
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> Fixed<IntBits, FracBits>::Epsilon(){
+    return FromRaw(1);
+}
+
+template<int IntBits, int FracBits>
+constexpr typename Fixed<IntBits, FracBits>::RawType Fixed<IntBits, FracBits>::Raw()const{
+    return m_Raw;
+}
+
+template<int IntBits, int FracBits>
+constexpr typename Fixed<IntBits, FracBits>::RawType Fixed<IntBits, FracBits>::ToInt()const{
+    return m_Raw >> FracBits;
+}
+
+template<int IntBits, int FracBits>
+constexpr float Fixed<IntBits, FracBits>::ToFloat()const{
+    return float(ToDouble());
+}
+
+template<int IntBits, int FracBits>
+constexpr double Fixed<IntBits, FracBits>::ToDouble()const{
+    return double(m_Raw) / double(RawOne);
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits>::operator bool()const{
+    return m_Raw != 0;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> &Fixed<IntBits, FracBits>::operator+=(Fixed other){
+    return *this = *this + other;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> &Fixed<IntBits, FracBits>::operator-=(Fixed other){
+    return *this = *this - other;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> &Fixed<IntBits, FracBits>::operator*=(Fixed other){
+    return *this = *this * other;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> &Fixed<IntBits, FracBits>::operator/=(Fixed other){
+    return *this = *this / other;
+}
+
+using Fixed32 = Fixed<16, 16>;
+using Fixed64 = Fixed<32, 32>;
+
+namespace Details{
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> FixedFromQ30(s64 value){
+    using RawType = typename Fixed<IntBits, FracBits>::RawType;
+
+    if constexpr(FracBits >= 30)
+        return Fixed<IntBits, FracBits>::FromRaw(RawType(value * (s64(1) << (FracBits - 30))));
+    else
+        return Fixed<IntBits, FracBits>::FromRaw(RawType((value + (s64(1) << (29 - FracBits))) >> (30 - FracBits)));
+}
+
+}//namespace Details::
+
+namespace Math{
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> SaturatingAdd(Fixed<IntBits, FracBits> left, Fixed<IntBits, FracBits> right){
+    const Fixed<IntBits, FracBits> sum = left + right;
+    if((left.Raw() < 0) == (right.Raw() < 0) && (sum.Raw() < 0) != (left.Raw() < 0))
+        return left.Raw() < 0 ? Fixed<IntBits, FracBits>::Min() : Fixed<IntBits, FracBits>::Max();
+    return sum;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> SaturatingSub(Fixed<IntBits, FracBits> left, Fixed<IntBits, FracBits> right){
+    const Fixed<IntBits, FracBits> difference = left - right;
+    if((left.Raw() < 0) != (right.Raw() < 0) && (difference.Raw() < 0) != (left.Raw() < 0))
+        return left.Raw() < 0 ? Fixed<IntBits, FracBits>::Min() : Fixed<IntBits, FracBits>::Max();
+    return difference;
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> SaturatingMul(Fixed<IntBits, FracBits> left, Fixed<IntBits, FracBits> right){
+    bool is_overflow = false;
+    const auto product = Details::FixedMultiply(left.Raw(), right.Raw(), FracBits, is_overflow);
+    if(is_overflow)
+        return (left.Raw() < 0) != (right.Raw() < 0) ? Fixed<IntBits, FracBits>::Min() : Fixed<IntBits, FracBits>::Max();
+    return Fixed<IntBits, FracBits>::FromRaw(product);
+}
+
+// division by zero saturates toward the sign of the dividend, zero by zero is zero
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> SaturatingDiv(Fixed<IntBits, FracBits> left, Fixed<IntBits, FracBits> right){
+    if(right.Raw() == 0)
+        return left.Raw() < 0 ? Fixed<IntBits, FracBits>::Min() : (left.Raw() > 0 ? Fixed<IntBits, FracBits>::Max() : left);
+
+    bool is_overflow = false;
+    const auto quotient = Details::FixedDivide(left.Raw(), right.Raw(), FracBits, is_overflow);
+    if(is_overflow)
+        return (left.Raw() < 0) != (right.Raw() < 0) ? Fixed<IntBits, FracBits>::Min() : Fixed<IntBits, FracBits>::Max();
+    return Fixed<IntBits, FracBits>::FromRaw(quotient);
+}
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> Abs(Fixed<IntBits, FracBits> value){
+    return value.Raw() < 0 ? -value : value;
+}
+
+// Sin and Cos interpolate a 1024 entry quarter wave table, absolute error is within 3e-7
+// on top of the format's own resolution. Angles are reduced modulo Pi / 2 exactly
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Sin(Fixed<IntBits, FracBits> radians){
+    return Details::FixedFromQ30<IntBits, FracBits>(Details::FixedSin(radians.Raw(), FracBits));
+}
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Cos(Fixed<IntBits, FracBits> radians){
+    return Details::FixedFromQ30<IntBits, FracBits>(Details::FixedCos(radians.Raw(), FracBits));
+}
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Tan(Fixed<IntBits, FracBits> radians){
+    return Sin(radians) / Cos(radians);
+}
+
+// Atan2 interpolates a 1024 entry table of atan over [0, 1], absolute error is within 1e-7.
+// Results up to Pi need at least 3 integer bits
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Atan2(Fixed<IntBits, FracBits> y, Fixed<IntBits, FracBits> x){
+    static_assert(IntBits >= 3, "Fixed: Atan2 results need at least 3 integer bits");
+    return Details::FixedFromQ30<IntBits, FracBits>(Details::FixedAtan2(y.Raw(), x.Raw()));
+}
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Atan(Fixed<IntBits, FracBits> value){
+    return Atan2(value, Fixed<IntBits, FracBits>(1));
+}
+
+// exact to the last bit, rounded to nearest
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Sqrt(Fixed<IntBits, FracBits> value){
+    SX_CORE_ASSERT(value.Raw() >= 0, "Fixed: Sqrt of a negative number");
+    const u64 raw = u64(value.Raw() < 0 ? 0 : value.Raw());
+    return Fixed<IntBits, FracBits>::FromRaw(typename Fixed<IntBits, FracBits>::RawType(Details::FixedSqrt({raw >> (64 - FracBits), raw << FracBits})));
+}
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Asin(Fixed<IntBits, FracBits> value){
+    return Atan2(value, Sqrt(Fixed<IntBits, FracBits>(1) - value * value));
+}
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Acos(Fixed<IntBits, FracBits> value){
+    return Atan2(Sqrt(Fixed<IntBits, FracBits>(1) - value * value), value);
+}
+
+}//namespace Math::
+
+template<int IntBits, int FracBits>
+struct Printer<Fixed<IntBits, FracBits>>{
+    static void Print(const Fixed<IntBits, FracBits> &value, StringWriter &writer){
+        Printer<double>::Print(value.ToDouble(), writer);
+    }
+};
+
+#endif//STRAITX_FIXED_HPP
@@ -0,0 +1,232 @@
+#include <cstring>
+#include "core/math/frustum.hpp"
+#include "core/math/functions.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+
+// Boxes are tested in center and extent form, box is outside of a plane when
+// SignedDistance(center) + Dot(Abs(Normal), extent) < 0. Scalar tests use the same operations
+// in the same order, so they agree with the batch ones on every element
+
+static Plane MakePlane(const Vector4f &coefficients){
+    const float length = coefficients.XYZ().Length();
+    return {coefficients.XYZ() / length, coefficients.w / length};
+}
+
+Frustum::Frustum(const Matrix4f &view_projection, ClipDepth depth){
+    const Vector4f &row0 = view_projection.Rows[0];
+    const Vector4f &row1 = view_projection.Rows[1];
+    const Vector4f &row2 = view_projection.Rows[2];
+    const Vector4f &row3 = view_projection.Rows[3];
+
+    Planes[Left]   = MakePlane(row3 + row0);
+    Planes[Right]  = MakePlane(row3 - row0);
+    Planes[Bottom] = MakePlane(row3 + row1);
+    Planes[Top]    = MakePlane(row3 - row1);
+    Planes[Near]   = MakePlane(depth == ClipDepth::ZeroToOne ? row2 : row3 + row2);
+    Planes[Far]    = MakePlane(row3 - row2);
+}
+
+bool Frustum::Intersects(const AABB3f &box)const{
+    const Vector3f center = (box.Min + box.Max) * 0.5f;
+    const Vector3f extent = (box.Max - box.Min) * 0.5f;
+
+    for(const Plane &plane: Planes){
+        const float distance = plane.Normal.x * center.x + plane.Normal.y * center.y + plane.Normal.z * center.z + plane.Distance;
+        const float radius = Math::Abs(plane.Normal.x) * extent.x + Math::Abs(plane.Normal.y) * extent.y + Math::Abs(plane.Normal.z) * extent.z;
+
+        if(distance + radius < 0.f)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::Intersects(const Spheref &sphere)const{
+    for(const Plane &plane: Planes){
+        const float distance = plane.Normal.x * sphere.Center.x + plane.Normal.y * sphere.Center.y + plane.Normal.z * sphere.Center.z + plane.Distance;
+
+        if(distance + sphere.Radius < 0.f)
+            return false;
+    }
+    return true;
+}
+
+namespace Math{
+
+struct CullPlanes{
+    float Normal[Frustum::PlanesCount][3];
+    float AbsNormal[Frustum::PlanesCount][3];
+    float Distance[Frustum::PlanesCount];
+
+    CullPlanes(const Frustum &frustum){
+        for(size_t p = 0; p < Frustum::PlanesCount; p++){
+            for(size_t c = 0; c < 3; c++){
+                Normal[p][c] = frustum.Planes[p].Normal[c];
+                AbsNormal[p][c] = Math::Abs(Normal[p][c]);
+            }
+            Distance[p] = frustum.Planes[p].Distance;
+        }
+    }
+};
+
+// Loops over the block have fixed trip counts and no branches, so they become
+// 4, 8 or 16 lanes wide vector code depending on the target
+
+static void TestBoxesBlock(const CullPlanes &planes, const float *const min[3], const float *const max[3], u8 *visibility){
+    float center[3][StreamLanes], extent[3][StreamLanes];
+    for(size_t c = 0; c < 3; c++){
+        for(size_t j = 0; j < StreamLanes; j++){
+            center[c][j] = (min[c][j] + max[c][j]) * 0.5f;
+            extent[c][j] = (max[c][j] - min[c][j]) * 0.5f;
+        }
+    }
+
+    u8 visible[StreamLanes];
+    for(size_t j = 0; j < StreamLanes; j++)
+        visible[j] = 1;
+
+    for(size_t p = 0; p < Frustum::PlanesCount; p++){
+        const float *n = planes.Normal[p];
+        const float *a = planes.AbsNormal[p];
+        const float d = planes.Distance[p];
+
+        for(size_t j = 0; j < StreamLanes; j++){
+            const float distance = n[0] * center[0][j] + n[1] * center[1][j] + n[2] * center[2][j] + d;
+            const float radius = a[0] * extent[0][j] + a[1] * extent[1][j] + a[2] * extent[2][j];
+            visible[j] &= distance + radius >= 0.f;
+        }
+    }
+
+    memcpy(visibility, visible, StreamLanes);
+}
+
+static void TestSpheresBlock(const CullPlanes &planes, const float *const center[3], const float *radius, u8 *visibility){
+    u8 visible[StreamLanes];
+    for(size_t j = 0; j < StreamLanes; j++)
+        visible[j] = 1;
+
+    for(size_t p = 0; p < Frustum::PlanesCount; p++){
+        const float *n = planes.Normal[p];
+        const float d = planes.Distance[p];
+
+        for(size_t j = 0; j < StreamLanes; j++){
+            const float distance = n[0] * center[0][j] + n[1] * center[1][j] + n[2] * center[2][j] + d;
+            visible[j] &= distance + radius[j] >= 0.f;
+        }
+    }
+
+    memcpy(visibility, visible, StreamLanes);
+}
+
+// test_block(i, block) writes visibility of elements [i, i + StreamLanes) into the block
+template<typename TestBlockType>
+static void Cull(size_t size, TestBlockType test_block, Span<u8> visibility){
+    SX_CORE_ASSERT(size == visibility.Size(), "Math: Cull visibility span should be the same size");
+
+    for(size_t i = 0; i < size; i += StreamLanes){
+        u8 block[StreamLanes];
+        test_block(i, block);
+        memcpy(visibility.Pointer() + i, block, Min(StreamLanes, size - i));
+    }
+}
+
+// every index is written and the count advances only for the visible ones, so compaction has no branches
+template<typename TestBlockType>
+static void Cull(size_t size, TestBlockType test_block, List<u32> &visible_indices){
+    const size_t first = visible_indices.Size();
+    visible_indices.Resize(first + size);
+
+    u32 *indices = visible_indices.Data() + first;
+    size_t count = 0;
+
+    for(size_t i = 0; i < size; i += StreamLanes){
+        u8 block[StreamLanes];
+        test_block(i, block);
+
+        const size_t block_size = Min(StreamLanes, size - i);
+        for(size_t j = 0; j < block_size; j++){
+            indices[count] = u32(i + j);
+            count += block[j];
+        }
+    }
+
+    visible_indices.Resize(first + count);
+}
+
+// Array of structures blocks are transposed on the stack, the tail is padded with empty boxes
+static auto BoxesBlockTest(const CullPlanes &planes, ConstSpan<AABB3f> boxes){
+    return [&planes, boxes](size_t offset, u8 *block){
+        float min[3][StreamLanes] = {}, max[3][StreamLanes] = {};
+        const size_t block_size = Min(StreamLanes, boxes.Size() - offset);
+
+        for(size_t j = 0; j < block_size; j++){
+            const AABB3f &box = boxes[offset + j];
+            for(size_t c = 0; c < 3; c++){
+                min[c][j] = box.Min.Data[c];
+                max[c][j] = box.Max.Data[c];
+            }
+        }
+
+        const float *const min_pointers[3] = {min[0], min[1], min[2]};
+        const float *const max_pointers[3] = {max[0], max[1], max[2]};
+        TestBoxesBlock(planes, min_pointers, max_pointers, block);
+    };
+}
+
+// streams are padded to StreamLanes already
+static auto StreamBlockTest(const CullPlanes &planes, const AABB3Stream &boxes){
+    return [&planes, &boxes](size_t offset, u8 *block){
+        const float *const min[3] = {boxes.Component(0) + offset, boxes.Component(1) + offset, boxes.Component(2) + offset};
+        const float *const max[3] = {boxes.Component(3) + offset, boxes.Component(4) + offset, boxes.Component(5) + offset};
+        TestBoxesBlock(planes, min, max, block);
+    };
+}
+
+static auto SpheresBlockTest(const CullPlanes &planes, ConstSpan<Spheref> spheres){
+    return [&planes, spheres](size_t offset, u8 *block){
+        float center[3][StreamLanes] = {}, radius[StreamLanes] = {};
+        const size_t block_size = Min(StreamLanes, spheres.Size() - offset);
+
+        for(size_t j = 0; j < block_size; j++){
+            const Spheref &sphere = spheres[offset + j];
+            for(size_t c = 0; c < 3; c++)
+                center[c][j] = sphere.Center.Data[c];
+            radius[j] = sphere.Radius;
+        }
+
+        const float *const center_pointers[3] = {center[0], center[1], center[2]};
+        TestSpheresBlock(planes, center_pointers, radius, block);
+    };
+}
+
+void CullAABBs(const Frustum &frustum, ConstSpan<AABB3f> boxes, Span<u8> visibility){
+    const CullPlanes planes(frustum);
+    Cull(boxes.Size(), BoxesBlockTest(planes, boxes), visibility);
+}
+
+void CullAABBs(const Frustum &frustum, ConstSpan<AABB3f> boxes, List<u32> &visible_indices){
+    const CullPlanes planes(frustum);
+    Cull(boxes.Size(), BoxesBlockTest(planes, boxes), visible_indices);
+}
+
+void CullAABBs(const Frustum &frustum, const AABB3Stream &boxes, Span<u8> visibility){
+    const CullPlanes planes(frustum);
+    Cull(boxes.Size(), StreamBlockTest(planes, boxes), visibility);
+}
+
+void CullAABBs(const Frustum &frustum, const AABB3Stream &boxes, List<u32> &visible_indices){
+    const CullPlanes planes(frustum);
+    Cull(boxes.Size(), StreamBlockTest(planes, boxes), visible_indices);
+}
+
+void CullSpheres(const Frustum &frustum, ConstSpan<Spheref> spheres, Span<u8> visibility){
+    const CullPlanes planes(frustum);
+    Cull(spheres.Size(), SpheresBlockTest(planes, spheres), visibility);
+}
+
+void CullSpheres(const Frustum &frustum, ConstSpan<Spheref> spheres, List<u32> &visible_indices){
+    const CullPlanes planes(frustum);
+    Cull(spheres.Size(), SpheresBlockTest(planes, spheres), visible_indices);
+}
+
+}//namespace Math::
@@ -0,0 +1,75 @@
+#ifndef STRAITX_FRUSTUM_HPP
+#define STRAITX_FRUSTUM_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/matrix4.hpp"
+#include "core/math/aabb3.hpp"
+#include "core/math/sphere.hpp"
+#include "core/math/vector_stream.hpp"
+
+// Points with Dot(Normal, point) + Distance >= 0 are on the inner side
+struct Plane{
+    Vector3f Normal;
+    float Distance = 0.f;
+
+    float SignedDistance(const Vector3f &point)const;
+};
+
+SX_INLINE float Plane::SignedDistance(const Vector3f &point)const{
+    return Dot(Normal, point) + Distance;
+}
+
+enum class ClipDepth: u8{
+    // Vulkan and Direct3D
+    ZeroToOne,
+    // OpenGL
+    MinusOneToOne
+};
+
+// Planes are extracted from a projection or view-projection matrix, multiplied with column vectors.
+// Intersection tests are conservative: boxes and spheres near the frustum corners may be reported
+// as visible while being outside, but nothing visible is ever culled
+class Frustum{
+public:
+    enum PlaneIndex{
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlanesCount
+    };
+
+    Plane Planes[PlanesCount];
+public:
+    Frustum(const Matrix4f &view_projection, ClipDepth depth = ClipDepth::ZeroToOne);
+
+    bool Intersects(const AABB3f &box)const;
+
+    bool Intersects(const Spheref &sphere)const;
+};
+
+namespace Math{
+
+// Boxes are tested StreamLanes at a time in structure of arrays blocks, visibility[i] is 1 when
+// frustum.Intersects(boxes[i]) and 0 otherwise. Index overloads append indices of the visible elements
+
+void CullAABBs(const Frustum &frustum, ConstSpan<AABB3f> boxes, Span<u8> visibility);
+
+void CullAABBs(const Frustum &frustum, ConstSpan<AABB3f> boxes, List<u32> &visible_indices);
+
+void CullAABBs(const Frustum &frustum, const AABB3Stream &boxes, Span<u8> visibility);
+
+void CullAABBs(const Frustum &frustum, const AABB3Stream &boxes, List<u32> &visible_indices);
+
+void CullSpheres(const Frustum &frustum, ConstSpan<Spheref> spheres, Span<u8> visibility);
+
+void CullSpheres(const Frustum &frustum, ConstSpan<Spheref> spheres, List<u32> &visible_indices);
+
+}//namespace Math::
+
+#endif//STRAITX_FRUSTUM_HPP
@@ -5,12 +5,18 @@
 #include <float.h>
 #include "core/env/compiler.hpp"
 
+template<int IntBits, int FracBits>
+class Fixed;
+
 namespace Math{
 
 constexpr double Pi = 3.14159265368979323;
 
+// types other than float provide theirs as a static Epsilon()
 template<typename NumberType>
-constexpr NumberType Epsilon();
+constexpr NumberType Epsilon(){
+    return NumberType::Epsilon();
+}
 
 template<>
 constexpr float Epsilon<float>() {
@@ -98,6 +104,36 @@ constexpr NumberType Clamp(NumberType number, NumberType lower, NumberType upper
     return number;
 }
 
+// Fixed point overloads are defined in core/math/fixed.hpp. Templates bind Math:: calls where they are
+// defined, so these have to be declared ahead of them
+
+template<int IntBits, int FracBits>
+constexpr Fixed<IntBits, FracBits> Abs(Fixed<IntBits, FracBits> value);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Sin(Fixed<IntBits, FracBits> radians);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Cos(Fixed<IntBits, FracBits> radians);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Tan(Fixed<IntBits, FracBits> radians);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Asin(Fixed<IntBits, FracBits> value);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Acos(Fixed<IntBits, FracBits> value);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Atan(Fixed<IntBits, FracBits> value);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Atan2(Fixed<IntBits, FracBits> y, Fixed<IntBits, FracBits> x);
+
+template<int IntBits, int FracBits>
+Fixed<IntBits, FracBits> Sqrt(Fixed<IntBits, FracBits> value);
+
 }//namespace Math::
 
 #endif//STRAITX_TRIG_HPP
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "core/assert.hpp"
 #include "core/printer.hpp"
 #include "core/math/linear.hpp"
+#include "core/math/simd.hpp"
 
 // Row Major Matrix
 template <typename T>
@@ -26,6 +27,8 @@ struct Matrix4{
 
     constexpr Matrix4 GetTransposed()const;
 
+    // Singular matrix has no inverse, identity is returned for it,
+    // so check GetDeterminant() first where such input is possible
     constexpr Matrix4 GetInverse()const;
     
     constexpr void Decompose(Vector3<T>& position, Vector3<T>& rotation, Vector3<T>& scale)const;
@@ -68,25 +71,27 @@ constexpr const Vector4<T> &Matrix4<T>::operator[](size_t index)const{
     SX_CORE_ASSERT(index < 4 && index >= 0, "Matrix4: Can't address move than 4 rows"); 
     return Rows[index];
 }
+namespace Details{
+
 template <typename T>
-constexpr Matrix4<T> Matrix4<T>::GetTransposed()const{
+constexpr Matrix4<T> ScalarTransposed(const Matrix4<T> &m){
     return {
-        {Rows[0][0], Rows[1][0], Rows[2][0], Rows[3][0]},
-        {Rows[0][1], Rows[1][1], Rows[2][1], Rows[3][1]},
-        {Rows[0][2], Rows[1][2], Rows[2][2], Rows[3][2]},
-        {Rows[0][3], Rows[1][3], Rows[2][3], Rows[3][3]}
+        {m[0][0], m[1][0], m[2][0], m[3][0]},
+        {m[0][1], m[1][1], m[2][1], m[3][1]},
+        {m[0][2], m[1][2], m[2][2], m[3][2]},
+        {m[0][3], m[1][3], m[2][3], m[3][3]}
     };
 }
 
+// Cofactor expansion, also the reference for the float specialization
 template <typename T>
-constexpr Matrix4<T> Matrix4<T>::GetInverse()const {
-    const T det = GetDeterminant();
+constexpr Matrix4<T> ScalarInverse(const Matrix4<T> &m){
+    const T det = m.GetDeterminant();
 
     if(det == static_cast<T>(0))
         return Matrix4<T>();
 
     const T invdet = static_cast<T>(1.0) / det;
-    const Matrix4<T>& m = *this;
 
     Matrix4<T> res;
     res[0][0] = invdet  * (m[1][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) + m[1][2] * (m[2][3] * m[3][1] - m[2][1] * m[3][3]) + m[1][3] * (m[2][1] * m[3][2] - m[2][2] * m[3][1]));
@@ -106,7 +111,19 @@ constexpr Matrix4<T> Matrix4<T>::GetInverse()const {
     res[3][2] = -invdet * (m[0][0] * (m[1][1] * m[3][2] - m[1][2] * m[3][1]) + m[0][1] * (m[1][2] * m[3][0] - m[1][0] * m[3][2]) + m[0][2] * (m[1][0] * m[3][1] - m[1][1] * m[3][0]));
     res[3][3] = invdet  * (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) + m[0][1] * (m[1][2] * m[2][0] - m[1][0] * m[2][2]) + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]));
 
-    return *this;
+    return res;
+}
+
+}//namespace Details::
+
+template <typename T>
+constexpr Matrix4<T> Matrix4<T>::GetTransposed()const{
+    return Details::ScalarTransposed(*this);
+}
+
+template <typename T>
+constexpr Matrix4<T> Matrix4<T>::GetInverse()const {
+    return Details::ScalarInverse(*this);
 }
 
 template <typename T>
@@ -210,6 +227,239 @@ constexpr Vector4<T> operator*(const Matrix4<T> &l, const Vector4<T> &r){
     };
 }
 
+#if defined(SX_SIMD)
+// Float versions stay constexpr, constant evaluation takes the generic templates and
+// runtime calls take the intrinsics, which compute the same results. Products are summed in the same order as Dot does and without fused multiply-add,
+// so multiplications are bit exact with the scalar code as long as the compiler doesn't
+// contract the scalar code into FMA either. GCC and Clang do that by default where FMA
+// is available (arm64, x86 with -mfma), -ffp-contract=off keeps them exact there.
+// Inverse is not bit exact, it differs from the scalar one within rounding
+
+namespace Details{
+
+inline Matrix4<float> SimdTransposed(const Matrix4<float> &matrix){
+    Float4 row0 = Float4::Load(matrix.Rows[0].Data);
+    Float4 row1 = Float4::Load(matrix.Rows[1].Data);
+    Float4 row2 = Float4::Load(matrix.Rows[2].Data);
+    Float4 row3 = Float4::Load(matrix.Rows[3].Data);
+
+    Transpose(row0, row1, row2, row3);
+
+    Matrix4<float> result;
+    row0.Store(result.Rows[0].Data);
+    row1.Store(result.Rows[1].Data);
+    row2.Store(result.Rows[2].Data);
+    row3.Store(result.Rows[3].Data);
+    return result;
+}
+
+// 2x2 matrices packed as (m00, m01, m10, m11)
+SX_INLINE Float4 Matrix2Mul(Float4 left, Float4 right){
+    return left * Swizzle<0, 3, 0, 3>(right) + Swizzle<1, 0, 3, 2>(left) * Swizzle<2, 1, 2, 1>(right);
+}
+// adjugate(left) * right
+SX_INLINE Float4 Matrix2AdjMul(Float4 left, Float4 right){
+    return Swizzle<3, 3, 0, 0>(left) * right - Swizzle<1, 1, 2, 2>(left) * Swizzle<2, 3, 0, 1>(right);
+}
+// left * adjugate(right)
+SX_INLINE Float4 Matrix2MulAdj(Float4 left, Float4 right){
+    return left * Swizzle<3, 0, 3, 0>(right) - Swizzle<1, 0, 3, 2>(left) * Swizzle<2, 1, 2, 1>(right);
+}
+
+SX_INLINE Float4 Cross(Float4 left, Float4 right){
+    return Swizzle<1, 2, 0, 3>(left) * Swizzle<2, 0, 1, 3>(right) - Swizzle<2, 0, 1, 3>(left) * Swizzle<1, 2, 0, 3>(right);
+}
+
+// Rotation and scale part is inverted through cross products, translation is rotated back
+inline Matrix4<float> AffineInverse(const Matrix4<float> &matrix){
+    const Float4 row0 = Float4::Load(matrix.Rows[0].Data);
+    const Float4 row1 = Float4::Load(matrix.Rows[1].Data);
+    const Float4 row2 = Float4::Load(matrix.Rows[2].Data);
+
+    // Translation is masked out, w lanes of cross products are x * y - x * y otherwise,
+    // which is not zero once contracted into FMA and leaks into the determinant
+    const Float4 mask = Float4::Set(1.f, 1.f, 1.f, 0.f);
+    const Float4 axis0 = row0 * mask;
+    const Float4 axis1 = row1 * mask;
+    const Float4 axis2 = row2 * mask;
+
+    // columns of the inverse, w lanes are zero
+    Float4 column0 = Cross(axis1, axis2);
+    Float4 column1 = Cross(axis2, axis0);
+    Float4 column2 = Cross(axis0, axis1);
+
+    const float determinant = HorizontalSum(axis0 * column0).X();
+    if(determinant == 0.f)
+        return Matrix4<float>();
+
+    const Float4 inverse_determinant = Float4::Splat(1.f / determinant);
+    column0 = column0 * inverse_determinant;
+    column1 = column1 * inverse_determinant;
+    column2 = column2 * inverse_determinant;
+
+    Float4 translation = Float4::Splat(0.f) - (
+          Swizzle<3, 3, 3, 3>(row0) * column0
+        + Swizzle<3, 3, 3, 3>(row1) * column1
+        + Swizzle<3, 3, 3, 3>(row2) * column2);
+
+    Transpose(column0, column1, column2, translation);
+
+    Matrix4<float> result;
+    column0.Store(result.Rows[0].Data);
+    column1.Store(result.Rows[1].Data);
+    column2.Store(result.Rows[2].Data);
+    return result;
+}
+
+// Blockwise inversion through 2x2 submatrices
+inline Matrix4<float> GeneralInverse(const Matrix4<float> &matrix){
+    const Float4 row0 = Float4::Load(matrix.Rows[0].Data);
+    const Float4 row1 = Float4::Load(matrix.Rows[1].Data);
+    const Float4 row2 = Float4::Load(matrix.Rows[2].Data);
+    const Float4 row3 = Float4::Load(matrix.Rows[3].Data);
+
+    const Float4 a = Shuffle<0, 1, 0, 1>(row0, row1);
+    const Float4 b = Shuffle<2, 3, 2, 3>(row0, row1);
+    const Float4 c = Shuffle<0, 1, 0, 1>(row2, row3);
+    const Float4 d = Shuffle<2, 3, 2, 3>(row2, row3);
+
+    // (|a|, |b|, |c|, |d|)
+    const Float4 sub_determinants =
+          Shuffle<0, 2, 0, 2>(row0, row2) * Shuffle<1, 3, 1, 3>(row1, row3)
+        - Shuffle<1, 3, 1, 3>(row0, row2) * Shuffle<0, 2, 0, 2>(row1, row3);
+
+    const Float4 determinant_a = Swizzle<0, 0, 0, 0>(sub_determinants);
+    const Float4 determinant_b = Swizzle<1, 1, 1, 1>(sub_determinants);
+    const Float4 determinant_c = Swizzle<2, 2, 2, 2>(sub_determinants);
+    const Float4 determinant_d = Swizzle<3, 3, 3, 3>(sub_determinants);
+
+    const Float4 d_c = Matrix2AdjMul(d, c);
+    const Float4 a_b = Matrix2AdjMul(a, b);
+
+    Float4 x = determinant_d * a - Matrix2Mul(b, d_c);
+    Float4 w = determinant_a * d - Matrix2Mul(c, a_b);
+    Float4 y = determinant_b * c - Matrix2MulAdj(d, a_b);
+    Float4 z = determinant_c * b - Matrix2MulAdj(a, d_c);
+
+    const Float4 trace = HorizontalSum(a_b * Swizzle<0, 2, 1, 3>(d_c));
+    const Float4 determinant = determinant_a * determinant_d + determinant_b * determinant_c - trace;
+
+    if(determinant.X() == 0.f)
+        return Matrix4<float>();
+
+    const Float4 inverse_determinant = Float4::Set(1.f, -1.f, -1.f, 1.f) / determinant;
+    x = x * inverse_determinant;
+    y = y * inverse_determinant;
+    z = z * inverse_determinant;
+    w = w * inverse_determinant;
+
+    // adjugate of the blocks is folded into the final shuffle
+    Matrix4<float> result;
+    Shuffle<3, 1, 3, 1>(x, y).Store(result.Rows[0].Data);
+    Shuffle<2, 0, 2, 0>(x, y).Store(result.Rows[1].Data);
+    Shuffle<3, 1, 3, 1>(z, w).Store(result.Rows[2].Data);
+    Shuffle<2, 0, 2, 0>(z, w).Store(result.Rows[3].Data);
+    return result;
+}
+
+// Matrices with (0, 0, 0, 1) bottom row take the cheaper affine path
+inline Matrix4<float> SimdInverse(const Matrix4<float> &matrix){
+    if(matrix.Rows[3].x == 0.f && matrix.Rows[3].y == 0.f && matrix.Rows[3].z == 0.f && matrix.Rows[3].w == 1.f)
+        return AffineInverse(matrix);
+    return GeneralInverse(matrix);
+}
+
+inline Matrix4<float> SimdMultiply(const Matrix4<float> &l, const Matrix4<float> &r){
+    Matrix4<float> result;
+
+#if defined(SX_SIMD_AVX)
+    // two rows of the result at once, right rows are duplicated in both halves
+    const __m256 r0 = _mm256_broadcast_ps((const __m128*)r.Rows[0].Data);
+    const __m256 r1 = _mm256_broadcast_ps((const __m128*)r.Rows[1].Data);
+    const __m256 r2 = _mm256_broadcast_ps((const __m128*)r.Rows[2].Data);
+    const __m256 r3 = _mm256_broadcast_ps((const __m128*)r.Rows[3].Data);
+
+    for(size_t i = 0; i < 4; i += 2){
+        const __m256 rows = _mm256_loadu_ps(l.Rows[i].Data);
+
+        __m256 sum = _mm256_mul_ps(_mm256_permute_ps(rows, 0x00), r0);
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(rows, 0x55), r1));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(rows, 0xAA), r2));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(rows, 0xFF), r3));
+
+        _mm256_storeu_ps(result.Rows[i].Data, sum);
+    }
+#else
+    const Float4 r0 = Float4::Load(r.Rows[0].Data);
+    const Float4 r1 = Float4::Load(r.Rows[1].Data);
+    const Float4 r2 = Float4::Load(r.Rows[2].Data);
+    const Float4 r3 = Float4::Load(r.Rows[3].Data);
+
+    const auto row_product = [&](const Vector4<float> &left){
+        const Float4 row = Float4::Load(left.Data);
+
+        return Swizzle<0, 0, 0, 0>(row) * r0
+             + Swizzle<1, 1, 1, 1>(row) * r1
+             + Swizzle<2, 2, 2, 2>(row) * r2
+             + Swizzle<3, 3, 3, 3>(row) * r3;
+    };
+
+    row_product(l.Rows[0]).Store(result.Rows[0].Data);
+    row_product(l.Rows[1]).Store(result.Rows[1].Data);
+    row_product(l.Rows[2]).Store(result.Rows[2].Data);
+    row_product(l.Rows[3]).Store(result.Rows[3].Data);
+#endif
+    return result;
+}
+
+inline Vector4<float> SimdMultiply(const Matrix4<float> &l, const Vector4<float> &r){
+    // columns don't depend on the vector, so in a loop the transpose is hoisted out
+    Float4 column0 = Float4::Load(l.Rows[0].Data);
+    Float4 column1 = Float4::Load(l.Rows[1].Data);
+    Float4 column2 = Float4::Load(l.Rows[2].Data);
+    Float4 column3 = Float4::Load(l.Rows[3].Data);
+
+    Transpose(column0, column1, column2, column3);
+
+    const Float4 result = column0 * Float4::Splat(r.x)
+                        + column1 * Float4::Splat(r.y)
+                        + column2 * Float4::Splat(r.z)
+                        + column3 * Float4::Splat(r.w);
+
+    Vector4<float> vector;
+    result.Store(vector.Data);
+    return vector;
+}
+
+}//namespace Details::
+
+template <>
+constexpr Matrix4<float> Matrix4<float>::GetTransposed()const{
+    if(SX_IS_CONSTANT_EVALUATED())
+        return Details::ScalarTransposed(*this);
+    return Details::SimdTransposed(*this);
+}
+
+template <>
+constexpr Matrix4<float> Matrix4<float>::GetInverse()const{
+    if(SX_IS_CONSTANT_EVALUATED())
+        return Details::ScalarInverse(*this);
+    return Details::SimdInverse(*this);
+}
+
+constexpr Matrix4<float> operator*(const Matrix4<float> &l, const Matrix4<float> &r){
+    if(SX_IS_CONSTANT_EVALUATED())
+        return operator*<float>(l, r);
+    return Details::SimdMultiply(l, r);
+}
+
+constexpr Vector4<float> operator*(const Matrix4<float> &l, const Vector4<float> &r){
+    if(SX_IS_CONSTANT_EVALUATED())
+        return operator*<float>(l, r);
+    return Details::SimdMultiply(l, r);
+}
+#endif
+
 typedef Matrix4<float> Matrix4f;
 typedef Matrix4<s32> Matrix4s;
 typedef Matrix4<u32> Matrix4u;    
@@ -0,0 +1,199 @@
+#include "core/math/packing.hpp"
+#include "core/math/simd.hpp"
+#include "core/assert.hpp"
+
+template<typename InputType, typename ResultType, typename FunctionType>
+static void Batch(ConstSpan<InputType> values, Span<ResultType> result, FunctionType function){
+    SX_CORE_ASSERT(values.Size() == result.Size(), "Math: result should be the same size as arguments");
+
+    for(size_t i = 0; i < values.Size(); i++)
+        result[i] = function(values[i]);
+}
+
+// Details::PackUnorm and Details::PackSnorm over lanes, the same operations in the same order
+template<typename IntegerType>
+static void PackNormalized(ConstSpan<float> values, Span<IntegerType> result){
+    SX_CORE_ASSERT(values.Size() == result.Size(), "Math: result should be the same size as arguments");
+
+    constexpr bool IsSigned = std::numeric_limits<IntegerType>::is_signed;
+    const Float4 scale = Float4::Splat(float(std::numeric_limits<IntegerType>::max()));
+    const Float4 lower = Float4::Splat(IsSigned ? -1.f : 0.f);
+    const Float4 upper = Float4::Splat(1.f);
+    const Float4 half = Float4::Splat(0.5f);
+    const Float4 zero = Float4::Splat(0.f);
+
+    const float *source = values.Pointer();
+    IntegerType *destination = result.Pointer();
+
+    size_t i = 0;
+    for(; i + 4 <= values.Size(); i += 4){
+        const Float4 value = Float4::Load(source + i);
+        Float4 clamped = Select(CompareGreater(value, upper), upper, value);
+        clamped = Select(CompareLess(value, lower), lower, clamped);
+        const Float4 rounding = IsSigned ? Select(CompareLess(value, zero), zero - half, half) : half;
+
+        s32 lanes[4];
+        ConvertToInt4(clamped * scale + rounding).Store(lanes);
+        for(size_t j = 0; j < 4; j++)
+            destination[i + j] = IntegerType(lanes[j]);
+    }
+    for(; i < values.Size(); i++)
+        destination[i] = IsSigned ? Details::PackSnorm<IntegerType>(source[i]) : Details::PackUnorm<IntegerType>(source[i]);
+}
+
+#if !defined(SX_SIMD_HALF)
+
+// Math::FloatToHalf over lanes, lanes of the result hold halves in the lowest 16 bits
+static Int4 FloatToHalf(Float4 value){
+    const Int4 bits = BitCastToInt4(value);
+    const Int4 sign = ShiftRight<16>(bits) & Int4::Splat(0x8000);
+    const Int4 magnitude_bits = bits & Int4::Splat(0x7FFFFFFF);
+    const Float4 magnitude = BitCastToFloat4(magnitude_bits);
+
+    const Int4 denormal = BitCastToInt4(magnitude + Float4::Splat(0.5f)) - Int4::Splat(0x3F000000);
+    const Int4 odd = ShiftRight<13>(magnitude_bits) & Int4::Splat(1);
+    const Int4 normal = ShiftRight<13>(magnitude_bits + Int4::Splat((15 - 127) * (1 << 23) + 0xFFF) + odd);
+    // NaN is the only value that isn't equal to itself
+    const Float4 special = Select(CompareEqual(magnitude, magnitude), BitCastToFloat4(Int4::Splat(0x7C00)), BitCastToFloat4(Int4::Splat(0x7E00)));
+
+    Float4 result = Select(CompareLess(magnitude, Float4::Splat(65536.f)), BitCastToFloat4(normal), special);
+    result = Select(CompareLess(magnitude, Float4::Splat(0x1p-14f)), BitCastToFloat4(denormal), result);
+    return BitCastToInt4(result) | sign;
+}
+
+// Math::HalfToFloat over lanes, halves are in the lowest 16 bits
+static Float4 HalfToFloat(Int4 half){
+    const Float4 magnitude = BitCastToFloat4(ShiftLeft<13>(half & Int4::Splat(0x7FFF))) * Float4::Splat(0x1p112f);
+    const Float4 special = BitCastToFloat4(BitCastToInt4(magnitude) | Int4::Splat(0x7F800000));
+
+    const Float4 result = Select(CompareLess(magnitude, Float4::Splat(65536.f)), magnitude, special);
+    return BitCastToFloat4(BitCastToInt4(result) | ShiftLeft<16>(half & Int4::Splat(0x8000)));
+}
+
+#endif
+
+namespace Math{
+
+// Hardware conversions round to nearest even as well, so only NaN payloads may differ from the scalar versions
+
+void FloatToHalf(ConstSpan<float> values, Span<u16> result){
+    SX_CORE_ASSERT(values.Size() == result.Size(), "Math: result should be the same size as arguments");
+
+    const float *source = values.Pointer();
+    u16 *destination = result.Pointer();
+
+    size_t i = 0;
+#if defined(SX_SIMD_HALF) && defined(SX_SIMD_SSE)
+    for(; i + 8 <= values.Size(); i += 8)
+        _mm_storeu_si128((__m128i*)(destination + i), _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(SX_SIMD_HALF) && defined(SX_SIMD_NEON)
+    for(; i + 4 <= values.Size(); i += 4)
+        vst1_u16(destination + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(source + i))));
+#else
+    for(; i + 4 <= values.Size(); i += 4){
+        s32 lanes[4];
+        ::FloatToHalf(Float4::Load(source + i)).Store(lanes);
+        for(size_t j = 0; j < 4; j++)
+            destination[i + j] = u16(lanes[j]);
+    }
+#endif
+    for(; i < values.Size(); i++)
+        destination[i] = FloatToHalf(source[i]);
+}
+
+void HalfToFloat(ConstSpan<u16> values, Span<float> result){
+    SX_CORE_ASSERT(values.Size() == result.Size(), "Math: result should be the same size as arguments");
+
+    const u16 *source = values.Pointer();
+    float *destination = result.Pointer();
+
+    size_t i = 0;
+#if defined(SX_SIMD_HALF) && defined(SX_SIMD_SSE)
+    for(; i + 8 <= values.Size(); i += 8)
+        _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(source + i))));
+#elif defined(SX_SIMD_HALF) && defined(SX_SIMD_NEON)
+    for(; i + 4 <= values.Size(); i += 4)
+        vst1q_f32(destination + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(source + i))));
+#else
+    for(; i + 4 <= values.Size(); i += 4){
+        const s32 lanes[4] = {source[i], source[i + 1], source[i + 2], source[i + 3]};
+        ::HalfToFloat(Int4::Load(lanes)).Store(destination + i);
+    }
+#endif
+    for(; i < values.Size(); i++)
+        destination[i] = HalfToFloat(source[i]);
+}
+
+void PackUnorm8(ConstSpan<float> values, Span<u8> result){
+    PackNormalized(values, result);
+}
+
+void UnpackUnorm8(ConstSpan<u8> values, Span<float> result){
+    Batch(values, result, Details::UnpackUnorm<u8>);
+}
+
+void PackSnorm8(ConstSpan<float> values, Span<s8> result){
+    PackNormalized(values, result);
+}
+
+void UnpackSnorm8(ConstSpan<s8> values, Span<float> result){
+    Batch(values, result, Details::UnpackSnorm<s8>);
+}
+
+void PackUnorm16(ConstSpan<float> values, Span<u16> result){
+    PackNormalized(values, result);
+}
+
+void UnpackUnorm16(ConstSpan<u16> values, Span<float> result){
+    Batch(values, result, Details::UnpackUnorm<u16>);
+}
+
+void PackSnorm16(ConstSpan<float> values, Span<s16> result){
+    PackNormalized(values, result);
+}
+
+void UnpackSnorm16(ConstSpan<s16> values, Span<float> result){
+    Batch(values, result, Details::UnpackSnorm<s16>);
+}
+
+void PackOctahedral8(ConstSpan<Vector3f> normals, Span<u16> result){
+    Batch(normals, result, [](const Vector3f &normal){ return PackOctahedral8(normal); });
+}
+
+void UnpackOctahedral8(ConstSpan<u16> packed, Span<Vector3f> result){
+    Batch(packed, result, [](u16 normal){ return UnpackOctahedral8(normal); });
+}
+
+void PackOctahedral16(ConstSpan<Vector3f> normals, Span<u32> result){
+    Batch(normals, result, [](const Vector3f &normal){ return PackOctahedral16(normal); });
+}
+
+void UnpackOctahedral16(ConstSpan<u32> packed, Span<Vector3f> result){
+    Batch(packed, result, [](u32 normal){ return UnpackOctahedral16(normal); });
+}
+
+void PackQuaternion(ConstSpan<Quaternionf> rotations, Span<u32> result){
+    Batch(rotations, result, [](const Quaternionf &rotation){ return PackQuaternion(rotation); });
+}
+
+void UnpackQuaternion(ConstSpan<u32> packed, Span<Quaternionf> result){
+    Batch(packed, result, [](u32 rotation){ return UnpackQuaternion(rotation); });
+}
+
+void QuantizePosition(ConstSpan<Vector3f> positions, const AABB3f &bounds, Span<Vector3<u16>> result){
+    const Vector3f inverse_size = Details::QuantizationInverseSize(bounds);
+
+    Batch(positions, result, [&bounds, inverse_size](const Vector3f &position){
+        return Details::QuantizePosition(position, bounds.Min, inverse_size);
+    });
+}
+
+void DequantizePosition(ConstSpan<Vector3<u16>> positions, const AABB3f &bounds, Span<Vector3f> result){
+    const Vector3f step = Details::QuantizationStep(bounds);
+
+    Batch(positions, result, [&bounds, step](const Vector3<u16> &position){
+        return Details::DequantizePosition(position, bounds.Min, step);
+    });
+}
+
+}//namespace Math::
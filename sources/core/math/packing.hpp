@@ -0,0 +1,298 @@
+#ifndef STRAITX_PACKING_HPP
+#define STRAITX_PACKING_HPP
+
+#include <cstring>
+#include <limits>
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/algorithm.hpp"
+#include "core/env/compiler.hpp"
+#include "core/math/functions.hpp"
+#include "core/math/vector2.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/quaternion.hpp"
+#include "core/math/aabb3.hpp"
+
+// Compact encodings of vertex attributes and snapshot data. Every scalar function has a batch overload over spans,
+// batches give the same results, half float ones go through F16C or NEON when SX_SIMD_HALF is defined.
+// Arguments are expected to be finite unless stated otherwise
+
+namespace Details{
+
+template<typename IntegerType>
+SX_INLINE IntegerType PackUnorm(float value){
+    constexpr float Scale = float(std::numeric_limits<IntegerType>::max());
+    return IntegerType(Math::Clamp(value, 0.f, 1.f) * Scale + 0.5f);
+}
+
+template<typename IntegerType>
+SX_INLINE float UnpackUnorm(IntegerType value){
+    return float(value) / float(std::numeric_limits<IntegerType>::max());
+}
+
+// rounds half away from zero, so the encoding is symmetric around zero
+template<typename IntegerType>
+SX_INLINE IntegerType PackSnorm(float value){
+    constexpr float Scale = float(std::numeric_limits<IntegerType>::max());
+    return IntegerType(Math::Clamp(value, -1.f, 1.f) * Scale + (value < 0.f ? -0.5f : 0.5f));
+}
+
+// the lowest integer is one step below -1 and decodes to -1 as well
+template<typename IntegerType>
+SX_INLINE float UnpackSnorm(IntegerType value){
+    return ::Max(float(value) / float(std::numeric_limits<IntegerType>::max()), -1.f);
+}
+
+// 10 bits per component, 511 is zero, so components of the identity come back exactly
+constexpr float QuaternionComponentScale = 511.f * 1.41421356237309505f;
+
+SX_INLINE Vector3<u16> QuantizePosition(const Vector3f &position, const Vector3f &min, const Vector3f &inverse_size){
+    return {
+        PackUnorm<u16>((position.x - min.x) * inverse_size.x),
+        PackUnorm<u16>((position.y - min.y) * inverse_size.y),
+        PackUnorm<u16>((position.z - min.z) * inverse_size.z)
+    };
+}
+
+SX_INLINE Vector3f DequantizePosition(const Vector3<u16> &position, const Vector3f &min, const Vector3f &step){
+    return {
+        min.x + float(position.x) * step.x,
+        min.y + float(position.y) * step.y,
+        min.z + float(position.z) * step.z
+    };
+}
+
+// flat axes map to zero
+SX_INLINE Vector3f QuantizationInverseSize(const AABB3f &bounds){
+    const Vector3f size = bounds.Size();
+    return {
+        size.x > 0.f ? 1.f / size.x : 0.f,
+        size.y > 0.f ? 1.f / size.y : 0.f,
+        size.z > 0.f ? 1.f / size.z : 0.f
+    };
+}
+
+SX_INLINE Vector3f QuantizationStep(const AABB3f &bounds){
+    return bounds.Size() / float(std::numeric_limits<u16>::max());
+}
+
+}//namespace Details::
+
+namespace Math{
+
+// IEEE 754 binary16, rounds to nearest even. Values too large for it become infinities,
+// NaN stays NaN, but its payload is not kept
+SX_INLINE u16 FloatToHalf(float value){
+    u32 bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const u32 sign = (bits >> 16) & 0x8000;
+    u32 magnitude = bits & 0x7FFFFFFF;
+
+    // 65536 and above rounds to infinity
+    if(magnitude >= 0x47800000)
+        return u16(sign | (magnitude > 0x7F800000 ? 0x7E00 : 0x7C00));
+
+    // below the smallest normal half, adding 0.5 makes float rounding leave the denormal mantissa in the lowest bits
+    if(magnitude < 0x38800000){
+        float shifted = 0.f;
+        memcpy(&shifted, &magnitude, sizeof(shifted));
+        shifted += 0.5f;
+        memcpy(&magnitude, &shifted, sizeof(magnitude));
+        return u16(sign | (magnitude - 0x3F000000));
+    }
+
+    // exponent is rebiased, 0xFFF plus the lowest kept bit rounds to nearest even
+    magnitude += u32((15 - 127) * (1 << 23) + 0xFFF) + ((magnitude >> 13) & 1);
+    return u16(sign | (magnitude >> 13));
+}
+
+SX_INLINE float HalfToFloat(u16 half){
+    // scaling by 2^112 rebiases exponent of normals and normalizes denormals exactly
+    const u32 shifted = u32(half & 0x7FFF) << 13;
+    float magnitude = 0.f;
+    memcpy(&magnitude, &shifted, sizeof(magnitude));
+    magnitude *= 0x1p112f;
+
+    u32 bits = 0;
+    memcpy(&bits, &magnitude, sizeof(bits));
+    // infinity and NaN
+    if(magnitude >= 65536.f)
+        bits |= 0x7F800000;
+    bits |= u32(half & 0x8000) << 16;
+
+    float value = 0.f;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Unorm maps [0, 1] onto the whole unsigned range, snorm maps [-1, 1] onto the signed one,
+// values outside are clamped
+
+SX_INLINE u8 PackUnorm8(float value){
+    return Details::PackUnorm<u8>(value);
+}
+
+SX_INLINE float UnpackUnorm8(u8 value){
+    return Details::UnpackUnorm(value);
+}
+
+SX_INLINE s8 PackSnorm8(float value){
+    return Details::PackSnorm<s8>(value);
+}
+
+SX_INLINE float UnpackSnorm8(s8 value){
+    return Details::UnpackSnorm(value);
+}
+
+SX_INLINE u16 PackUnorm16(float value){
+    return Details::PackUnorm<u16>(value);
+}
+
+SX_INLINE float UnpackUnorm16(u16 value){
+    return Details::UnpackUnorm(value);
+}
+
+SX_INLINE s16 PackSnorm16(float value){
+    return Details::PackSnorm<s16>(value);
+}
+
+SX_INLINE float UnpackSnorm16(s16 value){
+    return Details::UnpackSnorm(value);
+}
+
+// Projects a non zero vector onto the octahedron |x| + |y| + |z| = 1 and unfolds its lower half
+// over the upper one, giving a point of [-1, 1]^2
+SX_INLINE Vector2f OctahedralEncode(const Vector3f &normal){
+    const float length = Math::Abs(normal.x) + Math::Abs(normal.y) + Math::Abs(normal.z);
+    float x = normal.x / length;
+    float y = normal.y / length;
+
+    if(normal.z < 0.f){
+        const float folded_x = (1.f - Math::Abs(y)) * (x >= 0.f ? 1.f : -1.f);
+        y = (1.f - Math::Abs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = folded_x;
+    }
+    return {x, y};
+}
+
+// result is normalized
+SX_INLINE Vector3f OctahedralDecode(const Vector2f &encoded){
+    Vector3f normal(encoded.x, encoded.y, 1.f - Math::Abs(encoded.x) - Math::Abs(encoded.y));
+
+    const float fold = ::Max(-normal.z, 0.f);
+    normal.x += normal.x >= 0.f ? -fold : fold;
+    normal.y += normal.y >= 0.f ? -fold : fold;
+    return normal / normal.Length();
+}
+
+// two snorm8, worst direction error is about 1 degree
+SX_INLINE u16 PackOctahedral8(const Vector3f &normal){
+    const Vector2f encoded = OctahedralEncode(normal);
+    return u16(u8(PackSnorm8(encoded.x)) | (u8(PackSnorm8(encoded.y)) << 8));
+}
+
+SX_INLINE Vector3f UnpackOctahedral8(u16 packed){
+    return OctahedralDecode({UnpackSnorm8(s8(packed & 0xFF)), UnpackSnorm8(s8(packed >> 8))});
+}
+
+// two snorm16, worst direction error is about 0.04 degrees
+SX_INLINE u32 PackOctahedral16(const Vector3f &normal){
+    const Vector2f encoded = OctahedralEncode(normal);
+    return u32(u16(PackSnorm16(encoded.x))) | (u32(u16(PackSnorm16(encoded.y))) << 16);
+}
+
+SX_INLINE Vector3f UnpackOctahedral16(u32 packed){
+    return OctahedralDecode({UnpackSnorm16(s16(packed & 0xFFFF)), UnpackSnorm16(s16(packed >> 16))});
+}
+
+// Smallest three encoding of a unit quaternion. The largest component is dropped and restored from
+// the unit length, its index goes to the top two bits and the other three take 10 bits each.
+// Quaternion and its negation are the same rotation, so the dropped one is made positive and
+// the rest are within [-1 / sqrt(2), 1 / sqrt(2)]. Worst rotation error is about 0.25 degrees
+SX_INLINE u32 PackQuaternion(const Quaternionf &rotation){
+    const float components[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+
+    u32 largest = 0;
+    for(u32 i = 1; i < 4; i++){
+        if(Math::Abs(components[i]) > Math::Abs(components[largest]))
+            largest = i;
+    }
+
+    const float scale = components[largest] < 0.f ? -Details::QuaternionComponentScale : Details::QuaternionComponentScale;
+    u32 packed = largest;
+    for(u32 i = 0; i < 4; i++){
+        if(i != largest)
+            packed = (packed << 10) | u32(Math::Clamp(components[i] * scale, -511.f, 511.f) + 511.5f);
+    }
+    return packed;
+}
+
+SX_INLINE Quaternionf UnpackQuaternion(u32 packed){
+    const u32 largest = packed >> 30;
+
+    float components[4];
+    float length_squared = 0.f;
+    for(u32 i = 4; i-- > 0;){
+        if(i == largest)
+            continue;
+        components[i] = (float(packed & 0x3FF) - 511.f) / Details::QuaternionComponentScale;
+        length_squared += components[i] * components[i];
+        packed >>= 10;
+    }
+    components[largest] = Math::Sqrt(::Max(1.f - length_squared, 0.f));
+
+    return {components[0], components[1], components[2], components[3]};
+}
+
+// Maps bounds onto the whole u16 range along every axis, positions outside are clamped.
+// Step is bounds size / 65535, error is half of it
+SX_INLINE Vector3<u16> QuantizePosition(const Vector3f &position, const AABB3f &bounds){
+    return Details::QuantizePosition(position, bounds.Min, Details::QuantizationInverseSize(bounds));
+}
+
+SX_INLINE Vector3f DequantizePosition(const Vector3<u16> &position, const AABB3f &bounds){
+    return Details::DequantizePosition(position, bounds.Min, Details::QuantizationStep(bounds));
+}
+
+// Batch versions, result should be the same size as arguments
+
+void FloatToHalf(ConstSpan<float> values, Span<u16> result);
+
+void HalfToFloat(ConstSpan<u16> values, Span<float> result);
+
+void PackUnorm8(ConstSpan<float> values, Span<u8> result);
+
+void UnpackUnorm8(ConstSpan<u8> values, Span<float> result);
+
+void PackSnorm8(ConstSpan<float> values, Span<s8> result);
+
+void UnpackSnorm8(ConstSpan<s8> values, Span<float> result);
+
+void PackUnorm16(ConstSpan<float> values, Span<u16> result);
+
+void UnpackUnorm16(ConstSpan<u16> values, Span<float> result);
+
+void PackSnorm16(ConstSpan<float> values, Span<s16> result);
+
+void UnpackSnorm16(ConstSpan<s16> values, Span<float> result);
+
+void PackOctahedral8(ConstSpan<Vector3f> normals, Span<u16> result);
+
+void UnpackOctahedral8(ConstSpan<u16> packed, Span<Vector3f> result);
+
+void PackOctahedral16(ConstSpan<Vector3f> normals, Span<u32> result);
+
+void UnpackOctahedral16(ConstSpan<u32> packed, Span<Vector3f> result);
+
+void PackQuaternion(ConstSpan<Quaternionf> rotations, Span<u32> result);
+
+void UnpackQuaternion(ConstSpan<u32> packed, Span<Quaternionf> result);
+
+void QuantizePosition(ConstSpan<Vector3f> positions, const AABB3f &bounds, Span<Vector3<u16>> result);
+
+void DequantizePosition(ConstSpan<Vector3<u16>> positions, const AABB3f &bounds, Span<Vector3f> result);
+
+}//namespace Math::
+
+#endif//STRAITX_PACKING_HPP
@@ -0,0 +1,115 @@
+#include "core/math/quaternion.hpp"
+#include "core/assert.hpp"
+
+namespace Math{
+
+// Polynomials below are valid for the ranges slerp needs once right is flipped into the left's hemisphere:
+// cos is in [0, 1] and angles are in [0, Pi/2], so there is no range reduction. Errors are below 1e-7
+
+#if defined(SX_SIMD)
+// Abramowitz and Stegun 4.4.46, acos(x) = sqrt(1 - x) * P(x) for x in [0, 1]
+static Float4 AcosPositive(Float4 x){
+    Float4 p = Float4::Splat(-0.0012624911f);
+    p = p * x + Float4::Splat( 0.0066700901f);
+    p = p * x + Float4::Splat(-0.0170881256f);
+    p = p * x + Float4::Splat( 0.0308918810f);
+    p = p * x + Float4::Splat(-0.0501743046f);
+    p = p * x + Float4::Splat( 0.0889789874f);
+    p = p * x + Float4::Splat(-0.2145988016f);
+    p = p * x + Float4::Splat( 1.5707963050f);
+    return Sqrt(Float4::Splat(1.f) - x) * p;
+}
+
+// Taylor series up to x^11 for x in [0, Pi/2]
+static Float4 SinQuadrant(Float4 x){
+    const Float4 x2 = x * x;
+    Float4 p = Float4::Splat(-1.f / 39916800.f);
+    p = p * x2 + Float4::Splat( 1.f / 362880.f);
+    p = p * x2 + Float4::Splat(-1.f / 5040.f);
+    p = p * x2 + Float4::Splat( 1.f / 120.f);
+    p = p * x2 + Float4::Splat(-1.f / 6.f);
+    p = p * x2 + Float4::Splat( 1.f);
+    return p * x;
+}
+#endif
+
+// Four quaternions are transposed into x, y, z, w lanes, so weights, dot products and blending
+// are computed for all of them at once. Nearly parallel lanes are patched with NLerp weights
+void Slerp(ConstSpan<Quaternionf> left, ConstSpan<Quaternionf> right, float t, Span<Quaternionf> result){
+    SX_CORE_ASSERT(left.Size() == right.Size() && left.Size() == result.Size(), "Math: Slerp spans should be the same size");
+    SX_CORE_ASSERT(t >= 0.f && t <= 1.f, "Math: Slerp factor should be in [0, 1] range");
+
+    size_t i = 0;
+#if defined(SX_SIMD)
+    const Float4 left_t = Float4::Splat(1.f - t);
+    const Float4 right_t = Float4::Splat(t);
+
+    for(; i + 4 <= left.Size(); i += 4){
+        Float4 l[4], r[4];
+        for(size_t j = 0; j < 4; j++){
+            l[j] = Float4::Load(left[i + j].Data);
+            r[j] = Float4::Load(right[i + j].Data);
+        }
+        Transpose(l[0], l[1], l[2], l[3]);
+        Transpose(r[0], r[1], r[2], r[3]);
+
+        float cos[4], signs[4];
+        (l[0] * r[0] + l[1] * r[1] + l[2] * r[2] + l[3] * r[3]).Store(cos);
+
+        bool is_parallel = false;
+        for(size_t j = 0; j < 4; j++){
+            signs[j] = cos[j] < 0.f ? -1.f : 1.f;
+            cos[j] *= signs[j];
+            is_parallel |= cos[j] > 0.9995f;
+        }
+
+        const Float4 cos_angle = Float4::Load(cos);
+        const Float4 sign = Float4::Load(signs);
+        const Float4 angle = AcosPositive(cos_angle);
+        const Float4 inverse_sin = Float4::Splat(1.f) / Sqrt(Float4::Splat(1.f) - cos_angle * cos_angle);
+
+        Float4 left_weight = SinQuadrant(left_t * angle) * inverse_sin;
+        Float4 right_weight = SinQuadrant(right_t * angle) * inverse_sin * sign;
+
+        if(is_parallel){
+            float left_weights[4], right_weights[4];
+            left_weight.Store(left_weights);
+            right_weight.Store(right_weights);
+
+            for(size_t j = 0; j < 4; j++){
+                if(cos[j] > 0.9995f){
+                    left_weights[j] = 1.f - t;
+                    right_weights[j] = t * signs[j];
+                }
+            }
+            left_weight = Float4::Load(left_weights);
+            right_weight = Float4::Load(right_weights);
+        }
+
+        Float4 blended[4];
+        for(size_t c = 0; c < 4; c++)
+            blended[c] = l[c] * left_weight + r[c] * right_weight;
+
+        if(is_parallel){
+            float lengths[4];
+            Sqrt(blended[0] * blended[0] + blended[1] * blended[1] + blended[2] * blended[2] + blended[3] * blended[3]).Store(lengths);
+
+            for(size_t j = 0; j < 4; j++)
+                lengths[j] = cos[j] > 0.9995f ? lengths[j] : 1.f;
+
+            const Float4 length = Float4::Load(lengths);
+            for(size_t c = 0; c < 4; c++)
+                blended[c] = blended[c] / length;
+        }
+
+        Transpose(blended[0], blended[1], blended[2], blended[3]);
+        for(size_t j = 0; j < 4; j++)
+            blended[j].Store(result[i + j].Data);
+    }
+#endif
+
+    for(; i < left.Size(); i++)
+        result[i] = Slerp(left[i], right[i], t);
+}
+
+}//namespace Math::
@@ -0,0 +1,279 @@
+#ifndef STRAITX_QUATERNION_HPP
+#define STRAITX_QUATERNION_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/printer.hpp"
+#include "core/type_traits.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/matrix4.hpp"
+#include "core/math/functions.hpp"
+#include "core/math/simd.hpp"
+
+// Rotation as a unit quaternion, (x, y, z) is the vector part and w is the scalar one.
+// q1 * q2 rotates by q2 first, the same way Matrix4 products do
+template<typename T>
+struct alignas(IsSame<T, float>::Value ? 16 : alignof(T)) Quaternion{
+    union{
+        struct{
+            T x;
+            T y;
+            T z;
+            T w;
+        };
+        T Data[4];
+    };
+
+    // Creates an identity rotation
+    constexpr Quaternion();
+
+    constexpr Quaternion(const T &X, const T &Y, const T &Z, const T &W);
+
+    // Counterclockwise when looking against the axis, the same way Math::RotateX and Math::RotateZ do,
+    // axis should be normalized
+    static Quaternion FromAxisAngle(const Vector3<T> &axis, T radians);
+
+    // upper 3x3 of the matrix should be a rotation, without scale
+    static Quaternion FromMatrix(const Matrix4<T> &matrix);
+
+    void ToAxisAngle(Vector3<T> &axis, T &radians)const;
+
+    constexpr Matrix4<T> ToMatrix()const;
+
+    constexpr Quaternion GetConjugate()const;
+
+    // the same as GetConjugate for unit quaternions
+    constexpr Quaternion GetInverse()const;
+
+    Quaternion GetNormalized()const;
+
+    T Length()const;
+
+    constexpr Vector3<T> Rotate(const Vector3<T> &vector)const;
+};
+
+template <typename T>
+constexpr Quaternion<T>::Quaternion():
+    x(static_cast<T>(0)),
+    y(static_cast<T>(0)),
+    z(static_cast<T>(0)),
+    w(static_cast<T>(1))
+{}
+
+template <typename T>
+constexpr Quaternion<T>::Quaternion(const T &X, const T &Y, const T &Z, const T &W):
+    x(X),
+    y(Y),
+    z(Z),
+    w(W)
+{}
+
+template <typename T>
+Quaternion<T> Quaternion<T>::FromAxisAngle(const Vector3<T> &axis, T radians){
+    const T sin = Math::Sin(radians / T(2));
+    return {axis.x * sin, axis.y * sin, axis.z * sin, Math::Cos(radians / T(2))};
+}
+
+// The largest of the four components is found from the diagonal first, so division is always well conditioned
+template <typename T>
+Quaternion<T> Quaternion<T>::FromMatrix(const Matrix4<T> &m){
+    const T trace = m[0][0] + m[1][1] + m[2][2];
+
+    if(trace > T(0)){
+        const T s = Math::Sqrt(trace + T(1)) * T(2);
+        return {(m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s, s / T(4)};
+    }
+    if(m[0][0] > m[1][1] && m[0][0] > m[2][2]){
+        const T s = Math::Sqrt(T(1) + m[0][0] - m[1][1] - m[2][2]) * T(2);
+        return {s / T(4), (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s, (m[2][1] - m[1][2]) / s};
+    }
+    if(m[1][1] > m[2][2]){
+        const T s = Math::Sqrt(T(1) + m[1][1] - m[0][0] - m[2][2]) * T(2);
+        return {(m[0][1] + m[1][0]) / s, s / T(4), (m[1][2] + m[2][1]) / s, (m[0][2] - m[2][0]) / s};
+    }
+    const T s = Math::Sqrt(T(1) + m[2][2] - m[0][0] - m[1][1]) * T(2);
+    return {(m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, s / T(4), (m[1][0] - m[0][1]) / s};
+}
+
+// identity rotation gives (1, 0, 0) axis
+template <typename T>
+void Quaternion<T>::ToAxisAngle(Vector3<T> &axis, T &radians)const{
+    const T cos = Math::Clamp(w, T(-1), T(1));
+    const T sin = Math::Sqrt(T(1) - cos * cos);
+
+    radians = Math::Acos(cos) * T(2);
+
+    if(sin < Math::Epsilon<T>())
+        axis = Vector3<T>(T(1), T(0), T(0));
+    else
+        axis = Vector3<T>(x / sin, y / sin, z / sin);
+}
+
+template <typename T>
+constexpr Matrix4<T> Quaternion<T>::ToMatrix()const{
+    const T xx = x * x, yy = y * y, zz = z * z;
+    const T xy = x * y, xz = x * z, yz = y * z;
+    const T wx = w * x, wy = w * y, wz = w * z;
+
+    return {
+        {T(1) - T(2) * (yy + zz), T(2) * (xy - wz), T(2) * (xz + wy), T(0)},
+        {T(2) * (xy + wz), T(1) - T(2) * (xx + zz), T(2) * (yz - wx), T(0)},
+        {T(2) * (xz - wy), T(2) * (yz + wx), T(1) - T(2) * (xx + yy), T(0)},
+        {T(0), T(0), T(0), T(1)}
+    };
+}
+
+template <typename T>
+constexpr Quaternion<T> Quaternion<T>::GetConjugate()const{
+    return {-x, -y, -z, w};
+}
+
+template <typename T>
+constexpr Quaternion<T> Quaternion<T>::GetInverse()const{
+    const T length_squared = x * x + y * y + z * z + w * w;
+    return {-x / length_squared, -y / length_squared, -z / length_squared, w / length_squared};
+}
+
+template <typename T>
+Quaternion<T> Quaternion<T>::GetNormalized()const{
+    const T length = Length();
+    return {x / length, y / length, z / length, w / length};
+}
+
+template <typename T>
+T Quaternion<T>::Length()const{
+    return Math::Sqrt(x * x + y * y + z * z + w * w);
+}
+
+// v + w * t + cross(q, t), where t = 2 * cross(q, v)
+template <typename T>
+constexpr Vector3<T> Quaternion<T>::Rotate(const Vector3<T> &v)const{
+    const Vector3<T> t(
+        (y * v.z - z * v.y) * T(2),
+        (z * v.x - x * v.z) * T(2),
+        (x * v.y - y * v.x) * T(2)
+    );
+    return {
+        v.x + w * t.x + (y * t.z - z * t.y),
+        v.y + w * t.y + (z * t.x - x * t.z),
+        v.z + w * t.z + (x * t.y - y * t.x)
+    };
+}
+
+template <typename T>
+constexpr bool operator==(const Quaternion<T> &left, const Quaternion<T> &right){
+    return left.x == right.x && left.y == right.y && left.z == right.z && left.w == right.w;
+}
+
+template <typename T>
+constexpr bool operator!=(const Quaternion<T> &left, const Quaternion<T> &right){
+    return !(left == right);
+}
+
+// Hamilton product, terms are summed in the order the SIMD version does
+template <typename T>
+constexpr Quaternion<T> operator*(const Quaternion<T> &l, const Quaternion<T> &r){
+    return {
+        l.w * r.x + l.x * r.w + l.y * r.z - l.z * r.y,
+        l.w * r.y - l.x * r.z + l.y * r.w + l.z * r.x,
+        l.w * r.z + l.x * r.y - l.y * r.x + l.z * r.w,
+        l.w * r.w - l.x * r.x - l.y * r.y - l.z * r.z
+    };
+}
+
+template <typename T>
+constexpr Vector3<T> operator*(const Quaternion<T> &l, const Vector3<T> &r){
+    return l.Rotate(r);
+}
+
+template <typename T>
+constexpr T Dot(const Quaternion<T> &left, const Quaternion<T> &right){
+    return left.x * right.x + left.y * right.y + left.z * right.z + left.w * right.w;
+}
+
+#if defined(SX_SIMD)
+// Bit exact with the generic versions, negated terms are multiplied by -1 which is exact
+
+inline Quaternion<float> operator*(const Quaternion<float> &l, const Quaternion<float> &r){
+    const Float4 left = Float4::Load(l.Data);
+    const Float4 right = Float4::Load(r.Data);
+
+    const Float4 result = Swizzle<3, 3, 3, 3>(left) * right
+        + Swizzle<0, 0, 0, 0>(left) * (Swizzle<3, 2, 1, 0>(right) * Float4::Set(1.f, -1.f, 1.f, -1.f))
+        + Swizzle<1, 1, 1, 1>(left) * (Swizzle<2, 3, 0, 1>(right) * Float4::Set(1.f, 1.f, -1.f, -1.f))
+        + Swizzle<2, 2, 2, 2>(left) * (Swizzle<1, 0, 3, 2>(right) * Float4::Set(-1.f, 1.f, 1.f, -1.f));
+
+    Quaternion<float> quaternion;
+    result.Store(quaternion.Data);
+    return quaternion;
+}
+#endif
+
+template<typename T>
+struct Printer<Quaternion<T>>{
+	static void Print(const Quaternion<T> &value, StringWriter &writer){
+		Printer<char>::Print('(', writer);
+		Printer<T>::Print(value.x, writer);
+		Printer<char>::Print(',', writer);
+		Printer<T>::Print(value.y, writer);
+		Printer<char>::Print(',', writer);
+		Printer<T>::Print(value.z, writer);
+		Printer<char>::Print(',', writer);
+		Printer<T>::Print(value.w, writer);
+		Printer<char>::Print(')', writer);
+	}
+};
+
+typedef Quaternion<float> Quaternionf;
+typedef Quaternion<double> Quaterniond;
+
+namespace Math{
+
+// Interpolation goes along the shorter arc, so right is negated when quaternions are in opposite hemispheres
+
+template <typename T>
+Quaternion<T> NLerp(const Quaternion<T> &left, const Quaternion<T> &right, T t){
+    const T sign = Dot(left, right) < T(0) ? T(-1) : T(1);
+    const T l = T(1) - t;
+    const T r = t * sign;
+
+    return Quaternion<T>(
+        left.x * l + right.x * r,
+        left.y * l + right.y * r,
+        left.z * l + right.z * r,
+        left.w * l + right.w * r
+    ).GetNormalized();
+}
+
+// Nearly parallel rotations fall back to NLerp, where sin of the angle is too small to divide by
+template <typename T>
+Quaternion<T> Slerp(const Quaternion<T> &left, const Quaternion<T> &right, T t){
+    T cos = Dot(left, right);
+    T sign = T(1);
+    if(cos < T(0)){
+        cos = -cos;
+        sign = T(-1);
+    }
+
+    if(cos > T(0.9995))
+        return NLerp(left, right, t);
+
+    const T angle = Math::Acos(cos);
+    const T inverse_sin = T(1) / Math::Sqrt(T(1) - cos * cos);
+    const T l = Math::Sin((T(1) - t) * angle) * inverse_sin;
+    const T r = Math::Sin(t * angle) * inverse_sin * sign;
+
+    return {
+        left.x * l + right.x * r,
+        left.y * l + right.y * r,
+        left.z * l + right.z * r,
+        left.w * l + right.w * r
+    };
+}
+
+// result[i] = Slerp(left[i], right[i], t) within 1e-6, e.g. blending two animation poses. Result may alias the arguments
+void Slerp(ConstSpan<Quaternionf> left, ConstSpan<Quaternionf> right, float t, Span<Quaternionf> result);
+
+}//namespace Math::
+
+#endif//STRAITX_QUATERNION_HPP
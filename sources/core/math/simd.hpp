@@ -0,0 +1,362 @@
+#ifndef STRAITX_SIMD_HPP
+#define STRAITX_SIMD_HPP
+
+#include <cmath>
+#include <cstring>
+#include "core/types.hpp"
+#include "core/env/arch.hpp"
+#include "core/env/compiler.hpp"
+
+// SSE2 is there on every x86_64, AVX and F16C are used only when compiler targets them.
+// SX_SIMD_HALF means hardware conversions between float and half float
+#if defined(SX_ARCH_X86_64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SX_SIMD_SSE
+    #if defined(__AVX__)
+        #include <immintrin.h>
+        #define SX_SIMD_AVX
+    #endif
+    #if defined(__F16C__)
+        #include <immintrin.h>
+        #define SX_SIMD_HALF
+    #endif
+#elif defined(SX_ARCH_ARM_64) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define SX_SIMD_NEON
+    #if defined(SX_ARCH_ARM_64)
+        #define SX_SIMD_HALF
+    #endif
+#endif
+
+#if defined(SX_SIMD_SSE) || defined(SX_SIMD_NEON)
+    #define SX_SIMD
+#endif
+
+// Four packed floats in a register where there is one, plain array otherwise.
+// Loads and stores don't require alignment
+struct Float4{
+#if defined(SX_SIMD_SSE)
+    __m128 Value;
+#elif defined(SX_SIMD_NEON)
+    float32x4_t Value;
+#else
+    float Value[4];
+#endif
+
+    static Float4 Load(const float *source);
+
+    static Float4 Splat(float value);
+
+    static Float4 Set(float x, float y, float z, float w);
+
+    void Store(float *destination)const;
+
+    float X()const;
+};
+
+SX_INLINE Float4 Float4::Load(const float *source){
+#if defined(SX_SIMD_SSE)
+    return {_mm_loadu_ps(source)};
+#elif defined(SX_SIMD_NEON)
+    return {vld1q_f32(source)};
+#else
+    return {{source[0], source[1], source[2], source[3]}};
+#endif
+}
+
+SX_INLINE Float4 Float4::Splat(float value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_set1_ps(value)};
+#elif defined(SX_SIMD_NEON)
+    return {vdupq_n_f32(value)};
+#else
+    return {{value, value, value, value}};
+#endif
+}
+
+SX_INLINE Float4 Float4::Set(float x, float y, float z, float w){
+#if defined(SX_SIMD_SSE)
+    return {_mm_setr_ps(x, y, z, w)};
+#elif defined(SX_SIMD_NEON)
+    const float values[4] = {x, y, z, w};
+    return {vld1q_f32(values)};
+#else
+    return {{x, y, z, w}};
+#endif
+}
+
+SX_INLINE void Float4::Store(float *destination)const{
+#if defined(SX_SIMD_SSE)
+    _mm_storeu_ps(destination, Value);
+#elif defined(SX_SIMD_NEON)
+    vst1q_f32(destination, Value);
+#else
+    for(int i = 0; i < 4; i++)
+        destination[i] = Value[i];
+#endif
+}
+
+SX_INLINE float Float4::X()const{
+#if defined(SX_SIMD_SSE)
+    return _mm_cvtss_f32(Value);
+#elif defined(SX_SIMD_NEON)
+    return vgetq_lane_f32(Value, 0);
+#else
+    return Value[0];
+#endif
+}
+
+#if defined(SX_SIMD_SSE)
+    #define SX_FLOAT4_BINARY_OP(op, sse, neon) \
+        SX_INLINE Float4 operator op(Float4 left, Float4 right){ return {sse(left.Value, right.Value)}; }
+#elif defined(SX_SIMD_NEON)
+    #define SX_FLOAT4_BINARY_OP(op, sse, neon) \
+        SX_INLINE Float4 operator op(Float4 left, Float4 right){ return {neon(left.Value, right.Value)}; }
+#else
+    #define SX_FLOAT4_BINARY_OP(op, sse, neon) \
+        SX_INLINE Float4 operator op(Float4 left, Float4 right){ \
+            return {{left.Value[0] op right.Value[0], left.Value[1] op right.Value[1], left.Value[2] op right.Value[2], left.Value[3] op right.Value[3]}}; \
+        }
+#endif
+
+SX_FLOAT4_BINARY_OP(+, _mm_add_ps, vaddq_f32)
+SX_FLOAT4_BINARY_OP(-, _mm_sub_ps, vsubq_f32)
+SX_FLOAT4_BINARY_OP(*, _mm_mul_ps, vmulq_f32)
+SX_FLOAT4_BINARY_OP(/, _mm_div_ps, vdivq_f32)
+
+#undef SX_FLOAT4_BINARY_OP
+
+SX_INLINE Float4 Sqrt(Float4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_sqrt_ps(value.Value)};
+#elif defined(SX_SIMD_NEON) && defined(SX_ARCH_ARM_64)
+    return {vsqrtq_f32(value.Value)};
+#else
+    float lanes[4];
+    value.Store(lanes);
+    return Float4::Set(std::sqrt(lanes[0]), std::sqrt(lanes[1]), std::sqrt(lanes[2]), std::sqrt(lanes[3]));
+#endif
+}
+
+// (left[X], left[Y], right[Z], right[W]), the same as _mm_shuffle_ps
+template<int X, int Y, int Z, int W>
+SX_INLINE Float4 Shuffle(Float4 left, Float4 right){
+#if defined(SX_SIMD_SSE)
+    return {_mm_shuffle_ps(left.Value, right.Value, _MM_SHUFFLE(W, Z, Y, X))};
+#elif defined(SX_SIMD_NEON) && defined(SX_COMPILER_CLANG)
+    return {__builtin_shufflevector(left.Value, right.Value, X, Y, Z + 4, W + 4)};
+#elif defined(SX_SIMD_NEON)
+    return {__builtin_shuffle(left.Value, right.Value, uint32x4_t{X, Y, Z + 4, W + 4})};
+#else
+    return {{left.Value[X], left.Value[Y], right.Value[Z], right.Value[W]}};
+#endif
+}
+
+template<int X, int Y, int Z, int W>
+SX_INLINE Float4 Swizzle(Float4 value){
+    return Shuffle<X, Y, Z, W>(value, value);
+}
+
+// lanes sum in every lane
+SX_INLINE Float4 HorizontalSum(Float4 value){
+    value = value + Swizzle<2, 3, 0, 1>(value);
+    return value + Swizzle<1, 0, 3, 2>(value);
+}
+
+SX_INLINE void Transpose(Float4 &row0, Float4 &row1, Float4 &row2, Float4 &row3){
+    const Float4 low01  = Shuffle<0, 1, 0, 1>(row0, row1);
+    const Float4 high01 = Shuffle<2, 3, 2, 3>(row0, row1);
+    const Float4 low23  = Shuffle<0, 1, 0, 1>(row2, row3);
+    const Float4 high23 = Shuffle<2, 3, 2, 3>(row2, row3);
+
+    row0 = Shuffle<0, 2, 0, 2>(low01, low23);
+    row1 = Shuffle<1, 3, 1, 3>(low01, low23);
+    row2 = Shuffle<0, 2, 0, 2>(high01, high23);
+    row3 = Shuffle<1, 3, 1, 3>(high01, high23);
+}
+
+// Four packed 32 bit integers, for exponent and sign manipulations of Float4 lanes
+struct Int4{
+#if defined(SX_SIMD_SSE)
+    __m128i Value;
+#elif defined(SX_SIMD_NEON)
+    int32x4_t Value;
+#else
+    s32 Value[4];
+#endif
+
+    static Int4 Load(const s32 *source);
+
+    static Int4 Splat(s32 value);
+
+    void Store(s32 *destination)const;
+};
+
+SX_INLINE Int4 Int4::Load(const s32 *source){
+#if defined(SX_SIMD_SSE)
+    return {_mm_loadu_si128((const __m128i*)source)};
+#elif defined(SX_SIMD_NEON)
+    return {vld1q_s32(source)};
+#else
+    return {{source[0], source[1], source[2], source[3]}};
+#endif
+}
+
+SX_INLINE Int4 Int4::Splat(s32 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_set1_epi32(value)};
+#elif defined(SX_SIMD_NEON)
+    return {vdupq_n_s32(value)};
+#else
+    return {{value, value, value, value}};
+#endif
+}
+
+SX_INLINE void Int4::Store(s32 *destination)const{
+#if defined(SX_SIMD_SSE)
+    _mm_storeu_si128((__m128i*)destination, Value);
+#elif defined(SX_SIMD_NEON)
+    vst1q_s32(destination, Value);
+#else
+    memcpy(destination, Value, sizeof(Value));
+#endif
+}
+
+// wrap around on overflow, the same as the hardware does
+#if defined(SX_SIMD_SSE)
+    #define SX_INT4_BINARY_OP(op, sse, neon) \
+        SX_INLINE Int4 operator op(Int4 left, Int4 right){ return {sse(left.Value, right.Value)}; }
+#elif defined(SX_SIMD_NEON)
+    #define SX_INT4_BINARY_OP(op, sse, neon) \
+        SX_INLINE Int4 operator op(Int4 left, Int4 right){ return {neon(left.Value, right.Value)}; }
+#else
+    #define SX_INT4_BINARY_OP(op, sse, neon) \
+        SX_INLINE Int4 operator op(Int4 left, Int4 right){ \
+            Int4 result; \
+            for(int i = 0; i < 4; i++) \
+                result.Value[i] = s32(u32(left.Value[i]) op u32(right.Value[i])); \
+            return result; \
+        }
+#endif
+
+SX_INT4_BINARY_OP(+, _mm_add_epi32, vaddq_s32)
+SX_INT4_BINARY_OP(-, _mm_sub_epi32, vsubq_s32)
+SX_INT4_BINARY_OP(&, _mm_and_si128, vandq_s32)
+SX_INT4_BINARY_OP(|, _mm_or_si128, vorrq_s32)
+
+#undef SX_INT4_BINARY_OP
+
+template<int Count>
+SX_INLINE Int4 ShiftLeft(Int4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_slli_epi32(value.Value, Count)};
+#elif defined(SX_SIMD_NEON)
+    return {vshlq_n_s32(value.Value, Count)};
+#else
+    Int4 result;
+    for(int i = 0; i < 4; i++)
+        result.Value[i] = s32(u32(value.Value[i]) << Count);
+    return result;
+#endif
+}
+
+// shifts zeros in, sign is not extended
+template<int Count>
+SX_INLINE Int4 ShiftRight(Int4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_srli_epi32(value.Value, Count)};
+#elif defined(SX_SIMD_NEON)
+    return {vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(value.Value), Count))};
+#else
+    Int4 result;
+    for(int i = 0; i < 4; i++)
+        result.Value[i] = s32(u32(value.Value[i]) >> Count);
+    return result;
+#endif
+}
+
+// rounds toward zero, lanes out of the s32 range are unspecified
+SX_INLINE Int4 ConvertToInt4(Float4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_cvttps_epi32(value.Value)};
+#elif defined(SX_SIMD_NEON)
+    return {vcvtq_s32_f32(value.Value)};
+#else
+    return {{s32(value.Value[0]), s32(value.Value[1]), s32(value.Value[2]), s32(value.Value[3])}};
+#endif
+}
+
+SX_INLINE Float4 ConvertToFloat4(Int4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_cvtepi32_ps(value.Value)};
+#elif defined(SX_SIMD_NEON)
+    return {vcvtq_f32_s32(value.Value)};
+#else
+    return {{float(value.Value[0]), float(value.Value[1]), float(value.Value[2]), float(value.Value[3])}};
+#endif
+}
+
+SX_INLINE Int4 BitCastToInt4(Float4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_castps_si128(value.Value)};
+#elif defined(SX_SIMD_NEON)
+    return {vreinterpretq_s32_f32(value.Value)};
+#else
+    Int4 result;
+    memcpy(result.Value, value.Value, sizeof(result.Value));
+    return result;
+#endif
+}
+
+SX_INLINE Float4 BitCastToFloat4(Int4 value){
+#if defined(SX_SIMD_SSE)
+    return {_mm_castsi128_ps(value.Value)};
+#elif defined(SX_SIMD_NEON)
+    return {vreinterpretq_f32_s32(value.Value)};
+#else
+    Float4 result;
+    memcpy(result.Value, value.Value, sizeof(result.Value));
+    return result;
+#endif
+}
+
+// Comparisons give masks with all bits set in lanes where they hold and cleared elsewhere,
+// masks pick lanes with Select
+
+#if defined(SX_SIMD_SSE)
+    #define SX_FLOAT4_COMPARE(name, op, sse, neon) \
+        SX_INLINE Float4 name(Float4 left, Float4 right){ return {sse(left.Value, right.Value)}; }
+#elif defined(SX_SIMD_NEON)
+    #define SX_FLOAT4_COMPARE(name, op, sse, neon) \
+        SX_INLINE Float4 name(Float4 left, Float4 right){ return {vreinterpretq_f32_u32(neon(left.Value, right.Value))}; }
+#else
+    #define SX_FLOAT4_COMPARE(name, op, sse, neon) \
+        SX_INLINE Float4 name(Float4 left, Float4 right){ \
+            Int4 mask; \
+            for(int i = 0; i < 4; i++) \
+                mask.Value[i] = left.Value[i] op right.Value[i] ? -1 : 0; \
+            return BitCastToFloat4(mask); \
+        }
+#endif
+
+SX_FLOAT4_COMPARE(CompareLess, <, _mm_cmplt_ps, vcltq_f32)
+SX_FLOAT4_COMPARE(CompareGreater, >, _mm_cmpgt_ps, vcgtq_f32)
+SX_FLOAT4_COMPARE(CompareEqual, ==, _mm_cmpeq_ps, vceqq_f32)
+
+#undef SX_FLOAT4_COMPARE
+
+SX_INLINE Float4 Select(Float4 mask, Float4 if_true, Float4 if_false){
+#if defined(SX_SIMD_SSE)
+    return {_mm_or_ps(_mm_and_ps(mask.Value, if_true.Value), _mm_andnot_ps(mask.Value, if_false.Value))};
+#elif defined(SX_SIMD_NEON)
+    return {vbslq_f32(vreinterpretq_u32_f32(mask.Value), if_true.Value, if_false.Value)};
+#else
+    const Int4 bits = BitCastToInt4(mask);
+    Float4 result;
+    for(int i = 0; i < 4; i++)
+        result.Value[i] = bits.Value[i] ? if_true.Value[i] : if_false.Value[i];
+    return result;
+#endif
+}
+
+#endif//STRAITX_SIMD_HPP
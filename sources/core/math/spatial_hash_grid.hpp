@@ -0,0 +1,506 @@
+#ifndef STRAITX_SPATIAL_HASH_GRID_HPP
+#define STRAITX_SPATIAL_HASH_GRID_HPP
+
+#include <cmath>
+#include "core/types.hpp"
+#include "core/list.hpp"
+#include "core/pair.hpp"
+#include "core/move.hpp"
+#include "core/assert.hpp"
+#include "core/algorithm.hpp"
+#include "core/noncopyable.hpp"
+#include "core/math/functions.hpp"
+#include "core/math/vector2.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/aabb2.hpp"
+#include "core/math/aabb3.hpp"
+
+namespace Details{
+
+template<size_t Dim>
+struct SpatialHashGridTraits;
+
+template<>
+struct SpatialHashGridTraits<2>{
+    using VectorType = Vector2f;
+    using AABBType = AABB2f;
+};
+
+template<>
+struct SpatialHashGridTraits<3>{
+    using VectorType = Vector3f;
+    using AABBType = AABB3f;
+};
+
+}//namespace Details::
+
+// Broadphase over a uniform grid, hashed so only occupied cells take memory. Elements are registered
+// in every cell their box touches, so cell size should be about the size of typical elements,
+// much larger ones land in many cells and make updates slow. Handles are reused after Remove.
+// Queries report each element once without any marking: an element or a pair is only reported from
+// the first cell, along every axis, of the region both boxes cover
+template<size_t DimValue>
+class SpatialHashGrid: public NonCopyable{
+public:
+    static constexpr size_t Dim = DimValue;
+    static constexpr u32 InvalidHandle = u32(-1);
+
+    static_assert(Dim == 2 || Dim == 3, "SpatialHashGrid: only 2D and 3D grids are supported");
+
+    using VectorType = typename Details::SpatialHashGridTraits<Dim>::VectorType;
+    using AABBType = typename Details::SpatialHashGridTraits<Dim>::AABBType;
+private:
+    static constexpr u32 InvalidIndex = u32(-1);
+    // keeps cell coordinates far from overflow, elements beyond it share the border cells
+    static constexpr float MaxCellCoordinate = float(1 << 30);
+
+    struct CellCoordinates{
+        s32 Data[Dim];
+
+        bool operator==(const CellCoordinates &other)const;
+    };
+
+    struct CellRange{
+        CellCoordinates Min;
+        CellCoordinates Max;
+
+        bool Contains(const CellCoordinates &coordinates)const;
+    };
+
+    struct Entry{
+        AABBType Bounds;
+        CellRange Cells;
+        bool IsAlive;
+    };
+
+    struct Cell{
+        CellCoordinates Coordinates;
+        List<u32> Handles;
+    };
+
+    // coordinates are repeated here, so probing doesn't touch the cells
+    struct Slot{
+        CellCoordinates Coordinates;
+        u32 Cell;
+    };
+
+    float m_CellSize;
+    float m_InverseCellSize;
+    List<Entry> m_Entries;
+    List<u32> m_FreeHandles;
+    size_t m_Size = 0;
+    // occupied cells only, empty ones are removed right away
+    List<Cell> m_Cells;
+    // open addressing with linear probing, empty slots have InvalidIndex cell
+    List<Slot> m_Slots;
+public:
+    SpatialHashGrid(float cell_size);
+
+    SpatialHashGrid(SpatialHashGrid &&other);
+
+    SpatialHashGrid &operator=(SpatialHashGrid &&other);
+
+    u32 Insert(const AABBType &bounds);
+
+    // Only cells the element entered or left are touched, moving within the same cells just updates the box
+    void Update(u32 handle, const AABBType &bounds);
+
+    void Remove(u32 handle);
+
+    void Clear();
+
+    const AABBType &Bounds(u32 handle)const;
+
+    // appends handles of the elements intersecting the box
+    void Query(const AABBType &box, List<u32> &handles)const;
+
+    // appends handles of the elements which boxes are within the radius from the center
+    void Query(const VectorType &center, float radius, List<u32> &handles)const;
+
+    // Appends every pair of intersecting elements in a single pass over the cells, smaller handle goes first
+    void FindPairs(List<Pair<u32, u32>> &pairs)const;
+
+    size_t Size()const;
+
+    size_t CellsCount()const;
+
+    float CellSize()const;
+private:
+    CellRange CellsOf(const AABBType &bounds)const;
+
+    u32 FindCell(const CellCoordinates &coordinates)const;
+
+    void AddToCell(const CellCoordinates &coordinates, u32 handle);
+
+    void RemoveFromCell(const CellCoordinates &coordinates, u32 handle);
+
+    void RemoveCell(u32 index);
+
+    size_t FindSlot(const CellCoordinates &coordinates)const;
+
+    void EraseSlot(size_t slot);
+
+    void Rehash(size_t slots_count);
+
+    size_t HomeSlot(const CellCoordinates &coordinates)const;
+
+    // walks occupied cells instead of the range when there are fewer of them
+    template<typename FunctionType>
+    void ForEachCellIn(const CellRange &range, FunctionType function)const;
+
+    template<typename FunctionType>
+    static void ForEachCoordinates(const CellRange &range, FunctionType function);
+
+    // first cell of the region both ranges cover
+    static CellCoordinates FirstCommonCell(const CellRange &left, const CellRange &right);
+};
+
+template<size_t DimValue>
+bool SpatialHashGrid<DimValue>::CellCoordinates::operator==(const CellCoordinates &other)const{
+    for(size_t axis = 0; axis < Dim; axis++){
+        if(Data[axis] != other.Data[axis])
+            return false;
+    }
+    return true;
+}
+
+template<size_t DimValue>
+bool SpatialHashGrid<DimValue>::CellRange::Contains(const CellCoordinates &coordinates)const{
+    for(size_t axis = 0; axis < Dim; axis++){
+        if(coordinates.Data[axis] < Min.Data[axis] || coordinates.Data[axis] > Max.Data[axis])
+            return false;
+    }
+    return true;
+}
+
+template<size_t DimValue>
+SpatialHashGrid<DimValue>::SpatialHashGrid(float cell_size):
+    m_CellSize(cell_size),
+    m_InverseCellSize(1.f / cell_size)
+{
+    SX_CORE_ASSERT(cell_size > 0.f, "SpatialHashGrid: cell size should be positive");
+}
+
+template<size_t DimValue>
+SpatialHashGrid<DimValue>::SpatialHashGrid(SpatialHashGrid &&other){
+    *this = Move(other);
+}
+
+template<size_t DimValue>
+SpatialHashGrid<DimValue> &SpatialHashGrid<DimValue>::operator=(SpatialHashGrid &&other){
+    m_CellSize = other.m_CellSize;
+    m_InverseCellSize = other.m_InverseCellSize;
+    m_Entries = Move(other.m_Entries);
+    m_FreeHandles = Move(other.m_FreeHandles);
+    m_Size = other.m_Size;
+    m_Cells = Move(other.m_Cells);
+    m_Slots = Move(other.m_Slots);
+    other.m_Size = 0;
+    return *this;
+}
+
+template<size_t DimValue>
+u32 SpatialHashGrid<DimValue>::Insert(const AABBType &bounds){
+    const Entry entry{bounds, CellsOf(bounds), true};
+
+    u32 handle;
+    if(m_FreeHandles.Size()){
+        handle = m_FreeHandles.Last();
+        m_FreeHandles.RemoveLast();
+        m_Entries[handle] = entry;
+    }else{
+        handle = u32(m_Entries.Size());
+        m_Entries.Add(entry);
+    }
+    m_Size++;
+
+    ForEachCoordinates(entry.Cells, [&](const CellCoordinates &coordinates){
+        AddToCell(coordinates, handle);
+    });
+    return handle;
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::Update(u32 handle, const AABBType &bounds){
+    SX_CORE_ASSERT(handle < m_Entries.Size() && m_Entries[handle].IsAlive, "SpatialHashGrid: invalid handle");
+
+    Entry &entry = m_Entries[handle];
+    const CellRange old_cells = entry.Cells;
+    const CellRange new_cells = CellsOf(bounds);
+
+    entry.Bounds = bounds;
+    entry.Cells = new_cells;
+
+    if(old_cells.Min == new_cells.Min && old_cells.Max == new_cells.Max)
+        return;
+
+    ForEachCoordinates(old_cells, [&](const CellCoordinates &coordinates){
+        if(!new_cells.Contains(coordinates))
+            RemoveFromCell(coordinates, handle);
+    });
+    ForEachCoordinates(new_cells, [&](const CellCoordinates &coordinates){
+        if(!old_cells.Contains(coordinates))
+            AddToCell(coordinates, handle);
+    });
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::Remove(u32 handle){
+    SX_CORE_ASSERT(handle < m_Entries.Size() && m_Entries[handle].IsAlive, "SpatialHashGrid: invalid handle");
+
+    Entry &entry = m_Entries[handle];
+    ForEachCoordinates(entry.Cells, [&](const CellCoordinates &coordinates){
+        RemoveFromCell(coordinates, handle);
+    });
+
+    entry.IsAlive = false;
+    m_FreeHandles.Add(handle);
+    m_Size--;
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::Clear(){
+    m_Entries.Clear();
+    m_FreeHandles.Clear();
+    m_Size = 0;
+    m_Cells.Clear();
+    m_Slots.Clear();
+}
+
+template<size_t DimValue>
+const typename SpatialHashGrid<DimValue>::AABBType &SpatialHashGrid<DimValue>::Bounds(u32 handle)const{
+    SX_CORE_ASSERT(handle < m_Entries.Size() && m_Entries[handle].IsAlive, "SpatialHashGrid: invalid handle");
+    return m_Entries[handle].Bounds;
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::Query(const AABBType &box, List<u32> &handles)const{
+    const CellRange range = CellsOf(box);
+
+    ForEachCellIn(range, [&](const Cell &cell){
+        for(u32 handle: cell.Handles){
+            const Entry &entry = m_Entries[handle];
+            if(entry.Bounds.Intersects(box) && FirstCommonCell(entry.Cells, range) == cell.Coordinates)
+                handles.Add(handle);
+        }
+    });
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::Query(const VectorType &center, float radius, List<u32> &handles)const{
+    const AABBType box(center - VectorType(radius), VectorType(radius * 2.f));
+    const CellRange range = CellsOf(box);
+
+    ForEachCellIn(range, [&](const Cell &cell){
+        for(u32 handle: cell.Handles){
+            const Entry &entry = m_Entries[handle];
+            if(!(FirstCommonCell(entry.Cells, range) == cell.Coordinates))
+                continue;
+
+            float distance_squared = 0.f;
+            for(size_t axis = 0; axis < Dim; axis++){
+                const float nearest = Math::Clamp(center.Data[axis], entry.Bounds.Min.Data[axis], entry.Bounds.Max.Data[axis]);
+                const float offset = center.Data[axis] - nearest;
+                distance_squared += offset * offset;
+            }
+            if(distance_squared <= radius * radius)
+                handles.Add(handle);
+        }
+    });
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::FindPairs(List<Pair<u32, u32>> &pairs)const{
+    for(const Cell &cell: m_Cells){
+        const u32 *handles = cell.Handles.Data();
+        const size_t count = cell.Handles.Size();
+
+        for(size_t i = 0; i < count; i++){
+            const Entry &left = m_Entries[handles[i]];
+
+            for(size_t j = i + 1; j < count; j++){
+                const Entry &right = m_Entries[handles[j]];
+
+                if(left.Bounds.Intersects(right.Bounds) && FirstCommonCell(left.Cells, right.Cells) == cell.Coordinates)
+                    pairs.Add({Min(handles[i], handles[j]), Max(handles[i], handles[j])});
+            }
+        }
+    }
+}
+
+template<size_t DimValue>
+size_t SpatialHashGrid<DimValue>::Size()const{
+    return m_Size;
+}
+
+template<size_t DimValue>
+size_t SpatialHashGrid<DimValue>::CellsCount()const{
+    return m_Cells.Size();
+}
+
+template<size_t DimValue>
+float SpatialHashGrid<DimValue>::CellSize()const{
+    return m_CellSize;
+}
+
+template<size_t DimValue>
+typename SpatialHashGrid<DimValue>::CellRange SpatialHashGrid<DimValue>::CellsOf(const AABBType &bounds)const{
+    CellRange range;
+    for(size_t axis = 0; axis < Dim; axis++){
+        const float min = floorf(bounds.Min.Data[axis] * m_InverseCellSize);
+        const float max = floorf(bounds.Max.Data[axis] * m_InverseCellSize);
+        range.Min.Data[axis] = s32(Math::Clamp(min, -MaxCellCoordinate, MaxCellCoordinate));
+        range.Max.Data[axis] = s32(Math::Clamp(max, -MaxCellCoordinate, MaxCellCoordinate));
+    }
+    return range;
+}
+
+template<size_t DimValue>
+u32 SpatialHashGrid<DimValue>::FindCell(const CellCoordinates &coordinates)const{
+    if(!m_Slots.Size())
+        return InvalidIndex;
+    return m_Slots[FindSlot(coordinates)].Cell;
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::AddToCell(const CellCoordinates &coordinates, u32 handle){
+    // load factor is kept at or below one half
+    if((m_Cells.Size() + 1) * 2 > m_Slots.Size())
+        Rehash(Max<size_t>(m_Slots.Size() * 2, 64));
+
+    Slot &slot = m_Slots[FindSlot(coordinates)];
+    if(slot.Cell == InvalidIndex){
+        slot = {coordinates, u32(m_Cells.Size())};
+        m_Cells.Add({coordinates, {}});
+    }
+    m_Cells[slot.Cell].Handles.Add(handle);
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::RemoveFromCell(const CellCoordinates &coordinates, u32 handle){
+    const u32 index = FindCell(coordinates);
+    SX_CORE_ASSERT(index != InvalidIndex, "SpatialHashGrid: element is missing from its cell");
+
+    List<u32> &handles = m_Cells[index].Handles;
+    const bool is_removed = handles.UnorderedRemove(handle);
+    SX_CORE_ASSERT(is_removed, "SpatialHashGrid: element is missing from its cell");
+    (void)is_removed;
+
+    if(!handles.Size())
+        RemoveCell(index);
+}
+
+// the last cell takes the place of the removed one, so cells stay contiguous
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::RemoveCell(u32 index){
+    EraseSlot(FindSlot(m_Cells[index].Coordinates));
+
+    const u32 last = u32(m_Cells.Size() - 1);
+    if(index != last){
+        m_Slots[FindSlot(m_Cells[last].Coordinates)].Cell = index;
+        m_Cells[index] = Move(m_Cells[last]);
+    }
+    m_Cells.RemoveLast();
+}
+
+// slot of the cell or the empty slot it would take
+template<size_t DimValue>
+size_t SpatialHashGrid<DimValue>::FindSlot(const CellCoordinates &coordinates)const{
+    const size_t mask = m_Slots.Size() - 1;
+
+    size_t slot = HomeSlot(coordinates);
+    while(m_Slots[slot].Cell != InvalidIndex && !(m_Slots[slot].Coordinates == coordinates))
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+// Backward shift deletion, entries after the hole move into it unless that puts them before their home slot
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::EraseSlot(size_t slot){
+    const size_t mask = m_Slots.Size() - 1;
+
+    size_t hole = slot;
+    for(size_t i = (slot + 1) & mask; m_Slots[i].Cell != InvalidIndex; i = (i + 1) & mask){
+        const size_t home = HomeSlot(m_Slots[i].Coordinates);
+
+        if(((i - home) & mask) >= ((i - hole) & mask)){
+            m_Slots[hole] = m_Slots[i];
+            hole = i;
+        }
+    }
+    m_Slots[hole].Cell = InvalidIndex;
+}
+
+template<size_t DimValue>
+void SpatialHashGrid<DimValue>::Rehash(size_t slots_count){
+    m_Slots.Clear();
+    m_Slots.Resize(slots_count);
+    for(Slot &slot: m_Slots)
+        slot.Cell = InvalidIndex;
+
+    for(u32 i = 0; i < m_Cells.Size(); i++)
+        m_Slots[FindSlot(m_Cells[i].Coordinates)] = {m_Cells[i].Coordinates, i};
+}
+
+template<size_t DimValue>
+size_t SpatialHashGrid<DimValue>::HomeSlot(const CellCoordinates &coordinates)const{
+    u64 hash = 0;
+    for(size_t axis = 0; axis < Dim; axis++)
+        hash = (hash ^ u32(coordinates.Data[axis])) * 0x9E3779B97F4A7C15ull;
+    return size_t(hash >> 32) & (m_Slots.Size() - 1);
+}
+
+template<size_t DimValue>
+template<typename FunctionType>
+void SpatialHashGrid<DimValue>::ForEachCellIn(const CellRange &range, FunctionType function)const{
+    double range_cells = 1.0;
+    for(size_t axis = 0; axis < Dim; axis++)
+        range_cells *= double(range.Max.Data[axis]) - double(range.Min.Data[axis]) + 1.0;
+
+    if(range_cells > double(m_Cells.Size())){
+        for(const Cell &cell: m_Cells){
+            if(range.Contains(cell.Coordinates))
+                function(cell);
+        }
+        return;
+    }
+
+    ForEachCoordinates(range, [&](const CellCoordinates &coordinates){
+        const u32 index = FindCell(coordinates);
+        if(index != InvalidIndex)
+            function(m_Cells[index]);
+    });
+}
+
+template<size_t DimValue>
+template<typename FunctionType>
+void SpatialHashGrid<DimValue>::ForEachCoordinates(const CellRange &range, FunctionType function){
+    CellCoordinates coordinates = range.Min;
+    for(;;){
+        function(coordinates);
+
+        size_t axis = 0;
+        for(; axis < Dim; axis++){
+            if(coordinates.Data[axis] < range.Max.Data[axis]){
+                coordinates.Data[axis]++;
+                break;
+            }
+            coordinates.Data[axis] = range.Min.Data[axis];
+        }
+        if(axis == Dim)
+            return;
+    }
+}
+
+template<size_t DimValue>
+typename SpatialHashGrid<DimValue>::CellCoordinates SpatialHashGrid<DimValue>::FirstCommonCell(const CellRange &left, const CellRange &right){
+    CellCoordinates coordinates;
+    for(size_t axis = 0; axis < Dim; axis++)
+        coordinates.Data[axis] = Max(left.Min.Data[axis], right.Min.Data[axis]);
+    return coordinates;
+}
+
+using SpatialHashGrid2D = SpatialHashGrid<2>;
+using SpatialHashGrid3D = SpatialHashGrid<3>;
+
+#endif//STRAITX_SPATIAL_HASH_GRID_HPP
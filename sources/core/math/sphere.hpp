@@ -0,0 +1,31 @@
+#ifndef STRAITX_SPHERE_HPP
+#define STRAITX_SPHERE_HPP
+
+#include "core/math/vector3.hpp"
+
+template <typename Type>
+struct Sphere {
+	Vector3<Type> Center;
+	Type Radius;
+
+	Sphere(const Vector3<Type> &center, Type radius):
+		Center(center),
+		Radius(radius)
+	{}
+
+	bool Inside(const Vector3<Type>& point)const{
+		const Vector3<Type> offset = point - Center;
+		return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= Radius * Radius;
+	}
+
+	bool Intersects(const Sphere<Type> &other)const{
+		const Vector3<Type> offset = other.Center - Center;
+		const Type radius = Radius + other.Radius;
+		return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= radius * radius;
+	}
+};
+
+using Spheref = Sphere<float>;
+using Sphered = Sphere<double>;
+
+#endif//STRAITX_SPHERE_HPP
@@ -44,7 +44,7 @@ constexpr Matrix4<MatrixType> Rotate(Vector3<AngleType> radians){
 
 template<typename MatrixType>
 constexpr Matrix4<MatrixType> Translate(const Vector3<MatrixType> &translation) {
-    Matrix4f matrix{1};
+    Matrix4<MatrixType> matrix(static_cast<MatrixType>(1));
     for (int i = 0; i < 3; i++)
         matrix[i][3] = translation[i];
     return matrix;
@@ -52,7 +52,7 @@ constexpr Matrix4<MatrixType> Translate(const Vector3<MatrixType> &translation)
 
 template<typename MatrixType>
 constexpr Matrix4<MatrixType> Scale(const Vector3<MatrixType>& scale) {
-    Matrix4f matrix{ 1 };
+    Matrix4<MatrixType> matrix(static_cast<MatrixType>(1));
     for (int i = 0; i < 3; i++)
         matrix[i][i] = scale[i];
     return matrix;
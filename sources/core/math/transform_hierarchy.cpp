@@ -0,0 +1,346 @@
+#include "core/math/transform_hierarchy.hpp"
+#include "core/math/simd.hpp"
+#include "core/os/thread_pool.hpp"
+#include "core/algorithm.hpp"
+
+// dirty nodes are split between threads in chunks that large
+static constexpr size_t UpdateGrain = 1024;
+
+struct LocalTransforms{
+    const float *Position[3];
+    const float *Rotation[4];
+    const float *Scale[3];
+};
+
+// Builds T * R * S for four nodes at once, a node per lane. Components are gathered into lanes,
+// every matrix row is computed as four columns across nodes and transposed into rows of the nodes
+static void BuildLocalMatrices(const LocalTransforms &locals, const u32 indices[4], Matrix4f result[4]){
+    const auto gather = [indices](const float *component){
+        return Float4::Set(component[indices[0]], component[indices[1]], component[indices[2]], component[indices[3]]);
+    };
+
+    const Float4 x = gather(locals.Rotation[0]), y = gather(locals.Rotation[1]);
+    const Float4 z = gather(locals.Rotation[2]), w = gather(locals.Rotation[3]);
+    const Float4 scale[3] = {gather(locals.Scale[0]), gather(locals.Scale[1]), gather(locals.Scale[2])};
+
+    const Float4 one = Float4::Splat(1.f), two = Float4::Splat(2.f);
+    const Float4 xx = x * x, yy = y * y, zz = z * z;
+    const Float4 xy = x * y, xz = x * z, yz = y * z;
+    const Float4 wx = w * x, wy = w * y, wz = w * z;
+
+    const Float4 rotation[3][3] = {
+        {one - two * (yy + zz), two * (xy - wz), two * (xz + wy)},
+        {two * (xy + wz), one - two * (xx + zz), two * (yz - wx)},
+        {two * (xz - wy), two * (yz + wx), one - two * (xx + yy)}
+    };
+
+    for(size_t row = 0; row < 3; row++){
+        Float4 lanes[4] = {
+            rotation[row][0] * scale[0],
+            rotation[row][1] * scale[1],
+            rotation[row][2] * scale[2],
+            gather(locals.Position[row])
+        };
+
+        Transpose(lanes[0], lanes[1], lanes[2], lanes[3]);
+
+        for(size_t i = 0; i < 4; i++)
+            lanes[i].Store(result[i].Rows[row].Data);
+    }
+
+    for(size_t i = 0; i < 4; i++)
+        result[i].Rows[3] = Vector4f(0.f, 0.f, 0.f, 1.f);
+}
+
+TransformHierarchy::TransformHierarchy(TransformHierarchy &&other){
+    *this = Move(other);
+}
+
+TransformHierarchy &TransformHierarchy::operator=(TransformHierarchy &&other){
+    m_Positions = Move(other.m_Positions);
+    m_Rotations = Move(other.m_Rotations);
+    m_Scales = Move(other.m_Scales);
+    m_Parents = Move(other.m_Parents);
+    m_Depths = Move(other.m_Depths);
+    m_IsDirty = Move(other.m_IsDirty);
+    m_Worlds = Move(other.m_Worlds);
+    m_Handles = Move(other.m_Handles);
+    m_Indices = Move(other.m_Indices);
+    m_FreeHandles = Move(other.m_FreeHandles);
+    m_FirstDirty = other.m_FirstDirty;
+    other.m_FirstDirty = 0;
+    return *this;
+}
+
+u32 TransformHierarchy::Create(u32 parent){
+    return Create(Vector3f(0.f), Quaternionf(), Vector3f(1.f), parent);
+}
+
+u32 TransformHierarchy::Create(const Vector3f &position, const Quaternionf &rotation, const Vector3f &scale, u32 parent){
+    const u32 parent_index = parent == InvalidHandle ? InvalidHandle : IndexOf(parent);
+    const u32 index = (u32)Size();
+
+    u32 handle = InvalidHandle;
+    if(m_FreeHandles.Size()){
+        handle = m_FreeHandles.Last();
+        m_FreeHandles.RemoveLast();
+    }else{
+        handle = (u32)m_Indices.Size();
+        m_Indices.Add(InvalidHandle);
+    }
+    m_Indices[handle] = index;
+
+    m_Positions.Resize(index + 1);
+    m_Rotations.Resize(index + 1);
+    m_Scales.Resize(index + 1);
+    m_Positions.Set(index, position);
+    m_Rotations.Set(index, {rotation.x, rotation.y, rotation.z, rotation.w});
+    m_Scales.Set(index, scale);
+
+    m_Parents.Add(parent_index);
+    m_Depths.Add(parent_index == InvalidHandle ? 0 : m_Depths[parent_index] + 1);
+    m_IsDirty.Add(0);
+    m_Worlds.Add(Matrix4f());
+    m_Handles.Add(handle);
+
+    MarkDirty(index);
+    return handle;
+}
+
+void TransformHierarchy::Destroy(u32 handle){
+    const size_t count = MoveToEnd(IndexOf(handle));
+    const size_t size = Size() - count;
+
+    for(size_t i = size; i < Size(); i++){
+        m_Indices[m_Handles[i]] = InvalidHandle;
+        m_FreeHandles.Add(m_Handles[i]);
+    }
+
+    m_Positions.Resize(size);
+    m_Rotations.Resize(size);
+    m_Scales.Resize(size);
+    m_Parents.Resize(size);
+    m_Depths.Resize(size);
+    m_IsDirty.Resize(size);
+    m_Worlds.Resize(size);
+    m_Handles.Resize(size);
+    m_FirstDirty = Min(m_FirstDirty, size);
+}
+
+void TransformHierarchy::SetParent(u32 handle, u32 parent){
+    u32 index = IndexOf(handle);
+    u32 parent_index = parent == InvalidHandle ? InvalidHandle : IndexOf(parent);
+
+    for(u32 ancestor = parent_index; ancestor != InvalidHandle; ancestor = m_Parents[ancestor]){
+        SX_CORE_ASSERT(ancestor != index, "TransformHierarchy: node can't be parented to itself or its descendant");
+        if(ancestor == index)
+            return;
+    }
+
+    // subtree goes after the parent, the rest stays in order
+    if(parent_index != InvalidHandle && parent_index > index){
+        const size_t count = MoveToEnd(index);
+        index = u32(Size() - count);
+        parent_index = m_Indices[parent];
+    }
+    m_Parents[index] = parent_index;
+
+    // descendants follow the node in the array, so one pass fixes their depths
+    m_Depths[index] = parent_index == InvalidHandle ? 0 : m_Depths[parent_index] + 1;
+    for(size_t i = index + 1; i < Size(); i++){
+        if(m_Parents[i] != InvalidHandle && m_Parents[i] >= index)
+            m_Depths[i] = m_Depths[m_Parents[i]] + 1;
+    }
+
+    MarkDirty(index);
+}
+
+void TransformHierarchy::SetPosition(u32 handle, const Vector3f &position){
+    const u32 index = IndexOf(handle);
+    m_Positions.Set(index, position);
+    MarkDirty(index);
+}
+
+void TransformHierarchy::SetRotation(u32 handle, const Quaternionf &rotation){
+    const u32 index = IndexOf(handle);
+    m_Rotations.Set(index, {rotation.x, rotation.y, rotation.z, rotation.w});
+    MarkDirty(index);
+}
+
+void TransformHierarchy::SetScale(u32 handle, const Vector3f &scale){
+    const u32 index = IndexOf(handle);
+    m_Scales.Set(index, scale);
+    MarkDirty(index);
+}
+
+void TransformHierarchy::SetLocal(u32 handle, const Vector3f &position, const Quaternionf &rotation, const Vector3f &scale){
+    const u32 index = IndexOf(handle);
+    m_Positions.Set(index, position);
+    m_Rotations.Set(index, {rotation.x, rotation.y, rotation.z, rotation.w});
+    m_Scales.Set(index, scale);
+    MarkDirty(index);
+}
+
+void TransformHierarchy::Update(){
+    CollectDirty();
+    UpdateNodes(m_DirtyIndices.Data(), m_DirtyIndices.Size());
+}
+
+void TransformHierarchy::Update(ThreadPool &pool){
+    CollectDirty();
+
+    if(m_DirtyIndices.Size() < ParallelUpdateThreshold)
+        return UpdateNodes(m_DirtyIndices.Data(), m_DirtyIndices.Size());
+
+    // stable counting sort of dirty nodes by depth, levels are then updated one after another
+    m_LevelOffsets.Clear();
+    for(u32 index: m_DirtyIndices){
+        const u32 depth = m_Depths[index];
+        if(depth + 2 > m_LevelOffsets.Size())
+            m_LevelOffsets.Resize(depth + 2);
+        m_LevelOffsets[depth + 1]++;
+    }
+    for(size_t i = 1; i < m_LevelOffsets.Size(); i++)
+        m_LevelOffsets[i] += m_LevelOffsets[i - 1];
+
+    m_LevelIndices.Resize(m_DirtyIndices.Size());
+    for(u32 index: m_DirtyIndices)
+        m_LevelIndices[m_LevelOffsets[m_Depths[index]]++] = index;
+
+    u32 begin = 0;
+    for(size_t level = 0; level + 1 < m_LevelOffsets.Size(); level++){
+        // offsets were advanced to the ends of the levels
+        const u32 end = m_LevelOffsets[level];
+        const u32 *indices = m_LevelIndices.Data() + begin;
+
+        pool.ParallelFor(end - begin, UpdateGrain, [this, indices](size_t first, size_t last){
+            UpdateNodes(indices + first, last - first);
+        });
+        begin = end;
+    }
+}
+
+void TransformHierarchy::Clear(){
+    m_Positions.Clear();
+    m_Rotations.Clear();
+    m_Scales.Clear();
+    m_Parents.Clear();
+    m_Depths.Clear();
+    m_IsDirty.Clear();
+    m_Worlds.Clear();
+    m_Handles.Clear();
+    m_Indices.Clear();
+    m_FreeHandles.Clear();
+    m_FirstDirty = 0;
+}
+
+void TransformHierarchy::MarkDirty(u32 index){
+    m_IsDirty[index] = 1;
+    m_FirstDirty = Min(m_FirstDirty, size_t(index));
+}
+
+void TransformHierarchy::CollectDirty(){
+    m_DirtyIndices.Clear();
+
+    // parents are visited first, and everything before m_FirstDirty is clean
+    for(size_t i = m_FirstDirty; i < Size(); i++){
+        const u32 parent = m_Parents[i];
+        if(parent != InvalidHandle && m_IsDirty[parent])
+            m_IsDirty[i] = 1;
+
+        if(m_IsDirty[i])
+            m_DirtyIndices.Add(u32(i));
+    }
+
+    for(u32 index: m_DirtyIndices)
+        m_IsDirty[index] = 0;
+    m_FirstDirty = Size();
+}
+
+// Indices are in an order where parents go before children. Local matrices of a block are built before
+// any world matrix of it, world matrices go one by one, so a parent in the same block is ready before its child
+void TransformHierarchy::UpdateNodes(const u32 *indices, size_t count){
+    const LocalTransforms locals = {
+        {m_Positions.X(), m_Positions.Y(), m_Positions.Z()},
+        {m_Rotations.X(), m_Rotations.Y(), m_Rotations.Z(), m_Rotations.W()},
+        {m_Scales.X(), m_Scales.Y(), m_Scales.Z()}
+    };
+
+    Matrix4f local[4];
+    for(size_t i = 0; i < count; i += 4){
+        const size_t block = Min<size_t>(count - i, 4);
+
+        // the last block repeats its last node, only real ones are stored
+        u32 block_indices[4];
+        for(size_t j = 0; j < 4; j++)
+            block_indices[j] = indices[i + Min(j, block - 1)];
+
+        BuildLocalMatrices(locals, block_indices, local);
+
+        for(size_t j = 0; j < block; j++){
+            const u32 index = block_indices[j];
+            const u32 parent = m_Parents[index];
+            m_Worlds[index] = parent == InvalidHandle ? local[j] : m_Worlds[parent] * local[j];
+        }
+    }
+}
+
+size_t TransformHierarchy::MoveToEnd(u32 index){
+    // m_IsDirty is borrowed to mark the subtree with 2, dirty flags of the rest stay as they are
+    const u8 SubtreeMark = 2;
+    const size_t size = Size();
+
+    size_t count = 0;
+    m_Order.Clear();
+    for(size_t i = index; i < size; i++){
+        const u32 parent = m_Parents[i];
+        if(i == index || (parent != InvalidHandle && m_IsDirty[parent] & SubtreeMark)){
+            m_IsDirty[i] |= SubtreeMark;
+            count++;
+        }else{
+            m_Order.Add(u32(i));
+        }
+    }
+    for(size_t i = index; i < size; i++){
+        if(m_IsDirty[i] & SubtreeMark)
+            m_Order.Add(u32(i));
+    }
+
+    // m_Order holds old indices of [index, size) in the new order, m_Indices gets the new ones
+    for(size_t i = 0; i < m_Order.Size(); i++)
+        m_Indices[m_Handles[m_Order[i]]] = u32(index + i);
+
+    // parents are remapped in place before the handles move
+    for(size_t i = index; i < size; i++){
+        m_IsDirty[i] &= ~SubtreeMark;
+        if(m_Parents[i] != InvalidHandle && m_Parents[i] >= index)
+            m_Parents[i] = m_Indices[m_Handles[m_Parents[i]]];
+    }
+
+    const auto permute = [&](auto *data){
+        using ElementType = typename RemoveReference<decltype(*data)>::Type;
+
+        List<ElementType> moved;
+        moved.Reserve(m_Order.Size());
+        for(u32 old_index: m_Order)
+            moved.Add(data[old_index]);
+        for(size_t i = 0; i < moved.Size(); i++)
+            data[index + i] = moved[i];
+    };
+
+    for(size_t i = 0; i < 3; i++){
+        permute(m_Positions.Component(i));
+        permute(m_Scales.Component(i));
+    }
+    for(size_t i = 0; i < 4; i++)
+        permute(m_Rotations.Component(i));
+    permute(m_Depths.Data());
+    permute(m_IsDirty.Data());
+    permute(m_Worlds.Data());
+    permute(m_Parents.Data());
+    permute(m_Handles.Data());
+
+    // dirty nodes after the subtree move down to the index, they have to stay in front of m_FirstDirty
+    m_FirstDirty = Min(m_FirstDirty, size_t(index));
+    return count;
+}
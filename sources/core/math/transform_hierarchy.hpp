@@ -0,0 +1,153 @@
+#ifndef STRAITX_TRANSFORM_HIERARCHY_HPP
+#define STRAITX_TRANSFORM_HIERARCHY_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/assert.hpp"
+#include "core/noncopyable.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/matrix4.hpp"
+#include "core/math/quaternion.hpp"
+#include "core/math/vector_stream.hpp"
+
+class ThreadPool;
+
+// Scene graph of translation, rotation and scale transforms, world = parent world * T * R * S.
+// Nodes live in a flat array where parents go before their children, local transforms are stored
+// as structure of arrays. Setters mark nodes dirty and Update recomputes world matrices of dirty
+// nodes and their descendants only, the rest keep the ones from previous updates.
+// Handles stay valid until the node is destroyed, positions in the array change with Destroy and SetParent
+class TransformHierarchy: public NonCopyable{
+public:
+    static constexpr u32 InvalidHandle = u32(-1);
+    // ThreadPool overload of Update splits work between threads above that many dirty nodes
+    static constexpr size_t ParallelUpdateThreshold = 8 * 1024;
+private:
+    // by array index
+    Vector3Stream m_Positions;
+    Vector4Stream m_Rotations;
+    Vector3Stream m_Scales;
+    // array index of the parent, InvalidHandle for roots
+    List<u32> m_Parents;
+    // roots are at depth zero
+    List<u32> m_Depths;
+    List<u8> m_IsDirty;
+    List<Matrix4f> m_Worlds;
+    List<u32> m_Handles;
+    // array index of every handle, InvalidHandle for free ones
+    List<u32> m_Indices;
+    List<u32> m_FreeHandles;
+    // every node before it is clean
+    size_t m_FirstDirty = 0;
+
+    // scratch lists reused between updates
+    List<u32> m_DirtyIndices;
+    List<u32> m_LevelIndices;
+    List<u32> m_LevelOffsets;
+    List<u32> m_Order;
+public:
+    TransformHierarchy() = default;
+
+    TransformHierarchy(TransformHierarchy &&other);
+
+    TransformHierarchy &operator=(TransformHierarchy &&other);
+
+    // with identity local transform
+    u32 Create(u32 parent = InvalidHandle);
+
+    u32 Create(const Vector3f &position, const Quaternionf &rotation, const Vector3f &scale, u32 parent = InvalidHandle);
+
+    // destroys descendants as well, their handles become free
+    void Destroy(u32 handle);
+
+    // Local transform is kept, so the node follows its new parent.
+    // Parent can't be the node itself or one of its descendants
+    void SetParent(u32 handle, u32 parent);
+
+    u32 Parent(u32 handle)const;
+
+    void SetPosition(u32 handle, const Vector3f &position);
+
+    void SetRotation(u32 handle, const Quaternionf &rotation);
+
+    void SetScale(u32 handle, const Vector3f &scale);
+
+    void SetLocal(u32 handle, const Vector3f &position, const Quaternionf &rotation, const Vector3f &scale);
+
+    Vector3f Position(u32 handle)const;
+
+    Quaternionf Rotation(u32 handle)const;
+
+    Vector3f Scale(u32 handle)const;
+
+    // as of the last Update
+    const Matrix4f &World(u32 handle)const;
+
+    void Update();
+
+    // Nodes of the same depth don't depend on each other, so every level is split between threads
+    void Update(ThreadPool &pool);
+
+    void Clear();
+
+    size_t Size()const;
+
+    // in the array order, parents go before their children
+    ConstSpan<Matrix4f> WorldMatrices()const;
+
+    ConstSpan<u32> Handles()const;
+private:
+    u32 IndexOf(u32 handle)const;
+
+    void MarkDirty(u32 index);
+
+    // appends dirty nodes and their descendants to m_DirtyIndices in the array order
+    void CollectDirty();
+
+    void UpdateNodes(const u32 *indices, size_t count);
+
+    // Moves the subtree of the node to the end of the array, keeping the order of the rest, returns its size
+    size_t MoveToEnd(u32 index);
+};
+
+SX_INLINE u32 TransformHierarchy::IndexOf(u32 handle)const{
+    SX_CORE_ASSERT(handle < m_Indices.Size() && m_Indices[handle] != InvalidHandle, "TransformHierarchy: invalid handle");
+    return m_Indices[handle];
+}
+
+SX_INLINE u32 TransformHierarchy::Parent(u32 handle)const{
+    const u32 parent = m_Parents[IndexOf(handle)];
+    return parent == InvalidHandle ? InvalidHandle : m_Handles[parent];
+}
+
+SX_INLINE Vector3f TransformHierarchy::Position(u32 handle)const{
+    return m_Positions.Get(IndexOf(handle));
+}
+
+SX_INLINE Quaternionf TransformHierarchy::Rotation(u32 handle)const{
+    const Vector4f rotation = m_Rotations.Get(IndexOf(handle));
+    return {rotation.x, rotation.y, rotation.z, rotation.w};
+}
+
+SX_INLINE Vector3f TransformHierarchy::Scale(u32 handle)const{
+    return m_Scales.Get(IndexOf(handle));
+}
+
+SX_INLINE const Matrix4f &TransformHierarchy::World(u32 handle)const{
+    return m_Worlds[IndexOf(handle)];
+}
+
+SX_INLINE size_t TransformHierarchy::Size()const{
+    return m_Parents.Size();
+}
+
+SX_INLINE ConstSpan<Matrix4f> TransformHierarchy::WorldMatrices()const{
+    return ConstSpan<Matrix4f>(m_Worlds.Data(), m_Worlds.Size());
+}
+
+SX_INLINE ConstSpan<u32> TransformHierarchy::Handles()const{
+    return ConstSpan<u32>(m_Handles.Data(), m_Handles.Size());
+}
+
+#endif//STRAITX_TRANSFORM_HIERARCHY_HPP
@@ -4,10 +4,13 @@
 #include "core/types.hpp"
 #include "core/assert.hpp"
 #include "core/printer.hpp"
+#include "core/type_traits.hpp"
+#include "core/env/compiler.hpp"
 #include "core/math/vector3.hpp"
 
+// Vector4f is aligned to be loaded as a whole SIMD register
 template<typename T>
-struct Vector4{
+struct alignas(IsSame<T, float>::Value ? 16 : alignof(T)) Vector4{
     union{
         struct{
             T x;
@@ -36,9 +39,9 @@ struct Vector4{
     template <typename O>
     constexpr Vector4(const Vector4<O> &other);
 
-    constexpr Vector4 &operator=(const Vector4 &other);
+    constexpr Vector4 &operator=(const Vector4 &other) = default;
 
-    constexpr Vector4 &operator=(Vector4 &&other);    
+    constexpr Vector4 &operator=(Vector4 &&other) = default;
     // acces elements as if vector was an array
     constexpr T &operator[](size_t index);
     // acces const elements as if vector was an array
@@ -99,27 +102,12 @@ constexpr Vector4<T>::Vector4(const Vector4<O> &other):
     w(static_cast<T>(other.w))
 {}
 
-template <typename T>
-constexpr Vector4<T> &Vector4<T>::operator=(const Vector4<T> &other){
-    x=other.x;
-    y=other.y;
-    z=other.z;
-    w=other.w;
-    return *this;
-}
-
-template <typename T>
-constexpr Vector4<T> &Vector4<T>::operator=(Vector4<T> &&other){
-    x=other.x;
-    y=other.y;
-    z=other.z;
-    w=other.w;
-    return *this;
-}
-
 template <typename T>
 constexpr T &Vector4<T>::operator[](size_t index){
     SX_CORE_ASSERT(index < 4,"Vector4 can not index more than 4 elements");
+    // constructors initialize x, y, z and w, reading Data is not a constant expression
+    if(SX_IS_CONSTANT_EVALUATED())
+        return index == 0 ? x : index == 1 ? y : index == 2 ? z : w;
     return Data[index];
 }
 
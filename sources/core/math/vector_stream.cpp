@@ -0,0 +1,125 @@
+#include "core/math/vector_stream.hpp"
+#include "core/math/simd.hpp"
+
+// Each block is computed into locals before it is stored, so result aliasing an argument
+// needs no runtime checks and fixed trip counts leave no scalar remainder to generate
+
+namespace Details{
+
+template<typename OperationType>
+SX_INLINE void ForEachBlock(const float *left, const float *right, float *result, size_t count, OperationType operation){
+    for(size_t i = 0; i < count; i += StreamLanes){
+        float block[StreamLanes];
+        for(size_t j = 0; j < StreamLanes; j++)
+            block[j] = operation(left[i + j], right[i + j]);
+        for(size_t j = 0; j < StreamLanes; j++)
+            result[i + j] = block[j];
+    }
+}
+
+void StreamAdd(const float *left, const float *right, float *result, size_t count){
+    ForEachBlock(left, right, result, count, [](float l, float r){ return l + r; });
+}
+
+void StreamSubtract(const float *left, const float *right, float *result, size_t count){
+    ForEachBlock(left, right, result, count, [](float l, float r){ return l - r; });
+}
+
+void StreamMultiply(const float *left, const float *right, float *result, size_t count){
+    ForEachBlock(left, right, result, count, [](float l, float r){ return l * r; });
+}
+
+void StreamMultiplyAdd(const float *left, float scale, const float *right, float *result, size_t count){
+    ForEachBlock(left, right, result, count, [scale](float l, float r){ return l * scale + r; });
+}
+
+void StreamMin(const float *left, const float *right, float *result, size_t count){
+    ForEachBlock(left, right, result, count, [](float l, float r){ return l < r ? l : r; });
+}
+
+void StreamMax(const float *left, const float *right, float *result, size_t count){
+    ForEachBlock(left, right, result, count, [](float l, float r){ return l > r ? l : r; });
+}
+
+void StreamCross(const float *const left[3], const float *const right[3], float *const result[3], size_t count){
+    const float *lx = left[0], *ly = left[1], *lz = left[2];
+    const float *rx = right[0], *ry = right[1], *rz = right[2];
+
+    for(size_t i = 0; i < count; i += StreamLanes){
+        float x[StreamLanes], y[StreamLanes], z[StreamLanes];
+        for(size_t j = 0; j < StreamLanes; j++){
+            x[j] = ly[i + j] * rz[i + j] - lz[i + j] * ry[i + j];
+            y[j] = lz[i + j] * rx[i + j] - lx[i + j] * rz[i + j];
+            z[j] = lx[i + j] * ry[i + j] - ly[i + j] * rx[i + j];
+        }
+        for(size_t j = 0; j < StreamLanes; j++){
+            result[0][i + j] = x[j];
+            result[1][i + j] = y[j];
+            result[2][i + j] = z[j];
+        }
+    }
+}
+
+// sqrt is not vectorized by compilers while it may set errno, so lengths go through Float4
+void StreamNormalize(const float *const vectors[], float *const result[], size_t components, size_t count){
+    SX_CORE_ASSERT(components <= 4, "Math: Normalize supports up to 4 components");
+
+    for(size_t i = 0; i < count; i += StreamLanes){
+        float lengths[StreamLanes] = {};
+        for(size_t c = 0; c < components; c++){
+            for(size_t j = 0; j < StreamLanes; j++)
+                lengths[j] += vectors[c][i + j] * vectors[c][i + j];
+        }
+
+        for(size_t j = 0; j < StreamLanes; j += 4)
+            Sqrt(Float4::Load(lengths + j)).Store(lengths + j);
+
+        for(size_t c = 0; c < components; c++){
+            float block[StreamLanes];
+            for(size_t j = 0; j < StreamLanes; j++)
+                block[j] = vectors[c][i + j] / lengths[j];
+            for(size_t j = 0; j < StreamLanes; j++)
+                result[c][i + j] = block[j];
+        }
+    }
+}
+
+template<size_t ComponentsCount>
+static void StreamDot(const float *const left[], const float *const right[], float *result, size_t size){
+    for(size_t i = 0; i < size; i += StreamLanes){
+        float block[StreamLanes];
+        for(size_t j = 0; j < StreamLanes; j++)
+            block[j] = left[0][i + j] * right[0][i + j];
+
+        for(size_t c = 1; c < ComponentsCount; c++){
+            for(size_t j = 0; j < StreamLanes; j++)
+                block[j] += left[c][i + j] * right[c][i + j];
+        }
+        // last block is read from the padding, but only its elements are written
+        memcpy(result + i, block, Min(StreamLanes, size - i) * sizeof(float));
+    }
+}
+
+void StreamDot(const float *const left[], const float *const right[], size_t components, float *result, size_t size){
+    switch(components){
+    case 1: StreamDot<1>(left, right, result, size); break;
+    case 2: StreamDot<2>(left, right, result, size); break;
+    case 3: StreamDot<3>(left, right, result, size); break;
+    case 4: StreamDot<4>(left, right, result, size); break;
+    default: SX_CORE_ASSERT(false, "Math: Dot supports up to 4 components");
+    }
+}
+
+void StreamOverlaps(const float *const boxes[6], const AABB3f &box, bool *result, size_t size){
+    for(size_t i = 0; i < size; i += StreamLanes){
+        bool block[StreamLanes];
+        for(size_t j = 0; j < StreamLanes; j++){
+            block[j] = (boxes[0][i + j] <= box.Max.x) & (boxes[3][i + j] >= box.Min.x)
+                     & (boxes[1][i + j] <= box.Max.y) & (boxes[4][i + j] >= box.Min.y)
+                     & (boxes[2][i + j] <= box.Max.z) & (boxes[5][i + j] >= box.Min.z);
+        }
+        memcpy(result + i, block, Min(StreamLanes, size - i) * sizeof(bool));
+    }
+}
+
+}//namespace Details::
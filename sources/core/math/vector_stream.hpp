@@ -0,0 +1,406 @@
+#ifndef STRAITX_VECTOR_STREAM_HPP
+#define STRAITX_VECTOR_STREAM_HPP
+
+#include <cstring>
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/move.hpp"
+#include "core/assert.hpp"
+#include "core/algorithm.hpp"
+#include "core/noncopyable.hpp"
+#include "core/env/compiler.hpp"
+#include "core/allocators/allocator.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/vector4.hpp"
+#include "core/math/aabb3.hpp"
+
+// Structure of arrays storage, every component is a separate float array. Kernels go over
+// whole blocks of StreamLanes elements, so arrays start at StreamAlignment and are padded up to a block,
+// padding past Size holds unspecified values. Blocks are written the way compilers turn into
+// 4, 8 or 16 wide vector instructions depending on the target
+
+constexpr size_t StreamLanes = 16;
+constexpr size_t StreamAlignment = 64;
+
+namespace Details{
+
+// count is a multiple of StreamLanes, result may alias arguments
+void StreamAdd(const float *left, const float *right, float *result, size_t count);
+
+void StreamSubtract(const float *left, const float *right, float *result, size_t count);
+
+void StreamMultiply(const float *left, const float *right, float *result, size_t count);
+
+void StreamMultiplyAdd(const float *left, float scale, const float *right, float *result, size_t count);
+
+void StreamMin(const float *left, const float *right, float *result, size_t count);
+
+void StreamMax(const float *left, const float *right, float *result, size_t count);
+
+void StreamCross(const float *const left[3], const float *const right[3], float *const result[3], size_t count);
+
+void StreamNormalize(const float *const vectors[], float *const result[], size_t components, size_t count);
+
+// size is exact, result is a plain array
+void StreamDot(const float *const left[], const float *const right[], size_t components, float *result, size_t size);
+
+void StreamOverlaps(const float *const boxes[6], const AABB3f &box, bool *result, size_t size);
+
+}//namespace Details::
+
+template<size_t ComponentsCountValue, typename GeneralAllocator = DefaultGeneralAllocator>
+class ComponentStream: public NonCopyable, private GeneralAllocator{
+public:
+    static constexpr size_t ComponentsCount = ComponentsCountValue;
+private:
+    void *m_Memory = nullptr;
+    float *m_Data = nullptr;
+    size_t m_Size = 0;
+    size_t m_Capacity = 0;
+public:
+    ComponentStream() = default;
+
+    ComponentStream(size_t size){
+        Resize(size);
+    }
+
+    ComponentStream(ComponentStream &&other){
+        *this = Move(other);
+    }
+
+    ~ComponentStream(){
+        Free();
+    }
+
+    ComponentStream &operator=(ComponentStream &&other){
+        Free();
+        Swap(m_Memory, other.m_Memory);
+        Swap(m_Data, other.m_Data);
+        Swap(m_Size, other.m_Size);
+        Swap(m_Capacity, other.m_Capacity);
+        return *this;
+    }
+
+    // new elements are zeroed
+    void Resize(size_t size){
+        if(size > m_Capacity)
+            Reserve(Max(size, m_Capacity * 2));
+
+        if(size > m_Size){
+            for(size_t i = 0; i < ComponentsCount; i++)
+                memset(Component(i) + m_Size, 0, (size - m_Size) * sizeof(float));
+        }
+        m_Size = size;
+    }
+
+    void Reserve(size_t capacity){
+        capacity = (capacity + StreamLanes - 1) / StreamLanes * StreamLanes;
+        if(capacity <= m_Capacity)
+            return;
+
+        void *memory = GeneralAllocator::Alloc(ComponentsCount * capacity * sizeof(float) + StreamAlignment);
+        float *data = (float*)(((size_t)memory + StreamAlignment - 1) & ~(StreamAlignment - 1));
+
+        for(size_t i = 0; i < ComponentsCount && m_Size; i++)
+            memcpy(data + i * capacity, Component(i), m_Size * sizeof(float));
+
+        const size_t size = m_Size;
+        Free();
+        m_Memory = memory;
+        m_Data = data;
+        m_Size = size;
+        m_Capacity = capacity;
+    }
+
+    void Clear(){
+        m_Size = 0;
+    }
+
+    void Free(){
+        if(m_Memory)
+            GeneralAllocator::Free(m_Memory);
+        m_Memory = nullptr;
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Capacity = 0;
+    }
+
+    size_t Size()const{
+        return m_Size;
+    }
+
+    size_t Capacity()const{
+        return m_Capacity;
+    }
+
+    // element count kernels go over, Size rounded up to StreamLanes
+    size_t PaddedSize()const{
+        return (m_Size + StreamLanes - 1) / StreamLanes * StreamLanes;
+    }
+
+    float *Component(size_t index){
+        SX_CORE_ASSERT(index < ComponentsCount, "ComponentStream: component index is out of range");
+        return m_Data + index * m_Capacity;
+    }
+
+    const float *Component(size_t index)const{
+        SX_CORE_ASSERT(index < ComponentsCount, "ComponentStream: component index is out of range");
+        return m_Data + index * m_Capacity;
+    }
+};
+
+template<typename GeneralAllocator = DefaultGeneralAllocator>
+class BasicVector3Stream: public ComponentStream<3, GeneralAllocator>{
+public:
+    using ComponentStream<3, GeneralAllocator>::ComponentStream;
+    using ComponentStream<3, GeneralAllocator>::Component;
+    using ComponentStream<3, GeneralAllocator>::Size;
+
+    float *X(){ return Component(0); }
+    float *Y(){ return Component(1); }
+    float *Z(){ return Component(2); }
+
+    const float *X()const{ return Component(0); }
+    const float *Y()const{ return Component(1); }
+    const float *Z()const{ return Component(2); }
+
+    Vector3f Get(size_t index)const{
+        SX_CORE_ASSERT(index < Size(), "Vector3Stream: index is out of range");
+        return {X()[index], Y()[index], Z()[index]};
+    }
+
+    void Set(size_t index, const Vector3f &vector){
+        SX_CORE_ASSERT(index < Size(), "Vector3Stream: index is out of range");
+        X()[index] = vector.x;
+        Y()[index] = vector.y;
+        Z()[index] = vector.z;
+    }
+
+    // resizes the stream to the span
+    void FromAoS(ConstSpan<Vector3f> vectors){
+        this->Resize(vectors.Size());
+        float *x = X(), *y = Y(), *z = Z();
+        for(size_t i = 0; i < vectors.Size(); i++){
+            x[i] = vectors[i].x;
+            y[i] = vectors[i].y;
+            z[i] = vectors[i].z;
+        }
+    }
+
+    void ToAoS(Span<Vector3f> vectors)const{
+        SX_CORE_ASSERT(vectors.Size() == Size(), "Vector3Stream: span should be the same size");
+        const float *x = X(), *y = Y(), *z = Z();
+        for(size_t i = 0; i < vectors.Size(); i++)
+            vectors[i] = {x[i], y[i], z[i]};
+    }
+};
+
+template<typename GeneralAllocator = DefaultGeneralAllocator>
+class BasicVector4Stream: public ComponentStream<4, GeneralAllocator>{
+public:
+    using ComponentStream<4, GeneralAllocator>::ComponentStream;
+    using ComponentStream<4, GeneralAllocator>::Component;
+    using ComponentStream<4, GeneralAllocator>::Size;
+
+    float *X(){ return Component(0); }
+    float *Y(){ return Component(1); }
+    float *Z(){ return Component(2); }
+    float *W(){ return Component(3); }
+
+    const float *X()const{ return Component(0); }
+    const float *Y()const{ return Component(1); }
+    const float *Z()const{ return Component(2); }
+    const float *W()const{ return Component(3); }
+
+    Vector4f Get(size_t index)const{
+        SX_CORE_ASSERT(index < Size(), "Vector4Stream: index is out of range");
+        return {X()[index], Y()[index], Z()[index], W()[index]};
+    }
+
+    void Set(size_t index, const Vector4f &vector){
+        SX_CORE_ASSERT(index < Size(), "Vector4Stream: index is out of range");
+        for(size_t i = 0; i < 4; i++)
+            Component(i)[index] = vector.Data[i];
+    }
+
+    void FromAoS(ConstSpan<Vector4f> vectors){
+        this->Resize(vectors.Size());
+        for(size_t i = 0; i < vectors.Size(); i++){
+            for(size_t j = 0; j < 4; j++)
+                Component(j)[i] = vectors[i].Data[j];
+        }
+    }
+
+    void ToAoS(Span<Vector4f> vectors)const{
+        SX_CORE_ASSERT(vectors.Size() == Size(), "Vector4Stream: span should be the same size");
+        const float *x = X(), *y = Y(), *z = Z(), *w = W();
+        for(size_t i = 0; i < vectors.Size(); i++)
+            vectors[i] = {x[i], y[i], z[i], w[i]};
+    }
+};
+
+// components are MinX, MinY, MinZ, MaxX, MaxY, MaxZ
+template<typename GeneralAllocator = DefaultGeneralAllocator>
+class BasicAABB3Stream: public ComponentStream<6, GeneralAllocator>{
+public:
+    using ComponentStream<6, GeneralAllocator>::ComponentStream;
+    using ComponentStream<6, GeneralAllocator>::Component;
+    using ComponentStream<6, GeneralAllocator>::Size;
+
+    AABB3f Get(size_t index)const{
+        SX_CORE_ASSERT(index < Size(), "AABB3Stream: index is out of range");
+        AABB3f box({}, {});
+        for(size_t i = 0; i < 3; i++){
+            box.Min.Data[i] = Component(i)[index];
+            box.Max.Data[i] = Component(i + 3)[index];
+        }
+        return box;
+    }
+
+    void Set(size_t index, const AABB3f &box){
+        SX_CORE_ASSERT(index < Size(), "AABB3Stream: index is out of range");
+        for(size_t i = 0; i < 3; i++){
+            Component(i)[index] = box.Min.Data[i];
+            Component(i + 3)[index] = box.Max.Data[i];
+        }
+    }
+
+    void FromAoS(ConstSpan<AABB3f> boxes){
+        this->Resize(boxes.Size());
+        for(size_t i = 0; i < boxes.Size(); i++){
+            for(size_t j = 0; j < 3; j++){
+                Component(j)[i] = boxes[i].Min.Data[j];
+                Component(j + 3)[i] = boxes[i].Max.Data[j];
+            }
+        }
+    }
+
+    void ToAoS(Span<AABB3f> boxes)const{
+        SX_CORE_ASSERT(boxes.Size() == Size(), "AABB3Stream: span should be the same size");
+        for(size_t i = 0; i < boxes.Size(); i++){
+            for(size_t j = 0; j < 3; j++){
+                boxes[i].Min.Data[j] = Component(j)[i];
+                boxes[i].Max.Data[j] = Component(j + 3)[i];
+            }
+        }
+    }
+};
+
+using Vector3Stream = BasicVector3Stream<>;
+using Vector4Stream = BasicVector4Stream<>;
+using AABB3Stream = BasicAABB3Stream<>;
+
+namespace Math{
+
+// stream overloads below would hide them inside Math otherwise
+using ::Min;
+using ::Max;
+
+// Element-wise kernels. Result is resized to the arguments' size and may be one of them
+
+namespace Details{
+
+template<size_t ComponentsCount, typename GeneralAllocator, typename KernelType>
+SX_INLINE void ForEachComponent(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result, KernelType kernel){
+    SX_CORE_ASSERT(left.Size() == right.Size(), "Math: streams should be the same size");
+    result.Resize(left.Size());
+
+    for(size_t i = 0; i < ComponentsCount; i++)
+        kernel(left.Component(i), right.Component(i), result.Component(i), left.PaddedSize());
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void ComponentPointers(const ComponentStream<ComponentsCount, GeneralAllocator> &stream, const float *pointers[ComponentsCount]){
+    for(size_t i = 0; i < ComponentsCount; i++)
+        pointers[i] = stream.Component(i);
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void ComponentPointers(ComponentStream<ComponentsCount, GeneralAllocator> &stream, float *pointers[ComponentsCount]){
+    for(size_t i = 0; i < ComponentsCount; i++)
+        pointers[i] = stream.Component(i);
+}
+
+}//namespace Math::Details::
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Add(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    Details::ForEachComponent(left, right, result, ::Details::StreamAdd);
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Subtract(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    Details::ForEachComponent(left, right, result, ::Details::StreamSubtract);
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Multiply(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    Details::ForEachComponent(left, right, result, ::Details::StreamMultiply);
+}
+
+// result = left * scale + right, e.g. position = velocity * dt + position
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void MultiplyAdd(const ComponentStream<ComponentsCount, GeneralAllocator> &left, float scale, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    Details::ForEachComponent(left, right, result, [scale](const float *l, const float *r, float *res, size_t count){
+        ::Details::StreamMultiplyAdd(l, scale, r, res, count);
+    });
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Min(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    Details::ForEachComponent(left, right, result, ::Details::StreamMin);
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Max(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    Details::ForEachComponent(left, right, result, ::Details::StreamMax);
+}
+
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Dot(const ComponentStream<ComponentsCount, GeneralAllocator> &left, const ComponentStream<ComponentsCount, GeneralAllocator> &right, Span<float> result){
+    SX_CORE_ASSERT(left.Size() == right.Size() && left.Size() == result.Size(), "Math: Dot streams and span should be the same size");
+
+    const float *l[ComponentsCount], *r[ComponentsCount];
+    Details::ComponentPointers(left, l);
+    Details::ComponentPointers(right, r);
+    ::Details::StreamDot(l, r, ComponentsCount, result.Pointer(), result.Size());
+}
+
+// zero vectors give NaNs, as Normalize does
+template<size_t ComponentsCount, typename GeneralAllocator>
+SX_INLINE void Normalize(const ComponentStream<ComponentsCount, GeneralAllocator> &vectors, ComponentStream<ComponentsCount, GeneralAllocator> &result){
+    result.Resize(vectors.Size());
+
+    const float *v[ComponentsCount];
+    float *res[ComponentsCount];
+    Details::ComponentPointers(vectors, v);
+    Details::ComponentPointers(result, res);
+    ::Details::StreamNormalize(v, res, ComponentsCount, vectors.PaddedSize());
+}
+
+template<typename GeneralAllocator>
+SX_INLINE void Cross(const BasicVector3Stream<GeneralAllocator> &left, const BasicVector3Stream<GeneralAllocator> &right, BasicVector3Stream<GeneralAllocator> &result){
+    SX_CORE_ASSERT(left.Size() == right.Size(), "Math: Cross streams should be the same size");
+    result.Resize(left.Size());
+
+    const float *l[3], *r[3];
+    float *res[3];
+    Details::ComponentPointers(left, l);
+    Details::ComponentPointers(right, r);
+    Details::ComponentPointers(result, res);
+    ::Details::StreamCross(l, r, res, left.PaddedSize());
+}
+
+// result[i] = boxes[i].Intersects(box)
+template<typename GeneralAllocator>
+SX_INLINE void Overlaps(const BasicAABB3Stream<GeneralAllocator> &boxes, const AABB3f &box, Span<bool> result){
+    SX_CORE_ASSERT(boxes.Size() == result.Size(), "Math: Overlaps stream and span should be the same size");
+
+    const float *b[6];
+    Details::ComponentPointers(boxes, b);
+    ::Details::StreamOverlaps(b, box, result.Pointer(), result.Size());
+}
+
+}//namespace Math::
+
+#endif//STRAITX_VECTOR_STREAM_HPP
@@ -0,0 +1,94 @@
+#include "core/net/byte_order.hpp"
+#include "core/env/arch.hpp"
+
+#if defined(SX_ARCH_X86_64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define SX_BYTE_ORDER_SSE2
+    #if defined(__SSSE3__)
+        #include <tmmintrin.h>
+        #define SX_BYTE_ORDER_SSSE3
+    #endif
+#elif defined(SX_ARCH_ARM_64) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define SX_BYTE_ORDER_NEON
+#endif
+
+// Vector is 16 bytes on every path, ElementSize selects the swap
+template<size_t ElementSize>
+static void SwapVector(const u8 *source, u8 *destination);
+
+#if defined(SX_BYTE_ORDER_SSSE3)
+
+template<size_t ElementSize>
+static void SwapVector(const u8 *source, u8 *destination){
+    static const __m128i s_Masks[] = {
+        _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14),
+        _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12),
+        _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8)
+    };
+    const __m128i mask = s_Masks[ElementSize == 2 ? 0 : ElementSize == 4 ? 1 : 2];
+
+    __m128i value = _mm_loadu_si128((const __m128i*)source);
+    _mm_storeu_si128((__m128i*)destination, _mm_shuffle_epi8(value, mask));
+}
+
+#elif defined(SX_BYTE_ORDER_SSE2)
+
+template<size_t ElementSize>
+static void SwapVector(const u8 *source, u8 *destination){
+    __m128i value = _mm_loadu_si128((const __m128i*)source);
+    // swap bytes inside of 16 bit words, then reorder the words
+    value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+
+    if(ElementSize == 4)
+        value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0xB1), 0xB1);
+    if(ElementSize == 8)
+        value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0x1B), 0x1B);
+
+    _mm_storeu_si128((__m128i*)destination, value);
+}
+
+#elif defined(SX_BYTE_ORDER_NEON)
+
+template<size_t ElementSize>
+static void SwapVector(const u8 *source, u8 *destination){
+    uint8x16_t value = vld1q_u8(source);
+
+    if(ElementSize == 2)
+        value = vrev16q_u8(value);
+    if(ElementSize == 4)
+        value = vrev32q_u8(value);
+    if(ElementSize == 8)
+        value = vrev64q_u8(value);
+
+    vst1q_u8(destination, value);
+}
+
+#endif
+
+template<typename Type>
+static void SwapArray(const Type *source, Type *destination, size_t count){
+    size_t i = 0;
+
+#if defined(SX_BYTE_ORDER_SSE2) || defined(SX_BYTE_ORDER_NEON)
+    constexpr size_t PerVector = 16 / sizeof(Type);
+
+    for(; i + PerVector <= count; i += PerVector)
+        SwapVector<sizeof(Type)>((const u8*)(source + i), (u8*)(destination + i));
+#endif
+
+    for(; i < count; i++)
+        destination[i] = SwapEndianness(source[i]);
+}
+
+void SwapEndianness(const u16 *source, u16 *destination, size_t count){
+    SwapArray(source, destination, count);
+}
+
+void SwapEndianness(const u32 *source, u32 *destination, size_t count){
+    SwapArray(source, destination, count);
+}
+
+void SwapEndianness(const u64 *source, u64 *destination, size_t count){
+    SwapArray(source, destination, count);
+}
@@ -2,6 +2,8 @@
 #define STRAITX_NET_BYTE_ORDER_HPP
 
 #include "core/env/endianness.hpp"
+#include "core/span.hpp"
+#include "core/assert.hpp"
 //Assumes all targets are little endian
 
 inline u8 ToNetByteOrder(u8 value) {
@@ -30,4 +32,41 @@ inline u64 ToHostByteOrder(u64 value) {
     return SwapEndianness(value);
 }
 
+inline s16 ToNetByteOrder(s16 value) {
+    return (s16)SwapEndianness((u16)value);
+}
+inline s32 ToNetByteOrder(s32 value) {
+    return (s32)SwapEndianness((u32)value);
+}
+inline s64 ToNetByteOrder(s64 value) {
+    return (s64)SwapEndianness((u64)value);
+}
+
+inline s16 ToHostByteOrder(s16 value) {
+    return (s16)SwapEndianness((u16)value);
+}
+inline s32 ToHostByteOrder(s32 value) {
+    return (s32)SwapEndianness((u32)value);
+}
+inline s64 ToHostByteOrder(s64 value) {
+    return (s64)SwapEndianness((u64)value);
+}
+
+// Bulk conversions are vectorized, source and destination can be the same array
+void SwapEndianness(const u16 *source, u16 *destination, size_t count);
+void SwapEndianness(const u32 *source, u32 *destination, size_t count);
+void SwapEndianness(const u64 *source, u64 *destination, size_t count);
+
+template<typename Type>
+inline void ToNetByteOrder(ConstSpan<Type> source, Span<Type> destination) {
+    SX_CORE_ASSERT(source.Size() == destination.Size(), "ToNetByteOrder: Spans should be the same size");
+    SwapEndianness(source.Pointer(), destination.Pointer(), source.Size());
+}
+
+template<typename Type>
+inline void ToHostByteOrder(ConstSpan<Type> source, Span<Type> destination) {
+    SX_CORE_ASSERT(source.Size() == destination.Size(), "ToHostByteOrder: Spans should be the same size");
+    SwapEndianness(source.Pointer(), destination.Pointer(), source.Size());
+}
+
 #endif//STRAITX_NET_BYTE_ORDER_HPP
\ No newline at end of file
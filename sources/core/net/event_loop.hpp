@@ -0,0 +1,84 @@
+#ifndef STRAITX_EVENT_LOOP_HPP
+#define STRAITX_EVENT_LOOP_HPP
+
+#include "core/types.hpp"
+#include "core/function.hpp"
+#include "core/noncopyable.hpp"
+#include "core/os/time.hpp"
+#include "core/net/socket.hpp"
+
+class TcpSocket;
+class TcpListener;
+class UdpSocket;
+
+namespace IoEvent{
+	enum Value: u32{
+		Readable = 1 << 0,
+		Writable = 1 << 1,
+		// peer has closed the connection or socket is in error state, comes together with Readable
+		Closed   = 1 << 2
+	};
+}//namespace IoEvent::
+
+using TimerId = u64;
+
+// Single threaded reactor for non-blocking sockets with timers and cross-thread posts.
+// Notifications are edge-triggered, so callback should read, write or accept until operation would block.
+// To scale over cores run a loop per thread, each with its own listener bound to the same port
+// with SetReuseAddress(true), kernel balances incoming connections between them.
+// Implemented on Linux only for now
+class EventLoop: public NonCopyable{
+public:
+	// called with IoEvent flags
+	using IoCallback = Function<void(u32)>;
+	using Task = Function<void()>;
+
+	static constexpr TimerId InvalidTimer = 0;
+private:
+	void *m_Impl = nullptr;
+public:
+	EventLoop();
+
+	~EventLoop();
+
+	bool IsValid()const;
+
+	// Socket is switched to non-blocking mode and should outlive the watch,
+	// watching already watched socket replaces its events and callback
+	bool Watch(TcpSocket &socket, u32 events, IoCallback callback);
+
+	bool Watch(TcpListener &listener, IoCallback callback);
+
+	bool Watch(UdpSocket &socket, u32 events, IoCallback callback);
+	// Safe to call from inside of the callbacks, pending events of the socket are dropped.
+	// Socket that was closed on disconnect while handling Closed event is unwatched automatically
+	void Unwatch(TcpSocket &socket);
+
+	void Unwatch(TcpListener &listener);
+
+	void Unwatch(UdpSocket &socket);
+
+	// zero period is a one shot timer, otherwise timer repeats until it is cancelled
+	TimerId SetTimer(Time delay, Task task, Time period = {});
+	// safe to call from inside of the timer's own task
+	void CancelTimer(TimerId timer);
+
+	// Thread safe, task is called on the loop thread during the next iteration
+	void Post(Task task);
+
+	// processes events until Stop is called
+	void Run();
+	// Waits for up to timeout for the events and processes them along with expired timers and posted tasks.
+	// Returns false once Stop was called
+	bool RunOnce(Time timeout);
+	// thread safe, wakes up the loop if it is waiting
+	void Stop();
+
+	size_t WatchesCount()const;
+private:
+	bool WatchImpl(SocketHandle socket, u32 events, IoCallback callback);
+
+	void UnwatchImpl(SocketHandle socket);
+};
+
+#endif//STRAITX_EVENT_LOOP_HPP
@@ -0,0 +1,240 @@
+#include <cstring>
+#include "core/net/message_stream.hpp"
+#include "core/net/byte_order.hpp"
+#include "core/os/memory.hpp"
+#include "core/algorithm.hpp"
+
+// send queue is compacted once that many fully sent slabs have accumulated at its front
+static constexpr u32 SendQueueCompactThreshold = 64;
+
+MessageStream::MessageStream(TcpSocket &socket, SlabPool &pool, const MessageStreamConfig &config):
+	m_Socket(socket),
+	m_Pool(pool),
+	m_Config(config)
+{}
+
+MessageStream::~MessageStream(){
+	ReleaseSendSlabs(m_SendQueue.Size() - m_SendHead);
+	ReleaseReceive();
+}
+
+bool MessageStream::Send(ConstSpan<u8> message){
+	if(m_IsBroken || message.Size() > m_Config.MaxMessageSize)
+		return false;
+
+	if(m_Config.Framing == MessageFraming::LengthPrefix){
+		u32 prefix = ToNetByteOrder((u32)message.Size());
+
+		return Append((const u8*)&prefix, sizeof(prefix))
+			&& Append(message.Pointer(), message.Size());
+	}
+
+	return Append(message.Pointer(), message.Size())
+		&& Append(&m_Config.Delimiter, 1);
+}
+
+bool MessageStream::Flush(){
+	if(!m_Socket.IsConnected())
+		return false;
+
+	while(m_SendHead < m_SendQueue.Size()){
+		m_SendBuffers.Clear();
+
+		size_t batch_size = 0;
+		for(u32 i = m_SendHead; i < m_SendQueue.Size(); i++){
+			const SendSlab &slab = m_SendQueue[i];
+			m_SendBuffers.Add(ConstSpan<u8>(slab.Data + slab.Begin, slab.End - slab.Begin));
+			batch_size += slab.End - slab.Begin;
+		}
+
+		const u32 sent = m_Socket.SendVectored(ConstSpan<ConstSpan<u8>>(m_SendBuffers.Data(), m_SendBuffers.Size()));
+		m_QueuedSize -= sent;
+
+		u32 rest = sent;
+		u32 done = 0;
+		for(u32 i = m_SendHead; i < m_SendQueue.Size() && rest; i++){
+			SendSlab &slab = m_SendQueue[i];
+			const u32 part = Min(rest, slab.End - slab.Begin);
+
+			slab.Begin += part;
+			rest -= part;
+
+			if(slab.Begin == slab.End)
+				done++;
+		}
+		ReleaseSendSlabs(done);
+
+		if(sent < batch_size)
+			return false;
+	}
+	return true;
+}
+
+u32 MessageStream::Receive(){
+	if(m_IsBroken || !m_Socket.IsConnected() || !PrepareReceive())
+		return 0;
+
+	const u32 received = m_Socket.ReceiveSome(m_Received + m_ReceivedEnd, m_ReceivedCapacity - m_ReceivedEnd);
+	m_ReceivedEnd += received;
+
+	if(m_ReceivedBegin == m_ReceivedEnd)
+		ReleaseReceive();
+
+	return received;
+}
+
+bool MessageStream::NextMessage(ConstSpan<u8> &message){
+	if(m_IsBroken)
+		return false;
+
+	const u8 *pending = m_Received + m_ReceivedBegin;
+	const u32 pending_size = m_ReceivedEnd - m_ReceivedBegin;
+
+	if(m_Config.Framing == MessageFraming::LengthPrefix){
+		if(pending_size < LengthPrefixSize)
+			return false;
+
+		u32 size;
+		memcpy(&size, pending, sizeof(size));
+		size = ToHostByteOrder(size);
+
+		if(size > m_Config.MaxMessageSize){
+			m_IsBroken = true;
+			return false;
+		}
+
+		if(pending_size - LengthPrefixSize < size)
+			return false;
+
+		message = ConstSpan<u8>(pending + LengthPrefixSize, size);
+		m_ReceivedBegin += LengthPrefixSize + size;
+		return true;
+	}
+
+	const u8 *delimiter = pending_size ? (const u8*)memchr(pending + m_ScanOffset, m_Config.Delimiter, pending_size - m_ScanOffset) : nullptr;
+
+	if(!delimiter){
+		m_ScanOffset = pending_size;
+		m_IsBroken = pending_size > m_Config.MaxMessageSize;
+		return false;
+	}
+
+	const u32 size = u32(delimiter - pending);
+	message = ConstSpan<u8>(pending, size);
+	m_ReceivedBegin += size + 1;
+	m_ScanOffset = 0;
+	return true;
+}
+
+bool MessageStream::Append(const u8 *data, size_t size){
+	const u32 slab_size = (u32)m_Pool.SlabSize();
+
+	while(size){
+		if(m_SendHead == m_SendQueue.Size() || m_SendQueue.Last().End == slab_size){
+			u8 *slab = (u8*)m_Pool.Alloc();
+			// message may be queued partially, so the stream can't be used anymore
+			if(!slab){
+				m_IsBroken = true;
+				return false;
+			}
+			m_SendQueue.Add({slab, 0, 0});
+		}
+
+		SendSlab &tail = m_SendQueue.Last();
+		const u32 copied = (u32)Min<size_t>(size, slab_size - tail.End);
+
+		memcpy(tail.Data + tail.End, data, copied);
+		tail.End += copied;
+		data += copied;
+		size -= copied;
+		m_QueuedSize += copied;
+	}
+	return true;
+}
+
+void MessageStream::ReleaseSendSlabs(u32 count){
+	for(u32 i = 0; i < count; i++)
+		m_Pool.Free(m_SendQueue[m_SendHead + i].Data);
+	m_SendHead += count;
+
+	if(m_SendHead == m_SendQueue.Size()){
+		m_SendQueue.Clear();
+		m_SendHead = 0;
+	}else if(m_SendHead >= SendQueueCompactThreshold){
+		const size_t rest = m_SendQueue.Size() - m_SendHead;
+
+		for(size_t i = 0; i < rest; i++)
+			m_SendQueue[i] = m_SendQueue[m_SendHead + i];
+		m_SendQueue.Resize(rest);
+		m_SendHead = 0;
+	}
+}
+
+bool MessageStream::PrepareReceive(){
+	if(m_ReceivedBegin == m_ReceivedEnd){
+		m_ReceivedBegin = 0;
+		m_ReceivedEnd = 0;
+		m_ScanOffset = 0;
+	}
+
+	if(!m_Received){
+		m_Received = (u8*)m_Pool.Alloc();
+		if(!m_Received)
+			return false;
+		m_ReceivedCapacity = (u32)m_Pool.SlabSize();
+	}
+
+	const u32 pending_size = m_ReceivedEnd - m_ReceivedBegin;
+	const u32 frame_overhead = m_Config.Framing == MessageFraming::LengthPrefix ? LengthPrefixSize : 1;
+	const u64 max_frame_size = (u64)m_Config.MaxMessageSize + frame_overhead;
+
+	// at least a byte more than we have, or the whole message if its size is known
+	u64 required = pending_size + 1;
+	if(m_Config.Framing == MessageFraming::LengthPrefix && pending_size >= LengthPrefixSize){
+		u32 size;
+		memcpy(&size, m_Received + m_ReceivedBegin, sizeof(size));
+		required = Max<u64>(required, LengthPrefixSize + (u64)ToHostByteOrder(size));
+	}
+	// complete messages are waiting for NextMessage or the size is invalid, that is reported there
+	if(required > max_frame_size)
+		return false;
+
+	if(m_ReceivedEnd < m_ReceivedCapacity && m_ReceivedCapacity - m_ReceivedBegin >= required)
+		return true;
+
+	if(required > m_ReceivedCapacity){
+		const u32 capacity = (u32)Min<u64>(Max<u64>(required, (u64)m_ReceivedCapacity * 2), max_frame_size);
+
+		u8 *buffer = (u8*)Memory::Alloc(capacity);
+		if(!buffer)
+			return false;
+		memcpy(buffer, m_Received + m_ReceivedBegin, pending_size);
+
+		const u32 scan_offset = m_ScanOffset;
+		ReleaseReceive();
+		m_Received = buffer;
+		m_ReceivedCapacity = capacity;
+		m_ScanOffset = scan_offset;
+	}else{
+		memmove(m_Received, m_Received + m_ReceivedBegin, pending_size);
+	}
+
+	m_ReceivedBegin = 0;
+	m_ReceivedEnd = pending_size;
+	return true;
+}
+
+void MessageStream::ReleaseReceive(){
+	if(m_Received){
+		if(IsReceivedPooled())
+			m_Pool.Free(m_Received);
+		else
+			Memory::Free(m_Received);
+	}
+
+	m_Received = nullptr;
+	m_ReceivedCapacity = 0;
+	m_ReceivedBegin = 0;
+	m_ReceivedEnd = 0;
+	m_ScanOffset = 0;
+}
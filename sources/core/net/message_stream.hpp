@@ -0,0 +1,105 @@
+#ifndef STRAITX_MESSAGE_STREAM_HPP
+#define STRAITX_MESSAGE_STREAM_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/noncopyable.hpp"
+#include "core/env/compiler.hpp"
+#include "core/allocators/slab_pool.hpp"
+#include "core/net/tcp_socket.hpp"
+
+enum class MessageFraming: u8{
+	// u32 size in network byte order before every message
+	LengthPrefix,
+	// every message is followed by the delimiter byte, that is not part of the message
+	Delimiter
+};
+
+struct MessageStreamConfig{
+	MessageFraming Framing = MessageFraming::LengthPrefix;
+	u8 Delimiter = '\n';
+	// bigger incoming message breaks the stream, bigger outgoing one is refused
+	u32 MaxMessageSize = 16 * 1024 * 1024;
+};
+
+// Splits TcpSocket byte stream into messages. Received data goes into a pool slab that is consumed front to back:
+// complete messages are handed out as spans into it and only the unfinished tail is moved to the front
+// once the end is reached, so a span never wraps. Messages bigger than a slab get a dedicated buffer.
+// Sent messages are framed into a chain of slabs and flushed with a single vectored send.
+// Stream holds no slabs while it has nothing buffered, so idle connections cost no memory
+class MessageStream: public NonCopyable{
+public:
+	static constexpr u32 LengthPrefixSize = 4;
+private:
+	struct SendSlab{
+		u8 *Data = nullptr;
+		u32 Begin = 0;
+		u32 End = 0;
+	};
+private:
+	TcpSocket &m_Socket;
+	SlabPool &m_Pool;
+	MessageStreamConfig m_Config;
+	bool m_IsBroken = false;
+
+	u8 *m_Received = nullptr;
+	u32 m_ReceivedCapacity = 0;
+	u32 m_ReceivedBegin = 0;
+	u32 m_ReceivedEnd = 0;
+	// bytes after begin that are known to have no delimiter
+	u32 m_ScanOffset = 0;
+
+	List<SendSlab> m_SendQueue;
+	u32 m_SendHead = 0;
+	size_t m_QueuedSize = 0;
+	List<ConstSpan<u8>> m_SendBuffers;
+public:
+	MessageStream(TcpSocket &socket, SlabPool &pool, const MessageStreamConfig &config = {});
+
+	~MessageStream();
+
+	// Frames and queues a copy of the message until Flush, returns false if message is too big.
+	// With delimiter framing message should not contain the delimiter
+	bool Send(ConstSpan<u8> message);
+
+	// Returns true if everything queued was sent. Non-blocking socket that would block keeps the rest queued
+	bool Flush();
+
+	// Reads whatever has arrived, invalidating previously returned messages. Returns zero once
+	// there is nothing to read for now, the socket has disconnected or the stream is broken
+	u32 Receive();
+
+	// Takes the next complete received message, span stays valid until the next Receive
+	bool NextMessage(ConstSpan<u8> &message);
+
+	// peer has sent a message above MaxMessageSize, the rest of the stream can't be framed
+	bool IsBroken()const;
+
+	size_t QueuedSize()const;
+private:
+	bool Append(const u8 *data, size_t size);
+
+	void ReleaseSendSlabs(u32 count);
+
+	// makes room at the end of the receive buffer for the unfinished message
+	bool PrepareReceive();
+
+	void ReleaseReceive();
+
+	bool IsReceivedPooled()const;
+};
+
+SX_INLINE bool MessageStream::IsBroken()const{
+	return m_IsBroken;
+}
+
+SX_INLINE size_t MessageStream::QueuedSize()const{
+	return m_QueuedSize;
+}
+
+SX_INLINE bool MessageStream::IsReceivedPooled()const{
+	return m_ReceivedCapacity == m_Pool.SlabSize();
+}
+
+#endif//STRAITX_MESSAGE_STREAM_HPP
@@ -7,6 +7,7 @@
 using SocketHandle = u64;
 
 class Socket {
+	friend class EventLoop;
 public:
 	static constexpr u16 AnyPort = 0;
 protected:
@@ -19,6 +20,10 @@ protected:
 	static bool BindImpl(SocketHandle socket, IpAddress address, u16 port_hbo);
 
 	static void SetBlocking(SocketHandle socket, bool is_blocking);
+	// SO_REUSEADDR and SO_REUSEPORT where it is supported, should be set before bind
+	static void SetReuseAddress(SocketHandle socket, bool is_enabled);
+	// TCP_NODELAY, disables Nagle's algorithm
+	static void SetNoDelay(SocketHandle socket, bool is_enabled);
 };
 
 #endif//STRAITX_SOCKET_HPP
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 class TcpListener: public Socket{
 private:
+	friend class EventLoop;
 	SocketHandle m_Handle = InvalidSocket;
 public:
 	TcpListener();
@@ -22,6 +23,9 @@ public:
 
 	void SetBlocking(bool is_blocking) { Socket::SetBlocking(m_Handle, is_blocking); }
 
+	// should be called before Bind
+	void SetReuseAddress(bool is_enabled) { Socket::SetReuseAddress(m_Handle, is_enabled); }
+
 private:
 	bool IsValid()const {
 		return m_Handle != InvalidSocket;
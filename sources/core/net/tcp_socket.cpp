@@ -21,13 +21,25 @@ TcpSocket& TcpSocket::operator=(TcpSocket&& other)noexcept{
 	Swap(m_Handle, other.m_Handle);
 	Swap(m_RemoteIpAddress, other.m_RemoteIpAddress);
 	Swap(m_RemotePort, other.m_RemotePort);
+	Swap(m_IsNoDelay, other.m_IsNoDelay);
 	return *this;
 }
 
 bool TcpSocket::Connect(IpAddress address, u16 port_hbo){
 	MakeInvalid();
 	MakeValid();
-	return ConnectImpl(m_Handle, address, port_hbo);
+
+	if(m_IsNoDelay)
+		Socket::SetNoDelay(m_Handle, true);
+
+	if(!ConnectImpl(m_Handle, address, port_hbo)){
+		MakeInvalid();
+		return false;
+	}
+
+	m_RemoteIpAddress = address;
+	m_RemotePort = port_hbo;
+	return true;
 }
 
 void TcpSocket::Disconnect(){
@@ -56,8 +68,31 @@ u32 TcpSocket::Receive(void* data, u32 size){
 	return received;
 }
 
+u32 TcpSocket::SendVectored(ConstSpan<ConstSpan<u8>> buffers){
+	bool is_disconnected = false;
+
+	u32 sent = SendVectoredImpl(m_Handle, buffers, is_disconnected);
+
+	if(is_disconnected)
+		Disconnect();
+
+	return sent;
+}
+
+u32 TcpSocket::ReceiveSome(void* data, u32 size){
+	bool is_disconnected = false;
+
+	u32 received = ReceiveSomeImpl(m_Handle, data, size, is_disconnected);
+
+	if(is_disconnected)
+		Disconnect();
+
+	return received;
+}
+
 bool TcpSocket::IsConnected()const{
-	return RemotePort();
+	// socket is closed on disconnect or failed connect
+	return IsValid();
 }
 
 u16 TcpSocket::RemotePort() const{
@@ -68,6 +103,13 @@ IpAddress TcpSocket::RemoteIpAddress() const{
 	return m_RemoteIpAddress;
 }
 
+void TcpSocket::SetNoDelay(bool is_enabled){
+	m_IsNoDelay = is_enabled;
+
+	if(IsValid())
+		Socket::SetNoDelay(m_Handle, is_enabled);
+}
+
 void TcpSocket::MakeValid(){
 	if(IsValid())
 		return;
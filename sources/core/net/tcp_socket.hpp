@@ -1,13 +1,16 @@
 #ifndef STRAITX_TCP_SOCKET_HPP
 #define STRAITX_TCP_SOCKET_HPP
 
+#include "core/span.hpp"
 #include "core/net/socket.hpp"
 
 class TcpSocket: public Socket{
 private:
+	friend class EventLoop;
 	SocketHandle m_Handle = InvalidSocket;
 	IpAddress m_RemoteIpAddress = IpAddress::Any;
 	u16 m_RemotePort = 0;
+	bool m_IsNoDelay = false;
 public:
 	TcpSocket() = default;
 
@@ -29,6 +32,13 @@ public:
 	// if return < size then (!IsConnected => disconnected) ? not ready : disconnected
 	u32 Receive(void *data, u32 size);
 
+	// gathers buffers into as few system calls as possible, returns the same way as Send
+	u32 SendVectored(ConstSpan<ConstSpan<u8>> buffers);
+
+	// Returns whatever has already arrived, blocks only if there is nothing to receive yet.
+	// Zero means disconnect or, if still connected, that non-blocking socket has nothing to receive
+	u32 ReceiveSome(void *data, u32 size);
+
 	bool IsConnected()const;
 
 	u16 RemotePort()const;
@@ -36,6 +46,9 @@ public:
 	IpAddress RemoteIpAddress()const;
 
 	void SetBlocking(bool is_blocking) { Socket::SetBlocking(m_Handle, is_blocking); }
+
+	// kept across Connect, so it can be set before the socket is opened
+	void SetNoDelay(bool is_enabled);
 private:
 	void MakeValid();
 
@@ -48,6 +61,10 @@ private:
 	static u32 SendImpl(SocketHandle socket, const void *data, u32 size, bool &is_disconnected);
 
 	static u32 ReceiveImpl(SocketHandle socket, void *data, u32 size, bool &is_disconected);
+
+	static u32 SendVectoredImpl(SocketHandle socket, ConstSpan<ConstSpan<u8>> buffers, bool &is_disconnected);
+
+	static u32 ReceiveSomeImpl(SocketHandle socket, void *data, u32 size, bool &is_disconnected);
 };
 
 #endif//STRAITX_TCP_SOCKET_HPP
\ No newline at end of file
@@ -0,0 +1,576 @@
+#include <cstring>
+#include "core/net/udp_connection.hpp"
+#include "core/net/byte_order.hpp"
+#include "core/algorithm.hpp"
+#include "core/math/functions.hpp"
+#include "core/assert.hpp"
+
+static constexpr Time InitialResendDelay = Milliseconds(100);
+// pacing bucket allows bursts of that long at the send rate
+static constexpr s64 PacingBurstMicroseconds = 20000;
+// ack and ack bits of the packet are valid, they are not until the first packet from the peer arrives
+static constexpr u8 PacketFlagHasAcks = 1 << 0;
+// ack bits cover 32 packets, acks are sent without waiting for Update after half of that, the rest is left for reordering
+static constexpr u32 ImmediateAckThreshold = 16;
+// remote sequence and the 32 packets before it
+static constexpr u64 UnackedBitsMask = (u64(1) << 33) - 1;
+
+static void Write16(u8 *pointer, u16 value){
+	value = ToNetByteOrder(value);
+	memcpy(pointer, &value, sizeof(value));
+}
+
+static void Write32(u8 *pointer, u32 value){
+	value = ToNetByteOrder(value);
+	memcpy(pointer, &value, sizeof(value));
+}
+
+static u16 Read16(const u8 *pointer){
+	u16 value;
+	memcpy(&value, pointer, sizeof(value));
+	return ToHostByteOrder(value);
+}
+
+static u32 Read32(const u8 *pointer){
+	u32 value;
+	memcpy(&value, pointer, sizeof(value));
+	return ToHostByteOrder(value);
+}
+
+// sequence numbers wrap around, so newer is the one that is less than half of the range ahead
+static s16 SequenceDistance(u16 from, u16 to){
+	return (s16)(u16)(to - from);
+}
+
+UdpConnection::UdpConnection(PacketSender sender, const UdpConnectionConfig &config):
+	m_Config(config),
+	m_Sender(sender),
+	m_ResendDelay(Max(Min(InitialResendDelay, config.MaxResendDelay), config.MinResendDelay))
+{
+	SX_CORE_ASSERT(config.Mtu > PacketHeaderSize + FragmentHeaderSize && config.Mtu <= Udp::MaxDatagramSize, "UdpConnection: Invalid MTU");
+	SX_CORE_ASSERT(config.WindowSize && (config.WindowSize & (config.WindowSize - 1)) == 0 && config.WindowSize <= 0x8000, "UdpConnection: WindowSize should be a power of two up to 32768");
+	SX_CORE_ASSERT(config.WindowSize >= MaxFragments, "UdpConnection: WindowSize should fit the biggest message");
+	SX_CORE_ASSERT(config.UnreliableQueueSize >= MaxFragments, "UdpConnection: UnreliableQueueSize should fit the biggest message");
+
+	m_FragmentPayload = config.Mtu - PacketHeaderSize - FragmentHeaderSize;
+
+	for(ReliableChannel &channel: m_Reliable){
+		channel.Sent.Resize(config.WindowSize);
+		channel.SentData.Resize(config.WindowSize * m_FragmentPayload);
+		channel.Received.Resize(config.WindowSize);
+		channel.ReceivedData.Resize(config.WindowSize * m_FragmentPayload);
+	}
+
+	m_Unreliable.Queue.Resize(config.UnreliableQueueSize);
+	m_Unreliable.QueueData.Resize(config.UnreliableQueueSize * m_FragmentPayload);
+	m_Unreliable.ReassemblyData.Resize(MaxMessageSize());
+
+	m_SentPackets.Resize(AckHistorySize);
+	m_Packet.Resize(config.Mtu);
+	m_Reassembly.Resize(MaxMessageSize());
+}
+
+UdpConnection::UdpConnection(UdpSocket &socket, IpAddress address, u16 port, const UdpConnectionConfig &config):
+	UdpConnection(PacketSender(), config)
+{
+	m_Socket = &socket;
+	m_Address = address;
+	m_Port = port;
+	m_Sender = PacketSender(this, &UdpConnection::SendToSocket);
+}
+
+bool UdpConnection::Send(UdpChannel channel, ConstSpan<u8> message){
+	if(message.Size() > MaxMessageSize())
+		return false;
+
+	// empty message still takes a fragment
+	const u32 count = Max<u32>(1, (u32)((message.Size() + m_FragmentPayload - 1) / m_FragmentPayload));
+
+	auto fragment = [&](u32 index, u16 id, FragmentSlot &slot, u8 *data){
+		const size_t offset = index * m_FragmentPayload;
+
+		slot = FragmentSlot();
+		slot.Id = id;
+		slot.Size = (u16)Min<size_t>(message.Size() - offset, m_FragmentPayload);
+		slot.Index = (u8)index;
+		slot.Count = (u8)count;
+		slot.IsUsed = true;
+		memcpy(data, message.Pointer() + offset, slot.Size);
+	};
+
+	if(channel == UdpChannel::Unreliable){
+		UnreliableChannel &unreliable = m_Unreliable;
+		if(unreliable.QueueSize + count > unreliable.Queue.Size())
+			return false;
+
+		const u16 id = unreliable.NextId++;
+
+		for(u32 i = 0; i<count; i++){
+			const u32 slot = (unreliable.QueueHead + unreliable.QueueSize++) % unreliable.Queue.Size();
+			fragment(i, id, unreliable.Queue[slot], unreliable.QueueData.Data() + slot * m_FragmentPayload);
+		}
+		return true;
+	}
+
+	ReliableChannel &reliable = Reliable(channel);
+	if((u16)(reliable.NextId - reliable.SendBase) + count > m_Config.WindowSize)
+		return false;
+
+	for(u32 i = 0; i<count; i++){
+		const u16 id = reliable.NextId++;
+		fragment(i, id, reliable.Sent[SlotIndex(id)], SentData(reliable, id));
+	}
+	return true;
+}
+
+void UdpConnection::OnPacket(ConstSpan<u8> packet, Time now){
+	if(packet.Size() < PacketHeaderSize)
+		return;
+
+	const u8 *pointer = packet.Pointer();
+	const u16 sequence = Read16(pointer);
+	const u16 ack = Read16(pointer + 2);
+	const u32 ack_bits = Read32(pointer + 4);
+	const u8 flags = pointer[8];
+
+	// bit i of m_RemoteAckBits stands for m_RemoteSequence - 1 - i, bit i of m_UnackedBits for m_RemoteSequence - i
+	if(m_HasReceived){
+		const s16 distance = SequenceDistance(m_RemoteSequence, sequence);
+
+		if(distance > 0){
+			// Reordered packets arrive after newer ones have moved the remote sequence, they may be
+			// about to fall out of the ack bits before any ack had them. They are acked right away then,
+			// unless Update is building a packet, which carries the acks anyway
+			const bool is_unacked_dropped = distance > 32 ? m_UnackedBits != 0 : (m_UnackedBits >> (33 - distance)) != 0;
+			if(is_unacked_dropped && !m_IsUpdating){
+				BeginPacket();
+				FlushPacket(now);
+			}
+
+			m_RemoteAckBits = distance < 32 ? m_RemoteAckBits << distance : 0;
+			if(distance <= 32)
+				m_RemoteAckBits |= 1u << (distance - 1);
+			m_UnackedBits = (distance <= 32 ? m_UnackedBits << distance : 0) & UnackedBitsMask;
+			m_RemoteSequence = sequence;
+		}else{
+			const u32 back = -distance;
+			// duplicate, or too old to tell if it is one
+			if(back == 0 || back > 32 || (m_RemoteAckBits & (1u << (back - 1))))
+				return;
+			m_RemoteAckBits |= 1u << (back - 1);
+		}
+		m_UnackedBits |= u64(1) << (distance > 0 ? 0 : -distance);
+	}else{
+		m_RemoteSequence = sequence;
+		m_RemoteAckBits = 0;
+		m_UnackedBits = 1;
+		m_HasReceived = true;
+	}
+
+	m_Stats.PacketsReceived++;
+	m_IsAckPending = true;
+	m_PacketsSinceAck++;
+
+	if(flags & PacketFlagHasAcks)
+		OnAcks(ack, ack_bits, now);
+
+	// packet being built by Update carries the acks anyway
+	if(m_PacketsSinceAck >= ImmediateAckThreshold && !m_IsUpdating){
+		BeginPacket();
+		FlushPacket(now);
+	}
+
+	const u8 *const end = pointer + packet.Size();
+	pointer += PacketHeaderSize;
+
+	while(end - pointer >= FragmentHeaderSize){
+		const u8 channel = pointer[0];
+		const u16 id = Read16(pointer + 1);
+		const u8 index = pointer[3];
+		const u8 count = pointer[4];
+		const u16 size = Read16(pointer + 5);
+		pointer += FragmentHeaderSize;
+
+		const bool is_valid = channel <= (u8)UdpChannel::ReliableOrdered
+			&& count && count <= MaxFragments && index < count
+			&& size <= m_FragmentPayload && size <= end - pointer;
+
+		if(!is_valid)
+			return;
+
+		OnFragment((UdpChannel)channel, id, index, count, {pointer, size});
+		pointer += size;
+	}
+}
+
+void UdpConnection::Update(Time now){
+	if(m_Config.SendRate){
+		const s64 burst = Max<s64>((s64)m_Config.SendRate * PacingBurstMicroseconds / 1000000, 2 * m_Config.Mtu);
+
+		if(m_IsUpdated)
+			m_PacingTokens = Min(m_PacingTokens + (s64)m_Config.SendRate * (now - m_LastUpdate).AsMicroseconds() / 1000000, burst);
+		else
+			m_PacingTokens = burst;
+	}
+	m_LastUpdate = now;
+	m_IsUpdated = true;
+	m_IsUpdating = true;
+
+	// new packet with data is started only while pacing allows it, the packet itself may go into debt
+	auto append = [&](UdpChannel channel, const FragmentSlot &slot, const u8 *data)->bool{
+		if(AppendFragment(channel, slot, data))
+			return true;
+
+		FlushPacket(now);
+		BeginPacket();
+
+		if(m_Config.SendRate && m_PacingTokens <= 0)
+			return false;
+
+		return AppendFragment(channel, slot, data);
+	};
+
+	BeginPacket();
+
+	bool is_paced = m_Config.SendRate && m_PacingTokens <= 0;
+
+	for(UdpChannel channel: {UdpChannel::ReliableOrdered, UdpChannel::ReliableUnordered}){
+		ReliableChannel &reliable = Reliable(channel);
+
+		for(u16 id = reliable.SendBase; id != reliable.NextId && !is_paced; id++){
+			FragmentSlot &slot = reliable.Sent[SlotIndex(id)];
+
+			if(slot.IsDone || (slot.IsSent && now - slot.LastSent < m_ResendDelay))
+				continue;
+
+			if(!append(channel, slot, SentData(reliable, id))){
+				is_paced = true;
+				break;
+			}
+
+			if(slot.IsSent)
+				m_Stats.FragmentsResent++;
+			slot.IsSent = true;
+			slot.LastSent = now;
+		}
+	}
+
+	UnreliableChannel &unreliable = m_Unreliable;
+
+	// unreliable fragments that don't fit into the pacing budget wait for the next Update
+	while(unreliable.QueueSize && !is_paced){
+		const FragmentSlot &slot = unreliable.Queue[unreliable.QueueHead];
+
+		if(!append(UdpChannel::Unreliable, slot, unreliable.QueueData.Data() + unreliable.QueueHead * m_FragmentPayload)){
+			is_paced = true;
+			break;
+		}
+
+		unreliable.QueueHead = (unreliable.QueueHead + 1) % unreliable.Queue.Size();
+		unreliable.QueueSize--;
+	}
+
+	FlushPacket(now);
+	m_IsUpdating = false;
+}
+
+u32 UdpConnection::MaxMessageSize()const{
+	return MaxFragments * m_FragmentPayload;
+}
+
+void UdpConnection::SendToSocket(ConstSpan<u8> packet){
+	m_Socket->Send(packet.Pointer(), (u32)packet.Size(), m_Address, m_Port);
+}
+
+UdpConnection::ReliableChannel &UdpConnection::Reliable(UdpChannel channel){
+	SX_CORE_ASSERT(channel != UdpChannel::Unreliable, "UdpConnection: Unreliable channel has no reliable state");
+	return m_Reliable[(size_t)channel - 1];
+}
+
+u8 *UdpConnection::SentData(ReliableChannel &channel, u16 id){
+	return channel.SentData.Data() + SlotIndex(id) * m_FragmentPayload;
+}
+
+u8 *UdpConnection::ReceivedData(ReliableChannel &channel, u16 id){
+	return channel.ReceivedData.Data() + SlotIndex(id) * m_FragmentPayload;
+}
+
+u32 UdpConnection::SlotIndex(u16 id)const{
+	return id & (m_Config.WindowSize - 1);
+}
+
+void UdpConnection::OnFragment(UdpChannel channel, u16 id, u8 index, u8 count, ConstSpan<u8> payload){
+	if(channel == UdpChannel::Unreliable)
+		OnUnreliableFragment(id, index, count, payload);
+	else
+		OnReliableFragment(channel, id, index, count, payload);
+}
+
+void UdpConnection::OnReliableFragment(UdpChannel channel, u16 id, u8 index, u8 count, ConstSpan<u8> payload){
+	ReliableChannel &reliable = Reliable(channel);
+
+	// already delivered fragments are behind the base, sender never goes past the window
+	if((u16)(id - reliable.ReceiveBase) >= m_Config.WindowSize)
+		return;
+
+	FragmentSlot &slot = reliable.Received[SlotIndex(id)];
+	if(slot.IsUsed && slot.Id == id)
+		return;
+
+	slot = FragmentSlot();
+	slot.Id = id;
+	slot.Size = (u16)payload.Size();
+	slot.Index = index;
+	slot.Count = count;
+	slot.IsUsed = true;
+	memcpy(ReceivedData(reliable, id), payload.Pointer(), payload.Size());
+
+	auto is_complete = [&](u16 first_id)->bool{
+		const FragmentSlot &first = reliable.Received[SlotIndex(first_id)];
+
+		for(u8 i = 0; i<first.Count; i++){
+			const u16 fragment_id = first_id + i;
+			const FragmentSlot &fragment = reliable.Received[SlotIndex(fragment_id)];
+
+			if(!fragment.IsUsed || fragment.Id != fragment_id || fragment.IsDone || fragment.Index != i || fragment.Count != first.Count)
+				return false;
+		}
+		return true;
+	};
+
+	if(channel == UdpChannel::ReliableOrdered){
+		for(;;){
+			const u16 base = reliable.ReceiveBase;
+			const FragmentSlot &first = reliable.Received[SlotIndex(base)];
+
+			// sender moves its base by whole messages, so a message always starts at the receive base
+			if(!first.IsUsed || first.Id != base || first.Index != 0 || !is_complete(base))
+				break;
+
+			const u8 message_count = first.Count;
+			DeliverReliable(channel, base, message_count);
+
+			for(u8 i = 0; i<message_count; i++)
+				reliable.Received[SlotIndex(base + i)].IsUsed = false;
+			reliable.ReceiveBase = base + message_count;
+		}
+		return;
+	}
+
+	const u16 first_id = id - index;
+	if((u16)(first_id - reliable.ReceiveBase) >= m_Config.WindowSize || !reliable.Received[SlotIndex(first_id)].IsUsed)
+		return;
+
+	if(is_complete(first_id)){
+		DeliverReliable(channel, first_id, count);
+
+		for(u8 i = 0; i<count; i++)
+			reliable.Received[SlotIndex(first_id + i)].IsDone = true;
+	}
+
+	for(;;){
+		FragmentSlot &base = reliable.Received[SlotIndex(reliable.ReceiveBase)];
+		if(!base.IsUsed || base.Id != reliable.ReceiveBase || !base.IsDone)
+			break;
+
+		base.IsUsed = false;
+		reliable.ReceiveBase++;
+	}
+}
+
+void UdpConnection::OnUnreliableFragment(u16 id, u8 index, u8 count, ConstSpan<u8> payload){
+	if(count == 1)
+		return OnMessage(UdpChannel::Unreliable, payload);
+
+	UnreliableChannel &unreliable = m_Unreliable;
+
+	if(!unreliable.ReassemblyCount || unreliable.ReassemblyId != id){
+		// fragments of an older message would only break the current one
+		if(unreliable.ReassemblyCount && SequenceDistance(unreliable.ReassemblyId, id) < 0)
+			return;
+
+		unreliable.ReassemblyId = id;
+		unreliable.ReassemblyCount = count;
+		unreliable.ReassemblyMask = 0;
+		unreliable.ReassemblySize = 0;
+	}
+
+	const u64 bit = u64(1) << index;
+	const bool is_last = index + 1 == count;
+
+	if(count != unreliable.ReassemblyCount || (unreliable.ReassemblyMask & bit) || (!is_last && payload.Size() != m_FragmentPayload))
+		return;
+
+	memcpy(unreliable.ReassemblyData.Data() + index * m_FragmentPayload, payload.Pointer(), payload.Size());
+	unreliable.ReassemblyMask |= bit;
+	unreliable.ReassemblySize += payload.Size();
+
+	const u64 full_mask = count == 64 ? ~u64(0) : (u64(1) << count) - 1;
+	if(unreliable.ReassemblyMask != full_mask)
+		return;
+
+	unreliable.ReassemblyCount = 0;
+	OnMessage(UdpChannel::Unreliable, {unreliable.ReassemblyData.Data(), unreliable.ReassemblySize});
+}
+
+void UdpConnection::DeliverReliable(UdpChannel channel, u16 first_id, u8 count){
+	ReliableChannel &reliable = Reliable(channel);
+
+	if(count == 1)
+		return OnMessage(channel, {ReceivedData(reliable, first_id), reliable.Received[SlotIndex(first_id)].Size});
+
+	size_t size = 0;
+	for(u8 i = 0; i<count; i++){
+		const u16 id = first_id + i;
+		const u16 fragment_size = reliable.Received[SlotIndex(id)].Size;
+
+		memcpy(m_Reassembly.Data() + size, ReceivedData(reliable, id), fragment_size);
+		size += fragment_size;
+	}
+
+	OnMessage(channel, {m_Reassembly.Data(), size});
+}
+
+void UdpConnection::OnAcks(u16 ack, u32 ack_bits, Time now){
+	for(u32 i = 0; i <= 32; i++){
+		if(i && !(ack_bits & (1u << (i - 1))))
+			continue;
+
+		const u16 sequence = ack - i;
+		SentPacket &packet = m_SentPackets[sequence % AckHistorySize];
+
+		if(!packet.IsUsed || packet.Sequence != sequence || packet.IsAcked)
+			continue;
+
+		packet.IsAcked = true;
+		m_Stats.PacketsAcked++;
+
+		// packets acked through the bits could have been waiting for the next outgoing packet of the peer
+		if(i == 0)
+			OnRttSample(now - packet.SentTime);
+
+		OnPacketAcked(packet);
+	}
+}
+
+void UdpConnection::OnPacketAcked(SentPacket &packet){
+	bool is_acked[2] = {};
+
+	for(u32 i = 0; i<packet.FragmentsCount; i++){
+		const FragmentRef &ref = packet.Fragments[i];
+		ReliableChannel &reliable = Reliable(ref.Channel);
+		FragmentSlot &slot = reliable.Sent[SlotIndex(ref.Id)];
+
+		// fragment could be resent and acked by another packet, then the slot is reused
+		if(!slot.IsUsed || slot.Id != ref.Id)
+			continue;
+
+		slot.IsDone = true;
+		is_acked[(size_t)ref.Channel - 1] = true;
+	}
+
+	for(size_t i = 0; i<2; i++){
+		if(is_acked[i])
+			AdvanceSendBase(m_Reliable[i]);
+	}
+}
+
+void UdpConnection::OnRttSample(Time sample){
+	const s64 sample_us = sample.AsMicroseconds();
+	s64 rtt = m_SmoothedRtt.AsMicroseconds();
+	s64 variance = m_RttVariance.AsMicroseconds();
+
+	// RFC 6298
+	if(!m_HasRttSample){
+		rtt = sample_us;
+		variance = sample_us / 2;
+		m_HasRttSample = true;
+	}else{
+		variance = (3 * variance + Math::Abs(rtt - sample_us)) / 4;
+		rtt = (7 * rtt + sample_us) / 8;
+	}
+
+	m_SmoothedRtt = Microseconds(rtt);
+	m_RttVariance = Microseconds(variance);
+	m_ResendDelay = Max(Min(Microseconds(rtt + 4 * variance), m_Config.MaxResendDelay), m_Config.MinResendDelay);
+	m_Stats.Rtt = m_SmoothedRtt;
+}
+
+void UdpConnection::AdvanceSendBase(ReliableChannel &channel){
+	while(channel.SendBase != channel.NextId){
+		const FragmentSlot &first = channel.Sent[SlotIndex(channel.SendBase)];
+
+		for(u8 i = 0; i<first.Count; i++){
+			if(!channel.Sent[SlotIndex(channel.SendBase + i)].IsDone)
+				return;
+		}
+
+		const u8 count = first.Count;
+		for(u8 i = 0; i<count; i++)
+			channel.Sent[SlotIndex(channel.SendBase + i)].IsUsed = false;
+		channel.SendBase += count;
+	}
+}
+
+void UdpConnection::BeginPacket(){
+	m_PacketSize = PacketHeaderSize;
+	m_PacketEntries = 0;
+	m_PacketFragmentsCount = 0;
+}
+
+bool UdpConnection::AppendFragment(UdpChannel channel, const FragmentSlot &slot, const u8 *data){
+	if(m_PacketSize + FragmentHeaderSize + slot.Size > m_Config.Mtu)
+		return false;
+	if(channel != UdpChannel::Unreliable && m_PacketFragmentsCount == MaxFragmentsPerPacket)
+		return false;
+
+	u8 *pointer = m_Packet.Data() + m_PacketSize;
+	pointer[0] = (u8)channel;
+	Write16(pointer + 1, slot.Id);
+	pointer[3] = slot.Index;
+	pointer[4] = slot.Count;
+	Write16(pointer + 5, slot.Size);
+	memcpy(pointer + FragmentHeaderSize, data, slot.Size);
+
+	m_PacketSize += FragmentHeaderSize + slot.Size;
+	m_PacketEntries++;
+
+	if(channel != UdpChannel::Unreliable)
+		m_PacketFragments[m_PacketFragmentsCount++] = {channel, slot.Id};
+
+	return true;
+}
+
+void UdpConnection::FlushPacket(Time now){
+	if(!m_PacketEntries && !m_IsAckPending)
+		return;
+
+	const u16 sequence = m_LocalSequence++;
+
+	Write16(m_Packet.Data(), sequence);
+	Write16(m_Packet.Data() + 2, m_RemoteSequence);
+	Write32(m_Packet.Data() + 4, m_RemoteAckBits);
+	m_Packet[8] = m_HasReceived ? PacketFlagHasAcks : 0;
+
+	SentPacket &packet = m_SentPackets[sequence % AckHistorySize];
+	if(packet.IsUsed && !packet.IsAcked)
+		m_Stats.PacketsLost++;
+
+	packet.Sequence = sequence;
+	packet.IsUsed = true;
+	packet.IsAcked = false;
+	packet.SentTime = now;
+	packet.FragmentsCount = m_PacketFragmentsCount;
+	memcpy(packet.Fragments, m_PacketFragments, m_PacketFragmentsCount * sizeof(FragmentRef));
+
+	m_Sender({m_Packet.Data(), m_PacketSize});
+
+	m_Stats.PacketsSent++;
+	m_Stats.BytesSent += m_PacketSize;
+	m_PacingTokens -= m_PacketSize;
+	m_IsAckPending = false;
+	m_PacketsSinceAck = 0;
+	m_UnackedBits = 0;
+
+	BeginPacket();
+}
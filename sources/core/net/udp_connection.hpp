@@ -0,0 +1,224 @@
+#ifndef STRAITX_UDP_CONNECTION_HPP
+#define STRAITX_UDP_CONNECTION_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/function.hpp"
+#include "core/delegate.hpp"
+#include "core/noncopyable.hpp"
+#include "core/os/time.hpp"
+#include "core/env/compiler.hpp"
+#include "core/net/udp_socket.hpp"
+
+enum class UdpChannel: u8{
+	// May be lost, duplicated packets are dropped.
+	// Only the latest fragmented message is reassembled, fragments of older ones are dropped
+	Unreliable,
+	// delivered once, in arrival order
+	ReliableUnordered,
+	// delivered once, in send order
+	ReliableOrdered
+};
+
+struct UdpConnectionConfig{
+	// maximum packet size, messages above that are fragmented
+	u32 Mtu = 1200;
+	// fragments in flight per reliable channel, power of two
+	u32 WindowSize = 256;
+	// unreliable fragments waiting for the next Update
+	u32 UnreliableQueueSize = 256;
+	// bytes per second, zero disables pacing
+	u32 SendRate = 0;
+	Time MinResendDelay = Milliseconds(10);
+	Time MaxResendDelay = Seconds(1);
+};
+
+struct UdpConnectionStats{
+	Time Rtt;
+	u64 PacketsSent = 0;
+	u64 PacketsReceived = 0;
+	u64 PacketsAcked = 0;
+	// were not acked before falling out of the ack history
+	u64 PacketsLost = 0;
+	u64 FragmentsResent = 0;
+	u64 BytesSent = 0;
+};
+
+// Reliability layer over datagrams: packet sequence numbers with ack bitfields, selective resend of
+// unacked fragments after RTT based timeout, fragmentation up to MaxFragments per message and optional pacing.
+// Has no I/O of its own, incoming datagrams are fed with OnPacket, outgoing ones are produced by Update,
+// and by OnPacket when peer sends faster than Update is called and acks would fall out of the ack bits otherwise.
+// All the buffers are allocated up front, sending and receiving doesn't allocate
+class UdpConnection: public NonCopyable{
+public:
+	using PacketSender = Function<void(ConstSpan<u8>)>;
+
+	// sequence, ack, ack bits and flags
+	static constexpr u32 PacketHeaderSize = 9;
+	static constexpr u32 FragmentHeaderSize = 7;
+	static constexpr u32 MaxFragments = 64;
+	// Sent packets waiting for acks, has to outlast a round trip of the default window along with resends
+	// and ack only packets, otherwise packets are forgotten before their late acks arrive and are resent
+	static constexpr u32 AckHistorySize = 1024;
+	static constexpr u32 MaxFragmentsPerPacket = 64;
+private:
+	struct FragmentSlot{
+		u16 Id = 0;
+		u16 Size = 0;
+		u8 Index = 0;
+		u8 Count = 0;
+		bool IsUsed = false;
+		// sender: acked by the peer, receiver: delivered
+		bool IsDone = false;
+		Time LastSent;
+		bool IsSent = false;
+	};
+
+	struct FragmentRef{
+		UdpChannel Channel;
+		u16 Id;
+	};
+
+	struct SentPacket{
+		u16 Sequence = 0;
+		bool IsUsed = false;
+		bool IsAcked = false;
+		Time SentTime;
+		u32 FragmentsCount = 0;
+		FragmentRef Fragments[MaxFragmentsPerPacket];
+	};
+
+	struct ReliableChannel{
+		List<FragmentSlot> Sent;
+		List<u8> SentData;
+		// oldest message with unacked fragments
+		u16 SendBase = 0;
+		u16 NextId = 0;
+
+		List<FragmentSlot> Received;
+		List<u8> ReceivedData;
+		// oldest undelivered fragment
+		u16 ReceiveBase = 0;
+	};
+
+	struct UnreliableChannel{
+		List<FragmentSlot> Queue;
+		List<u8> QueueData;
+		u32 QueueHead = 0;
+		u32 QueueSize = 0;
+		u16 NextId = 0;
+
+		// reassembly of the latest fragmented message
+		u16 ReassemblyId = 0;
+		u8 ReassemblyCount = 0;
+		u64 ReassemblyMask = 0;
+		u32 ReassemblySize = 0;
+		List<u8> ReassemblyData;
+	};
+private:
+	UdpConnectionConfig m_Config;
+	u32 m_FragmentPayload = 0;
+	PacketSender m_Sender;
+
+	UdpSocket *m_Socket = nullptr;
+	IpAddress m_Address = IpAddress::Any;
+	u16 m_Port = 0;
+
+	ReliableChannel m_Reliable[2];
+	UnreliableChannel m_Unreliable;
+
+	u16 m_LocalSequence = 0;
+	List<SentPacket> m_SentPackets;
+
+	u16 m_RemoteSequence = 0;
+	u32 m_RemoteAckBits = 0;
+	bool m_HasReceived = false;
+	bool m_IsAckPending = false;
+	// received since the last outgoing packet
+	u32 m_PacketsSinceAck = 0;
+	// received packets that no outgoing packet has acked yet
+	u64 m_UnackedBits = 0;
+
+	Time m_SmoothedRtt;
+	Time m_RttVariance;
+	Time m_ResendDelay;
+	bool m_HasRttSample = false;
+
+	Time m_LastUpdate;
+	s64 m_PacingTokens = 0;
+	bool m_IsUpdated = false;
+	bool m_IsUpdating = false;
+
+	List<u8> m_Packet;
+	u32 m_PacketSize = 0;
+	u32 m_PacketEntries = 0;
+	FragmentRef m_PacketFragments[MaxFragmentsPerPacket];
+	u32 m_PacketFragmentsCount = 0;
+
+	List<u8> m_Reassembly;
+
+	UdpConnectionStats m_Stats;
+public:
+	// called from OnPacket with every complete message, data is valid until the callback returns
+	Delegate<UdpChannel, ConstSpan<u8>> OnMessage;
+public:
+	UdpConnection(PacketSender sender, const UdpConnectionConfig &config = {});
+	// packets are sent to the address through the socket, incoming ones should still be fed with OnPacket
+	UdpConnection(UdpSocket &socket, IpAddress address, u16 port, const UdpConnectionConfig &config = {});
+
+	// Queues the message, returns false if it is too big or the channel's window is full
+	bool Send(UdpChannel channel, ConstSpan<u8> message);
+	// processes a received datagram, delivers complete messages through OnMessage
+	void OnPacket(ConstSpan<u8> packet, Time now);
+	// sends queued and timed out fragments, acks and pending unreliable messages, should be called every tick
+	void Update(Time now);
+
+	u32 MaxMessageSize()const;
+
+	Time Rtt()const;
+
+	const UdpConnectionStats &Stats()const;
+private:
+	void SendToSocket(ConstSpan<u8> packet);
+
+	ReliableChannel &Reliable(UdpChannel channel);
+
+	u8 *SentData(ReliableChannel &channel, u16 id);
+
+	u8 *ReceivedData(ReliableChannel &channel, u16 id);
+
+	u32 SlotIndex(u16 id)const;
+
+	void OnFragment(UdpChannel channel, u16 id, u8 index, u8 count, ConstSpan<u8> payload);
+
+	void OnReliableFragment(UdpChannel channel, u16 id, u8 index, u8 count, ConstSpan<u8> payload);
+
+	void OnUnreliableFragment(u16 id, u8 index, u8 count, ConstSpan<u8> payload);
+
+	void DeliverReliable(UdpChannel channel, u16 first_id, u8 count);
+
+	void OnAcks(u16 ack, u32 ack_bits, Time now);
+
+	void OnPacketAcked(SentPacket &packet);
+
+	void OnRttSample(Time sample);
+
+	void AdvanceSendBase(ReliableChannel &channel);
+
+	void BeginPacket();
+
+	bool AppendFragment(UdpChannel channel, const FragmentSlot &slot, const u8 *data);
+
+	void FlushPacket(Time now);
+};
+
+SX_INLINE Time UdpConnection::Rtt()const{
+	return m_SmoothedRtt;
+}
+
+SX_INLINE const UdpConnectionStats &UdpConnection::Stats()const{
+	return m_Stats;
+}
+
+#endif//STRAITX_UDP_CONNECTION_HPP
@@ -65,3 +65,23 @@ u32 UdpSocket::Receive(void* data, u32 size, IpAddress& src_ip, u16& src_port_hb
 
 	return ReceiveImpl(m_Handle, data, size, src_ip, src_port_hbo);
 }
+
+u32 UdpSocket::SendBatch(ConstSpan<UdpOutDatagram> datagrams) {
+	SX_CORE_ASSERT(IsOpen(), "Can't send on a closed UdpSocket");
+	m_IsBound = true;
+
+	return SendBatchImpl(m_Handle, datagrams);
+}
+
+u32 UdpSocket::ReceiveBatch(Span<UdpInDatagram> datagrams) {
+	SX_CORE_ASSERT(IsOpen(), "Can't receive on closed UdpSocket");
+	SX_CORE_ASSERT(IsBound(), "Can't receive on unbound UdpSocket");
+
+	return ReceiveBatchImpl(m_Handle, datagrams);
+}
+
+bool UdpSocket::SetReceiveOffload(bool is_enabled) {
+	SX_CORE_ASSERT(IsOpen(), "Can't configure closed UdpSocket");
+
+	return SetReceiveOffloadImpl(m_Handle, is_enabled);
+}
@@ -2,14 +2,33 @@
 #define STRAITX_UDP_SOCKET_HPP
 
 #include "core/net/socket.hpp"
+#include "core/span.hpp"
 
 namespace Udp {
 	constexpr u32 HeaderSize = 8;
 	constexpr u32 MaxDatagramSize = Ip::MaxPacketSize - Ip::HeaderSize - Udp::HeaderSize;
 }//namespace Udp::
 
+struct UdpOutDatagram{
+	ConstSpan<u8> Data;
+	IpAddress Address = IpAddress::Any;
+	u16 Port = 0;
+};
+
+struct UdpInDatagram{
+	Span<u8> Buffer;
+	// filled by ReceiveBatch
+	u32 Size = 0;
+	// Equals to Size unless receive offload is enabled, then Buffer may hold several datagrams
+	// of SegmentSize from the same source coalesced by the kernel, the last one may be shorter
+	u32 SegmentSize = 0;
+	IpAddress Address = IpAddress::Any;
+	u16 Port = 0;
+};
+
 class UdpSocket: public Socket{
 private:
+	friend class EventLoop;
 	SocketHandle m_Handle = InvalidSocket;
 	bool m_IsBound = false;
 public:
@@ -42,11 +61,29 @@ public:
 		return Receive(data, size, dummy_ip, dummy_port);
 	}
 
+	// Sends as many datagrams as possible with a few syscalls, returns the number of datagrams sent.
+	// Consecutive equally sized datagrams to the same destination are segmented by the kernel (UDP GSO) where supported
+	u32 SendBatch(ConstSpan<UdpOutDatagram> datagrams);
+	// Blocks until at least one datagram is available (unless socket is non-blocking),
+	// then takes what is already queued, returns the number of datagrams received
+	u32 ReceiveBatch(Span<UdpInDatagram> datagrams);
+	// Enables UDP GRO where supported, returns false if it is not. Buffers should be Udp::MaxDatagramSize to benefit
+	bool SetReceiveOffload(bool is_enabled);
+
 	void SetBlocking(bool is_blocking) { Socket::SetBlocking(m_Handle, is_blocking); }
+
+	// should be called before Bind
+	void SetReuseAddress(bool is_enabled) { Socket::SetReuseAddress(m_Handle, is_enabled); }
 private:
 	static u32 SendImpl(SocketHandle socket, const void *data, u32 size, IpAddress dst_ip, u16 dst_port_hbo);
 
 	static u32 ReceiveImpl(SocketHandle socket, void *data, u32 size, IpAddress &src_ip, u16 &src_port_hbo);
+
+	static u32 SendBatchImpl(SocketHandle socket, ConstSpan<UdpOutDatagram> datagrams);
+
+	static u32 ReceiveBatchImpl(SocketHandle socket, Span<UdpInDatagram> datagrams);
+
+	static bool SetReceiveOffloadImpl(SocketHandle socket, bool is_enabled);
 };
 
 #endif//STRAITX_UDP_SOCKET_HPP
\ No newline at end of file
@@ -0,0 +1,178 @@
+#ifndef STRAITX_ASYNC_FILE_IO_HPP
+#define STRAITX_ASYNC_FILE_IO_HPP
+
+#include <atomic>
+#include "core/types.hpp"
+#include "core/result.hpp"
+#include "core/span.hpp"
+#include "core/function.hpp"
+#include "core/noncopyable.hpp"
+#include "core/os/file.hpp"
+
+class AsyncFileIO;
+struct AsyncFileIOImpl;
+
+// Completion handle of a single asynchronous operation.
+// Is owned by the caller and should outlive the operation it was submitted with
+class AsyncFileRequest: public NonCopyable{
+public:
+    using Callback = Function<void(AsyncFileRequest &)>;
+
+    static constexpr s64 Failed = -1;
+private:
+    enum class Operation: u8{
+        Read,
+        Write
+    };
+private:
+    AsyncFileIO *m_Owner = nullptr;
+    std::atomic<bool> m_IsComplete{true};
+    s64 m_Transferred = 0;
+    Callback m_OnComplete;
+
+    u64 m_FD = File::InvalidFD;
+    u64 m_Offset = 0;
+    void *m_Buffer = nullptr;
+    u64 m_Size = 0;
+    Operation m_Operation = Operation::Read;
+    s32 m_FileIndex = -1;
+    s32 m_BufferIndex = -1;
+
+    friend class AsyncFileIO;
+    friend struct AsyncFileIOImpl;
+    friend class ThreadPoolBackend;
+    friend class IoUringBackend;
+public:
+    AsyncFileRequest() = default;
+
+    ~AsyncFileRequest();
+
+    bool IsComplete()const;
+    // blocks until the operation is complete, returns Transferred()
+    s64 Wait();
+    // amount of bytes transferred or Failed, valid only after completion
+    s64 Transferred()const;
+private:
+    // performs the operation synchronously on the calling thread
+    void Execute();
+};
+
+// Batches file reads and writes through io_uring, falls back to blocking
+// pread/pwrite on a thread pool if io_uring is not available.
+// Completion callbacks are called from the internal completion thread,
+// after request is marked as complete, so they can read the result and submit
+// the request again. Request should stay alive until its callback returns.
+// Implemented on Linux only for now
+class AsyncFileIO: public NonCopyable{
+public:
+    using Callback = AsyncFileRequest::Callback;
+
+    static constexpr u32 DefaultQueueDepth = 128;
+private:
+    void *m_Impl = nullptr;
+
+    friend class AsyncFileRequest;
+public:
+    AsyncFileIO(u32 queue_depth = DefaultQueueDepth, bool force_fallback = false);
+    // waits for all in-flight requests
+    ~AsyncFileIO();
+
+    // Requests are queued and sent to the kernel in batches,
+    // Flush() or AsyncFileRequest::Wait() submits everything queued so far
+    Result Read(AsyncFileRequest &request, const File &file, u64 offset, Span<u8> buffer, Callback on_complete = {});
+
+    Result Write(AsyncFileRequest &request, const File &file, u64 offset, ConstSpan<u8> buffer, Callback on_complete = {});
+
+    // buffer should lie inside of the registered buffer with buffer_index,
+    // file_index refers to the file passed to RegisterFiles
+    Result ReadRegistered(AsyncFileRequest &request, u32 file_index, u64 offset, u32 buffer_index, Span<u8> buffer, Callback on_complete = {});
+
+    Result WriteRegistered(AsyncFileRequest &request, u32 file_index, u64 offset, u32 buffer_index, ConstSpan<u8> buffer, Callback on_complete = {});
+
+    void Flush();
+
+    // Registration pins buffers and file tables in kernel to avoid per-request lookups,
+    // should be done while there are no requests in flight
+    Result RegisterBuffers(ConstSpan<Span<u8>> buffers);
+
+    Result RegisterFiles(ConstSpan<const File *> files);
+
+    void UnregisterBuffers();
+
+    void UnregisterFiles();
+
+    bool IsUsingIoUring()const;
+private:
+    Result Submit(AsyncFileRequest &request, Callback &&on_complete);
+
+    void Wait(AsyncFileRequest &request);
+};
+
+SX_INLINE AsyncFileRequest::~AsyncFileRequest(){
+    SX_CORE_ASSERT(IsComplete(), "AsyncFileRequest: Can't destroy a request that is still in flight");
+}
+
+SX_INLINE bool AsyncFileRequest::IsComplete()const{
+    return m_IsComplete.load(std::memory_order_acquire);
+}
+
+SX_INLINE s64 AsyncFileRequest::Wait(){
+    if(!IsComplete())
+        m_Owner->Wait(*this);
+    return Transferred();
+}
+
+SX_INLINE s64 AsyncFileRequest::Transferred()const{
+    SX_CORE_ASSERT(IsComplete(), "AsyncFileRequest: Operation is still in flight");
+    return m_Transferred;
+}
+
+SX_INLINE Result AsyncFileIO::Read(AsyncFileRequest &request, const File &file, u64 offset, Span<u8> buffer, Callback on_complete){
+    SX_CORE_ASSERT(file.IsOpen(), "AsyncFileIO: Can't read from closed file");
+
+    request.m_FD = file.FD();
+    request.m_FileIndex = -1;
+    request.m_BufferIndex = -1;
+    request.m_Offset = offset;
+    request.m_Buffer = buffer.Pointer();
+    request.m_Size = buffer.Size();
+    request.m_Operation = AsyncFileRequest::Operation::Read;
+    return Submit(request, Move(on_complete));
+}
+
+SX_INLINE Result AsyncFileIO::Write(AsyncFileRequest &request, const File &file, u64 offset, ConstSpan<u8> buffer, Callback on_complete){
+    SX_CORE_ASSERT(file.IsOpen(), "AsyncFileIO: Can't write to closed file");
+
+    request.m_FD = file.FD();
+    request.m_FileIndex = -1;
+    request.m_BufferIndex = -1;
+    request.m_Offset = offset;
+    request.m_Buffer = const_cast<u8*>(buffer.Pointer());
+    request.m_Size = buffer.Size();
+    request.m_Operation = AsyncFileRequest::Operation::Write;
+    return Submit(request, Move(on_complete));
+}
+
+SX_INLINE Result AsyncFileIO::ReadRegistered(AsyncFileRequest &request, u32 file_index, u64 offset, u32 buffer_index, Span<u8> buffer, Callback on_complete){
+    request.m_FD = File::InvalidFD;
+    request.m_FileIndex = (s32)file_index;
+    request.m_BufferIndex = (s32)buffer_index;
+    request.m_Offset = offset;
+    request.m_Buffer = buffer.Pointer();
+    request.m_Size = buffer.Size();
+    request.m_Operation = AsyncFileRequest::Operation::Read;
+    return Submit(request, Move(on_complete));
+}
+
+SX_INLINE Result AsyncFileIO::WriteRegistered(AsyncFileRequest &request, u32 file_index, u64 offset, u32 buffer_index, ConstSpan<u8> buffer, Callback on_complete){
+    request.m_FD = File::InvalidFD;
+    request.m_FileIndex = (s32)file_index;
+    request.m_BufferIndex = (s32)buffer_index;
+    request.m_Offset = offset;
+    request.m_Buffer = const_cast<u8*>(buffer.Pointer());
+    request.m_Size = buffer.Size();
+    request.m_Operation = AsyncFileRequest::Operation::Write;
+    return Submit(request, Move(on_complete));
+}
+
+#endif//STRAITX_ASYNC_FILE_IO_HPP
@@ -0,0 +1,160 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "core/os/directory.hpp"
+#include "core/os/thread_pool.hpp"
+#include "core/os/memory.hpp"
+#include "core/list.hpp"
+#include "core/algorithm.hpp"
+
+// Keeps paths of directories waiting to be enumerated, everything is freed at once after the walk
+class WalkArena{
+private:
+	static constexpr size_t BlockSize = 64 * Memory::Kilobyte;
+
+	List<char *> m_Blocks;
+	size_t m_Used = BlockSize;
+public:
+	WalkArena() = default;
+
+	WalkArena(WalkArena &&other) = default;
+
+	WalkArena(const WalkArena &other) = delete;
+
+	~WalkArena(){
+		for(char *block: m_Blocks)
+			Memory::Free(block);
+	}
+
+	StringView Store(StringView string){
+		if(m_Used + string.Size() > BlockSize){
+			m_Blocks.Add((char*)Memory::Alloc(Max(BlockSize, string.Size())));
+			m_Used = 0;
+		}
+
+		char *destination = m_Blocks.Last() + m_Used;
+		Memory::Copy(string.Data(), destination, string.Size());
+		m_Used += string.Size();
+
+		return {destination, string.Size()};
+	}
+};
+
+struct PendingDirectory{
+	StringView Path;
+	u32 Depth = 0;
+};
+
+struct DirectoryWalker{
+	const Directory::WalkCallback &OnEntry;
+	const Directory::WalkFilter &Filter;
+
+	List<WalkArena> Arenas;
+	// used as a stack to keep depth first order and bounded amount of pending directories
+	List<PendingDirectory> Pending;
+	size_t Active = 0;
+	std::mutex Lock;
+	std::condition_variable HasWork;
+
+	DirectoryWalker(const Directory::WalkCallback &on_entry, const Directory::WalkFilter &filter, u32 workers_count):
+		OnEntry(on_entry),
+		Filter(filter)
+	{
+		Arenas.Reserve(workers_count);
+		for(u32 i = 0; i<workers_count; i++)
+			Arenas.Emplace();
+	}
+
+	void WorkerMain(u32 index){
+		WalkArena &arena = Arenas[index];
+		List<PendingDirectory> found;
+		String path;
+
+		for(;;){
+			PendingDirectory directory;
+			{
+				std::unique_lock<std::mutex> lock(Lock);
+				HasWork.wait(lock, [this](){ return Pending.Size() || !Active; });
+
+				if(!Pending.Size())
+					break;
+
+				directory = Pending.Last();
+				Pending.RemoveLast();
+				Active++;
+			}
+
+			Enumerate(directory, arena, path, found);
+
+			bool is_done = false;
+			{
+				std::unique_lock<std::mutex> lock(Lock);
+				for(const PendingDirectory &pending: found)
+					Pending.Add(pending);
+				Active--;
+				is_done = !Active && !Pending.Size();
+			}
+
+			if(found.Size() > 1 || is_done)
+				HasWork.notify_all();
+			else if(found.Size())
+				HasWork.notify_one();
+
+			found.Clear();
+		}
+		// wake up the rest to let them see that walk is done
+		HasWork.notify_all();
+	}
+
+	void Enumerate(const PendingDirectory &directory, WalkArena &arena, String &path, List<PendingDirectory> &found){
+		path.Clear();
+		path.Append(directory.Path);
+		if(!path.Size() || path[path.Size() - 1] != '/')
+			path.Append(StringView("/"));
+		const size_t prefix = path.Size();
+
+		for(const DirectoryEntry &entry: Directory(directory.Path)){
+			path.Resize(prefix);
+			path.Append(entry.Name);
+
+			DirectoryWalkEntry walk_entry;
+			walk_entry.Path = path.View();
+			walk_entry.Name = {path.Data() + prefix, entry.Name.Size()};
+			walk_entry.IsFile = entry.IsFile;
+			walk_entry.IsDirectory = entry.IsDirectory;
+			walk_entry.IsSymlink = entry.IsSymlink;
+			walk_entry.Depth = directory.Depth;
+
+			if(Filter.IsBound() && !Filter(walk_entry))
+				continue;
+
+			OnEntry.TryCall(walk_entry);
+
+			if(entry.IsDirectory && !entry.IsSymlink)
+				found.Add({arena.Store(path), directory.Depth + 1});
+		}
+	}
+};
+
+Result Directory::Walk(StringView path, WalkCallback on_entry, WalkFilter filter, u32 threads_count){
+	if(!IsDirectory(path))
+		return Result::NotFound;
+
+	if(!threads_count)
+		threads_count = ThreadPool::HardwareThreadsCount();
+
+	DirectoryWalker walker(on_entry, filter, threads_count);
+	walker.Pending.Add({path, 0});
+
+	List<std::thread> helpers;
+	helpers.Reserve(threads_count - 1);
+	for(u32 i = 1; i<threads_count; i++)
+		helpers.Emplace(&DirectoryWalker::WorkerMain, &walker, i);
+
+	walker.WorkerMain(0);
+
+	for(std::thread &helper: helpers)
+		helper.join();
+
+	return Result::Success;
+}
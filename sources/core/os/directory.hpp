@@ -6,13 +6,28 @@
 #include "core/string.hpp"
 #include "core/string_view.hpp"
 #include "core/noncopyable.hpp"
+#include "core/function.hpp"
 
 class DirectoryIterator;
 
 struct DirectoryEntry{
-	String Name;
+	// points into the iterator's buffer, valid until the iterator is advanced
+	StringView Name;
 	bool IsFile = false;
 	bool IsDirectory = false;
+	// symlinks are classified by their target
+	bool IsSymlink = false;
+};
+
+struct DirectoryWalkEntry{
+	// entry name joined with the walk root, valid only during the callback
+	StringView Path;
+	StringView Name;
+	bool IsFile = false;
+	bool IsDirectory = false;
+	bool IsSymlink = false;
+	// zero for direct children of the walk root
+	u32 Depth = 0;
 };
 
 class DirectoryIterator {
@@ -38,6 +53,10 @@ public:
 };
 
 class Directory {
+public:
+	using WalkCallback = Function<void(const DirectoryWalkEntry &)>;
+	// returning false skips the entry, and if it is a directory, everything inside of it
+	using WalkFilter = Function<bool(const DirectoryWalkEntry &)>;
 private:
 	StringView m_Path;
 public:
@@ -61,7 +80,13 @@ public:
 
 	static bool Change(StringView path);
 
+	// removes directory with all of its content
 	static Result Delete(StringView path);
+
+	// Recursively visits everything under the path, directories are enumerated in parallel
+	// so callbacks are called concurrently from up to threads_count threads, zero means one per hardware thread.
+	// Symlinked directories are reported but not descended into
+	static Result Walk(StringView path, WalkCallback on_entry, WalkFilter filter = {}, u32 threads_count = 0);
 };
 
 #endif//STRAITX_DIRECTORY_HPP
\ No newline at end of file
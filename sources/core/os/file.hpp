@@ -8,6 +8,7 @@
 #include "core/string_view.hpp"
 #include "core/string.hpp"
 #include "core/optional.hpp"
+#include "core/span.hpp"
 
 class File: public NonCopyable{
 public:
@@ -22,6 +23,13 @@ public:
         Current = 1,
         End     = 2
     };
+
+    enum class AccessHint{
+        Normal,
+        Sequential,
+        Random,
+        WillNeed
+    };
     static constexpr u64 InvalidFD = -1;
 private:
     u64 m_FD = InvalidFD;
@@ -46,12 +54,26 @@ public:
     size_t Read(void *buffer, size_t size);
 
     size_t Write(const void *buffer, size_t size);
+    // Positional IO, doesn't use the cursor and is safe to call concurrently on the same File.
+    // Retries on interrupts and short transfers, returns less than size only on end of file or error.
+    // Note: on Windows the cursor is moved
+    size_t ReadAt(void *buffer, size_t size, u64 offset);
+
+    size_t WriteAt(const void *buffer, size_t size, u64 offset);
+    // Vectored IO at the cursor, same retry semantic as positional IO
+    size_t ReadV(ConstSpan<Span<u8>> buffers);
+
+    size_t WriteV(ConstSpan<ConstSpan<u8>> buffers);
 
     s64 Seek(SeekPos position, s64 offset);
 
     s64 Tell();
 
     u64 Size();
+    // readahead and caching hint for the OS, size of zero means until the end of file
+    void Advise(AccessHint hint, u64 offset = 0, u64 size = 0);
+    // native file descriptor or handle, InvalidFD if not opened
+    u64 FD()const;
 
     static Result Delete(StringView filename);
 
@@ -65,6 +87,11 @@ public:
 
     static bool IsFile(const char *filename);
 
+    // Copies in kernel space where possible, doesn't move cursors, returns amount of bytes copied
+    static u64 Copy(File &source, u64 source_offset, File &destination, u64 destination_offset, u64 size);
+    // destination is created or truncated, AlreadyExist if it is the source itself or its hard link
+    static Result Copy(StringView source, StringView destination);
+
     static Optional<String> ReadEntire(StringView filename);
 
     static bool WriteEntire(StringView filename, StringView content);
@@ -96,6 +123,10 @@ SX_INLINE bool File::IsOpen()const{
     return m_FD != InvalidFD;
 }
 
+SX_INLINE u64 File::FD()const{
+    return m_FD;
+}
+
 
 SX_INLINE Result File::Delete(const char* filename) {
     return File::Delete(StringView(filename));
@@ -0,0 +1,134 @@
+#include <cstring>
+#include "core/os/file_reader.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+
+FileReader::FileReader(File &file, size_t buffer_size):
+    m_File(file),
+    m_Buffer((u8*)Memory::Alloc(buffer_size)),
+    m_BufferSize(buffer_size)
+{
+    SX_CORE_ASSERT(file.IsOpen(), "FileReader: Can't read from closed file");
+    SX_CORE_ASSERT(buffer_size, "FileReader: Buffer size can't be zero");
+
+    m_File.Advise(File::AccessHint::Sequential);
+}
+
+FileReader::~FileReader(){
+    Memory::Free(m_Buffer);
+}
+
+size_t FileReader::Read(void *data, size_t size){
+    u8 *dst = (u8*)data;
+    size_t done = Min(size, Buffered());
+
+    Memory::Copy(m_Buffer + m_Begin, dst, done);
+    m_Begin += done;
+
+    while(done < size && !m_IsFileEnd){
+        const size_t left = size - done;
+
+        if(left >= m_BufferSize){
+            size_t read = m_File.Read(dst + done, left);
+            if(read == 0 || read == (size_t)-1){
+                m_IsFileEnd = true;
+                break;
+            }
+            done += read;
+        }else{
+            if(!Fill())
+                break;
+            size_t chunk = Min(left, Buffered());
+            Memory::Copy(m_Buffer + m_Begin, dst + done, chunk);
+            m_Begin += chunk;
+            done += chunk;
+        }
+    }
+
+    return done;
+}
+
+bool FileReader::ReadExact(void *data, size_t size){
+    return Read(data, size) == size;
+}
+
+ConstSpan<u8> FileReader::Peek(size_t size){
+    size = Min(size, m_BufferSize);
+
+    while(Buffered() < size && !m_IsFileEnd)
+        Fill();
+
+    return {m_Buffer + m_Begin, Min(size, Buffered())};
+}
+
+bool FileReader::ReadLine(String &line){
+    line.Clear();
+
+    bool has_read = false;
+    for(;;){
+        if(!Buffered() && !Fill())
+            break;
+        has_read = true;
+
+        const u8 *begin = m_Buffer + m_Begin;
+        const u8 *newline = (const u8*)memchr(begin, '\n', Buffered());
+
+        if(newline){
+            line.Append(StringView((const char*)begin, newline - begin));
+            m_Begin += newline - begin + 1;
+
+            if(line.Size() && line[line.Size() - 1] == '\r')
+                line.Resize(line.Size() - 1);
+            return true;
+        }
+
+        line.Append(StringView((const char*)begin, Buffered()));
+        m_Begin = m_End;
+    }
+    return has_read;
+}
+
+size_t FileReader::Skip(size_t size){
+    size_t skipped = Min(size, Buffered());
+    m_Begin += skipped;
+
+    if(skipped == size || m_IsFileEnd)
+        return skipped;
+
+    const s64 position = m_File.Tell();
+    const s64 file_size = (s64)m_File.Size();
+    const s64 target = Min<s64>(position + (s64)(size - skipped), file_size);
+
+    m_File.Seek(File::Begin, target);
+    if(target == file_size)
+        m_IsFileEnd = true;
+
+    return skipped + (size_t)(target - position);
+}
+
+bool FileReader::IsEnd(){
+    return !Buffered() && !Fill();
+}
+
+s64 FileReader::Tell(){
+    return m_File.Tell() - (s64)Buffered();
+}
+
+size_t FileReader::Fill(){
+    if(m_Begin){
+        Memory::Move(m_Buffer + m_Begin, m_Buffer, Buffered());
+        m_End -= m_Begin;
+        m_Begin = 0;
+    }
+
+    if(m_IsFileEnd || m_End == m_BufferSize)
+        return Buffered();
+
+    size_t read = m_File.Read(m_Buffer + m_End, m_BufferSize - m_End);
+    if(read == 0 || read == (size_t)-1)
+        m_IsFileEnd = true;
+    else
+        m_End += read;
+
+    return Buffered();
+}
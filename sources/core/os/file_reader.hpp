@@ -0,0 +1,64 @@
+#ifndef STRAITX_FILE_READER_HPP
+#define STRAITX_FILE_READER_HPP
+
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/string.hpp"
+#include "core/noncopyable.hpp"
+#include "core/os/file.hpp"
+#include "core/os/memory.hpp"
+
+// Buffered sequential reader on top of the File cursor,
+// reads bigger than the buffer go straight to the File
+class FileReader: public NonCopyable{
+public:
+    static constexpr size_t DefaultBufferSize = 64 * Memory::Kilobyte;
+private:
+    File &m_File;
+    u8 *m_Buffer = nullptr;
+    size_t m_BufferSize = 0;
+    size_t m_Begin = 0;
+    size_t m_End = 0;
+    bool m_IsFileEnd = false;
+public:
+    FileReader(File &file, size_t buffer_size = DefaultBufferSize);
+
+    ~FileReader();
+
+    size_t Read(void *data, size_t size);
+    // returns false if file has ended before size bytes were read
+    bool ReadExact(void *data, size_t size);
+    // returns up to size buffered bytes without consuming them, size is limited by BufferSize()
+    ConstSpan<u8> Peek(size_t size);
+    // line is returned without line ending, returns false if there is nothing left to read
+    bool ReadLine(String &line);
+
+    size_t Skip(size_t size);
+
+    bool IsEnd();
+    // position of the reader in the file, which is behind the File's own cursor by buffered amount
+    s64 Tell();
+
+    size_t BufferSize()const;
+
+    File &Source();
+private:
+    // moves buffered bytes to the beginning and fills the rest, returns amount of buffered bytes
+    size_t Fill();
+
+    size_t Buffered()const;
+};
+
+SX_INLINE size_t FileReader::BufferSize()const{
+    return m_BufferSize;
+}
+
+SX_INLINE File &FileReader::Source(){
+    return m_File;
+}
+
+SX_INLINE size_t FileReader::Buffered()const{
+    return m_End - m_Begin;
+}
+
+#endif//STRAITX_FILE_READER_HPP
@@ -0,0 +1,67 @@
+#ifndef STRAITX_FILE_WATCHER_HPP
+#define STRAITX_FILE_WATCHER_HPP
+
+#include "core/types.hpp"
+#include "core/result.hpp"
+#include "core/span.hpp"
+#include "core/string.hpp"
+#include "core/string_view.hpp"
+#include "core/delegate.hpp"
+#include "core/noncopyable.hpp"
+#include "core/os/time.hpp"
+
+enum class FileChange: u8{
+	Created,
+	Modified,
+	Deleted,
+	// Path is the new name and OldPath is the old one, content at Path may have changed as well
+	Renamed,
+	// kernel queue has overflowed and changes were lost, Path is a watched root that should be rescanned
+	Overflowed
+};
+
+struct FileChangeEvent{
+	String Path;
+	String OldPath;
+	FileChange Change = FileChange::Modified;
+	bool IsDirectory = false;
+};
+
+// Watches directories and delivers changes in debounced batches,
+// all the changes of a single path within a batch are coalesced into one event.
+// Has no thread of its own and costs nothing while idle, changes are collected by Poll or Wait.
+// Implemented on Linux only for now
+class FileWatcher: public NonCopyable{
+public:
+	static constexpr Time DefaultDebounce = Milliseconds(50);
+	static constexpr Time DefaultMaxDelay = Milliseconds(500);
+private:
+	void *m_Impl = nullptr;
+public:
+	// called with every batch on the thread that calls Poll or Wait
+	Delegate<ConstSpan<FileChangeEvent>> OnChanges;
+public:
+	// Batch is delivered when there were no new changes for debounce time,
+	// but no later than max_delay after the first change in the batch
+	FileWatcher(Time debounce = DefaultDebounce, Time max_delay = DefaultMaxDelay);
+
+	~FileWatcher();
+
+	bool IsValid()const;
+	// recursive watch picks up directories created later on
+	Result Watch(StringView directory, bool recursive = true);
+	// stops watching the directory and everything watched inside of it
+	Result Unwatch(StringView directory);
+
+	// Reads pending changes without blocking and delivers a batch if it is ready.
+	// Returned batch is valid until the next call to Poll or Wait
+	ConstSpan<FileChangeEvent> Poll();
+	// same as Poll, but blocks for up to timeout until a batch is ready
+	ConstSpan<FileChangeEvent> Wait(Time timeout);
+	// becomes readable when there are changes, for integration with external event loops
+	int Handle()const;
+
+	size_t WatchesCount()const;
+};
+
+#endif//STRAITX_FILE_WATCHER_HPP
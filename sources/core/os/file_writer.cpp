@@ -0,0 +1,60 @@
+#include "core/os/file_writer.hpp"
+#include "core/assert.hpp"
+
+FileWriter::FileWriter(File &file, size_t buffer_size):
+    m_File(file),
+    m_Buffer((u8*)Memory::Alloc(buffer_size)),
+    m_BufferSize(buffer_size)
+{
+    SX_CORE_ASSERT(file.IsOpen(), "FileWriter: Can't write to closed file");
+    SX_CORE_ASSERT(buffer_size, "FileWriter: Buffer size can't be zero");
+}
+
+FileWriter::~FileWriter(){
+    (void)Flush();
+    Memory::Free(m_Buffer);
+}
+
+size_t FileWriter::Write(const void *data, size_t size){
+    const u8 *src = (const u8*)data;
+
+    if(m_Size + size <= m_BufferSize){
+        Memory::Copy(src, m_Buffer + m_Size, size);
+        m_Size += size;
+        return size;
+    }
+
+    if(!Flush())
+        return 0;
+
+    if(size >= m_BufferSize)
+        return WriteToFile(src, size) ? size : 0;
+
+    Memory::Copy(src, m_Buffer, size);
+    m_Size = size;
+    return size;
+}
+
+bool FileWriter::Flush(){
+    if(!m_Size)
+        return !m_IsFailed;
+
+    bool is_written = WriteToFile(m_Buffer, m_Size);
+    m_Size = 0;
+    return is_written;
+}
+
+bool FileWriter::WriteToFile(const u8 *data, size_t size){
+    while(size){
+        size_t written = m_File.Write(data, size);
+
+        if(written == 0 || written == (size_t)-1){
+            m_IsFailed = true;
+            return false;
+        }
+
+        data += written;
+        size -= written;
+    }
+    return true;
+}
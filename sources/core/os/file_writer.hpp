@@ -0,0 +1,53 @@
+#ifndef STRAITX_FILE_WRITER_HPP
+#define STRAITX_FILE_WRITER_HPP
+
+#include "core/types.hpp"
+#include "core/noncopyable.hpp"
+#include "core/string_writer.hpp"
+#include "core/os/file.hpp"
+#include "core/os/memory.hpp"
+
+// Buffered writer on top of the File cursor, can be a target for WriterPrint.
+// Writes bigger than the buffer go straight to the File
+class FileWriter: public StringWriter, public NonCopyable{
+public:
+    static constexpr size_t DefaultBufferSize = 64 * Memory::Kilobyte;
+private:
+    File &m_File;
+    u8 *m_Buffer = nullptr;
+    size_t m_BufferSize = 0;
+    size_t m_Size = 0;
+    bool m_IsFailed = false;
+public:
+    FileWriter(File &file, size_t buffer_size = DefaultBufferSize);
+    // flushes buffered data
+    ~FileWriter();
+
+    using StringWriter::Write;
+
+    void Write(const char *string, size_t size)override;
+
+    size_t Write(const void *data, size_t size);
+
+    bool Flush();
+    // true if any of the writes to the File has failed since construction
+    bool IsFailed()const;
+
+    File &Target();
+private:
+    bool WriteToFile(const u8 *data, size_t size);
+};
+
+SX_INLINE void FileWriter::Write(const char *string, size_t size){
+    (void)Write((const void*)string, size);
+}
+
+SX_INLINE bool FileWriter::IsFailed()const{
+    return m_IsFailed;
+}
+
+SX_INLINE File &FileWriter::Target(){
+    return m_File;
+}
+
+#endif//STRAITX_FILE_WRITER_HPP
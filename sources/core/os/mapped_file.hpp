@@ -0,0 +1,76 @@
+#ifndef STRAITX_MAPPED_FILE_HPP
+#define STRAITX_MAPPED_FILE_HPP
+
+#include "core/types.hpp"
+#include "core/result.hpp"
+#include "core/span.hpp"
+#include "core/string_view.hpp"
+#include "core/noncopyable.hpp"
+#include "core/move.hpp"
+
+// Read-only mapping of the whole file into memory, pages are loaded on first access
+class MappedFile: public NonCopyable{
+private:
+    const u8 *m_Pointer = nullptr;
+    size_t m_Size = 0;
+    // file mapping object on Windows
+    void *m_Handle = nullptr;
+    bool m_IsOpen = false;
+public:
+    MappedFile() = default;
+
+    MappedFile(MappedFile &&other)noexcept;
+
+    ~MappedFile();
+
+    MappedFile &operator=(MappedFile &&other)noexcept;
+
+    Result Open(StringView filename);
+
+    void Close();
+
+    bool IsOpen()const;
+
+    ConstSpan<u8> Data()const;
+
+    size_t Size()const;
+};
+
+SX_INLINE MappedFile::MappedFile(MappedFile &&other)noexcept{
+    *this = Move(other);
+}
+
+SX_INLINE MappedFile::~MappedFile(){
+    if(IsOpen())
+        Close();
+}
+
+SX_INLINE MappedFile &MappedFile::operator=(MappedFile &&other)noexcept{
+    if(IsOpen())
+        Close();
+
+    m_Pointer = other.m_Pointer;
+    m_Size = other.m_Size;
+    m_Handle = other.m_Handle;
+    m_IsOpen = other.m_IsOpen;
+
+    other.m_Pointer = nullptr;
+    other.m_Size = 0;
+    other.m_Handle = nullptr;
+    other.m_IsOpen = false;
+    return *this;
+}
+
+SX_INLINE bool MappedFile::IsOpen()const{
+    return m_IsOpen;
+}
+
+SX_INLINE ConstSpan<u8> MappedFile::Data()const{
+    return {m_Pointer, m_Size};
+}
+
+SX_INLINE size_t MappedFile::Size()const{
+    return m_Size;
+}
+
+#endif//STRAITX_MAPPED_FILE_HPP
@@ -69,3 +69,7 @@ void Memory::Copy(const void *source, void *destination, size_t size){
     memcpy(destination,source,size);
 }
 
+void Memory::Move(const void *source, void *destination, size_t size){
+    memmove(destination,source,size);
+}
+
@@ -40,6 +40,8 @@ public:
     static void Set(void *memory, u8 byte, size_t size);
 
     static void Copy(const void *source, void *destination, size_t size);
+    // same as Copy, but source and destination may overlap
+    static void Move(const void *source, void *destination, size_t size);
 private:
 	// Implemented per platform
 	static void *AlignedAllocImpl(size_t size, size_t alignment);
@@ -0,0 +1,80 @@
+#include "core/os/thread_pool.hpp"
+
+// pool the current thread is a worker of
+static thread_local const ThreadPool *s_CurrentPool = nullptr;
+
+ThreadPool::ThreadPool(u32 threads_count){
+    if(!threads_count)
+        threads_count = HardwareThreadsCount();
+
+    m_Workers.Reserve(threads_count);
+    for(u32 i = 0; i<threads_count; i++)
+        m_Workers.Emplace(&ThreadPool::WorkerMain, this);
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+        m_IsRunning = false;
+    }
+    m_HasTasks.notify_all();
+
+    for(std::thread &worker: m_Workers)
+        worker.join();
+}
+
+void ThreadPool::Enqueue(Task task){
+    SX_CORE_ASSERT(task.IsBound(), "ThreadPool: Can't enqueue empty task");
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+        m_Tasks.Add(Move(task));
+    }
+    m_HasTasks.notify_one();
+}
+
+void ThreadPool::WaitIdle(){
+    std::unique_lock<std::mutex> lock(m_Lock);
+    m_IsIdle.wait(lock, [this](){
+        return m_TasksHead == m_Tasks.Size() && m_Busy == 0;
+    });
+}
+
+bool ThreadPool::IsWorkerThread()const{
+    return s_CurrentPool == this;
+}
+
+u32 ThreadPool::HardwareThreadsCount(){
+    u32 count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+void ThreadPool::WorkerMain(){
+    s_CurrentPool = this;
+
+    std::unique_lock<std::mutex> lock(m_Lock);
+
+    for(;;){
+        m_HasTasks.wait(lock, [this](){
+            return m_TasksHead != m_Tasks.Size() || !m_IsRunning;
+        });
+
+        if(m_TasksHead == m_Tasks.Size())
+            break;
+
+        Task task = Move(m_Tasks[m_TasksHead++]);
+        // queue is drained, reuse its storage from the beginning
+        if(m_TasksHead == m_Tasks.Size()){
+            m_Tasks.Clear();
+            m_TasksHead = 0;
+        }
+        m_Busy++;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        m_Busy--;
+        if(m_TasksHead == m_Tasks.Size() && m_Busy == 0)
+            m_IsIdle.notify_all();
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef STRAITX_THREAD_POOL_HPP
+#define STRAITX_THREAD_POOL_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "core/types.hpp"
+#include "core/function.hpp"
+#include "core/list.hpp"
+#include "core/algorithm.hpp"
+#include "core/noncopyable.hpp"
+
+class ThreadPool: public NonCopyable{
+public:
+    using Task = Function<void()>;
+private:
+    List<std::thread> m_Workers;
+    List<Task> m_Tasks;
+    size_t m_TasksHead = 0;
+    size_t m_Busy = 0;
+    bool m_IsRunning = true;
+    std::mutex m_Lock;
+    std::condition_variable m_HasTasks;
+    std::condition_variable m_IsIdle;
+public:
+    // zero means one thread per hardware thread
+    ThreadPool(u32 threads_count = 0);
+
+    ~ThreadPool();
+
+    void Enqueue(Task task);
+    // blocks until queue is empty and all the workers are done
+    void WaitIdle();
+
+    u32 ThreadsCount()const;
+    // true when called from a task running on one of the workers of this pool
+    bool IsWorkerThread()const;
+    // Splits [0, count) into chunks of grain elements and calls functor(begin, end) for each of them,
+    // calling thread participates in the work, returns when all chunks are processed.
+    // Called from a worker of the same pool it runs all chunks inline, as waiting there for helper
+    // tasks would deadlock once every worker does the same
+    template<typename FunctorType>
+    void ParallelFor(size_t count, size_t grain, const FunctorType &functor);
+
+    static u32 HardwareThreadsCount();
+private:
+    void WorkerMain();
+};
+
+SX_INLINE u32 ThreadPool::ThreadsCount()const{
+    return (u32)m_Workers.Size();
+}
+
+template<typename FunctorType>
+void ThreadPool::ParallelFor(size_t count, size_t grain, const FunctorType &functor){
+    if(!count)
+        return;
+    if(!grain)
+        grain = 1;
+
+    if(IsWorkerThread()){
+        for(size_t begin = 0; begin < count; begin += grain)
+            functor(begin, Min(begin + grain, count));
+        return;
+    }
+
+    struct Job{
+        const FunctorType &Functor;
+        size_t Count;
+        size_t Grain;
+        std::atomic<size_t> Next{0};
+        size_t PendingHelpers;
+        std::mutex Lock;
+        std::condition_variable IsDone;
+
+        Job(const FunctorType &functor, size_t count, size_t grain, size_t helpers):
+            Functor(functor),
+            Count(count),
+            Grain(grain),
+            PendingHelpers(helpers)
+        {}
+
+        void Work(){
+            for(;;){
+                size_t begin = Next.fetch_add(Grain, std::memory_order_relaxed);
+                if(begin >= Count)
+                    break;
+                Functor(begin, Min(begin + Grain, Count));
+            }
+        }
+
+        void HelperMain(){
+            Work();
+
+            std::unique_lock<std::mutex> lock(Lock);
+            if(--PendingHelpers == 0)
+                IsDone.notify_one();
+        }
+    };
+
+    const size_t chunks = (count + grain - 1) / grain;
+    const size_t helpers = Min<size_t>(chunks - 1, ThreadsCount());
+
+    Job job(functor, count, grain, helpers);
+
+    for(size_t i = 0; i<helpers; i++)
+        Enqueue(Task(&job, &Job::HelperMain));
+
+    job.Work();
+
+    std::unique_lock<std::mutex> lock(job.Lock);
+    job.IsDone.wait(lock, [&job](){ return job.PendingHelpers == 0; });
+}
+
+#endif//STRAITX_THREAD_POOL_HPP
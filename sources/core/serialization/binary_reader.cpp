@@ -0,0 +1,74 @@
+#include "core/serialization/binary_reader.hpp"
+#include "core/serialization/binary_writer.hpp"
+#include "core/algorithm.hpp"
+
+BinaryReader::BinaryReader(ConstSpan<u8> data):
+    m_Data(data.Pointer()),
+    m_Size(data.Size())
+{}
+
+Result BinaryReader::ReadVarint(u64 &value){
+    const u8 *data = m_Data + m_Offset;
+    size_t available = Min(Remaining(), BinaryWriter::MaxVarintSize);
+
+    u64 result = 0;
+    for(size_t i = 0; i < available; i++){
+        u8 byte = data[i];
+        // tenth byte can only carry the highest bit
+        if(i == BinaryWriter::MaxVarintSize - 1 && byte > 1)
+            return Result::WrongFormat;
+
+        result |= u64(byte & 0x7F) << (7 * i);
+
+        if(!(byte & 0x80)){
+            value = result;
+            m_Offset += i + 1;
+            return Result::Success;
+        }
+    }
+    return available == BinaryWriter::MaxVarintSize ? Result::WrongFormat : Result::Overflow;
+}
+
+Result BinaryReader::ReadBytes(Span<u8> bytes){
+    if(Remaining() < bytes.Size())
+        return Result::Overflow;
+
+    memcpy(bytes.Pointer(), m_Data + m_Offset, bytes.Size());
+    m_Offset += bytes.Size();
+    return Result::Success;
+}
+
+Result BinaryReader::ReadBytes(ConstSpan<u8> &bytes, size_t size){
+    if(Remaining() < size)
+        return Result::Overflow;
+
+    bytes = ConstSpan<u8>(m_Data + m_Offset, size);
+    m_Offset += size;
+    return Result::Success;
+}
+
+Result BinaryReader::ReadString(StringView &string){
+    size_t offset = m_Offset;
+
+    u64 size;
+    Result result = ReadVarint(size);
+    if(!result)
+        return result;
+
+    if(Remaining() < size){
+        m_Offset = offset;
+        return Result::Overflow;
+    }
+
+    string = StringView((const char*)m_Data + m_Offset, (size_t)size);
+    m_Offset += (size_t)size;
+    return Result::Success;
+}
+
+Result BinaryReader::ReadString(String &string){
+    StringView view;
+    Result result = ReadString(view);
+    if(result)
+        string = String(view);
+    return result;
+}
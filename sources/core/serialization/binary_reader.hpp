@@ -0,0 +1,220 @@
+#ifndef STRAITX_BINARY_READER_HPP
+#define STRAITX_BINARY_READER_HPP
+
+#include <cstring>
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/result.hpp"
+#include "core/string.hpp"
+#include "core/string_view.hpp"
+#include "core/net/byte_order.hpp"
+
+// Decodes what BinaryWriter has encoded. Every read is bounds checked, read past the end
+// fails with Result::Overflow, malformed varint with Result::WrongFormat, failed read consumes nothing.
+// Views returned by ReadBytes and ReadString point into the source data
+class BinaryReader{
+private:
+    const u8 *m_Data = nullptr;
+    size_t m_Size = 0;
+    size_t m_Offset = 0;
+public:
+    BinaryReader(ConstSpan<u8> data);
+
+    Result Read(u8 &value);
+    Result Read(s8 &value);
+    Result Read(u16 &value);
+    Result Read(s16 &value);
+    Result Read(u32 &value);
+    Result Read(s32 &value);
+    Result Read(u64 &value);
+    Result Read(s64 &value);
+    Result Read(float &value);
+    Result Read(double &value);
+    Result Read(bool &value);
+
+    Result ReadVarint(u64 &value);
+    Result ReadVarint(s64 &value);
+
+    // copies bytes.Size() bytes
+    Result ReadBytes(Span<u8> bytes);
+    // zero-copy view of the next size bytes
+    Result ReadBytes(ConstSpan<u8> &bytes, size_t size);
+
+    Result ReadArray(Span<u8> array);
+    Result ReadArray(Span<s8> array);
+    Result ReadArray(Span<u16> array);
+    Result ReadArray(Span<s16> array);
+    Result ReadArray(Span<u32> array);
+    Result ReadArray(Span<s32> array);
+    Result ReadArray(Span<u64> array);
+    Result ReadArray(Span<s64> array);
+    Result ReadArray(Span<float> array);
+    Result ReadArray(Span<double> array);
+
+    // zero-copy view into the data
+    Result ReadString(StringView &string);
+
+    Result ReadString(String &string);
+
+    Result Skip(size_t size);
+
+    size_t Offset()const;
+
+    size_t Remaining()const;
+
+    bool IsEnd()const;
+private:
+    template<typename Type>
+    Result ReadFixed(Type &value);
+
+    template<typename Type>
+    Result ReadSwapped(Type *array, size_t count);
+};
+
+template<typename Type>
+SX_INLINE Result BinaryReader::ReadFixed(Type &value){
+    if(Remaining() < sizeof(Type))
+        return Result::Overflow;
+
+    memcpy(&value, m_Data + m_Offset, sizeof(Type));
+    value = ToHostByteOrder(value);
+    m_Offset += sizeof(Type);
+    return Result::Success;
+}
+
+SX_INLINE Result BinaryReader::Read(u8 &value){
+    return ReadFixed(value);
+}
+
+SX_INLINE Result BinaryReader::Read(s8 &value){
+    return ReadFixed((u8&)value);
+}
+
+SX_INLINE Result BinaryReader::Read(u16 &value){
+    return ReadFixed(value);
+}
+
+SX_INLINE Result BinaryReader::Read(s16 &value){
+    return ReadFixed((u16&)value);
+}
+
+SX_INLINE Result BinaryReader::Read(u32 &value){
+    return ReadFixed(value);
+}
+
+SX_INLINE Result BinaryReader::Read(s32 &value){
+    return ReadFixed((u32&)value);
+}
+
+SX_INLINE Result BinaryReader::Read(u64 &value){
+    return ReadFixed(value);
+}
+
+SX_INLINE Result BinaryReader::Read(s64 &value){
+    return ReadFixed((u64&)value);
+}
+
+SX_INLINE Result BinaryReader::Read(float &value){
+    u32 bits;
+    Result result = ReadFixed(bits);
+    if(result)
+        memcpy(&value, &bits, sizeof(value));
+    return result;
+}
+
+SX_INLINE Result BinaryReader::Read(double &value){
+    u64 bits;
+    Result result = ReadFixed(bits);
+    if(result)
+        memcpy(&value, &bits, sizeof(value));
+    return result;
+}
+
+SX_INLINE Result BinaryReader::Read(bool &value){
+    u8 byte;
+    Result result = ReadFixed(byte);
+    if(result)
+        value = byte != 0;
+    return result;
+}
+
+SX_INLINE Result BinaryReader::ReadVarint(s64 &value){
+    u64 encoded;
+    Result result = ReadVarint(encoded);
+    if(result)
+        value = s64(encoded >> 1) ^ -s64(encoded & 1);
+    return result;
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<u8> array){
+    return ReadBytes(array);
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<s8> array){
+    return ReadBytes(Span<u8>((u8*)array.Pointer(), array.Size()));
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<u16> array){
+    return ReadSwapped(array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<s16> array){
+    return ReadSwapped((u16*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<u32> array){
+    return ReadSwapped(array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<s32> array){
+    return ReadSwapped((u32*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<u64> array){
+    return ReadSwapped(array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<s64> array){
+    return ReadSwapped((u64*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<float> array){
+    return ReadSwapped((u32*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryReader::ReadArray(Span<double> array){
+    return ReadSwapped((u64*)array.Pointer(), array.Size());
+}
+
+template<typename Type>
+SX_INLINE Result BinaryReader::ReadSwapped(Type *array, size_t count){
+    if(Remaining() / sizeof(Type) < count)
+        return Result::Overflow;
+
+    // destination is aligned unlike the source, so swap in place there
+    memcpy(array, m_Data + m_Offset, count * sizeof(Type));
+    SwapEndianness(array, array, count);
+    m_Offset += count * sizeof(Type);
+    return Result::Success;
+}
+
+SX_INLINE Result BinaryReader::Skip(size_t size){
+    if(Remaining() < size)
+        return Result::Overflow;
+    m_Offset += size;
+    return Result::Success;
+}
+
+SX_INLINE size_t BinaryReader::Offset()const{
+    return m_Offset;
+}
+
+SX_INLINE size_t BinaryReader::Remaining()const{
+    return m_Size - m_Offset;
+}
+
+SX_INLINE bool BinaryReader::IsEnd()const{
+    return m_Offset == m_Size;
+}
+
+#endif//STRAITX_BINARY_READER_HPP
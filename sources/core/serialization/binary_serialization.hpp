@@ -0,0 +1,155 @@
+#ifndef STRAITX_BINARY_SERIALIZATION_HPP
+#define STRAITX_BINARY_SERIALIZATION_HPP
+
+#include "core/list.hpp"
+#include "core/string.hpp"
+#include "core/templates.hpp"
+#include "core/type_traits.hpp"
+#include "core/serialization/binary_writer.hpp"
+#include "core/serialization/binary_reader.hpp"
+
+// BinarySerialize/BinaryDeserialize handle fundamental types, enums, String, StringView, List
+// and types with Serialize/Deserialize members, other types can be supported by overloading them
+// in the type's namespace. Fields are written back to back without tags, so the layout is the declaration order
+
+template<typename Type, typename = EnableIfType<!IsEnum<Type>::Value>>
+SX_INLINE auto BinarySerialize(BinaryWriter &writer, const Type &value)->decltype(writer.Write(value)){
+    return writer.Write(value);
+}
+
+template<typename Type, typename = EnableIfType<!IsEnum<Type>::Value>>
+SX_INLINE auto BinaryDeserialize(BinaryReader &reader, Type &value)->decltype(reader.Read(value)){
+    return reader.Read(value);
+}
+
+template<typename Type, typename = EnableIfType<IsEnum<Type>::Value>>
+SX_INLINE Result BinarySerialize(BinaryWriter &writer, Type value){
+    return writer.Write((typename UnderlyingType<Type>::Type)value);
+}
+
+template<typename Type, typename = EnableIfType<IsEnum<Type>::Value>>
+SX_INLINE Result BinaryDeserialize(BinaryReader &reader, Type &value){
+    typename UnderlyingType<Type>::Type underlying;
+    Result result = reader.Read(underlying);
+    if(result)
+        value = (Type)underlying;
+    return result;
+}
+
+template<typename Type>
+SX_INLINE auto BinarySerialize(BinaryWriter &writer, const Type &value)->decltype(value.Serialize(writer)){
+    return value.Serialize(writer);
+}
+
+template<typename Type>
+SX_INLINE auto BinaryDeserialize(BinaryReader &reader, Type &value)->decltype(value.Deserialize(reader)){
+    return value.Deserialize(reader);
+}
+
+SX_INLINE Result BinarySerialize(BinaryWriter &writer, StringView string){
+    return writer.WriteString(string);
+}
+
+SX_INLINE Result BinarySerialize(BinaryWriter &writer, const String &string){
+    return writer.WriteString(string);
+}
+
+// zero-copy, view points into the reader's data
+SX_INLINE Result BinaryDeserialize(BinaryReader &reader, StringView &string){
+    return reader.ReadString(string);
+}
+
+SX_INLINE Result BinaryDeserialize(BinaryReader &reader, String &string){
+    return reader.ReadString(string);
+}
+
+namespace Details{
+
+// arrays of fundamental types go through bulk byte swap
+template<typename Type>
+SX_INLINE auto BinarySerializeElements(BinaryWriter &writer, ConstSpan<Type> elements, int)->decltype(writer.WriteArray(elements)){
+    return writer.WriteArray(elements);
+}
+
+template<typename Type>
+SX_INLINE Result BinarySerializeElements(BinaryWriter &writer, ConstSpan<Type> elements, long){
+    for(const Type &element: elements){
+        Result result = BinarySerialize(writer, element);
+        if(!result)
+            return result;
+    }
+    return Result::Success;
+}
+
+template<typename Type>
+SX_INLINE auto BinaryDeserializeElements(BinaryReader &reader, Span<Type> elements, int)->decltype(reader.ReadArray(elements)){
+    return reader.ReadArray(elements);
+}
+
+template<typename Type>
+SX_INLINE Result BinaryDeserializeElements(BinaryReader &reader, Span<Type> elements, long){
+    for(Type &element: elements){
+        Result result = BinaryDeserialize(reader, element);
+        if(!result)
+            return result;
+    }
+    return Result::Success;
+}
+
+}//namespace Details::
+
+// varint count followed by the elements
+template<typename Type>
+SX_INLINE Result BinarySerialize(BinaryWriter &writer, const List<Type> &list){
+    Result result = writer.WriteVarint((u64)list.Size());
+    if(!result)
+        return result;
+    return Details::BinarySerializeElements(writer, ConstSpan<Type>(list.Data(), list.Size()), 0);
+}
+
+// every element is expected to take at least a byte, so count is validated before allocation
+template<typename Type>
+SX_INLINE Result BinaryDeserialize(BinaryReader &reader, List<Type> &list){
+    u64 count;
+    Result result = reader.ReadVarint(count);
+    if(!result)
+        return result;
+
+    if(count > reader.Remaining())
+        return Result::Overflow;
+
+    list.Clear();
+    list.Resize((size_t)count);
+    return Details::BinaryDeserializeElements(reader, Span<Type>(list.Data(), list.Size()), 0);
+}
+
+namespace Details{
+
+template<typename...FieldsTypes>
+SX_INLINE Result BinarySerializeFields(BinaryWriter &writer, const FieldsTypes &...fields){
+    Result result = Result::Success;
+    // stops at the first failed field
+    (void)((result = BinarySerialize(writer, fields)) && ...);
+    return result;
+}
+
+template<typename...FieldsTypes>
+SX_INLINE Result BinaryDeserializeFields(BinaryReader &reader, FieldsTypes &...fields){
+    Result result = Result::Success;
+    (void)((result = BinaryDeserialize(reader, fields)) && ...);
+    return result;
+}
+
+}//namespace Details::
+
+// Generates Serialize and Deserialize members for the listed fields,
+// failed Serialize leaves already written fields in the writer
+#define SX_BINARY_SERIALIZABLE(...) \
+    Result Serialize(BinaryWriter &writer)const{ \
+        return Details::BinarySerializeFields(writer, __VA_ARGS__); \
+    } \
+    Result Deserialize(BinaryReader &reader){ \
+        return Details::BinaryDeserializeFields(reader, __VA_ARGS__); \
+    }
+
+#endif//STRAITX_BINARY_SERIALIZATION_HPP
@@ -0,0 +1,56 @@
+#include "core/serialization/binary_writer.hpp"
+
+BinaryWriter::BinaryWriter(Span<u8> memory):
+    m_Data(memory.Pointer()),
+    m_Capacity(memory.Size())
+{}
+
+BinaryWriter::BinaryWriter(List<u8> &buffer):
+    m_Data(buffer.Data()),
+    m_Size(buffer.Size()),
+    m_Capacity(buffer.Size()),
+    m_Buffer(&buffer)
+{}
+
+Result BinaryWriter::WriteVarint(u64 value){
+    u8 encoded[MaxVarintSize];
+    size_t size = 0;
+
+    while(value >= 0x80){
+        encoded[size++] = u8(value | 0x80);
+        value >>= 7;
+    }
+    encoded[size++] = u8(value);
+
+    u8 *pointer = Reserve(size);
+    if(!pointer)
+        return Result::Overflow;
+
+    memcpy(pointer, encoded, size);
+    return Result::Success;
+}
+
+Result BinaryWriter::WriteBytes(ConstSpan<u8> bytes){
+    u8 *pointer = Reserve(bytes.Size());
+    if(!pointer)
+        return Result::Overflow;
+
+    memcpy(pointer, bytes.Pointer(), bytes.Size());
+    return Result::Success;
+}
+
+Result BinaryWriter::WriteString(StringView string){
+    size_t size = m_Size;
+
+    if(!WriteVarint((u64)string.Size()))
+        return Result::Overflow;
+
+    if(!WriteBytes(ConstSpan<u8>((const u8*)string.Data(), string.Size()))){
+        // don't leave dangling size behind
+        m_Size = size;
+        if(m_Buffer)
+            m_Buffer->Resize(size);
+        return Result::Overflow;
+    }
+    return Result::Success;
+}
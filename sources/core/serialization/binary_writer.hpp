@@ -0,0 +1,224 @@
+#ifndef STRAITX_BINARY_WRITER_HPP
+#define STRAITX_BINARY_WRITER_HPP
+
+#include <cstring>
+#include "core/types.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/result.hpp"
+#include "core/string_view.hpp"
+#include "core/noncopyable.hpp"
+#include "core/net/byte_order.hpp"
+
+// Encodes values in network byte order either into fixed memory or at the end of a List.
+// Fixed width values take their size, varints are LEB128 with zigzag for signed values
+class BinaryWriter: public NonCopyable{
+public:
+    // the longest u64 varint
+    static constexpr size_t MaxVarintSize = 10;
+private:
+    u8 *m_Data = nullptr;
+    size_t m_Size = 0;
+    size_t m_Capacity = 0;
+    List<u8> *m_Buffer = nullptr;
+public:
+    // write that doesn't fit into memory fails with Result::Overflow and writes nothing
+    BinaryWriter(Span<u8> memory);
+    // appends to the buffer, growing it when needed
+    BinaryWriter(List<u8> &buffer);
+
+    Result Write(u8 value);
+    Result Write(s8 value);
+    Result Write(u16 value);
+    Result Write(s16 value);
+    Result Write(u32 value);
+    Result Write(s32 value);
+    Result Write(u64 value);
+    Result Write(s64 value);
+    Result Write(float value);
+    Result Write(double value);
+    Result Write(bool value);
+
+    Result WriteVarint(u64 value);
+    // zigzag encoded, so small negative values stay short
+    Result WriteVarint(s64 value);
+
+    Result WriteBytes(ConstSpan<u8> bytes);
+    // arrays are byte swapped in bulk
+    Result WriteArray(ConstSpan<u8> array);
+    Result WriteArray(ConstSpan<s8> array);
+    Result WriteArray(ConstSpan<u16> array);
+    Result WriteArray(ConstSpan<s16> array);
+    Result WriteArray(ConstSpan<u32> array);
+    Result WriteArray(ConstSpan<s32> array);
+    Result WriteArray(ConstSpan<u64> array);
+    Result WriteArray(ConstSpan<s64> array);
+    Result WriteArray(ConstSpan<float> array);
+    Result WriteArray(ConstSpan<double> array);
+    // varint size followed by the bytes
+    Result WriteString(StringView string);
+
+    // everything written so far, for List mode that is the whole List
+    ConstSpan<u8> Written()const;
+
+    size_t Size()const;
+private:
+    // returns where to write size bytes or nullptr if they don't fit
+    u8 *Reserve(size_t size);
+
+    template<typename Type>
+    Result WriteFixed(Type value);
+
+    template<typename Type>
+    Result WriteSwapped(const Type *array, size_t count);
+};
+
+SX_INLINE u8 *BinaryWriter::Reserve(size_t size){
+    if(m_Buffer){
+        m_Buffer->Resize(m_Size + size);
+        m_Data = m_Buffer->Data();
+        m_Capacity = m_Buffer->Size();
+    }else if(m_Capacity - m_Size < size){
+        return nullptr;
+    }
+
+    u8 *pointer = m_Data + m_Size;
+    m_Size += size;
+    return pointer;
+}
+
+template<typename Type>
+SX_INLINE Result BinaryWriter::WriteFixed(Type value){
+    u8 *pointer = Reserve(sizeof(Type));
+    if(!pointer)
+        return Result::Overflow;
+
+    value = ToNetByteOrder(value);
+    memcpy(pointer, &value, sizeof(value));
+    return Result::Success;
+}
+
+SX_INLINE Result BinaryWriter::Write(u8 value){
+    return WriteFixed(value);
+}
+
+SX_INLINE Result BinaryWriter::Write(s8 value){
+    return WriteFixed((u8)value);
+}
+
+SX_INLINE Result BinaryWriter::Write(u16 value){
+    return WriteFixed(value);
+}
+
+SX_INLINE Result BinaryWriter::Write(s16 value){
+    return WriteFixed((u16)value);
+}
+
+SX_INLINE Result BinaryWriter::Write(u32 value){
+    return WriteFixed(value);
+}
+
+SX_INLINE Result BinaryWriter::Write(s32 value){
+    return WriteFixed((u32)value);
+}
+
+SX_INLINE Result BinaryWriter::Write(u64 value){
+    return WriteFixed(value);
+}
+
+SX_INLINE Result BinaryWriter::Write(s64 value){
+    return WriteFixed((u64)value);
+}
+
+SX_INLINE Result BinaryWriter::Write(float value){
+    u32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return WriteFixed(bits);
+}
+
+SX_INLINE Result BinaryWriter::Write(double value){
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return WriteFixed(bits);
+}
+
+SX_INLINE Result BinaryWriter::Write(bool value){
+    return WriteFixed((u8)value);
+}
+
+SX_INLINE Result BinaryWriter::WriteVarint(s64 value){
+    return WriteVarint(((u64)value << 1) ^ (u64)(value >> 63));
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<u8> array){
+    return WriteBytes(array);
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<s8> array){
+    return WriteBytes(ConstSpan<u8>((const u8*)array.Pointer(), array.Size()));
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<u16> array){
+    return WriteSwapped(array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<s16> array){
+    return WriteSwapped((const u16*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<u32> array){
+    return WriteSwapped(array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<s32> array){
+    return WriteSwapped((const u32*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<u64> array){
+    return WriteSwapped(array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<s64> array){
+    return WriteSwapped((const u64*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<float> array){
+    static_assert(sizeof(float) == sizeof(u32), "float is expected to be 32 bit");
+    return WriteSwapped((const u32*)array.Pointer(), array.Size());
+}
+
+SX_INLINE Result BinaryWriter::WriteArray(ConstSpan<double> array){
+    static_assert(sizeof(double) == sizeof(u64), "double is expected to be 64 bit");
+    return WriteSwapped((const u64*)array.Pointer(), array.Size());
+}
+
+template<typename Type>
+SX_INLINE Result BinaryWriter::WriteSwapped(const Type *array, size_t count){
+    u8 *pointer = Reserve(count * sizeof(Type));
+    if(!pointer)
+        return Result::Overflow;
+
+    // destination is not aligned in general, so swap in place after the copy
+    memcpy(pointer, array, count * sizeof(Type));
+    if(alignof(Type) == 1 || (size_t)pointer % alignof(Type) == 0){
+        SwapEndianness((const Type*)pointer, (Type*)pointer, count);
+    }else{
+        for(size_t i = 0; i<count; i++){
+            Type value;
+            memcpy(&value, pointer + i * sizeof(Type), sizeof(Type));
+            value = SwapEndianness(value);
+            memcpy(pointer + i * sizeof(Type), &value, sizeof(Type));
+        }
+    }
+    return Result::Success;
+}
+
+SX_INLINE ConstSpan<u8> BinaryWriter::Written()const{
+    return ConstSpan<u8>(m_Data, m_Size);
+}
+
+SX_INLINE size_t BinaryWriter::Size()const{
+    return m_Size;
+}
+
+#endif//STRAITX_BINARY_WRITER_HPP
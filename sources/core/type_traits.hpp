@@ -193,6 +193,14 @@ public:
     static constexpr bool Value = __has_trivial_destructor(Type);
 };
 
+template<typename Type>
+struct IsEnum: IntegralConstant<bool, __is_enum(Type)>{};
+
+template<typename EnumType>
+struct UnderlyingType{
+    using Type = __underlying_type(EnumType);
+};
+
 template<typename Type>
 class IsPolymorhpic {
 private:
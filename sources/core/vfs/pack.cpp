@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <string_view>
+#include "core/vfs/pack.hpp"
+#include "core/assert.hpp"
+#include "core/compression/lz_block.hpp"
+
+static bool IsSeparator(char ch){
+    return ch == '/' || ch == '\\';
+}
+
+static char NormalizeSeparator(char ch){
+    return ch == '\\' ? '/' : ch;
+}
+
+static StringView TrimPath(StringView path){
+    for(;;){
+        if(path.Size() >= 2 && path[0] == '.' && IsSeparator(path[1]))
+            path = StringView(path.Data() + 2, path.Size() - 2);
+        else if(path.Size() && IsSeparator(path[0]))
+            path = StringView(path.Data() + 1, path.Size() - 1);
+        else
+            return path;
+    }
+}
+
+// name is stored normalized, path is trimmed
+static bool IsSamePath(StringView name, StringView path){
+    if(name.Size() != path.Size())
+        return false;
+
+    for(size_t i = 0; i<name.Size(); i++){
+        if(name[i] != NormalizeSeparator(path[i]))
+            return false;
+    }
+    return true;
+}
+
+static u64 AlignUp(u64 value, u64 alignment){
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// decompressed size is what Read allocates, so it is bounded by what the stored bytes can decode to
+static bool IsValidSize(const PackEntry &entry){
+    switch(entry.Compression){
+    case PackCompression::None:
+        return entry.Size == entry.StoredSize;
+    case PackCompression::Lz:
+        // a length byte extends a match by 255 bytes at most
+        return entry.Size <= LzBlock::MaxInputSize && entry.Size / 255 <= entry.StoredSize;
+    }
+    return false;
+}
+
+u64 PackArchive::HashPath(StringView path){
+    path = TrimPath(path);
+
+    // FNV-1a
+    u64 hash = 0xcbf29ce484222325;
+    for(char ch: path){
+        hash ^= (u8)NormalizeSeparator(ch);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+Result PackArchive::Open(StringView filename){
+    SX_CORE_ASSERT(!IsOpen(), "PackArchive: Is already open");
+
+    Result result = m_File.Open(filename);
+    if(!result)
+        return result;
+
+    const ConstSpan<u8> data = m_File.Data();
+    const PackHeader *header = (const PackHeader*)data.Pointer();
+
+    const bool is_valid = data.Size() >= sizeof(PackHeader)
+        && header->Magic == PackHeader::MagicValue
+        && header->Version == PackHeader::CurrentVersion
+        && header->EntriesOffset % alignof(PackEntry) == 0
+        && header->EntriesOffset <= data.Size() && header->NamesOffset <= data.Size()
+        && header->EntriesOffset + header->EntriesCount * sizeof(PackEntry) <= data.Size()
+        && header->NamesSize <= data.Size() - header->NamesOffset;
+
+    if(!is_valid){
+        m_File.Close();
+        return Result::WrongFormat;
+    }
+
+    m_Entries = {(const PackEntry*)(data.Pointer() + header->EntriesOffset), header->EntriesCount};
+    m_Names = (const char*)data.Pointer() + header->NamesOffset;
+
+    for(const PackEntry &entry: m_Entries){
+        // sums of the untrusted fields may wrap around
+        if(entry.Offset > data.Size() || entry.StoredSize > data.Size() - entry.Offset || (u64)entry.NameOffset + entry.NameSize > header->NamesSize || !IsValidSize(entry)){
+            Close();
+            return Result::WrongFormat;
+        }
+    }
+
+    return Result::Success;
+}
+
+void PackArchive::Close(){
+    m_File.Close();
+    m_Entries = {};
+    m_Names = nullptr;
+}
+
+const PackEntry *PackArchive::Find(StringView path)const{
+    path = TrimPath(path);
+    const u64 hash = HashPath(path);
+
+    const PackEntry *entry = std::lower_bound(m_Entries.begin(), m_Entries.end(), hash, [](const PackEntry &entry, u64 hash){
+        return entry.Hash < hash;
+    });
+
+    for(; entry != m_Entries.end() && entry->Hash == hash; ++entry){
+        if(IsSamePath(Name(*entry), path))
+            return entry;
+    }
+    return nullptr;
+}
+
+Optional<ConstSpan<u8>> PackArchive::Read(const PackEntry &entry, List<u8> &storage)const{
+    SX_CORE_ASSERT(entry.Offset <= m_File.Data().Size() && entry.StoredSize <= m_File.Data().Size() - entry.Offset, "PackArchive: Entry is out of the archive");
+    SX_CORE_ASSERT(IsValidSize(entry), "PackArchive: Entry size is corrupted");
+
+    switch(entry.Compression){
+    case PackCompression::None:
+        return Stored(entry);
+    case PackCompression::Lz:
+        storage.Resize(entry.Size);
+        if(LzBlock::Decompress(Stored(entry), {storage.Data(), storage.Size()}) != entry.Size)
+            return {};
+        return ConstSpan<u8>(storage.Data(), storage.Size());
+    }
+    return {};
+}
+
+Result PackWriter::Open(StringView filename){
+    if(File::Exists(filename) && !File::Delete(filename))
+        return Result::AlreadyExist;
+
+    Result result = m_File.Open(filename, File::Mode::Write, true);
+    if(!result)
+        return result;
+
+    // first page is reserved for the header
+    m_Offset = PackArchive::Alignment;
+    m_Entries.Clear();
+    m_Names.Clear();
+    return Result::Success;
+}
+
+Result PackWriter::Add(StringView path, ConstSpan<u8> content, PackCompression compression){
+    SX_CORE_ASSERT(m_File.IsOpen(), "PackWriter: Is not open");
+
+    path = TrimPath(path);
+    if(!path.Size())
+        return Result::InvalidArgs;
+
+    ConstSpan<u8> stored = content;
+
+    if(compression == PackCompression::Lz && content.Size() <= LzBlock::MaxInputSize){
+        m_Compressed.Resize(content.Size());
+        size_t compressed = LzBlock::Compress(content, {m_Compressed.Data(), m_Compressed.Size()}, LzBlock::Level::High);
+
+        if(compressed != LzBlock::InvalidSize && compressed < content.Size())
+            stored = {m_Compressed.Data(), compressed};
+        else
+            compression = PackCompression::None;
+    }else{
+        compression = PackCompression::None;
+    }
+
+    if(m_File.WriteAt(stored.Pointer(), stored.Size(), m_Offset) != stored.Size())
+        return Result::Failure;
+
+    PackEntry entry;
+    entry.Hash = PackArchive::HashPath(path);
+    entry.Offset = m_Offset;
+    entry.StoredSize = stored.Size();
+    entry.Size = content.Size();
+    entry.NameOffset = (u32)m_Names.Size();
+    entry.NameSize = (u32)path.Size();
+    entry.Compression = compression;
+    m_Entries.Add(entry);
+
+    m_Names.Append(path);
+    for(size_t i = entry.NameOffset; i<m_Names.Size(); i++)
+        m_Names[i] = NormalizeSeparator(m_Names[i]);
+
+    SX_CORE_ASSERT(m_Names.Size() <= 0xFFFFFFFF, "PackWriter: Names table has exceeded 4GB");
+
+    m_Offset = AlignUp(m_Offset + stored.Size(), PackArchive::Alignment);
+    return Result::Success;
+}
+
+Result PackWriter::AddFile(StringView path, StringView filename, PackCompression compression){
+    MappedFile file;
+    Result result = file.Open(filename);
+    if(!result)
+        return result;
+
+    return Add(path, file.Data(), compression);
+}
+
+Result PackWriter::Finish(){
+    SX_CORE_ASSERT(m_File.IsOpen(), "PackWriter: Is not open");
+
+    auto name = [this](const PackEntry &entry){
+        return std::string_view(m_Names.Data() + entry.NameOffset, entry.NameSize);
+    };
+
+    std::sort(m_Entries.begin(), m_Entries.end(), [&name](const PackEntry &left, const PackEntry &right){
+        if(left.Hash != right.Hash)
+            return left.Hash < right.Hash;
+        return name(left) < name(right);
+    });
+
+    for(size_t i = 1; i<m_Entries.Size(); i++){
+        if(m_Entries[i - 1].Hash == m_Entries[i].Hash && name(m_Entries[i - 1]) == name(m_Entries[i])){
+            m_File.Close();
+            return Result::AlreadyExist;
+        }
+    }
+
+    PackHeader header;
+    header.EntriesCount = (u32)m_Entries.Size();
+    // empty pack has nothing past the header
+    header.EntriesOffset = m_Entries.Size() ? m_Offset : sizeof(PackHeader);
+    header.NamesOffset = header.EntriesOffset + m_Entries.Size() * sizeof(PackEntry);
+    header.NamesSize = m_Names.Size();
+
+    const size_t entries_size = m_Entries.Size() * sizeof(PackEntry);
+
+    const bool is_written = m_File.WriteAt(m_Entries.Data(), entries_size, header.EntriesOffset) == entries_size
+        && m_File.WriteAt(m_Names.Data(), m_Names.Size(), header.NamesOffset) == m_Names.Size()
+        && m_File.WriteAt(&header, sizeof(header), 0) == sizeof(header);
+
+    m_File.Close();
+    m_Entries.Clear();
+    m_Names.Clear();
+    return ResultError(!is_written);
+}
@@ -0,0 +1,117 @@
+#ifndef STRAITX_PACK_HPP
+#define STRAITX_PACK_HPP
+
+#include "core/types.hpp"
+#include "core/result.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/string.hpp"
+#include "core/string_view.hpp"
+#include "core/optional.hpp"
+#include "core/noncopyable.hpp"
+#include "core/os/file.hpp"
+#include "core/os/mapped_file.hpp"
+
+// Pack layout, values are stored in native little endian:
+//     PackHeader | entries content, each at Alignment boundary | PackEntry table sorted by Hash | names
+// Paths are stored with '/' separators and without leading "./" or '/'
+
+enum class PackCompression: u8{
+    None = 0,
+    // single LzBlock, written with the high ratio level
+    Lz   = 1
+};
+
+struct PackHeader{
+    static constexpr u32 MagicValue = 0x4B505853; // "SXPK"
+    static constexpr u16 CurrentVersion = 1;
+
+    u32 Magic = MagicValue;
+    u16 Version = CurrentVersion;
+    u16 Flags = 0;
+    u32 EntriesCount = 0;
+    u32 Reserved = 0;
+    u64 EntriesOffset = 0;
+    u64 NamesOffset = 0;
+    u64 NamesSize = 0;
+};
+static_assert(sizeof(PackHeader) == 40, "PackHeader is a part of the file format");
+
+struct PackEntry{
+    u64 Hash = 0;
+    u64 Offset = 0;
+    // size of the entry in the pack
+    u64 StoredSize = 0;
+    // size of the content after decompression
+    u64 Size = 0;
+    u32 NameOffset = 0;
+    u32 NameSize = 0;
+    PackCompression Compression = PackCompression::None;
+    u8 Reserved[7] = {};
+};
+static_assert(sizeof(PackEntry) == 48, "PackEntry is a part of the file format");
+
+// Read-only pack, table of contents and uncompressed entries are used straight from the mapping
+class PackArchive: public NonCopyable{
+public:
+    static constexpr size_t Alignment = 4096;
+private:
+    MappedFile m_File;
+    ConstSpan<PackEntry> m_Entries;
+    const char *m_Names = nullptr;
+public:
+    Result Open(StringView filename);
+
+    void Close();
+
+    bool IsOpen()const;
+    // returns nullptr if there is no such entry
+    const PackEntry *Find(StringView path)const;
+
+    StringView Name(const PackEntry &entry)const;
+    // entry bytes as they are stored in the pack
+    ConstSpan<u8> Stored(const PackEntry &entry)const;
+    // Uncompressed entries are returned straight from the mapping,
+    // compressed ones are decoded into storage. Empty on corrupted entry
+    Optional<ConstSpan<u8>> Read(const PackEntry &entry, List<u8> &storage)const;
+
+    ConstSpan<PackEntry> Entries()const;
+    // '\' is treated as '/', leading "./" and '/' are ignored
+    static u64 HashPath(StringView path);
+};
+
+SX_INLINE bool PackArchive::IsOpen()const{
+    return m_File.IsOpen();
+}
+
+SX_INLINE StringView PackArchive::Name(const PackEntry &entry)const{
+    return {m_Names + entry.NameOffset, entry.NameSize};
+}
+
+SX_INLINE ConstSpan<u8> PackArchive::Stored(const PackEntry &entry)const{
+    return {m_File.Data().Pointer() + entry.Offset, (size_t)entry.StoredSize};
+}
+
+SX_INLINE ConstSpan<PackEntry> PackArchive::Entries()const{
+    return m_Entries;
+}
+
+class PackWriter: public NonCopyable{
+private:
+    File m_File;
+    u64 m_Offset = 0;
+    List<PackEntry> m_Entries;
+    String m_Names;
+    List<u8> m_Compressed;
+public:
+    Result Open(StringView filename);
+
+    // entry is stored uncompressed when compression doesn't pay off
+    Result Add(StringView path, ConstSpan<u8> content, PackCompression compression = PackCompression::None);
+
+    Result AddFile(StringView path, StringView filename, PackCompression compression = PackCompression::None);
+    // writes table of contents and closes the pack, fails with AlreadyExist on duplicated paths
+    Result Finish();
+};
+
+#endif//STRAITX_PACK_HPP
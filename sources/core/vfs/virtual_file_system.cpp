@@ -0,0 +1,63 @@
+#include "core/vfs/virtual_file_system.hpp"
+#include "core/os/file.hpp"
+
+Result VirtualFileSystem::Mount(StringView pack_filename){
+    UniquePtr<PackArchive> archive(new PackArchive());
+
+    Result result = archive->Open(pack_filename);
+    if(!result)
+        return result;
+
+    m_Mounts.Add({pack_filename, Move(archive)});
+    return Result::Success;
+}
+
+Result VirtualFileSystem::Unmount(StringView pack_filename){
+    for(size_t i = m_Mounts.Size(); i--;){
+        if(m_Mounts[i].Filename != pack_filename)
+            continue;
+
+        // keep the order, it defines precedence
+        for(; i + 1 < m_Mounts.Size(); i++)
+            Swap(m_Mounts[i], m_Mounts[i + 1]);
+        m_Mounts.RemoveLast();
+        return Result::Success;
+    }
+    return Result::NotFound;
+}
+
+const PackEntry *VirtualFileSystem::Find(StringView path, const PackArchive **archive)const{
+    for(size_t i = m_Mounts.Size(); i--;){
+        const PackEntry *entry = m_Mounts[i].Archive->Find(path);
+        if(!entry)
+            continue;
+
+        if(archive)
+            *archive = m_Mounts[i].Archive.Get();
+        return entry;
+    }
+
+    if(archive)
+        *archive = nullptr;
+    return nullptr;
+}
+
+bool VirtualFileSystem::Exists(StringView path)const{
+    return Find(path) || File::Exists(path);
+}
+
+Optional<ConstSpan<u8>> VirtualFileSystem::Read(StringView path, List<u8> &storage)const{
+    const PackArchive *archive = nullptr;
+    if(const PackEntry *entry = Find(path, &archive))
+        return archive->Read(*entry, storage);
+
+    File file;
+    if(!file.Open(path, File::Mode::Read, false))
+        return {};
+
+    storage.Resize(file.Size());
+    if(file.Read(storage.Data(), storage.Size()) != storage.Size())
+        return {};
+
+    return ConstSpan<u8>(storage.Data(), storage.Size());
+}
@@ -0,0 +1,45 @@
+#ifndef STRAITX_VIRTUAL_FILE_SYSTEM_HPP
+#define STRAITX_VIRTUAL_FILE_SYSTEM_HPP
+
+#include "core/types.hpp"
+#include "core/result.hpp"
+#include "core/span.hpp"
+#include "core/list.hpp"
+#include "core/string.hpp"
+#include "core/string_view.hpp"
+#include "core/optional.hpp"
+#include "core/unique_ptr.hpp"
+#include "core/noncopyable.hpp"
+#include "core/vfs/pack.hpp"
+
+// Resolves paths against mounted packs, packs mounted later take precedence,
+// then falls back to the real filesystem.
+// Lookups don't allocate and are safe to do concurrently while nothing is being mounted
+class VirtualFileSystem: public NonCopyable{
+private:
+    struct MountPoint{
+        String Filename;
+        UniquePtr<PackArchive> Archive;
+    };
+
+    List<MountPoint> m_Mounts;
+public:
+    Result Mount(StringView pack_filename);
+
+    Result Unmount(StringView pack_filename);
+    // archive is set to the pack that contains the entry, nullptr if path is not packed
+    const PackEntry *Find(StringView path, const PackArchive **archive = nullptr)const;
+
+    bool Exists(StringView path)const;
+    // Content of packed uncompressed entries points into the pack mapping,
+    // everything else is read or decoded into storage
+    Optional<ConstSpan<u8>> Read(StringView path, List<u8> &storage)const;
+
+    size_t MountsCount()const;
+};
+
+SX_INLINE size_t VirtualFileSystem::MountsCount()const{
+    return m_Mounts.Size();
+}
+
+#endif//STRAITX_VIRTUAL_FILE_SYSTEM_HPP
@@ -0,0 +1,583 @@
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "core/os/async_file_io.hpp"
+#include "core/os/thread_pool.hpp"
+#include "core/os/memory.hpp"
+#include "core/list.hpp"
+
+static int IoUringSetup(u32 entries, io_uring_params *params){
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int IoUringEnter(int ring, u32 to_submit, u32 min_complete, u32 flags){
+    return (int)syscall(__NR_io_uring_enter, ring, to_submit, min_complete, flags, nullptr, 0);
+}
+
+static int IoUringRegister(int ring, u32 opcode, const void *arg, u32 args_count){
+    return (int)syscall(__NR_io_uring_register, ring, opcode, arg, args_count);
+}
+
+struct AsyncFileIOImpl{
+    AsyncFileIO &Owner;
+    List<int> RegisteredFiles;
+    List<iovec> RegisteredBuffers;
+
+    std::mutex WaitLock;
+    std::condition_variable HasCompleted;
+
+    AsyncFileIOImpl(AsyncFileIO &owner):
+        Owner(owner)
+    {}
+
+    virtual ~AsyncFileIOImpl() = default;
+
+    virtual bool IsIoUring()const = 0;
+
+    virtual Result Submit(AsyncFileRequest &request) = 0;
+
+    virtual void Flush() = 0;
+
+    virtual Result RegisterBuffers(ConstSpan<Span<u8>> buffers){
+        RegisteredBuffers.Clear();
+        for(Span<u8> buffer: buffers)
+            RegisteredBuffers.Add({buffer.Pointer(), buffer.Size()});
+        return Result::Success;
+    }
+
+    virtual Result RegisterFiles(ConstSpan<const File *> files){
+        RegisteredFiles.Clear();
+        for(const File *file: files)
+            RegisteredFiles.Add(file ? (int)file->FD() : -1);
+        return Result::Success;
+    }
+
+    virtual void UnregisterBuffers(){
+        RegisteredBuffers.Clear();
+    }
+
+    virtual void UnregisterFiles(){
+        RegisteredFiles.Clear();
+    }
+
+    bool IsRegisteredRange(const AsyncFileRequest &request)const{
+        if(request.m_BufferIndex < 0)
+            return true;
+        if(request.m_BufferIndex >= (s32)RegisteredBuffers.Size())
+            return false;
+
+        const iovec &buffer = RegisteredBuffers[request.m_BufferIndex];
+        const u8 *begin = (const u8*)buffer.iov_base;
+        const u8 *request_begin = (const u8*)request.m_Buffer;
+        return request_begin >= begin && request_begin + request.m_Size <= begin + buffer.iov_len;
+    }
+
+    int NativeFD(const AsyncFileRequest &request)const{
+        if(request.m_FileIndex < 0)
+            return (int)request.m_FD;
+        return RegisteredFiles[request.m_FileIndex];
+    }
+
+    // Callback is moved out before the request is marked as complete, so it can read
+    // the result and submit the request again
+    void Complete(AsyncFileRequest &request, s64 transferred){
+        AsyncFileRequest::Callback on_complete(Move(request.m_OnComplete));
+        request.m_OnComplete.Unbind();
+        request.m_Transferred = transferred;
+        request.m_IsComplete.store(true, std::memory_order_release);
+
+        {
+            std::unique_lock<std::mutex> lock(WaitLock);
+            HasCompleted.notify_all();
+        }
+        on_complete.TryCall(request);
+    }
+
+    // Blocking path, used by thread pool fallback
+    void Execute(AsyncFileRequest &request){
+        const int fd = NativeFD(request);
+        u8 *buffer = (u8*)request.m_Buffer;
+        u64 done = 0;
+
+        while(done < request.m_Size){
+            ssize_t result = request.m_Operation == AsyncFileRequest::Operation::Read
+                ? pread(fd, buffer + done, request.m_Size - done, request.m_Offset + done)
+                : pwrite(fd, buffer + done, request.m_Size - done, request.m_Offset + done);
+
+            if(result < 0 && errno == EINTR)
+                continue;
+
+            if(result < 0)
+                return Complete(request, AsyncFileRequest::Failed);
+            // end of file
+            if(result == 0)
+                break;
+
+            done += (u64)result;
+        }
+
+        Complete(request, done);
+    }
+};
+
+class ThreadPoolBackend: public AsyncFileIOImpl{
+private:
+    ThreadPool m_Pool;
+public:
+    ThreadPoolBackend(AsyncFileIO &owner, u32 queue_depth):
+        AsyncFileIOImpl(owner),
+        m_Pool(Min(queue_depth, ThreadPool::HardwareThreadsCount() * 2))
+    {}
+
+    ~ThreadPoolBackend(){
+        m_Pool.WaitIdle();
+    }
+
+    bool IsIoUring()const override{
+        return false;
+    }
+
+    Result Submit(AsyncFileRequest &request)override{
+        m_Pool.Enqueue(ThreadPool::Task(&request, &AsyncFileRequest::Execute));
+        return Result::Success;
+    }
+
+    void Flush()override{ }
+};
+
+class IoUringBackend: public AsyncFileIOImpl{
+private:
+    // user_data of the request used to wake completion thread up
+    static constexpr u64 ShutdownMarker = 0;
+    // sqe length is 32 bit, larger requests go in parts through the short transfer path
+    static constexpr u64 MaxSqeLength = 1u << 30;
+private:
+    int m_Ring = -1;
+    io_uring_params m_Params = {};
+
+    void *m_SqRing = nullptr;
+    size_t m_SqRingSize = 0;
+    void *m_CqRing = nullptr;
+    size_t m_CqRingSize = 0;
+    io_uring_sqe *m_Sqes = nullptr;
+    size_t m_SqesSize = 0;
+
+    u32 *m_SqHead = nullptr;
+    u32 *m_SqTail = nullptr;
+    u32 m_SqMask = 0;
+    u32 *m_SqArray = nullptr;
+
+    u32 *m_CqHead = nullptr;
+    u32 *m_CqTail = nullptr;
+    u32 m_CqMask = 0;
+    io_uring_cqe *m_Cqes = nullptr;
+
+    std::mutex m_SubmitLock;
+    std::condition_variable m_HasRoom;
+    u32 m_Queued = 0;
+    u32 m_InFlight = 0;
+    // requests kernel refused to take, are completed as failed outside of m_SubmitLock
+    List<AsyncFileRequest*> m_Stranded;
+
+    std::thread m_CompletionThread;
+public:
+    IoUringBackend(AsyncFileIO &owner):
+        AsyncFileIOImpl(owner)
+    {}
+
+    ~IoUringBackend(){
+        if(m_Ring == -1)
+            return;
+
+        if(m_CompletionThread.joinable()){
+            Flush();
+            {
+                std::unique_lock<std::mutex> lock(m_SubmitLock);
+                m_HasRoom.wait(lock, [this](){ return m_InFlight == 0; });
+
+                io_uring_sqe *sqe = NextSqe();
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = ShutdownMarker;
+                m_Queued++;
+                FlushLocked();
+            }
+            m_CompletionThread.join();
+        }
+
+        if(m_Sqes)
+            munmap(m_Sqes, m_SqesSize);
+        if(m_CqRing && m_CqRing != m_SqRing)
+            munmap(m_CqRing, m_CqRingSize);
+        if(m_SqRing)
+            munmap(m_SqRing, m_SqRingSize);
+        close(m_Ring);
+    }
+
+    bool Initialize(u32 queue_depth){
+        m_Ring = IoUringSetup(queue_depth, &m_Params);
+        if(m_Ring < 0){
+            m_Ring = -1;
+            return false;
+        }
+
+        if(!IsSupported(IORING_OP_READ) || !IsSupported(IORING_OP_WRITE))
+            return false;
+
+        m_SqRingSize = m_Params.sq_off.array + m_Params.sq_entries * sizeof(u32);
+        m_CqRingSize = m_Params.cq_off.cqes + m_Params.cq_entries * sizeof(io_uring_cqe);
+
+        if(m_Params.features & IORING_FEAT_SINGLE_MMAP)
+            m_SqRingSize = m_CqRingSize = Max(m_SqRingSize, m_CqRingSize);
+
+        m_SqRing = Map(m_SqRingSize, IORING_OFF_SQ_RING);
+        if(!m_SqRing)
+            return false;
+
+        if(m_Params.features & IORING_FEAT_SINGLE_MMAP)
+            m_CqRing = m_SqRing;
+        else
+            m_CqRing = Map(m_CqRingSize, IORING_OFF_CQ_RING);
+
+        if(!m_CqRing)
+            return false;
+
+        m_SqesSize = m_Params.sq_entries * sizeof(io_uring_sqe);
+        m_Sqes = (io_uring_sqe*)Map(m_SqesSize, IORING_OFF_SQES);
+        if(!m_Sqes)
+            return false;
+
+        u8 *sq = (u8*)m_SqRing;
+        m_SqHead  = (u32*)(sq + m_Params.sq_off.head);
+        m_SqTail  = (u32*)(sq + m_Params.sq_off.tail);
+        m_SqMask  = *(u32*)(sq + m_Params.sq_off.ring_mask);
+        m_SqArray = (u32*)(sq + m_Params.sq_off.array);
+
+        u8 *cq = (u8*)m_CqRing;
+        m_CqHead = (u32*)(cq + m_Params.cq_off.head);
+        m_CqTail = (u32*)(cq + m_Params.cq_off.tail);
+        m_CqMask = *(u32*)(cq + m_Params.cq_off.ring_mask);
+        m_Cqes   = (io_uring_cqe*)(cq + m_Params.cq_off.cqes);
+
+        m_CompletionThread = std::thread(&IoUringBackend::CompletionThreadMain, this);
+
+        return true;
+    }
+
+    bool IsIoUring()const override{
+        return true;
+    }
+
+    Result Submit(AsyncFileRequest &request)override{
+        std::unique_lock<std::mutex> lock(m_SubmitLock);
+        // don't let completion queue overflow
+        if(m_InFlight == m_Params.cq_entries){
+            FlushLocked();
+            m_HasRoom.wait(lock, [this](){ return m_InFlight < m_Params.cq_entries; });
+        }
+
+        QueueLocked(request);
+        m_InFlight++;
+
+        lock.unlock();
+        CompleteStranded();
+        return Result::Success;
+    }
+
+    void Flush()override{
+        {
+            std::unique_lock<std::mutex> lock(m_SubmitLock);
+            FlushLocked();
+        }
+        CompleteStranded();
+    }
+
+    Result RegisterBuffers(ConstSpan<Span<u8>> buffers)override{
+        UnregisterBuffers();
+        (void)AsyncFileIOImpl::RegisterBuffers(buffers);
+
+        if(IoUringRegister(m_Ring, IORING_REGISTER_BUFFERS, RegisteredBuffers.Data(), RegisteredBuffers.Size()) < 0){
+            RegisteredBuffers.Clear();
+            return errno == ENOMEM ? Result::MemoryFailure : Result::Failure;
+        }
+        return Result::Success;
+    }
+
+    Result RegisterFiles(ConstSpan<const File *> files)override{
+        UnregisterFiles();
+        (void)AsyncFileIOImpl::RegisterFiles(files);
+
+        if(IoUringRegister(m_Ring, IORING_REGISTER_FILES, RegisteredFiles.Data(), RegisteredFiles.Size()) < 0){
+            RegisteredFiles.Clear();
+            return Result::Failure;
+        }
+        return Result::Success;
+    }
+
+    void UnregisterBuffers()override{
+        if(RegisteredBuffers.Size())
+            (void)IoUringRegister(m_Ring, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        AsyncFileIOImpl::UnregisterBuffers();
+    }
+
+    void UnregisterFiles()override{
+        if(RegisteredFiles.Size())
+            (void)IoUringRegister(m_Ring, IORING_UNREGISTER_FILES, nullptr, 0);
+        AsyncFileIOImpl::UnregisterFiles();
+    }
+private:
+    void *Map(size_t size, u64 offset){
+        void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, offset);
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+    bool IsSupported(u8 opcode){
+        constexpr size_t OpsCount = 256;
+        const size_t probe_size = sizeof(io_uring_probe) + OpsCount * sizeof(io_uring_probe_op);
+
+        io_uring_probe *probe = (io_uring_probe*)SX_STACK_ALLOC(probe_size);
+        Memory::Set(probe, 0, probe_size);
+
+        if(IoUringRegister(m_Ring, IORING_REGISTER_PROBE, probe, OpsCount) < 0)
+            return false;
+
+        return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    u32 SqSpace()const{
+        u32 head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE);
+        return m_Params.sq_entries - (*m_SqTail - head);
+    }
+
+    // should be called under m_SubmitLock with SqSpace() > 0
+    io_uring_sqe *NextSqe(){
+        u32 tail = *m_SqTail;
+        u32 index = tail & m_SqMask;
+
+        io_uring_sqe *sqe = &m_Sqes[index];
+        Memory::Set(sqe, 0, sizeof(io_uring_sqe));
+
+        m_SqArray[index] = index;
+        __atomic_store_n(m_SqTail, tail + 1, __ATOMIC_RELEASE);
+        return sqe;
+    }
+
+    // Queues the part of the request that is not transferred yet, m_Transferred counts
+    // bytes done by previous parts. Should be called under m_SubmitLock
+    void QueueLocked(AsyncFileRequest &request){
+        if(SqSpace() == 0)
+            FlushLocked();
+
+        const bool is_read = request.m_Operation == AsyncFileRequest::Operation::Read;
+        const bool is_fixed_buffer = request.m_BufferIndex >= 0;
+        const u64 done = (u64)request.m_Transferred;
+
+        io_uring_sqe *sqe = NextSqe();
+        if(is_fixed_buffer)
+            sqe->opcode = is_read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+        else
+            sqe->opcode = is_read ? IORING_OP_READ : IORING_OP_WRITE;
+
+        if(request.m_FileIndex >= 0){
+            sqe->fd = request.m_FileIndex;
+            sqe->flags |= IOSQE_FIXED_FILE;
+        }else{
+            sqe->fd = (int)request.m_FD;
+        }
+        sqe->off = request.m_Offset + done;
+        sqe->addr = (u64)request.m_Buffer + done;
+        sqe->len = (u32)Min(request.m_Size - done, MaxSqeLength);
+        sqe->buf_index = is_fixed_buffer ? (u16)request.m_BufferIndex : 0;
+        sqe->user_data = (u64)&request;
+
+        m_Queued++;
+    }
+
+    // Short transfers and interrupted operations are resubmitted for the rest of the range,
+    // the same way the blocking path loops
+    void OnCompletion(AsyncFileRequest &request, s32 result){
+        if(result == -EINTR || result == -EAGAIN)
+            return Resubmit(request);
+        if(result < 0)
+            return Finish(request, AsyncFileRequest::Failed);
+
+        request.m_Transferred += result;
+        // end of file
+        if(result == 0 || (u64)request.m_Transferred == request.m_Size)
+            return Finish(request, request.m_Transferred);
+
+        Resubmit(request);
+    }
+
+    // request leaves the queue before its callback runs, so the callback can submit it again
+    void Finish(AsyncFileRequest &request, s64 transferred){
+        {
+            std::unique_lock<std::mutex> lock(m_SubmitLock);
+            m_InFlight--;
+            m_HasRoom.notify_all();
+        }
+        Complete(request, transferred);
+    }
+
+    void Resubmit(AsyncFileRequest &request){
+        {
+            std::unique_lock<std::mutex> lock(m_SubmitLock);
+            QueueLocked(request);
+            FlushLocked();
+        }
+        CompleteStranded();
+    }
+
+    void FlushLocked(){
+        while(m_Queued){
+            int submitted = IoUringEnter(m_Ring, m_Queued, 0, 0);
+
+            if(submitted < 0){
+                if(errno == EINTR || errno == EAGAIN || errno == EBUSY){
+                    std::this_thread::yield();
+                    continue;
+                }
+                return StrandLocked();
+            }
+
+            m_Queued -= (u32)submitted;
+        }
+    }
+
+    // Kernel didn't take the rest of the queue, its entries are taken back out of the ring,
+    // otherwise their requests would never complete and Wait would hang on them
+    void StrandLocked(){
+        const u32 tail = *m_SqTail;
+        const u32 head = tail - m_Queued;
+
+        for(u32 i = head; i != tail; i++){
+            const u64 user_data = m_Sqes[i & m_SqMask].user_data;
+            if(user_data != ShutdownMarker)
+                m_Stranded.Add((AsyncFileRequest*)user_data);
+        }
+        __atomic_store_n(m_SqTail, head, __ATOMIC_RELEASE);
+        m_Queued = 0;
+    }
+
+    void CompleteStranded(){
+        List<AsyncFileRequest*> stranded;
+        {
+            std::unique_lock<std::mutex> lock(m_SubmitLock);
+            if(!m_Stranded.Size())
+                return;
+            stranded = Move(m_Stranded);
+        }
+
+        for(AsyncFileRequest *request: stranded)
+            Finish(*request, AsyncFileRequest::Failed);
+    }
+
+    void CompletionThreadMain(){
+        bool is_running = true;
+
+        while(is_running){
+            if(IoUringEnter(m_Ring, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                break;
+
+            u32 head = *m_CqHead;
+
+            while(head != __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE)){
+                const io_uring_cqe &cqe = m_Cqes[head & m_CqMask];
+                const u64 user_data = cqe.user_data;
+                const s32 transferred = cqe.res;
+                __atomic_store_n(m_CqHead, ++head, __ATOMIC_RELEASE);
+
+                if(user_data == ShutdownMarker){
+                    is_running = false;
+                    continue;
+                }
+
+                OnCompletion(*(AsyncFileRequest*)user_data, transferred);
+            }
+        }
+    }
+};
+
+static AsyncFileIOImpl *ToImpl(void *impl){
+    return reinterpret_cast<AsyncFileIOImpl*>(impl);
+}
+
+void AsyncFileRequest::Execute(){
+    ToImpl(m_Owner->m_Impl)->Execute(*this);
+}
+
+AsyncFileIO::AsyncFileIO(u32 queue_depth, bool force_fallback){
+    if(!force_fallback){
+        IoUringBackend *uring = new IoUringBackend(*this);
+        if(uring->Initialize(queue_depth)){
+            m_Impl = uring;
+            return;
+        }
+        delete uring;
+    }
+    m_Impl = new ThreadPoolBackend(*this, queue_depth);
+}
+
+AsyncFileIO::~AsyncFileIO(){
+    delete ToImpl(m_Impl);
+}
+
+void AsyncFileIO::Flush(){
+    ToImpl(m_Impl)->Flush();
+}
+
+Result AsyncFileIO::RegisterBuffers(ConstSpan<Span<u8>> buffers){
+    return ToImpl(m_Impl)->RegisterBuffers(buffers);
+}
+
+Result AsyncFileIO::RegisterFiles(ConstSpan<const File *> files){
+    return ToImpl(m_Impl)->RegisterFiles(files);
+}
+
+void AsyncFileIO::UnregisterBuffers(){
+    ToImpl(m_Impl)->UnregisterBuffers();
+}
+
+void AsyncFileIO::UnregisterFiles(){
+    ToImpl(m_Impl)->UnregisterFiles();
+}
+
+bool AsyncFileIO::IsUsingIoUring()const{
+    return ToImpl(m_Impl)->IsIoUring();
+}
+
+Result AsyncFileIO::Submit(AsyncFileRequest &request, Callback &&on_complete){
+    SX_CORE_ASSERT(request.IsComplete(), "AsyncFileIO: Request is already in flight");
+
+    AsyncFileIOImpl *impl = ToImpl(m_Impl);
+
+    if(request.m_FileIndex >= (s32)impl->RegisteredFiles.Size())
+        return Result::InvalidArgs;
+    if(!impl->IsRegisteredRange(request))
+        return Result::InvalidArgs;
+
+    request.m_Owner = this;
+    request.m_Transferred = 0;
+    request.m_OnComplete = Move(on_complete);
+    request.m_IsComplete.store(false, std::memory_order_relaxed);
+
+    Result result = impl->Submit(request);
+    if(!result){
+        request.m_OnComplete.Unbind();
+        request.m_IsComplete.store(true, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void AsyncFileIO::Wait(AsyncFileRequest &request){
+    AsyncFileIOImpl *impl = ToImpl(m_Impl);
+    impl->Flush();
+
+    std::unique_lock<std::mutex> lock(impl->WaitLock);
+    impl->HasCompleted.wait(lock, [&request](){ return request.IsComplete(); });
+}
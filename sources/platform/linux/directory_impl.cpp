@@ -0,0 +1,230 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "core/os/directory.hpp"
+#include "core/assert.hpp"
+
+// glibc exposes getdents64 only since 2.30
+struct LinuxDirent64{
+	u64 Inode;
+	s64 Offset;
+	u16 RecordLength;
+	u8 Type;
+	char Name[1];
+};
+
+static bool IsSpecialDirectory(const char *name){
+	return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+struct DirectoryIteratorImpl{
+	// big enough to get a few hundred entries per syscall
+	static constexpr size_t BufferSize = 32 * 1024;
+
+	int FD = -1;
+	size_t Size = 0;
+	size_t Offset = 0;
+	alignas(LinuxDirent64) u8 Buffer[BufferSize];
+
+	DirectoryIteratorImpl(int fd, DirectoryEntry &entry):
+		FD(fd)
+	{
+		MoveNext(entry);
+	}
+
+	~DirectoryIteratorImpl(){
+		Invalidate();
+	}
+
+	void MoveNext(DirectoryEntry &entry){
+		entry = DirectoryEntry();
+
+		for(;;){
+			if(Offset == Size && !Fill())
+				return Invalidate();
+
+			const LinuxDirent64 *dirent = (const LinuxDirent64*)(Buffer + Offset);
+			Offset += dirent->RecordLength;
+
+			if(IsSpecialDirectory(dirent->Name))
+				continue;
+
+			entry.Name = StringView(dirent->Name);
+			if(!Classify(dirent, entry))
+				continue;
+			return;
+		}
+	}
+
+	bool Fill(){
+		long read;
+		do{
+			read = syscall(SYS_getdents64, FD, Buffer, BufferSize);
+		}while(read < 0 && errno == EINTR);
+
+		Size = read > 0 ? read : 0;
+		Offset = 0;
+		return Size;
+	}
+
+	// d_type spares a stat per entry, which is needed only for symlinks and filesystems that don't fill it
+	bool Classify(const LinuxDirent64 *dirent, DirectoryEntry &entry){
+		switch(dirent->Type){
+		case DT_REG:
+			entry.IsFile = true;
+			return true;
+		case DT_DIR:
+			entry.IsDirectory = true;
+			return true;
+		case DT_LNK:
+			entry.IsSymlink = true;
+			[[fallthrough]];
+		case DT_UNKNOWN: {
+			struct stat st;
+			// dangling symlink or entry removed while iterating
+			if(fstatat(FD, dirent->Name, &st, 0) != 0)
+				return entry.IsSymlink;
+
+			entry.IsDirectory = S_ISDIR(st.st_mode);
+			entry.IsFile = !entry.IsDirectory;
+			return true;
+		}
+		default:
+			// sockets, pipes and devices are reported as files, same as on Windows
+			entry.IsFile = true;
+			return true;
+		}
+	}
+
+	bool IsValid()const{
+		return FD != -1;
+	}
+
+	void Invalidate(){
+		if(IsValid())
+			close(FD);
+		FD = -1;
+	}
+};
+
+static auto ToDirItImpl(void *ptr){
+	return reinterpret_cast<DirectoryIteratorImpl*>(ptr);
+}
+
+DirectoryIterator::DirectoryIterator(StringView path){
+	int fd = open(String(path).Data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd == -1)
+		return;
+
+	auto impl = new DirectoryIteratorImpl(fd, m_CurrentEntry);
+	if(!impl->IsValid()){
+		delete impl;
+		return;
+	}
+	m_Impl = impl;
+}
+
+DirectoryIterator::~DirectoryIterator(){
+	delete ToDirItImpl(m_Impl);
+}
+
+bool DirectoryIterator::operator!=(const DirectoryIterator &other)const{
+	return m_Impl != other.m_Impl;
+}
+
+DirectoryIterator &DirectoryIterator::operator++(){
+	auto impl = ToDirItImpl(m_Impl);
+	impl->MoveNext(m_CurrentEntry);
+	if(!impl->IsValid()){
+		delete impl;
+		m_Impl = nullptr;
+	}
+	return *this;
+}
+
+const DirectoryEntry &DirectoryIterator::operator*()const{
+	return m_CurrentEntry;
+}
+
+const DirectoryEntry *DirectoryIterator::operator->()const{
+	return &m_CurrentEntry;
+}
+
+bool Directory::Exists(StringView path){
+	return IsDirectory(path);
+}
+
+bool Directory::IsDirectory(StringView path){
+	struct stat st;
+	if(stat(String(path).Data(), &st) != 0)
+		return false;
+	return S_ISDIR(st.st_mode);
+}
+
+String Directory::Current(){
+	String path;
+	path.Resize(256);
+
+	while(!getcwd(path.Data(), path.Size())){
+		if(errno != ERANGE)
+			return {};
+		path.Resize(path.Size() * 2);
+	}
+	path.Resize(String::Length(path.Data()));
+	return path;
+}
+
+bool Directory::Change(StringView path){
+	return chdir(String(path).Data()) == 0;
+}
+
+static Result DeleteContent(int dir_fd){
+	Result result = Result::Success;
+
+	DIR *dir = fdopendir(dir_fd);
+	if(!dir){
+		close(dir_fd);
+		return Result::Failure;
+	}
+
+	while(dirent *entry = readdir(dir)){
+		if(IsSpecialDirectory(entry->d_name))
+			continue;
+
+		bool is_directory = entry->d_type == DT_DIR;
+		if(entry->d_type == DT_UNKNOWN){
+			struct stat st;
+			is_directory = fstatat(dir_fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+		}
+
+		if(is_directory){
+			int fd = openat(dir_fd, entry->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+			if(fd == -1 || DeleteContent(fd) != Result::Success){
+				result = Result::Failure;
+				continue;
+			}
+		}
+
+		if(unlinkat(dir_fd, entry->d_name, is_directory ? AT_REMOVEDIR : 0) != 0)
+			result = Result::Failure;
+	}
+
+	closedir(dir);
+	return result;
+}
+
+Result Directory::Delete(StringView path){
+	String cpath = path;
+
+	int fd = open(cpath.Data(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+	if(fd == -1)
+		return errno == ENOENT ? Result::NotFound : Result::Failure;
+
+	if(DeleteContent(fd) != Result::Success)
+		return Result::Failure;
+
+	return ResultError(rmdir(cpath.Data()) != 0);
+}
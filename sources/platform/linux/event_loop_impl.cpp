@@ -0,0 +1,374 @@
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include "core/net/event_loop.hpp"
+#include "core/net/tcp_socket.hpp"
+#include "core/net/tcp_listener.hpp"
+#include "core/net/udp_socket.hpp"
+#include "core/os/clock.hpp"
+#include "core/hash_table.hpp"
+#include "core/list.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+
+// epoll key of the wakeup eventfd, socket keys are fd and generation
+static constexpr u64 s_WakeupKey = ~u64(0);
+
+static u64 MakeKey(int fd, u32 generation){
+	return (u64)generation << 32 | (u32)fd;
+}
+
+static u32 ToEpollEvents(u32 events){
+	u32 result = EPOLLET | EPOLLRDHUP;
+	if(events & IoEvent::Readable)
+		result |= EPOLLIN;
+	if(events & IoEvent::Writable)
+		result |= EPOLLOUT;
+	return result;
+}
+
+static u32 FromEpollEvents(u32 events){
+	u32 result = 0;
+	if(events & (EPOLLIN | EPOLLPRI))
+		result |= IoEvent::Readable;
+	if(events & EPOLLOUT)
+		result |= IoEvent::Writable;
+	// there is something to read on closed socket, at least the end of stream
+	if(events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+		result |= IoEvent::Closed | IoEvent::Readable;
+	return result;
+}
+
+struct SocketWatch{
+	EventLoop::IoCallback Callback;
+	u32 Generation = 0;
+	bool IsActive = false;
+};
+
+struct TimerEntry{
+	EventLoop::Task Task;
+	Time Period;
+};
+
+struct ScheduledTimer{
+	Time Deadline;
+	TimerId Id;
+
+	// std heap is a max heap, so earliest deadline goes first with inverted comparison
+	bool operator<(const ScheduledTimer &other)const{
+		return Deadline > other.Deadline;
+	}
+};
+
+struct EventLoopImpl{
+	static constexpr size_t MaxEventsPerWait = 256;
+
+	int Poller = -1;
+	int Wakeup = -1;
+
+	// indexed by fd, kernel hands out the lowest free descriptors so it stays dense
+	List<SocketWatch> Watches;
+	size_t WatchesCount = 0;
+
+	List<ScheduledTimer> Schedule;
+	HashTable<TimerId, TimerEntry> Timers;
+	TimerId NextTimer = EventLoop::InvalidTimer + 1;
+
+	std::mutex PostedLock;
+	List<EventLoop::Task> Posted;
+	List<EventLoop::Task> Running;
+
+	std::atomic<bool> IsStopped{false};
+
+	epoll_event Events[MaxEventsPerWait];
+
+	EventLoopImpl(){
+		Poller = epoll_create1(EPOLL_CLOEXEC);
+		Wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLET;
+		event.data.u64 = s_WakeupKey;
+
+		if(Poller == -1 || Wakeup == -1 || epoll_ctl(Poller, EPOLL_CTL_ADD, Wakeup, &event) == -1)
+			Close();
+	}
+
+	~EventLoopImpl(){
+		Close();
+	}
+
+	void Close(){
+		if(Poller != -1)
+			close(Poller);
+		if(Wakeup != -1)
+			close(Wakeup);
+		Poller = -1;
+		Wakeup = -1;
+	}
+
+	bool IsValid()const{
+		return Poller != -1;
+	}
+
+	bool Watch(int fd, u32 events, EventLoop::IoCallback callback){
+		if(fd < 0)
+			return false;
+
+		if((size_t)fd >= Watches.Size())
+			Watches.Resize(fd + 1);
+
+		SocketWatch &watch = Watches[fd];
+
+		epoll_event event = {};
+		event.events = ToEpollEvents(events);
+
+		if(watch.IsActive){
+			event.data.u64 = MakeKey(fd, watch.Generation);
+
+			if(epoll_ctl(Poller, EPOLL_CTL_MOD, fd, &event) == 0){
+				watch.Callback = callback;
+				return true;
+			}
+			// descriptor was closed without Unwatch and then reused, epoll has forgotten it already
+			if(errno != ENOENT)
+				return false;
+
+			Drop(fd);
+		}
+
+		event.data.u64 = MakeKey(fd, watch.Generation + 1);
+
+		if(epoll_ctl(Poller, EPOLL_CTL_ADD, fd, &event) == -1)
+			return false;
+
+		watch.Generation++;
+		watch.IsActive = true;
+		watch.Callback = callback;
+		WatchesCount++;
+		return true;
+	}
+
+	void Drop(int fd){
+		SocketWatch &watch = Watches[fd];
+		watch.IsActive = false;
+		watch.Callback = EventLoop::IoCallback();
+		WatchesCount--;
+	}
+
+	void Unwatch(int fd){
+		if(fd < 0 || (size_t)fd >= Watches.Size() || !Watches[fd].IsActive)
+			return;
+
+		epoll_ctl(Poller, EPOLL_CTL_DEL, fd, nullptr);
+		Drop(fd);
+	}
+
+	TimerId SetTimer(Time delay, EventLoop::Task task, Time period){
+		const TimerId id = NextTimer++;
+
+		Timers.Add(id, TimerEntry{task, period});
+		Schedule.Add(ScheduledTimer{Clock::GetMonotonicTime() + delay, id});
+		std::push_heap(Schedule.begin(), Schedule.end());
+
+		return id;
+	}
+
+	void Post(EventLoop::Task task){
+		{
+			std::lock_guard<std::mutex> lock(PostedLock);
+			Posted.Add(task);
+		}
+		Wake();
+	}
+
+	void Wake(){
+		const u64 value = 1;
+		(void)write(Wakeup, &value, sizeof(value));
+	}
+
+	int WaitTimeout(Time timeout)const{
+		s64 milliseconds = Max<s64>(timeout.AsMilliseconds(), 0);
+
+		if(Schedule.Size()){
+			const Time until_timer = Schedule[0].Deadline - Clock::GetMonotonicTime();
+			// round up, so the timer has expired by the time we wake up
+			milliseconds = Min<s64>(milliseconds, Max<s64>((until_timer.AsMicroseconds() + 999) / 1000, 0));
+		}
+
+		return (int)Min<s64>(milliseconds, 0x7FFFFFFF);
+	}
+
+	void DispatchEvents(int count){
+		for(int i = 0; i<count; i++){
+			const u64 key = Events[i].data.u64;
+
+			if(key == s_WakeupKey){
+				u64 value;
+				(void)read(Wakeup, &value, sizeof(value));
+				continue;
+			}
+
+			const int fd = (int)(u32)key;
+			const u32 generation = (u32)(key >> 32);
+
+			// socket could be unwatched or rewatched by one of the previous callbacks in this batch
+			if((size_t)fd >= Watches.Size() || !Watches[fd].IsActive || Watches[fd].Generation != generation)
+				continue;
+
+			// callback may watch new sockets and reallocate the list
+			const EventLoop::IoCallback callback = Watches[fd].Callback;
+			const u32 events = FromEpollEvents(Events[i].events);
+			callback(events);
+
+			// TcpSocket closes itself on disconnect, so it can't be unwatched by the callback,
+			// closed descriptor is gone from epoll already and is dropped here
+			if((events & IoEvent::Closed) && Watches[fd].IsActive && Watches[fd].Generation == generation && fcntl(fd, F_GETFD) == -1)
+				Drop(fd);
+		}
+	}
+
+	void RunTimers(){
+		const Time now = Clock::GetMonotonicTime();
+
+		while(Schedule.Size() && Schedule[0].Deadline <= now){
+			std::pop_heap(Schedule.begin(), Schedule.end());
+			const ScheduledTimer scheduled = Schedule.Last();
+			Schedule.RemoveLast();
+
+			auto it = Timers.Find(scheduled.Id);
+			// cancelled
+			if(it == Timers.end())
+				continue;
+
+			const TimerEntry entry = it->second;
+
+			if(entry.Period == Time()){
+				Timers.Remove(scheduled.Id);
+			}else{
+				// don't try to catch up missed periods
+				Schedule.Add(ScheduledTimer{Max(scheduled.Deadline + entry.Period, now), scheduled.Id});
+				std::push_heap(Schedule.begin(), Schedule.end());
+			}
+
+			entry.Task();
+		}
+	}
+
+	void RunPosted(){
+		{
+			std::lock_guard<std::mutex> lock(PostedLock);
+			Swap(Posted, Running);
+		}
+
+		for(const EventLoop::Task &task: Running)
+			task();
+		Running.Clear();
+	}
+
+	bool RunOnce(Time timeout){
+		if(IsStopped.load(std::memory_order_acquire))
+			return false;
+
+		int count = epoll_wait(Poller, Events, MaxEventsPerWait, WaitTimeout(timeout));
+
+		if(count > 0)
+			DispatchEvents(count);
+
+		RunTimers();
+		RunPosted();
+
+		return !IsStopped.load(std::memory_order_acquire);
+	}
+};
+
+EventLoop::EventLoop():
+	m_Impl(new EventLoopImpl())
+{}
+
+EventLoop::~EventLoop(){
+	delete (EventLoopImpl*)m_Impl;
+}
+
+bool EventLoop::IsValid()const{
+	return ((EventLoopImpl*)m_Impl)->IsValid();
+}
+
+bool EventLoop::Watch(TcpSocket &socket, u32 events, IoCallback callback){
+	return WatchImpl(socket.m_Handle, events, callback);
+}
+
+bool EventLoop::Watch(TcpListener &listener, IoCallback callback){
+	return WatchImpl(listener.m_Handle, IoEvent::Readable, callback);
+}
+
+bool EventLoop::Watch(UdpSocket &socket, u32 events, IoCallback callback){
+	return WatchImpl(socket.m_Handle, events, callback);
+}
+
+void EventLoop::Unwatch(TcpSocket &socket){
+	UnwatchImpl(socket.m_Handle);
+}
+
+void EventLoop::Unwatch(TcpListener &listener){
+	UnwatchImpl(listener.m_Handle);
+}
+
+void EventLoop::Unwatch(UdpSocket &socket){
+	UnwatchImpl(socket.m_Handle);
+}
+
+TimerId EventLoop::SetTimer(Time delay, Task task, Time period){
+	return ((EventLoopImpl*)m_Impl)->SetTimer(delay, task, period);
+}
+
+void EventLoop::CancelTimer(TimerId timer){
+	// scheduled entry stays in the heap and is skipped when it expires
+	((EventLoopImpl*)m_Impl)->Timers.Remove(timer);
+}
+
+void EventLoop::Post(Task task){
+	((EventLoopImpl*)m_Impl)->Post(task);
+}
+
+void EventLoop::Run(){
+	SX_CORE_ASSERT(IsValid(), "EventLoop: Is not valid");
+
+	while(RunOnce(Seconds(60)))
+		continue;
+}
+
+bool EventLoop::RunOnce(Time timeout){
+	return ((EventLoopImpl*)m_Impl)->RunOnce(timeout);
+}
+
+void EventLoop::Stop(){
+	EventLoopImpl *impl = (EventLoopImpl*)m_Impl;
+
+	impl->IsStopped.store(true, std::memory_order_release);
+	impl->Wake();
+}
+
+size_t EventLoop::WatchesCount()const{
+	return ((EventLoopImpl*)m_Impl)->WatchesCount;
+}
+
+bool EventLoop::WatchImpl(SocketHandle socket, u32 events, IoCallback callback){
+	if(socket == Socket::InvalidSocket)
+		return false;
+
+	Socket::SetBlocking(socket, false);
+	return ((EventLoopImpl*)m_Impl)->Watch((int)socket, events, callback);
+}
+
+void EventLoop::UnwatchImpl(SocketHandle socket){
+	if(socket == Socket::InvalidSocket)
+		return;
+
+	((EventLoopImpl*)m_Impl)->Unwatch((int)socket);
+}
@@ -0,0 +1,417 @@
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include "core/os/file_watcher.hpp"
+#include "core/os/directory.hpp"
+#include "core/os/clock.hpp"
+#include "core/hash_table.hpp"
+#include "core/list.hpp"
+#include "core/algorithm.hpp"
+#include "core/assert.hpp"
+
+static constexpr u32 s_WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO
+	| IN_DELETE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+static bool IsInside(StringView path, StringView directory){
+	if(path.Size() < directory.Size())
+		return false;
+	if(StringView(path.Data(), directory.Size()) != directory)
+		return false;
+	return path.Size() == directory.Size() || path[directory.Size()] == '/';
+}
+
+static String JoinPath(StringView directory, StringView name){
+	String path;
+	path.Append(directory);
+	path.Append(StringView("/"));
+	path.Append(name);
+	return path;
+}
+
+static StringView StripTrailingSlash(StringView path){
+	while(path.Size() > 1 && path[path.Size() - 1] == '/')
+		path = StringView(path.Data(), path.Size() - 1);
+	return path;
+}
+
+struct DirectoryWatch{
+	String Path;
+	bool IsRecursive = false;
+	bool IsRoot = false;
+};
+
+struct PendingChange{
+	FileChangeEvent Event;
+	bool IsDropped = false;
+};
+
+// first half of a rename, waits for IN_MOVED_TO with the same cookie
+struct PendingMove{
+	u32 Cookie = 0;
+	String Path;
+	bool IsDirectory = false;
+};
+
+struct FileWatcherImpl{
+	// enough for a few thousand events per read
+	static constexpr size_t BufferSize = 64 * 1024;
+
+	int FD = -1;
+	Time Debounce;
+	Time MaxDelay;
+
+	HashTable<int, DirectoryWatch> Watches;
+
+	List<PendingChange> Pending;
+	HashTable<String, size_t> PendingIndex;
+	List<PendingMove> Moves;
+	Time FirstChangeTime;
+	Time LastChangeTime;
+
+	List<FileChangeEvent> Batch;
+
+	alignas(inotify_event) u8 Buffer[BufferSize];
+
+	FileWatcherImpl(Time debounce, Time max_delay):
+		FD(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+		Debounce(debounce),
+		MaxDelay(max_delay)
+	{}
+
+	~FileWatcherImpl(){
+		if(FD != -1)
+			close(FD);
+	}
+
+	Result AddWatch(StringView root, bool is_recursive, bool is_root, bool report_content){
+		List<String> directories;
+		directories.Add(root);
+
+		Result result = Result::Success;
+		while(directories.Size()){
+			String path = Move(directories.Last());
+			directories.RemoveLast();
+
+			int wd = inotify_add_watch(FD, path.Data(), s_WatchMask | (is_root ? 0 : IN_DONT_FOLLOW));
+			if(wd == -1){
+				// directory can be removed while we are scanning
+				if(errno == ENOENT && !is_root)
+					continue;
+				result = errno == ENOSPC ? Result::Overflow : errno == EACCES ? Result::PermissionDenied : Result::Failure;
+				if(is_root)
+					return result;
+				continue;
+			}
+
+			DirectoryWatch &watch = Watches[wd];
+			watch.Path = path;
+			watch.IsRecursive = is_recursive;
+			watch.IsRoot = watch.IsRoot || is_root;
+			is_root = false;
+
+			if(!is_recursive && !report_content)
+				continue;
+
+			for(const DirectoryEntry &entry: Directory(path)){
+				const bool is_directory = entry.IsDirectory && !entry.IsSymlink;
+				// entries created before the watch was added to the new directory have no events of their own
+				if(report_content)
+					Push(JoinPath(path, entry.Name), FileChange::Created, is_directory);
+				if(is_directory && is_recursive)
+					directories.Add(JoinPath(path, entry.Name));
+			}
+		}
+		return result;
+	}
+
+	void RemoveWatchesInside(StringView directory){
+		for(auto it = Watches.begin(); it != Watches.end();){
+			if(IsInside(it->second.Path, directory)){
+				inotify_rm_watch(FD, it->first);
+				it = Watches.erase(it);
+			}else{
+				++it;
+			}
+		}
+	}
+
+	void RenameWatchesInside(StringView old_directory, StringView new_directory){
+		for(auto &[wd, watch]: Watches){
+			if(!IsInside(watch.Path, old_directory))
+				continue;
+
+			String path = new_directory;
+			path.Append(StringView(watch.Path.Data() + old_directory.Size(), watch.Path.Size() - old_directory.Size()));
+			watch.Path = Move(path);
+		}
+	}
+
+	void ReadEvents(){
+		for(;;){
+			ssize_t size = read(FD, Buffer, BufferSize);
+			if(size < 0 && errno == EINTR)
+				continue;
+			if(size <= 0)
+				return;
+
+			for(ssize_t offset = 0; offset < size;){
+				const inotify_event *event = (const inotify_event*)(Buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				HandleEvent(event);
+			}
+		}
+	}
+
+	void HandleEvent(const inotify_event *event){
+		if(event->mask & IN_Q_OVERFLOW){
+			for(const auto &[wd, watch]: Watches){
+				if(watch.IsRoot)
+					Push(watch.Path, FileChange::Overflowed, true);
+			}
+			return;
+		}
+
+		auto it = Watches.Find(event->wd);
+		if(it == Watches.end())
+			return;
+
+		if(event->mask & IN_IGNORED){
+			Watches.erase(it);
+			return;
+		}
+
+		// children are reported by the parent's watch, root has no parent to do so
+		if(event->mask & IN_DELETE_SELF){
+			if(it->second.IsRoot)
+				Push(it->second.Path, FileChange::Deleted, true);
+			return;
+		}
+
+		const DirectoryWatch &watch = it->second;
+		const bool is_directory = event->mask & IN_ISDIR;
+		String path = JoinPath(watch.Path, StringView(event->len ? event->name : ""));
+
+		if(event->mask & IN_CREATE){
+			Push(path, FileChange::Created, is_directory);
+			if(is_directory && watch.IsRecursive)
+				(void)AddWatch(path, true, false, true);
+		}else if(event->mask & IN_MODIFY){
+			Push(path, FileChange::Modified, is_directory);
+		}else if(event->mask & IN_DELETE){
+			Push(path, FileChange::Deleted, is_directory);
+		}else if(event->mask & IN_MOVED_FROM){
+			Touch();
+			Moves.Add({event->cookie, Move(path), is_directory});
+		}else if(event->mask & IN_MOVED_TO){
+			const bool is_recursive = watch.IsRecursive;
+
+			for(size_t i = 0; i<Moves.Size(); i++){
+				if(Moves[i].Cookie != event->cookie)
+					continue;
+
+				String old_path = Move(Moves[i].Path);
+				Moves.UnorderedRemove(i);
+
+				if(is_directory)
+					RenameWatchesInside(old_path, path);
+				Push(path, FileChange::Renamed, is_directory, Move(old_path));
+				return;
+			}
+
+			// moved in from outside of the watched tree
+			Push(path, FileChange::Created, is_directory);
+			if(is_directory && is_recursive)
+				(void)AddWatch(path, true, false, true);
+		}
+	}
+
+	void Touch(){
+		Time now = Clock::GetMonotonicTime();
+		if(!HasPending())
+			FirstChangeTime = now;
+		LastChangeTime = now;
+	}
+
+	void Drop(size_t index){
+		Pending[index].IsDropped = true;
+		PendingIndex.Remove(Pending[index].Event.Path);
+	}
+
+	void Push(const String &path, FileChange change, bool is_directory, String old_path = {}){
+		Touch();
+
+		if(change == FileChange::Renamed){
+			auto old = PendingIndex.Find(old_path);
+			if(old != PendingIndex.end()){
+				const size_t old_index = old->second;
+				const FileChange old_change = Pending[old_index].Event.Change;
+				String origin = Move(Pending[old_index].Event.OldPath);
+				Drop(old_index);
+
+				// file that didn't exist before the batch is just created under the new name
+				if(old_change == FileChange::Created)
+					return Push(path, FileChange::Created, is_directory);
+				// chain of renames collapses into a single one
+				if(old_change == FileChange::Renamed)
+					old_path = Move(origin);
+			}
+		}
+
+		auto it = PendingIndex.Find(path);
+		if(it == PendingIndex.end()){
+			PendingIndex.Add(path, Pending.Size());
+			Pending.Add({{path, Move(old_path), change, is_directory}});
+			return;
+		}
+
+		const size_t index = it->second;
+		FileChangeEvent &event = Pending[index].Event;
+		event.IsDirectory = is_directory;
+
+		switch(change){
+		case FileChange::Created:
+			// deleted and created again within a batch
+			event.Change = event.Change == FileChange::Deleted ? FileChange::Modified : FileChange::Created;
+			break;
+		case FileChange::Modified:
+			if(event.Change == FileChange::Deleted)
+				event.Change = FileChange::Modified;
+			break;
+		case FileChange::Deleted:
+			if(event.Change == FileChange::Created){
+				Drop(index);
+			}else if(event.Change == FileChange::Renamed){
+				// original file is gone, the new name has never been seen by the consumer
+				String origin = Move(event.OldPath);
+				Drop(index);
+				Push(origin, FileChange::Deleted, is_directory);
+			}else{
+				event.Change = FileChange::Deleted;
+			}
+			break;
+		case FileChange::Renamed:
+			event.Change = FileChange::Renamed;
+			event.OldPath = Move(old_path);
+			break;
+		case FileChange::Overflowed:
+			event.Change = FileChange::Overflowed;
+			break;
+		}
+	}
+
+	bool HasPending()const{
+		return PendingIndex.Size() || Moves.Size();
+	}
+
+	// how long to wait until pending batch is ready
+	Time ReadyIn(Time now)const{
+		Time debounce_left = LastChangeTime + Debounce - now;
+		Time delay_left = FirstChangeTime + MaxDelay - now;
+		return Max(Min(debounce_left, delay_left), Time());
+	}
+
+	ConstSpan<FileChangeEvent> Flush(){
+		// renamed to outside of the watched tree
+		for(PendingMove &move: Moves){
+			if(move.IsDirectory)
+				RemoveWatchesInside(move.Path);
+			Push(move.Path, FileChange::Deleted, move.IsDirectory);
+		}
+		Moves.Clear();
+
+		Batch.Clear();
+		Batch.Reserve(PendingIndex.Size());
+		for(PendingChange &change: Pending){
+			if(!change.IsDropped)
+				Batch.Add(Move(change.Event));
+		}
+		Pending.Clear();
+		PendingIndex.Clear();
+
+		return {Batch.Data(), Batch.Size()};
+	}
+
+	ConstSpan<FileChangeEvent> Poll(){
+		ReadEvents();
+
+		if(!HasPending() || ReadyIn(Clock::GetMonotonicTime()) > Time())
+			return {};
+		return Flush();
+	}
+};
+
+static auto ToImpl(void *impl){
+	return reinterpret_cast<FileWatcherImpl*>(impl);
+}
+
+FileWatcher::FileWatcher(Time debounce, Time max_delay):
+	m_Impl(new FileWatcherImpl(debounce, max_delay))
+{}
+
+FileWatcher::~FileWatcher(){
+	delete ToImpl(m_Impl);
+}
+
+bool FileWatcher::IsValid()const{
+	return ToImpl(m_Impl)->FD != -1;
+}
+
+Result FileWatcher::Watch(StringView directory, bool recursive){
+	SX_CORE_ASSERT(IsValid(), "FileWatcher: inotify instance is not created");
+
+	directory = StripTrailingSlash(directory);
+	if(!Directory::IsDirectory(directory))
+		return Result::NotFound;
+
+	return ToImpl(m_Impl)->AddWatch(directory, recursive, true, false);
+}
+
+Result FileWatcher::Unwatch(StringView directory){
+	auto impl = ToImpl(m_Impl);
+	const size_t count = impl->Watches.Size();
+
+	impl->RemoveWatchesInside(StripTrailingSlash(directory));
+
+	return count != impl->Watches.Size() ? Result::Success : Result::NotFound;
+}
+
+ConstSpan<FileChangeEvent> FileWatcher::Poll(){
+	ConstSpan<FileChangeEvent> batch = ToImpl(m_Impl)->Poll();
+
+	if(batch.Size())
+		OnChanges(batch);
+	return batch;
+}
+
+ConstSpan<FileChangeEvent> FileWatcher::Wait(Time timeout){
+	auto impl = ToImpl(m_Impl);
+	const Time deadline = Clock::GetMonotonicTime() + timeout;
+
+	for(;;){
+		ConstSpan<FileChangeEvent> batch = Poll();
+		if(batch.Size())
+			return batch;
+
+		const Time now = Clock::GetMonotonicTime();
+		if(now >= deadline)
+			return {};
+
+		Time wait = deadline - now;
+		if(impl->HasPending())
+			wait = Min(wait, impl->ReadyIn(now));
+
+		pollfd fd = {impl->FD, POLLIN, 0};
+		// round up to not spin on sub-millisecond remainders
+		(void)poll(&fd, 1, (int)((wait.AsMicroseconds() + 999) / 1000));
+	}
+}
+
+int FileWatcher::Handle()const{
+	return ToImpl(m_Impl)->FD;
+}
+
+size_t FileWatcher::WatchesCount()const{
+	return ToImpl(m_Impl)->Watches.Size();
+}
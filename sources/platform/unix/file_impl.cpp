@@ -3,9 +3,11 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <assert.h>
+#include <sys/uio.h>
 #include "core/os/file.hpp"
 #include "core/env/os.hpp"
 #include "core/string.hpp"
+#include "core/algorithm.hpp"
 
 #if defined(SX_ARCH_64_BIT)
     #define lseek64(fd, offset, whence) (off_t)lseek(fd, (off_t)offset, whence)
@@ -59,6 +61,102 @@ size_t File::Write(const void *buffer, size_t size){
     return write(m_FD, buffer, size);
 }
 
+size_t File::ReadAt(void *buffer, size_t size, u64 offset){
+    assert(m_Mode == Mode::Read || m_Mode == Mode::ReadWrite);
+    assert(m_FD != InvalidFD);
+
+    size_t done = 0;
+    while(done < size){
+        ssize_t result = pread(m_FD, (u8*)buffer + done, size - done, offset + done);
+
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result <= 0)
+            break;
+
+        done += result;
+    }
+    return done;
+}
+
+size_t File::WriteAt(const void *buffer, size_t size, u64 offset){
+    assert(m_Mode == Mode::Write || m_Mode == Mode::ReadWrite);
+    assert(m_FD != InvalidFD);
+
+    size_t done = 0;
+    while(done < size){
+        ssize_t result = pwrite(m_FD, (const u8*)buffer + done, size - done, offset + done);
+
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result <= 0)
+            break;
+
+        done += result;
+    }
+    return done;
+}
+
+template<typename BufferType>
+static size_t VectoredIO(int fd, ConstSpan<BufferType> buffers, bool is_read){
+    constexpr size_t BatchSize = 64;
+    iovec batch[BatchSize];
+
+    size_t done = 0;
+    size_t index = 0;
+    // progress inside of the buffers[index]
+    size_t offset = 0;
+
+    for(;;){
+        while(index < buffers.Size() && buffers[index].Size() == offset){
+            index++;
+            offset = 0;
+        }
+
+        if(index == buffers.Size())
+            break;
+
+        int count = 0;
+        for(size_t i = index; i < buffers.Size() && count < (int)BatchSize; i++, count++){
+            size_t skip = i == index ? offset : 0;
+            batch[count].iov_base = (void*)(buffers[i].Pointer() + skip);
+            batch[count].iov_len = buffers[i].Size() - skip;
+        }
+
+        ssize_t result = is_read ? readv(fd, batch, count) : writev(fd, batch, count);
+
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result <= 0)
+            break;
+
+        done += result;
+
+        size_t left = result;
+        while(left && left >= buffers[index].Size() - offset){
+            left -= buffers[index].Size() - offset;
+            index++;
+            offset = 0;
+        }
+        offset += left;
+    }
+    return done;
+}
+
+size_t File::ReadV(ConstSpan<Span<u8>> buffers){
+    assert(m_Mode == Mode::Read || m_Mode == Mode::ReadWrite);
+    assert(m_FD != InvalidFD);
+
+    return VectoredIO(m_FD, buffers, true);
+}
+
+size_t File::WriteV(ConstSpan<ConstSpan<u8>> buffers){
+    assert(m_Mode == Mode::Write || m_Mode == Mode::ReadWrite);
+    assert(m_FD != InvalidFD);
+
+    return VectoredIO(m_FD, buffers, false);
+}
+
 s64 File::Seek(SeekPos position, s64 offset){
     assert(m_FD != InvalidFD);
 
@@ -79,6 +177,139 @@ u64 File::Size(){
     return st.st_size;
 }
 
+void File::Advise(AccessHint hint, u64 offset, u64 size){
+    assert(m_FD != InvalidFD);
+
+#if defined(SX_OS_LINUX)
+    int advice = POSIX_FADV_NORMAL;
+    switch (hint) {
+    case AccessHint::Normal:     advice = POSIX_FADV_NORMAL; break;
+    case AccessHint::Sequential: advice = POSIX_FADV_SEQUENTIAL; break;
+    case AccessHint::Random:     advice = POSIX_FADV_RANDOM; break;
+    case AccessHint::WillNeed:   advice = POSIX_FADV_WILLNEED; break;
+    }
+    (void)posix_fadvise(m_FD, offset, size, advice);
+#elif defined(SX_OS_MACOS)
+    if(hint == AccessHint::WillNeed){
+        radvisory advisory;
+        advisory.ra_offset = offset;
+        advisory.ra_count = size ? (int)Min<u64>(size, 0x7FFFFFFF) : 0x7FFFFFFF;
+        (void)fcntl(m_FD, F_RDADVISE, &advisory);
+    }else{
+        (void)fcntl(m_FD, F_RDAHEAD, hint != AccessHint::Random);
+    }
+#endif
+}
+
+static u64 CopyThroughBuffer(int source, u64 source_offset, int destination, u64 destination_offset, u64 size){
+    constexpr size_t BufferSize = 64 * 1024;
+    u8 buffer[BufferSize];
+
+    u64 done = 0;
+    while(done < size){
+        ssize_t read = pread(source, buffer, Min<u64>(BufferSize, size - done), source_offset + done);
+
+        if(read < 0 && errno == EINTR)
+            continue;
+        if(read <= 0)
+            break;
+
+        ssize_t written = 0;
+        while(written < read){
+            ssize_t result = pwrite(destination, buffer + written, read - written, destination_offset + done + written);
+
+            if(result < 0 && errno == EINTR)
+                continue;
+            if(result <= 0)
+                return done + written;
+
+            written += result;
+        }
+        done += read;
+    }
+    return done;
+}
+
+u64 File::Copy(File &source, u64 source_offset, File &destination, u64 destination_offset, u64 size){
+    assert(source.m_FD != InvalidFD && destination.m_FD != InvalidFD);
+
+    const int src = (int)source.m_FD;
+    const int dst = (int)destination.m_FD;
+    u64 done = 0;
+
+#if defined(SX_OS_LINUX)
+    int error = 0;
+    while(done < size){
+        loff_t src_offset = source_offset + done;
+        loff_t dst_offset = destination_offset + done;
+
+        ssize_t result = copy_file_range(src, &src_offset, dst, &dst_offset, size - done, 0);
+
+        if(result < 0 && errno == EINTR)
+            continue;
+        if(result < 0)
+            error = errno;
+        if(result <= 0)
+            break;
+
+        done += result;
+    }
+    // copy_file_range is not supported for this pair (cross filesystem on older kernels, special files),
+    // the rest goes through a buffer with positional IO. Zero result is the end of source
+    if(done < size && (error == EXDEV || error == ENOSYS || error == EINVAL || error == EOPNOTSUPP))
+        done += CopyThroughBuffer(src, source_offset + done, dst, destination_offset + done, size - done);
+#else
+    done = CopyThroughBuffer(src, source_offset, dst, destination_offset, size);
+#endif
+
+    return done;
+}
+
+Result File::Copy(StringView source, StringView destination){
+    int src = open(String(source).Data(), O_RDONLY);
+    if(src == -1)
+        return errno == ENOENT ? Result::NotFound : Result::Failure;
+
+    struct stat64 st;
+    if(fstat64(src, &st) == -1){
+        close(src);
+        return Result::Failure;
+    }
+
+    // truncated only after the check, copying a file onto itself or its hard link would destroy it
+    int dst = open(String(destination).Data(), O_WRONLY | O_CREAT, st.st_mode & 0777);
+    if(dst == -1){
+        close(src);
+        return errno == EACCES ? Result::PermissionDenied : Result::Failure;
+    }
+
+    struct stat64 dst_st;
+    if(fstat64(dst, &dst_st) == -1){
+        close(src);
+        close(dst);
+        return Result::Failure;
+    }
+
+    if(dst_st.st_dev == st.st_dev && dst_st.st_ino == st.st_ino){
+        close(src);
+        close(dst);
+        return Result::AlreadyExist;
+    }
+
+    if(ftruncate(dst, 0) == -1){
+        close(src);
+        close(dst);
+        return Result::Failure;
+    }
+
+    File src_file, dst_file;
+    src_file.m_FD = src;
+    dst_file.m_FD = dst;
+    dst_file.m_Mode = Mode::Write;
+
+    return ResultError(Copy(src_file, 0, dst_file, 0, st.st_size) != (u64)st.st_size);
+}
+
 Result File::Delete(StringView filename){
     return ResultError(unlink(String(filename).Data()) == -1);
 }
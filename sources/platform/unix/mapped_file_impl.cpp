@@ -0,0 +1,54 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "core/os/mapped_file.hpp"
+#include "core/string.hpp"
+#include "core/assert.hpp"
+
+Result MappedFile::Open(StringView filename){
+    SX_CORE_ASSERT(!IsOpen(), "MappedFile: Is already open");
+
+    int fd = open(String(filename).Data(), O_RDONLY | O_CLOEXEC);
+    if(fd == -1){
+        switch (errno) {
+        case ENOENT: return Result::NotFound;
+        case EACCES: return Result::PermissionDenied;
+        }
+        return Result::Failure;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)){
+        close(fd);
+        return Result::Failure;
+    }
+
+    // zero sized mapping is not allowed, but empty file is still a valid file
+    if(st.st_size){
+        void *pointer = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(pointer == MAP_FAILED){
+            close(fd);
+            return Result::Failure;
+        }
+        m_Pointer = (const u8*)pointer;
+    }
+    // mapping keeps the file referenced by itself
+    close(fd);
+
+    m_Size = st.st_size;
+    m_IsOpen = true;
+    return Result::Success;
+}
+
+void MappedFile::Close(){
+    SX_CORE_ASSERT(IsOpen(), "MappedFile: Is not open");
+
+    if(m_Pointer)
+        munmap((void*)m_Pointer, m_Size);
+
+    m_Pointer = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
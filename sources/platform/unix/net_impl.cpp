@@ -0,0 +1,571 @@
+#include "core/net/udp_socket.hpp"
+#include "core/net/tcp_socket.hpp"
+#include "core/net/tcp_listener.hpp"
+#include "core/env/os.hpp"
+#include "core/algorithm.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <net/if.h>
+#include <ifaddrs.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <atomic>
+
+#if defined(SX_OS_LINUX) || defined(SX_OS_ANDROID)
+	#include <netinet/udp.h>
+#endif
+
+#if defined(SX_OS_LINUX) || defined(SX_OS_ANDROID)
+	// peer reset should be an error, not a SIGPIPE that kills the process
+	constexpr int SendFlags = MSG_NOSIGNAL;
+	constexpr int SocketFlags = SOCK_CLOEXEC;
+
+	#if !defined(UDP_SEGMENT)
+		#define UDP_SEGMENT 103
+	#endif
+	#if !defined(UDP_GRO)
+		#define UDP_GRO 104
+	#endif
+	#define SX_NET_HAS_MMSG
+#else
+	// macos has no MSG_NOSIGNAL, SO_NOSIGPIPE is set on the socket instead
+	constexpr int SendFlags = 0;
+	constexpr int SocketFlags = 0;
+#endif
+
+static int ToFD(SocketHandle socket) {
+	return (int)socket;
+}
+
+static SocketHandle ToHandle(int fd) {
+	// -1 is extended to InvalidSocket
+	return (SocketHandle)(s64)fd;
+}
+
+static bool IsWouldBlock(int error) {
+	return error == EAGAIN || error == EWOULDBLOCK;
+}
+
+static void SetIntOption(SocketHandle socket, int level, int option, int value) {
+	setsockopt(ToFD(socket), level, option, &value, sizeof(value));
+}
+
+static void PrepareSocket(int fd) {
+#if defined(SO_NOSIGPIPE)
+	int value = 1;
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#else
+	(void)fd;
+#endif
+#if !defined(SX_OS_LINUX) && !defined(SX_OS_ANDROID)
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+}
+
+static sockaddr_in MakeAddress(IpAddress address, u16 port_hbo) {
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = ToNetByteOrder(port_hbo);
+	addr.sin_addr.s_addr = (u32)address;
+	return addr;
+}
+
+IpAddress IpAddress::LocalNetworkAddress() {
+	ifaddrs *interfaces = nullptr;
+	if(getifaddrs(&interfaces) != 0)
+		return IpAddress::Any;
+
+	IpAddress result = IpAddress::Any;
+
+	for(ifaddrs *it = interfaces; it; it = it->ifa_next){
+		if(!it->ifa_addr || it->ifa_addr->sa_family != AF_INET)
+			continue;
+		if(!(it->ifa_flags & IFF_UP) || (it->ifa_flags & IFF_LOOPBACK))
+			continue;
+
+		result = IpAddress(((sockaddr_in*)it->ifa_addr)->sin_addr.s_addr);
+		break;
+	}
+
+	freeifaddrs(interfaces);
+	return result;
+}
+
+SocketHandle Socket::OpenImpl(bool is_udp) {
+	int fd = socket(AF_INET, (is_udp ? SOCK_DGRAM : SOCK_STREAM) | SocketFlags, 0);
+	if(fd == -1)
+		return InvalidSocket;
+
+	PrepareSocket(fd);
+
+	if(is_udp)
+		SetIntOption(ToHandle(fd), SOL_SOCKET, SO_BROADCAST, 1);
+
+	return ToHandle(fd);
+}
+
+void Socket::CloseImpl(SocketHandle socket) {
+	close(ToFD(socket));
+}
+
+bool Socket::BindImpl(SocketHandle socket, IpAddress address, u16 port_hbo) {
+	sockaddr_in addr = MakeAddress(address, port_hbo);
+
+	return bind(ToFD(socket), (sockaddr*)&addr, sizeof(addr)) == 0;
+}
+
+void Socket::SetBlocking(SocketHandle socket, bool is_blocking) {
+	int flags = fcntl(ToFD(socket), F_GETFL, 0);
+	if(flags == -1)
+		return;
+
+	flags = is_blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+	fcntl(ToFD(socket), F_SETFL, flags);
+}
+
+void Socket::SetReuseAddress(SocketHandle socket, bool is_enabled) {
+	SetIntOption(socket, SOL_SOCKET, SO_REUSEADDR, is_enabled);
+#if defined(SO_REUSEPORT)
+	SetIntOption(socket, SOL_SOCKET, SO_REUSEPORT, is_enabled);
+#endif
+}
+
+void Socket::SetNoDelay(SocketHandle socket, bool is_enabled) {
+	SetIntOption(socket, IPPROTO_TCP, TCP_NODELAY, is_enabled);
+}
+
+u32 UdpSocket::SendImpl(SocketHandle socket, const void* data, u32 size, IpAddress dst_ip, u16 dst_port_hbo) {
+	sockaddr_in dst_addr = MakeAddress(dst_ip, dst_port_hbo);
+
+	ssize_t sent;
+	do{
+		sent = sendto(ToFD(socket), data, size, SendFlags, (sockaddr*)&dst_addr, sizeof(dst_addr));
+	}while(sent == -1 && errno == EINTR);
+
+	if(sent == -1)
+		return 0;
+	return u32(sent);
+}
+
+u32 UdpSocket::ReceiveImpl(SocketHandle socket, void* data, u32 size, IpAddress& src_ip, u16& src_port_hbo) {
+	sockaddr_in src_addr = {};
+	socklen_t addr_len = sizeof(src_addr);
+
+	ssize_t received;
+	do{
+		received = recvfrom(ToFD(socket), data, size, 0, (sockaddr*)&src_addr, &addr_len);
+	}while(received == -1 && errno == EINTR);
+
+	// would block in non-blocking mode is reported the same way as an error
+	if(received == -1)
+		return 0;
+
+	src_ip = IpAddress(src_addr.sin_addr.s_addr);
+	src_port_hbo = ToHostByteOrder(src_addr.sin_port);
+
+	return u32(received);
+}
+
+#if defined(SX_NET_HAS_MMSG)
+
+static constexpr size_t MaxMessagesPerCall = 64;
+static constexpr size_t MaxIovecsPerCall = 512;
+// UDP_MAX_SEGMENTS of the kernel
+static constexpr size_t MaxSegments = 64;
+
+// -1 until probed, kernel is the same for all the sockets
+static std::atomic<int> s_IsSendOffloadSupported{-1};
+
+static bool IsSendOffloadSupported(int fd) {
+	int state = s_IsSendOffloadSupported.load(std::memory_order_relaxed);
+
+	if(state == -1){
+		int value = 0;
+		socklen_t value_size = sizeof(value);
+		// kernels without UDP GSO don't know the option and would silently ignore the control message
+		state = getsockopt(fd, SOL_UDP, UDP_SEGMENT, &value, &value_size) == 0;
+		s_IsSendOffloadSupported.store(state, std::memory_order_relaxed);
+	}
+	return state;
+}
+
+// number of datagrams from the beginning that can be sent as a single segmented message
+static size_t SegmentsRun(ConstSpan<UdpOutDatagram> datagrams, size_t limit) {
+	const UdpOutDatagram &first = datagrams[0];
+	const size_t segment_size = first.Data.Size();
+	if(!segment_size)
+		return 1;
+
+	size_t total_size = segment_size;
+	size_t count = 1;
+
+	for(; count < datagrams.Size() && count < limit; count++){
+		const UdpOutDatagram &next = datagrams[count];
+
+		if((u32)next.Address != (u32)first.Address || next.Port != first.Port)
+			break;
+		if(!next.Data.Size() || next.Data.Size() > segment_size || total_size + next.Data.Size() > Udp::MaxDatagramSize)
+			break;
+
+		total_size += next.Data.Size();
+		// only the last segment can be shorter
+		if(next.Data.Size() < segment_size){
+			count++;
+			break;
+		}
+	}
+	return count;
+}
+
+u32 UdpSocket::SendBatchImpl(SocketHandle socket, ConstSpan<UdpOutDatagram> datagrams) {
+	bool is_offload_enabled = IsSendOffloadSupported(ToFD(socket));
+
+	mmsghdr messages[MaxMessagesPerCall];
+	iovec iovecs[MaxIovecsPerCall];
+	sockaddr_in addresses[MaxMessagesPerCall];
+	alignas(cmsghdr) u8 controls[MaxMessagesPerCall][CMSG_SPACE(sizeof(u16))];
+	size_t runs[MaxMessagesPerCall];
+
+	size_t sent = 0;
+
+	while(sent < datagrams.Size()){
+		size_t messages_count = 0;
+		size_t iovecs_count = 0;
+		bool is_segmented = false;
+
+		for(size_t next = sent; next < datagrams.Size() && messages_count < MaxMessagesPerCall && iovecs_count < MaxIovecsPerCall; messages_count++){
+			const ConstSpan<UdpOutDatagram> rest(datagrams.Pointer() + next, datagrams.Size() - next);
+			const size_t run = is_offload_enabled ? SegmentsRun(rest, Min(MaxSegments, MaxIovecsPerCall - iovecs_count)) : 1;
+
+			mmsghdr &message = messages[messages_count];
+			message = {};
+			addresses[messages_count] = MakeAddress(rest[0].Address, rest[0].Port);
+			message.msg_hdr.msg_name = &addresses[messages_count];
+			message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			message.msg_hdr.msg_iov = &iovecs[iovecs_count];
+			message.msg_hdr.msg_iovlen = run;
+
+			for(size_t i = 0; i<run; i++)
+				iovecs[iovecs_count++] = {(void*)rest[i].Data.Pointer(), rest[i].Data.Size()};
+
+			if(run > 1){
+				is_segmented = true;
+				message.msg_hdr.msg_control = controls[messages_count];
+				message.msg_hdr.msg_controllen = sizeof(controls[messages_count]);
+
+				cmsghdr *control = CMSG_FIRSTHDR(&message.msg_hdr);
+				control->cmsg_level = SOL_UDP;
+				control->cmsg_type = UDP_SEGMENT;
+				control->cmsg_len = CMSG_LEN(sizeof(u16));
+				const u16 segment_size = rest[0].Data.Size();
+				memcpy(CMSG_DATA(control), &segment_size, sizeof(segment_size));
+			}
+
+			runs[messages_count] = run;
+			next += run;
+		}
+
+		int result = sendmmsg(ToFD(socket), messages, messages_count, SendFlags);
+
+		if(result == -1){
+			if(errno == EINTR)
+				continue;
+			// segmentation needs checksum offload of the outgoing device (EIO), some kernels and devices
+			// reject UDP_SEGMENT with EINVAL or ENOPROTOOPT instead, fall back to plain datagrams
+			if(is_segmented && (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT)){
+				is_offload_enabled = false;
+				s_IsSendOffloadSupported.store(0, std::memory_order_relaxed);
+				continue;
+			}
+			break;
+		}
+
+		for(int i = 0; i<result; i++)
+			sent += runs[i];
+
+		// socket buffer is full
+		if((size_t)result < messages_count)
+			break;
+	}
+
+	return sent;
+}
+
+u32 UdpSocket::ReceiveBatchImpl(SocketHandle socket, Span<UdpInDatagram> datagrams) {
+	mmsghdr messages[MaxMessagesPerCall];
+	iovec iovecs[MaxMessagesPerCall];
+	sockaddr_in addresses[MaxMessagesPerCall];
+	alignas(cmsghdr) u8 controls[MaxMessagesPerCall][CMSG_SPACE(sizeof(int))];
+
+	size_t received = 0;
+
+	while(received < datagrams.Size()){
+		const size_t count = Min(datagrams.Size() - received, MaxMessagesPerCall);
+
+		for(size_t i = 0; i<count; i++){
+			UdpInDatagram &datagram = datagrams[received + i];
+
+			iovecs[i] = {datagram.Buffer.Pointer(), datagram.Buffer.Size()};
+
+			mmsghdr &message = messages[i];
+			message = {};
+			message.msg_hdr.msg_name = &addresses[i];
+			message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			message.msg_hdr.msg_iov = &iovecs[i];
+			message.msg_hdr.msg_iovlen = 1;
+			message.msg_hdr.msg_control = controls[i];
+			message.msg_hdr.msg_controllen = sizeof(controls[i]);
+		}
+
+		// first call waits for one datagram, next ones only take what is queued already
+		int result = recvmmsg(ToFD(socket), messages, count, received ? MSG_DONTWAIT : MSG_WAITFORONE, nullptr);
+
+		if(result == -1){
+			if(errno == EINTR)
+				continue;
+			break;
+		}
+
+		for(int i = 0; i<result; i++){
+			UdpInDatagram &datagram = datagrams[received + i];
+
+			datagram.Size = messages[i].msg_len;
+			datagram.SegmentSize = datagram.Size;
+			datagram.Address = IpAddress(addresses[i].sin_addr.s_addr);
+			datagram.Port = ToHostByteOrder(addresses[i].sin_port);
+
+			for(cmsghdr *control = CMSG_FIRSTHDR(&messages[i].msg_hdr); control; control = CMSG_NXTHDR(&messages[i].msg_hdr, control)){
+				if(control->cmsg_level != SOL_UDP || control->cmsg_type != UDP_GRO)
+					continue;
+
+				int segment_size;
+				memcpy(&segment_size, CMSG_DATA(control), sizeof(segment_size));
+				datagram.SegmentSize = segment_size;
+			}
+		}
+
+		received += result;
+
+		if((size_t)result < count)
+			break;
+	}
+
+	return received;
+}
+
+bool UdpSocket::SetReceiveOffloadImpl(SocketHandle socket, bool is_enabled) {
+	int value = is_enabled;
+	return setsockopt(ToFD(socket), SOL_UDP, UDP_GRO, &value, sizeof(value)) == 0 || !is_enabled;
+}
+
+#else
+
+// no mmsg syscalls, batches are emulated one datagram at a time
+u32 UdpSocket::SendBatchImpl(SocketHandle socket, ConstSpan<UdpOutDatagram> datagrams) {
+	u32 sent = 0;
+	for(const UdpOutDatagram &datagram: datagrams){
+		if(SendImpl(socket, datagram.Data.Pointer(), (u32)datagram.Data.Size(), datagram.Address, datagram.Port) != datagram.Data.Size())
+			break;
+		sent++;
+	}
+	return sent;
+}
+
+u32 UdpSocket::ReceiveBatchImpl(SocketHandle socket, Span<UdpInDatagram> datagrams) {
+	u32 received = 0;
+
+	for(UdpInDatagram &datagram: datagrams){
+		sockaddr_in src_addr = {};
+		socklen_t addr_len = sizeof(src_addr);
+
+		ssize_t result;
+		do{
+			// only the first receive can block
+			result = recvfrom(ToFD(socket), datagram.Buffer.Pointer(), datagram.Buffer.Size(), received ? MSG_DONTWAIT : 0, (sockaddr*)&src_addr, &addr_len);
+		}while(result == -1 && errno == EINTR);
+
+		if(result == -1)
+			break;
+
+		datagram.Size = result;
+		datagram.SegmentSize = datagram.Size;
+		datagram.Address = IpAddress(src_addr.sin_addr.s_addr);
+		datagram.Port = ToHostByteOrder(src_addr.sin_port);
+		received++;
+	}
+	return received;
+}
+
+bool UdpSocket::SetReceiveOffloadImpl(SocketHandle, bool is_enabled) {
+	return !is_enabled;
+}
+
+#endif
+
+bool TcpSocket::ConnectImpl(SocketHandle socket, IpAddress address, u16 port_hbo) {
+	sockaddr_in addr = MakeAddress(address, port_hbo);
+
+	int res = connect(ToFD(socket), (sockaddr*)&addr, sizeof(addr));
+
+	// interrupted connect keeps going in the background and can't be restarted
+	if(res == -1 && errno == EINTR){
+		pollfd poll_fd = {ToFD(socket), POLLOUT, 0};
+		while(poll(&poll_fd, 1, -1) == -1 && errno == EINTR)
+			;
+
+		int error = 0;
+		socklen_t error_len = sizeof(error);
+		return getsockopt(ToFD(socket), SOL_SOCKET, SO_ERROR, &error, &error_len) == 0 && error == 0;
+	}
+
+	return res == 0;
+}
+
+// if returned size is less than size(param) then the error occured during transfering or socket would block
+u32 TcpSocket::SendImpl(SocketHandle socket, const void* data, u32 size, bool& is_disconnected) {
+	is_disconnected = false;
+
+	u32 actual_sent = 0;
+
+	while(actual_sent < size){
+		ssize_t sent = send(ToFD(socket), (const u8*)data + actual_sent, size - actual_sent, SendFlags);
+
+		if(sent == -1){
+			if(errno == EINTR)
+				continue;
+
+			is_disconnected = !IsWouldBlock(errno);
+			break;
+		}
+
+		actual_sent += sent;
+	}
+
+	return actual_sent;
+}
+
+u32 TcpSocket::ReceiveImpl(SocketHandle socket, void* data, u32 size, bool& is_disconnected) {
+	is_disconnected = false;
+
+	u32 actual_received = 0;
+
+	while(actual_received < size){
+		ssize_t received = recv(ToFD(socket), (u8*)data + actual_received, size - actual_received, 0);
+
+		if(received == 0){
+			is_disconnected = true;
+			break;
+		}
+
+		if(received == -1){
+			if(errno == EINTR)
+				continue;
+
+			is_disconnected = !IsWouldBlock(errno);
+			break;
+		}
+
+		actual_received += received;
+	}
+
+	return actual_received;
+}
+
+// sendmsg instead of writev, because only it takes SendFlags
+u32 TcpSocket::SendVectoredImpl(SocketHandle socket, ConstSpan<ConstSpan<u8>> buffers, bool& is_disconnected) {
+	static constexpr size_t MaxIovecs = 64;
+
+	is_disconnected = false;
+
+	u32 actual_sent = 0;
+	size_t buffer = 0;
+	// already sent bytes of the first buffer in the batch
+	size_t offset = 0;
+
+	while(buffer < buffers.Size()){
+		iovec iovecs[MaxIovecs];
+		size_t iovecs_count = 0;
+
+		for(size_t i = buffer; i < buffers.Size() && iovecs_count < MaxIovecs; i++){
+			const size_t skip = i == buffer ? offset : 0;
+			iovecs[iovecs_count].iov_base = (void*)(buffers[i].Pointer() + skip);
+			iovecs[iovecs_count].iov_len = buffers[i].Size() - skip;
+			iovecs_count++;
+		}
+
+		msghdr message = {};
+		message.msg_iov = iovecs;
+		message.msg_iovlen = iovecs_count;
+
+		ssize_t sent = sendmsg(ToFD(socket), &message, SendFlags);
+
+		if(sent == -1){
+			if(errno == EINTR)
+				continue;
+
+			is_disconnected = !IsWouldBlock(errno);
+			break;
+		}
+
+		actual_sent += sent;
+
+		size_t rest = sent;
+		while(buffer < buffers.Size() && rest >= buffers[buffer].Size() - offset){
+			rest -= buffers[buffer].Size() - offset;
+			offset = 0;
+			buffer++;
+		}
+		offset += rest;
+	}
+
+	return actual_sent;
+}
+
+u32 TcpSocket::ReceiveSomeImpl(SocketHandle socket, void* data, u32 size, bool& is_disconnected) {
+	is_disconnected = false;
+
+	ssize_t received;
+	do{
+		received = recv(ToFD(socket), data, size, 0);
+	}while(received == -1 && errno == EINTR);
+
+	if(received == -1){
+		is_disconnected = !IsWouldBlock(errno);
+		return 0;
+	}
+
+	is_disconnected = received == 0 && size;
+	return u32(received);
+}
+
+bool TcpListener::ListenImpl(SocketHandle socket) {
+	return listen(ToFD(socket), SOMAXCONN) == 0;
+}
+
+SocketHandle TcpListener::AcceptImpl(SocketHandle socket, IpAddress& src_ip, u16& src_port_hbo) {
+	sockaddr_in src_addr = {};
+	socklen_t addr_len = sizeof(src_addr);
+
+	int connection;
+	do{
+#if defined(SX_OS_LINUX) || defined(SX_OS_ANDROID)
+		connection = accept4(ToFD(socket), (sockaddr*)&src_addr, &addr_len, SOCK_CLOEXEC);
+#else
+		connection = accept(ToFD(socket), (sockaddr*)&src_addr, &addr_len);
+#endif
+	}while(connection == -1 && errno == EINTR);
+
+	// non-blocking listener without pending connections returns InvalidSocket
+	if(connection == -1)
+		return InvalidSocket;
+
+	PrepareSocket(connection);
+
+	src_ip = IpAddress(src_addr.sin_addr.s_addr);
+	src_port_hbo = ToHostByteOrder(src_addr.sin_port);
+	return ToHandle(connection);
+}
@@ -10,6 +10,7 @@ bool IsSpecialDirectory(const wchar_t* path) {
 struct DirectoryIteratorImpl {
 	HANDLE CurrentFile = INVALID_HANDLE_VALUE;
 	WIN32_FIND_DATAW CurrentFileMetadata = {};
+	String NameStorage;
 
 	DirectoryIteratorImpl(StringView path, DirectoryEntry &entry) {
 		std::wstring wpath = Windows::Utf8ToWPath(path);
@@ -28,10 +29,12 @@ struct DirectoryIteratorImpl {
 
 		if (!IsValid())return;
 		
+		NameStorage = Windows::WstrToUtf8(CurrentFileMetadata.cFileName);
 		entry = DirectoryEntry{
-			Name(),
+			NameStorage,
 			IsFile(),
-			IsDirectory()
+			IsDirectory(),
+			IsSymlink()
 		};
 	}
 
@@ -51,10 +54,12 @@ struct DirectoryIteratorImpl {
 
 		if (!IsValid())return;
 		
+		NameStorage = Windows::WstrToUtf8(CurrentFileMetadata.cFileName);
 		entry = DirectoryEntry{
-			Name(),
+			NameStorage,
 			IsFile(),
-			IsDirectory()
+			IsDirectory(),
+			IsSymlink()
 		};
 	}
 
@@ -78,8 +83,10 @@ struct DirectoryIteratorImpl {
 			&& CurrentFileMetadata.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
 	}
 
-	String Name()const {
-		return Windows::WstrToUtf8(CurrentFileMetadata.cFileName);
+	bool IsSymlink()const {
+		return IsValid()
+			&& CurrentFileMetadata.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT
+			&& CurrentFileMetadata.dwReserved0 == IO_REPARSE_TAG_SYMLINK;
 	}
 };
 
@@ -2,6 +2,7 @@
 #include <assert.h>
 #include "core/os/file.hpp"
 #include "core/log.hpp"
+#include "core/algorithm.hpp"
 #include "platform/windows/wchar.hpp"
 
 static_assert(sizeof(HANDLE) <= sizeof(u64),"Win32 Handle can't fit into File::m_FD");
@@ -62,6 +63,70 @@ size_t File::Write(const void* buffer, size_t size) {
 	return write;
 }
 
+size_t File::ReadAt(void* buffer, size_t size, u64 offset) {
+	assert(m_FD != InvalidFD);
+	assert(m_Mode == Mode::Read || m_Mode == Mode::ReadWrite);
+
+	size_t done = 0;
+	while (done < size) {
+		OVERLAPPED overlapped = {};
+		overlapped.Offset = (DWORD)(offset + done);
+		overlapped.OffsetHigh = (DWORD)((offset + done) >> 32);
+
+		DWORD chunk = (DWORD)Min<size_t>(size - done, 0x80000000);
+		DWORD read = 0;
+		if (!ReadFile(reinterpret_cast<HANDLE>(m_FD), (u8*)buffer + done, chunk, &read, &overlapped) || !read)
+			break;
+
+		done += read;
+	}
+	return done;
+}
+
+size_t File::WriteAt(const void* buffer, size_t size, u64 offset) {
+	assert(m_FD != InvalidFD);
+	assert(m_Mode == Mode::Write || m_Mode == Mode::ReadWrite);
+
+	size_t done = 0;
+	while (done < size) {
+		OVERLAPPED overlapped = {};
+		overlapped.Offset = (DWORD)(offset + done);
+		overlapped.OffsetHigh = (DWORD)((offset + done) >> 32);
+
+		DWORD chunk = (DWORD)Min<size_t>(size - done, 0x80000000);
+		DWORD written = 0;
+		if (!WriteFile(reinterpret_cast<HANDLE>(m_FD), (const u8*)buffer + done, chunk, &written, &overlapped) || !written)
+			break;
+
+		done += written;
+	}
+	return done;
+}
+
+size_t File::ReadV(ConstSpan<Span<u8>> buffers) {
+	size_t done = 0;
+	for (const Span<u8> &buffer : buffers) {
+		size_t read = Read(buffer.Pointer(), buffer.Size());
+		done += read;
+
+		if (read != buffer.Size())
+			break;
+	}
+	return done;
+}
+
+size_t File::WriteV(ConstSpan<ConstSpan<u8>> buffers) {
+	size_t done = 0;
+	for (const ConstSpan<u8> &buffer : buffers) {
+		size_t written = Write(buffer.Pointer(), buffer.Size());
+		done += written;
+
+		if (written != buffer.Size())
+			break;
+	}
+	return done;
+}
+
 s64 File::Seek(SeekPos position, s64 offset) {
 	union {
 		s64 Offset;
@@ -90,6 +155,45 @@ u64 File::Size() {
 	return size.U64;
 }
 
+void File::Advise(AccessHint hint, u64 offset, u64 size) {
+	// Windows takes caching hints only at CreateFile time
+	(void)hint;
+	(void)offset;
+	(void)size;
+}
+
+u64 File::Copy(File& source, u64 source_offset, File& destination, u64 destination_offset, u64 size) {
+	constexpr size_t BufferSize = 64 * 1024;
+	u8 buffer[BufferSize];
+
+	u64 done = 0;
+	while (done < size) {
+		size_t read = source.ReadAt(buffer, (size_t)Min<u64>(BufferSize, size - done), source_offset + done);
+		size_t written = destination.WriteAt(buffer, read, destination_offset + done);
+		done += written;
+
+		if (!read || written != read)
+			break;
+	}
+	return done;
+}
+
+Result File::Copy(StringView source, StringView destination) {
+	// CopyFileW uses server-side copy on network shares and block cloning on ReFS
+	if (CopyFileW(Windows::Utf8ToWPath(source).c_str(), Windows::Utf8ToWPath(destination).c_str(), FALSE))
+		return Result::Success;
+
+	switch (GetLastError()) {
+	case ERROR_FILE_NOT_FOUND:
+	case ERROR_PATH_NOT_FOUND:
+		return Result::NotFound;
+	case ERROR_ACCESS_DENIED:
+		return Result::PermissionDenied;
+	default:
+		return Result::Failure;
+	}
+}
+
 Result File::Delete(StringView filename) {
 	return ResultError(!DeleteFileW(Windows::Utf8ToWPath(filename).c_str()));
 }
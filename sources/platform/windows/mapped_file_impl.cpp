@@ -0,0 +1,63 @@
+#include <windows.h>
+#include "core/os/mapped_file.hpp"
+#include "core/assert.hpp"
+#include "platform/windows/wchar.hpp"
+
+Result MappedFile::Open(StringView filename) {
+	SX_CORE_ASSERT(!IsOpen(), "MappedFile: Is already open");
+
+	HANDLE file = CreateFileW(Windows::Utf8ToWPath(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		switch (GetLastError()) {
+		case ERROR_FILE_NOT_FOUND:
+		case ERROR_PATH_NOT_FOUND: return Result::NotFound;
+		case ERROR_ACCESS_DENIED: return Result::PermissionDenied;
+		}
+		return Result::Failure;
+	}
+
+	LARGE_INTEGER size = {};
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return Result::Failure;
+	}
+
+	// empty files can't be mapped
+	if (size.QuadPart) {
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			CloseHandle(file);
+			return Result::Failure;
+		}
+
+		void *pointer = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!pointer) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return Result::Failure;
+		}
+
+		m_Pointer = (const u8*)pointer;
+		m_Handle = mapping;
+	}
+	// mapping keeps the file referenced by itself
+	CloseHandle(file);
+
+	m_Size = (size_t)size.QuadPart;
+	m_IsOpen = true;
+	return Result::Success;
+}
+
+void MappedFile::Close() {
+	SX_CORE_ASSERT(IsOpen(), "MappedFile: Is not open");
+
+	if (m_Pointer)
+		UnmapViewOfFile(m_Pointer);
+	if (m_Handle)
+		CloseHandle((HANDLE)m_Handle);
+
+	m_Pointer = nullptr;
+	m_Handle = nullptr;
+	m_Size = 0;
+	m_IsOpen = false;
+}
@@ -70,6 +70,17 @@ void Socket::SetBlocking(SocketHandle socket, bool is_blocking) {
     WSA_EXPR(ioctlsocket((SOCKET)socket, static_cast<long>(FIONBIO), &blocking));
 }
 
+void Socket::SetReuseAddress(SocketHandle socket, bool is_enabled) {
+	// windows has no SO_REUSEPORT, SO_REUSEADDR allows port sharing already
+	BOOL value = is_enabled;
+	WSA_EXPR(setsockopt((SOCKET)socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&value, sizeof(value)));
+}
+
+void Socket::SetNoDelay(SocketHandle socket, bool is_enabled) {
+	BOOL value = is_enabled;
+	WSA_EXPR(setsockopt((SOCKET)socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&value, sizeof(value)));
+}
+
 u32 UdpSocket::SendImpl(SocketHandle socket, const void* data, u32 size, IpAddress dst_ip, u16 dst_port_hbo) {
 	
 	sockaddr_in dst_addr = {0};
@@ -99,6 +110,40 @@ u32 UdpSocket::ReceiveImpl(SocketHandle socket, void* data, u32 size, IpAddress&
 	return u32(received);
 }
 
+// no mmsg syscalls on windows, batches are emulated one datagram at a time
+u32 UdpSocket::SendBatchImpl(SocketHandle socket, ConstSpan<UdpOutDatagram> datagrams) {
+	u32 sent = 0;
+	for (const UdpOutDatagram &datagram : datagrams) {
+		if(SendImpl(socket, datagram.Data.Pointer(), (u32)datagram.Data.Size(), datagram.Address, datagram.Port) != datagram.Data.Size())
+			break;
+		sent++;
+	}
+	return sent;
+}
+
+u32 UdpSocket::ReceiveBatchImpl(SocketHandle socket, Span<UdpInDatagram> datagrams) {
+	u32 received = 0;
+	for (UdpInDatagram &datagram : datagrams) {
+		// only the first receive can block
+		if (received) {
+			u_long available = 0;
+			if(ioctlsocket((SOCKET)socket, FIONREAD, &available) != 0 || !available)
+				break;
+		}
+
+		datagram.Size = ReceiveImpl(socket, datagram.Buffer.Pointer(), (u32)datagram.Buffer.Size(), datagram.Address, datagram.Port);
+		datagram.SegmentSize = datagram.Size;
+		if(!datagram.Size)
+			break;
+		received++;
+	}
+	return received;
+}
+
+bool UdpSocket::SetReceiveOffloadImpl(SocketHandle, bool is_enabled) {
+	return !is_enabled;
+}
+
 bool TcpSocket::ConnectImpl(SocketHandle socket, IpAddress address, u16 port_hbo) {
 	sockaddr_in addr = {0};
 	addr.sin_family = AF_INET;
@@ -156,6 +201,55 @@ u32 TcpSocket::ReceiveImpl(SocketHandle socket, void* data, u32 size, bool& is_d
 	return actual_received;
 }
 
+u32 TcpSocket::SendVectoredImpl(SocketHandle socket, ConstSpan<ConstSpan<u8>> buffers, bool& is_disconnected) {
+	static constexpr size_t MaxBuffers = 64;
+
+	is_disconnected = false;
+
+	u32 actual_sent = 0;
+
+	for(size_t buffer = 0; buffer < buffers.Size();){
+		WSABUF wsa_buffers[MaxBuffers];
+		DWORD wsa_buffers_count = 0;
+		u32 batch_size = 0;
+
+		for(; buffer < buffers.Size() && wsa_buffers_count < MaxBuffers; buffer++){
+			wsa_buffers[wsa_buffers_count].buf = (char*)buffers[buffer].Pointer();
+			wsa_buffers[wsa_buffers_count].len = (ULONG)buffers[buffer].Size();
+			wsa_buffers_count++;
+			batch_size += (u32)buffers[buffer].Size();
+		}
+
+		DWORD sent = 0;
+		// blocking WSASend sends everything, non-blocking one fails with WSAEWOULDBLOCK when buffer is full
+		if(WSASend((SOCKET)socket, wsa_buffers, wsa_buffers_count, &sent, 0, nullptr, nullptr) == SOCKET_ERROR){
+			is_disconnected = WSAGetLastError() != WSAEWOULDBLOCK;
+			break;
+		}
+
+		actual_sent += sent;
+
+		if(sent < batch_size)
+			break;
+	}
+
+	return actual_sent;
+}
+
+u32 TcpSocket::ReceiveSomeImpl(SocketHandle socket, void* data, u32 size, bool& is_disconnected) {
+	is_disconnected = false;
+
+	int received = recv((SOCKET)socket, (char*)data, size, 0);
+
+	if(received == SOCKET_ERROR){
+		is_disconnected = WSAGetLastError() != WSAEWOULDBLOCK;
+		return 0;
+	}
+
+	is_disconnected = received == 0 && size;
+	return u32(received);
+}
+
 bool TcpListener::ListenImpl(SocketHandle socket) {
 	return listen((SOCKET)socket, 20) == 0;
 }
@@ -0,0 +1,114 @@
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include "core/list.hpp"
+#include "core/os/async_file_io.hpp"
+#include "test.hpp"
+
+// Reads of a file with known content through io_uring and the thread pool fallback. Callbacks
+// see their request complete and chain the next read by submitting the same request again
+
+static const char *s_Filename = "sx_async_file_io_test.bin";
+
+static constexpr u64 FileSize = 1024 * 1024;
+static constexpr u64 BlockSize = 16 * 1024;
+
+static u8 ByteAt(u64 offset){
+    return u8(offset * 2654435761u >> 13);
+}
+
+static bool IsContent(const u8 *data, u64 offset, u64 size){
+    for(u64 i = 0; i<size; i++){
+        if(data[i] != ByteAt(offset + i))
+            return false;
+    }
+    return true;
+}
+
+// reads the file block by block, every completion submits the next block from its callback
+struct ChainedReader{
+    AsyncFileIO &IO;
+    const File &Source;
+    u8 Buffer[BlockSize];
+    u64 Offset = 0;
+    std::atomic<u32> Blocks{0};
+    std::atomic<bool> IsValid{true};
+    std::atomic<bool> IsDone{false};
+
+    ChainedReader(AsyncFileIO &io, const File &source):
+        IO(io),
+        Source(source)
+    {}
+
+    void OnRead(AsyncFileRequest &request){
+        const bool is_block = request.IsComplete() && request.Transferred() == s64(BlockSize) && IsContent(Buffer, Offset, BlockSize);
+        if(!is_block)
+            IsValid = false;
+        Blocks++;
+
+        Offset += BlockSize;
+        if(is_block && Offset < FileSize && IO.Read(request, Source, Offset, {Buffer, BlockSize}, {this, &ChainedReader::OnRead})){
+            IO.Flush();
+            return;
+        }
+        IsDone = true;
+    }
+};
+
+static void Reads(bool force_fallback){
+    File file(s_Filename, File::Mode::Read, false);
+    SX_TEST_CHECK(file.IsOpen());
+
+    constexpr size_t Count = 64;
+    AsyncFileRequest requests[Count];
+    AsyncFileRequest chained_request, tail_request;
+    List<u8> buffers;
+    buffers.Resize(Count * BlockSize);
+    u8 tail[BlockSize];
+
+    // requests outlive io, so callbacks are done before they are destroyed
+    AsyncFileIO io(AsyncFileIO::DefaultQueueDepth, force_fallback);
+
+    // unaligned offsets, every request is waited on
+    for(size_t i = 0; i<Count; i++){
+        const u64 offset = (i * 7919 * 4099) % (FileSize - BlockSize);
+        SX_TEST_CHECK(io.Read(requests[i], file, offset, {buffers.Data() + i * BlockSize, BlockSize}));
+    }
+    bool is_valid = true;
+    for(size_t i = 0; i<Count; i++){
+        const u64 offset = (i * 7919 * 4099) % (FileSize - BlockSize);
+        is_valid = is_valid && requests[i].Wait() == s64(BlockSize) && IsContent(buffers.Data() + i * BlockSize, offset, BlockSize);
+    }
+    SX_TEST_CHECK(is_valid);
+
+    // short read at the end of file
+    SX_TEST_CHECK(io.Read(tail_request, file, FileSize - 100, {tail, BlockSize}));
+    SX_TEST_CHECK(tail_request.Wait() == 100 && IsContent(tail, FileSize - 100, 100));
+
+    ChainedReader reader(io, file);
+    SX_TEST_CHECK(io.Read(chained_request, file, 0, {reader.Buffer, BlockSize}, {&reader, &ChainedReader::OnRead}));
+    io.Flush();
+    // the request is submitted again by the callback, only the reader knows when the chain ends
+    while(!reader.IsDone)
+        std::this_thread::yield();
+    SX_TEST_CHECK(reader.IsValid);
+    SX_TEST_CHECK(reader.Blocks == FileSize / BlockSize);
+}
+
+int main(){
+    {
+        List<u8> content;
+        content.Resize(FileSize);
+        for(u64 i = 0; i<FileSize; i++)
+            content[i] = ByteAt(i);
+
+        File file(s_Filename, File::Mode::Write);
+        SX_TEST_CHECK(file.IsOpen() && file.Write(content.Data(), content.Size()) == content.Size());
+    }
+
+    Reads(false);
+    Reads(true);
+
+    File::Delete(s_Filename);
+    return Test::Result();
+}
@@ -0,0 +1,160 @@
+#include <cstring>
+#include "core/list.hpp"
+#include "core/math/batch_transform.hpp"
+#include "core/os/thread_pool.hpp"
+#include "test.hpp"
+
+// Batch kernels against the single element operator*, sizes go across the four element SIMD groups
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector4f RandomVector(){
+    return {Random(), Random(), Random(), Random()};
+}
+
+static Matrix4f RandomMatrix(){
+    return {RandomVector(), RandomVector(), RandomVector(), RandomVector()};
+}
+
+template<typename Type>
+static bool IsBitExact(const Type &left, const Type &right){
+    return memcmp(&left, &right, sizeof(Type)) == 0;
+}
+
+static const size_t s_Sizes[] = {0, 1, 3, 4, 5, 7, 8, 9, 17, 1001};
+
+static void Points(){
+    const Matrix4f matrix = RandomMatrix();
+
+    for(size_t size: s_Sizes){
+        List<Vector3f> points, result;
+        for(size_t i = 0; i<size; i++)
+            points.Add(RandomVector().XYZ());
+        result.Resize(size);
+
+        Math::TransformPoints(matrix, {points.Data(), size}, {result.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitExact(result[i], (matrix * Vector4f(points[i], 1.f)).XYZ()));
+
+        // in place
+        Math::TransformPoints(matrix, {points.Data(), size}, {points.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitExact(points[i], result[i]));
+    }
+}
+
+// w is zero, so the only difference from operator* may be the sign of zero
+static void Directions(){
+    const Matrix4f matrix = RandomMatrix();
+
+    for(size_t size: s_Sizes){
+        List<Vector3f> directions, result;
+        for(size_t i = 0; i<size; i++)
+            directions.Add(RandomVector().XYZ());
+        result.Resize(size);
+
+        Math::TransformDirections(matrix, {directions.Data(), size}, {result.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(result[i] == (matrix * Vector4f(directions[i], 0.f)).XYZ());
+    }
+}
+
+static void Vectors(){
+    const Matrix4f matrix = RandomMatrix();
+
+    for(size_t size: s_Sizes){
+        List<Vector4f> vectors, result;
+        for(size_t i = 0; i<size; i++)
+            vectors.Add(RandomVector());
+        result.Resize(size);
+
+        Math::TransformVectors(matrix, {vectors.Data(), size}, {result.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitExact(result[i], matrix * vectors[i]));
+
+        Math::TransformVectors(matrix, {vectors.Data(), size}, {vectors.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitExact(vectors[i], result[i]));
+    }
+}
+
+static void Matrices(){
+    for(size_t size: s_Sizes){
+        List<Matrix4f> left, right, result;
+        for(size_t i = 0; i<size; i++){
+            left.Add(RandomMatrix());
+            right.Add(RandomMatrix());
+        }
+        result.Resize(size);
+
+        Math::MultiplyMatrices({left.Data(), size}, {right.Data(), size}, {result.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitExact(result[i], left[i] * right[i]));
+
+        // result aliasing the left side
+        Math::MultiplyMatrices({left.Data(), size}, {right.Data(), size}, {left.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitExact(left[i], result[i]));
+    }
+}
+
+// several grains with a tail, split between the workers it has to match the serial result
+static void Parallel(){
+    constexpr size_t Count = Math::ParallelGrain * 5 + 3;
+
+    ThreadPool pool(4);
+    const Matrix4f matrix = RandomMatrix();
+
+    List<Vector3f> points, serial, parallel;
+    List<Vector4f> vectors, serial_vectors, parallel_vectors;
+    for(size_t i = 0; i<Count; i++){
+        points.Add(RandomVector().XYZ());
+        vectors.Add(RandomVector());
+    }
+    serial.Resize(Count);
+    parallel.Resize(Count);
+    serial_vectors.Resize(Count);
+    parallel_vectors.Resize(Count);
+
+    Math::TransformPoints(matrix, {points.Data(), Count}, {serial.Data(), Count});
+    Math::TransformPoints(matrix, {points.Data(), Count}, {parallel.Data(), Count}, pool);
+    SX_TEST_CHECK(memcmp(serial.Data(), parallel.Data(), Count * sizeof(Vector3f)) == 0);
+
+    Math::TransformDirections(matrix, {points.Data(), Count}, {serial.Data(), Count});
+    Math::TransformDirections(matrix, {points.Data(), Count}, {parallel.Data(), Count}, pool);
+    SX_TEST_CHECK(memcmp(serial.Data(), parallel.Data(), Count * sizeof(Vector3f)) == 0);
+
+    Math::TransformVectors(matrix, {vectors.Data(), Count}, {serial_vectors.Data(), Count});
+    Math::TransformVectors(matrix, {vectors.Data(), Count}, {parallel_vectors.Data(), Count}, pool);
+    SX_TEST_CHECK(memcmp(serial_vectors.Data(), parallel_vectors.Data(), Count * sizeof(Vector4f)) == 0);
+
+    constexpr size_t MatricesCount = Math::ParallelGrain + 5;
+    List<Matrix4f> left, right, serial_matrices, parallel_matrices;
+    for(size_t i = 0; i<MatricesCount; i++){
+        left.Add(RandomMatrix());
+        right.Add(RandomMatrix());
+    }
+    serial_matrices.Resize(MatricesCount);
+    parallel_matrices.Resize(MatricesCount);
+
+    Math::MultiplyMatrices({left.Data(), MatricesCount}, {right.Data(), MatricesCount}, {serial_matrices.Data(), MatricesCount});
+    Math::MultiplyMatrices({left.Data(), MatricesCount}, {right.Data(), MatricesCount}, {parallel_matrices.Data(), MatricesCount}, pool);
+    SX_TEST_CHECK(memcmp(serial_matrices.Data(), parallel_matrices.Data(), MatricesCount * sizeof(Matrix4f)) == 0);
+}
+
+int main(){
+    Points();
+    Directions();
+    Vectors();
+    Matrices();
+    Parallel();
+
+    return Test::Result();
+}
@@ -0,0 +1,156 @@
+#include "core/serialization/binary_serialization.hpp"
+#include "test.hpp"
+
+enum class Shape: u8{
+    Box,
+    Sphere
+};
+
+struct Body{
+    u32 Id = 0;
+    s64 Delta = 0;
+    float Mass = 0;
+    Shape Type = Shape::Box;
+    String Name;
+    List<u16> Indices;
+
+    SX_BINARY_SERIALIZABLE(Id, Delta, Mass, Type, Name, Indices)
+};
+
+static void FixedWidth(){
+    List<u8> buffer;
+    BinaryWriter writer(buffer);
+
+    SX_TEST_CHECK(writer.Write(u8(0xAB)));
+    SX_TEST_CHECK(writer.Write(u16(0x1234)));
+    SX_TEST_CHECK(writer.Write(s32(-2)));
+    SX_TEST_CHECK(writer.Write(u64(0x0102030405060708)));
+    SX_TEST_CHECK(writer.Write(-1.5f));
+    SX_TEST_CHECK(writer.Write(true));
+
+    // network byte order
+    SX_TEST_CHECK(buffer.Size() == 1 + 2 + 4 + 8 + 4 + 1);
+    SX_TEST_CHECK(buffer[1] == 0x12 && buffer[2] == 0x34);
+    SX_TEST_CHECK(buffer[7] == 0x01 && buffer[14] == 0x08);
+
+    BinaryReader reader({buffer.Data(), buffer.Size()});
+    u8 a = 0; u16 b = 0; s32 c = 0; u64 d = 0; float e = 0; bool f = false;
+    SX_TEST_CHECK(reader.Read(a) && a == 0xAB);
+    SX_TEST_CHECK(reader.Read(b) && b == 0x1234);
+    SX_TEST_CHECK(reader.Read(c) && c == -2);
+    SX_TEST_CHECK(reader.Read(d) && d == 0x0102030405060708);
+    SX_TEST_CHECK(reader.Read(e) && e == -1.5f);
+    SX_TEST_CHECK(reader.Read(f) && f);
+    SX_TEST_CHECK(reader.IsEnd());
+    SX_TEST_CHECK(reader.Read(a) == Result::Overflow);
+}
+
+static void Varints(){
+    const u64 unsigned_values[] = {0, 1, 127, 128, 16383, 16384, 0xFFFFFFFF, ~0ull};
+    const s64 signed_values[] = {0, -1, 1, -64, 64, -0x7FFFFFFFFFFFFFFF - 1, 0x7FFFFFFFFFFFFFFF};
+
+    List<u8> buffer;
+    BinaryWriter writer(buffer);
+    for(u64 value: unsigned_values)
+        SX_TEST_CHECK(writer.WriteVarint(value));
+    for(s64 value: signed_values)
+        SX_TEST_CHECK(writer.WriteVarint(value));
+
+    BinaryReader reader({buffer.Data(), buffer.Size()});
+    for(u64 value: unsigned_values){
+        u64 read = 0;
+        SX_TEST_CHECK(reader.ReadVarint(read) && read == value);
+    }
+    for(s64 value: signed_values){
+        s64 read = 0;
+        SX_TEST_CHECK(reader.ReadVarint(read) && read == value);
+    }
+    SX_TEST_CHECK(reader.IsEnd());
+
+    // one byte per 7 bits, zigzag keeps small negative values short
+    List<u8> small;
+    BinaryWriter small_writer(small);
+    small_writer.WriteVarint(s64(-64));
+    small_writer.WriteVarint(u64(16384));
+    SX_TEST_CHECK(small.Size() == 1 + 3);
+
+    // continuation bit on the last byte
+    const u8 truncated[] = {0x80, 0x80};
+    BinaryReader truncated_reader({truncated, sizeof(truncated)});
+    u64 value = 0;
+    SX_TEST_CHECK(!truncated_reader.ReadVarint(value));
+    SX_TEST_CHECK(truncated_reader.Offset() == 0);
+}
+
+static void Arrays(){
+    u32 values[37];
+    for(u32 i = 0; i<37; i++)
+        values[i] = i * 0x01010101u;
+
+    List<u8> buffer;
+    BinaryWriter writer(buffer);
+    SX_TEST_CHECK(writer.WriteArray(ConstSpan<u32>(values, 37)));
+    SX_TEST_CHECK(buffer.Size() == sizeof(values));
+    SX_TEST_CHECK(buffer[4] == 0x01 && buffer[7] == 0x01 && buffer[8] == 0x02);
+
+    u32 read[37] = {};
+    BinaryReader reader({buffer.Data(), buffer.Size()});
+    SX_TEST_CHECK(reader.ReadArray(Span<u32>(read, 37)));
+    for(u32 i = 0; i<37; i++)
+        SX_TEST_CHECK(read[i] == values[i]);
+
+    BinaryReader short_reader({buffer.Data(), buffer.Size() - 1});
+    SX_TEST_CHECK(short_reader.ReadArray(Span<u32>(read, 37)) == Result::Overflow);
+    SX_TEST_CHECK(short_reader.Offset() == 0);
+}
+
+static void Structs(){
+    Body body;
+    body.Id = 42;
+    body.Delta = -123456789;
+    body.Mass = 2.5f;
+    body.Type = Shape::Sphere;
+    body.Name = String("crate");
+    for(u16 i = 0; i<10; i++)
+        body.Indices.Add(i * 1000);
+
+    List<u8> buffer;
+    BinaryWriter writer(buffer);
+    SX_TEST_CHECK(BinarySerialize(writer, body));
+
+    Body read;
+    BinaryReader reader({buffer.Data(), buffer.Size()});
+    SX_TEST_CHECK(BinaryDeserialize(reader, read));
+    SX_TEST_CHECK(reader.IsEnd());
+    SX_TEST_CHECK(read.Id == 42 && read.Delta == -123456789 && read.Mass == 2.5f && read.Type == Shape::Sphere);
+    SX_TEST_CHECK(read.Name == body.Name);
+    SX_TEST_CHECK(read.Indices.Size() == 10 && read.Indices[9] == 9000);
+
+    // every prefix of the encoding is a truncated struct
+    for(size_t size = 0; size<buffer.Size(); size++){
+        Body truncated;
+        BinaryReader truncated_reader({buffer.Data(), size});
+        SX_TEST_CHECK(!BinaryDeserialize(truncated_reader, truncated));
+    }
+}
+
+static void FixedMemory(){
+    u8 memory[6];
+    BinaryWriter writer(Span<u8>(memory, sizeof(memory)));
+
+    SX_TEST_CHECK(writer.Write(u32(1)));
+    SX_TEST_CHECK(writer.Write(u32(2)) == Result::Overflow);
+    SX_TEST_CHECK(writer.Size() == 4);
+    SX_TEST_CHECK(writer.Write(u16(3)));
+    SX_TEST_CHECK(writer.Size() == sizeof(memory));
+}
+
+int main(){
+    FixedWidth();
+    Varints();
+    Arrays();
+    Structs();
+    FixedMemory();
+
+    return Test::Result();
+}
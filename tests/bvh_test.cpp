@@ -0,0 +1,216 @@
+#include <cmath>
+#include <algorithm>
+#include "core/list.hpp"
+#include "core/math/bvh.hpp"
+#include "core/os/thread_pool.hpp"
+#include "test.hpp"
+
+// Queries against brute force over the same boxes, with the same slab arithmetic
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector3f RandomVector(){
+    return {Random(), Random(), Random()};
+}
+
+static void RandomBoxes(List<AABB3f> &boxes, size_t count){
+    boxes.Clear();
+    for(size_t i = 0; i<count; i++)
+        boxes.Add(AABB3f(RandomVector() * 100.f, {Random() + 1.5f, Random() + 1.5f, Random() + 1.5f}));
+}
+
+static Ray3f RandomRay(){
+    return Ray3f(RandomVector() * 150.f, RandomVector());
+}
+
+static bool IntersectRay(const AABB3f &box, const Ray3f &ray, float max_distance, float &entry){
+    float near = 0.f, far = max_distance;
+    for(size_t i = 0; i<3; i++){
+        const float inverse = 1.f / ray.Direction().Data[i];
+        const float t0 = (box.Min.Data[i] - ray.Origin().Data[i]) * inverse;
+        const float t1 = (box.Max.Data[i] - ray.Origin().Data[i]) * inverse;
+        near = Max(near, Min(t0, t1));
+        far = Min(far, Max(t0, t1));
+    }
+    entry = near;
+    return near <= far;
+}
+
+static RayHit BruteForceClosest(const List<AABB3f> &boxes, const Ray3f &ray, float max_distance){
+    RayHit hit = {Bvh::InvalidIndex, max_distance};
+    for(size_t i = 0; i<boxes.Size(); i++){
+        float entry;
+        if(IntersectRay(boxes[i], ray, hit.Distance, entry) && (hit.Index == Bvh::InvalidIndex || entry < hit.Distance))
+            hit = {(u32)i, entry};
+    }
+    return hit;
+}
+
+// ties between boxes at the same distance may go either way, so the distance is compared
+static bool IsSameHit(const RayHit &hit, const RayHit &expected){
+    if(expected.Index == Bvh::InvalidIndex)
+        return hit.Index == Bvh::InvalidIndex;
+    return hit.Index != Bvh::InvalidIndex && std::fabs(hit.Distance - expected.Distance) <= 1e-4f;
+}
+
+// every box is in exactly one leaf and every node contains what is below it
+static bool IsValid(const Bvh &bvh, const List<AABB3f> &boxes){
+    const ConstSpan<Bvh::Node> nodes = bvh.Nodes();
+    if(!boxes.Size())
+        return bvh.Size() == 0;
+
+    size_t leaf_elements = 0;
+    for(const Bvh::Node &node: nodes){
+        if(node.Count){
+            leaf_elements += node.Count;
+            if(node.Count > Bvh::MaxLeafSize)
+                return false;
+            continue;
+        }
+        for(u32 child = node.Index; child < node.Index + 2; child++){
+            for(size_t i = 0; i<3; i++){
+                if(nodes[child].Min.Data[i] < node.Min.Data[i] || nodes[child].Max.Data[i] > node.Max.Data[i])
+                    return false;
+            }
+        }
+    }
+    return leaf_elements == boxes.Size() && bvh.Size() == boxes.Size();
+}
+
+static void Queries(const Bvh &bvh, const List<AABB3f> &boxes){
+    constexpr float MaxDistance = 1000.f;
+
+    for(u32 i = 0; i<200; i++){
+        const Ray3f ray = RandomRay();
+        const RayHit expected = BruteForceClosest(boxes, ray, MaxDistance);
+
+        RayHit hit;
+        SX_TEST_CHECK(bvh.RayClosest(ray, MaxDistance, hit) == (expected.Index != Bvh::InvalidIndex));
+        SX_TEST_CHECK(IsSameHit(hit, expected));
+        SX_TEST_CHECK(bvh.RayAny(ray, MaxDistance) == (expected.Index != Bvh::InvalidIndex));
+        if(hit.Index != Bvh::InvalidIndex){
+            float entry;
+            SX_TEST_CHECK(IntersectRay(boxes[hit.Index], ray, MaxDistance, entry) && std::fabs(entry - hit.Distance) <= 1e-4f);
+        }
+    }
+
+    // packets with a partial last one
+    constexpr size_t RaysCount = Bvh::PacketSize * 3 + 5;
+    List<Ray3f> rays;
+    List<RayHit> hits;
+    List<u8> any_hits;
+    const Vector3f origin = RandomVector() * 150.f;
+    for(size_t i = 0; i<RaysCount; i++)
+        rays.Add(i % 2 ? RandomRay() : Ray3f(origin, -origin + RandomVector() * 50.f));
+    hits.Resize(RaysCount);
+    any_hits.Resize(RaysCount);
+
+    bvh.RayClosest({rays.Data(), RaysCount}, MaxDistance, {hits.Data(), RaysCount});
+    bvh.RayAny({rays.Data(), RaysCount}, MaxDistance, {any_hits.Data(), RaysCount});
+    for(size_t i = 0; i<RaysCount; i++){
+        const RayHit expected = BruteForceClosest(boxes, rays[i], MaxDistance);
+        SX_TEST_CHECK(IsSameHit(hits[i], expected));
+        SX_TEST_CHECK(any_hits[i] == (expected.Index != Bvh::InvalidIndex));
+    }
+
+    for(u32 i = 0; i<100; i++){
+        const AABB3f query(RandomVector() * 100.f, {Random() * 10 + 10, Random() * 10 + 10, Random() * 10 + 10});
+
+        List<u32> indices, expected;
+        indices.Add(Bvh::InvalidIndex);
+        bvh.Overlaps(query, indices);
+        for(size_t j = 0; j<boxes.Size(); j++){
+            if(boxes[j].Intersects(query))
+                expected.Add((u32)j);
+        }
+
+        // appended after what was there, in any order
+        SX_TEST_CHECK(indices.Size() == expected.Size() + 1 && indices[0] == Bvh::InvalidIndex);
+        std::sort(indices.begin() + 1, indices.end());
+        for(size_t j = 0; j<Min(expected.Size(), indices.Size() - 1); j++)
+            SX_TEST_CHECK(indices[j + 1] == expected[j]);
+    }
+}
+
+static void Build(){
+    const size_t sizes[] = {0, 1, 7, 9, 100, 5000};
+
+    for(size_t size: sizes){
+        List<AABB3f> boxes;
+        RandomBoxes(boxes, size);
+
+        const Bvh bvh({boxes.Data(), size});
+        SX_TEST_CHECK(IsValid(bvh, boxes));
+        Queries(bvh, boxes);
+    }
+}
+
+// all boxes at the same spot can't be split by SAH, depth is still bounded
+static void Degenerate(){
+    List<AABB3f> boxes;
+    for(size_t i = 0; i<1000; i++)
+        boxes.Add(AABB3f({1, 2, 3}, {1, 1, 1}));
+
+    const Bvh bvh({boxes.Data(), boxes.Size()});
+    SX_TEST_CHECK(IsValid(bvh, boxes));
+
+    RayHit hit;
+    SX_TEST_CHECK(bvh.RayClosest(Ray3f({1.5f, 2.5f, -10}, {0, 0, 1}), 100.f, hit));
+    SX_TEST_CHECK(hit.Distance == 13.f);
+
+    // starting inside
+    SX_TEST_CHECK(bvh.RayClosest(Ray3f({1.5f, 2.5f, 3.5f}, {0, 1, 0}), 100.f, hit));
+    SX_TEST_CHECK(hit.Distance == 0.f);
+
+    SX_TEST_CHECK(!bvh.RayAny(Ray3f({1.5f, 2.5f, -10}, {0, 0, -1}), 100.f));
+    SX_TEST_CHECK(!bvh.RayAny(Ray3f({1.5f, 2.5f, -10}, {0, 0, 1}), 12.f));
+}
+
+static void Refit(){
+    List<AABB3f> boxes;
+    RandomBoxes(boxes, 3000);
+    Bvh bvh({boxes.Data(), boxes.Size()});
+
+    for(AABB3f &box: boxes){
+        const Vector3f offset = RandomVector() * 20.f;
+        box.Min += offset;
+        box.Max += offset;
+    }
+    bvh.Refit({boxes.Data(), boxes.Size()});
+
+    SX_TEST_CHECK(IsValid(bvh, boxes));
+    Queries(bvh, boxes);
+}
+
+static void ParallelBuild(){
+    List<AABB3f> boxes;
+    RandomBoxes(boxes, Bvh::ParallelBuildThreshold * 2 + 17);
+
+    ThreadPool pool(4);
+    Bvh bvh;
+    bvh.Build({boxes.Data(), boxes.Size()}, pool);
+
+    SX_TEST_CHECK(IsValid(bvh, boxes));
+    Queries(bvh, boxes);
+
+    bvh.Clear();
+    SX_TEST_CHECK(bvh.Size() == 0);
+    RayHit hit;
+    SX_TEST_CHECK(!bvh.RayClosest(RandomRay(), 1000.f, hit) && hit.Index == Bvh::InvalidIndex);
+}
+
+int main(){
+    Build();
+    Degenerate();
+    Refit();
+    ParallelBuild();
+
+    return Test::Result();
+}
@@ -0,0 +1,257 @@
+#include <cmath>
+#include <cstring>
+#include "core/list.hpp"
+#include "core/math/fast_math.hpp"
+#include "test.hpp"
+
+// Errors against double precision libm, swept densely over the ranges the bounds in
+// fast_math.hpp are documented for. Float4, batch and Constexpr versions are expected
+// to match the scalar ones bit for bit
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+// distance from the reference in units of the last place of the float nearest to it
+static double Ulp(float result, double reference){
+    const float nearest = std::fabs(float(reference));
+    const double ulp = nearest >= 1.17549435e-38f ? double(std::nextafter(nearest, INFINITY)) - nearest : 1.40129846e-45;
+    return std::fabs(double(result) - reference) / ulp;
+}
+
+static bool IsBitEqual(float left, float right){
+    return std::memcmp(&left, &right, sizeof(float)) == 0;
+}
+
+// points evenly spread over the range plus random ones
+static void Sweep(float min, float max, List<float> &x){
+    constexpr size_t Count = 200000;
+    x.Clear();
+    for(size_t i = 0; i<=Count; i++)
+        x.Add(min + (max - min) * float(i) / Count);
+    for(size_t i = 0; i<Count; i++)
+        x.Add(min + (max - min) * (Random() + 1.f) * 0.5f);
+}
+
+static void SinCos(){
+    List<float> x;
+    Sweep(-8192.f, 8192.f, x);
+    Sweep(-10.f, 10.f, x);
+
+    double sin_ulp = 0.0, cos_ulp = 0.0, absolute = 0.0;
+    for(float value: x){
+        float sin, cos;
+        Math::Fast::SinCos(value, sin, cos);
+        const double sin_reference = std::sin(double(value)), cos_reference = std::cos(double(value));
+
+        absolute = Max(absolute, Max(std::fabs(sin - sin_reference), std::fabs(cos - cos_reference)));
+        if(std::fabs(sin_reference) > 0.01)
+            sin_ulp = Max(sin_ulp, Ulp(sin, sin_reference));
+        if(std::fabs(cos_reference) > 0.01)
+            cos_ulp = Max(cos_ulp, Ulp(cos, cos_reference));
+
+        SX_TEST_CHECK(IsBitEqual(sin, Math::Fast::Sin(value)) && IsBitEqual(cos, Math::Fast::Cos(value)));
+    }
+    SX_TEST_CHECK(absolute < 8e-8);
+    SX_TEST_CHECK(sin_ulp <= 2.0);
+    SX_TEST_CHECK(cos_ulp <= 2.0);
+
+    SX_TEST_CHECK(Math::Fast::Sin(0.f) == 0.f && Math::Fast::Cos(0.f) == 1.f);
+}
+
+static void Atan2(){
+    double ulp = 0.0;
+    for(u32 i = 0; i<400000; i++){
+        // magnitudes from tiny to huge, in all quadrants
+        const float y = Random() * std::exp2(Random() * 60.f), x = Random() * std::exp2(Random() * 60.f);
+        ulp = Max(ulp, Ulp(Math::Fast::Atan2(y, x), std::atan2(double(y), double(x))));
+    }
+    for(u32 i = 0; i<=3600; i++){
+        const double angle = (i / 1800.0 - 1.0) * 3.14159265358979;
+        const float y = float(std::sin(angle)), x = float(std::cos(angle));
+        ulp = Max(ulp, Ulp(Math::Fast::Atan2(y, x), std::atan2(double(y), double(x))));
+    }
+    SX_TEST_CHECK(ulp <= 3.0);
+
+    SX_TEST_CHECK(Math::Fast::Atan2(0.f, 0.f) == 0.f);
+    SX_TEST_CHECK(Math::Fast::Atan2(0.f, 1.f) == 0.f);
+    SX_TEST_CHECK(std::fabs(Math::Fast::Atan2(1.f, 0.f) - 1.57079633f) < 1e-7f);
+    SX_TEST_CHECK(std::fabs(Math::Fast::Atan2(0.f, -1.f) - 3.14159265f) < 1e-6f);
+}
+
+static void Exp(){
+    List<float> x;
+    Sweep(-103.f, 88.7f, x);
+    Sweep(-1.f, 1.f, x);
+
+    double ulp = 0.0;
+    for(float value: x){
+        const double reference = std::exp(double(value));
+        // denormal results have fewer bits, their ulp is the denormal step
+        ulp = Max(ulp, Ulp(Math::Fast::Exp(value), reference));
+    }
+    SX_TEST_CHECK(ulp <= 1.0);
+
+    SX_TEST_CHECK(Math::Fast::Exp(0.f) == 1.f);
+    SX_TEST_CHECK(Math::Fast::Exp(89.f) == INFINITY);
+    SX_TEST_CHECK(Math::Fast::Exp(-105.f) == 0.f);
+}
+
+static void Log(){
+    List<float> x;
+    Sweep(1e-3f, 10.f, x);
+    Sweep(0.5f, 2.f, x);
+    // every binade from denormals up
+    for(u32 i = 0; i<400000; i++)
+        x.Add(std::exp2(Random() * 149.f - 10.f) * (Random() + 2.f));
+
+    double ulp = 0.0;
+    for(float value: x)
+        ulp = Max(ulp, Ulp(Math::Fast::Log(value), std::log(double(value))));
+    SX_TEST_CHECK(ulp <= 1.0);
+
+    SX_TEST_CHECK(Math::Fast::Log(1.f) == 0.f);
+    SX_TEST_CHECK(Math::Fast::Log(0.f) == -INFINITY);
+    SX_TEST_CHECK(std::isnan(Math::Fast::Log(-1.f)));
+    SX_TEST_CHECK(Math::Fast::Log(INFINITY) == INFINITY);
+}
+
+static void Pow(){
+    double small_ulp = 0.0, large_ulp = 0.0;
+    for(u32 i = 0; i<400000; i++){
+        const float x = std::exp2(Random() * 20.f), y = Random() * 20.f;
+        const double reference = std::pow(double(x), double(y));
+        const double exponent = std::fabs(double(y) * std::log(double(x)));
+
+        if(exponent < 1.0)
+            small_ulp = Max(small_ulp, Ulp(Math::Fast::Pow(x, y), reference));
+        else if(exponent < 80.0)
+            large_ulp = Max(large_ulp, Ulp(Math::Fast::Pow(x, y), reference));
+    }
+    SX_TEST_CHECK(small_ulp <= 2.0);
+    SX_TEST_CHECK(large_ulp <= 128.0);
+
+    SX_TEST_CHECK(Math::Fast::Pow(5.f, 0.f) == 1.f);
+    SX_TEST_CHECK(Math::Fast::Pow(0.f, 0.f) == 1.f);
+    SX_TEST_CHECK(std::fabs(Math::Fast::Pow(2.f, 10.f) - 1024.f) <= 1024.f * 1e-6f);
+}
+
+static void Rsqrt(){
+    List<float> x;
+    Sweep(1e-3f, 1e3f, x);
+    for(u32 i = 0; i<400000; i++)
+        x.Add(std::exp2(Random() * 125.f));
+
+    double ulp = 0.0;
+    for(float value: x)
+        ulp = Max(ulp, Ulp(Math::Fast::Rsqrt(value), 1.0 / std::sqrt(double(value))));
+    SX_TEST_CHECK(ulp <= 3.0);
+}
+
+// sizes that end with a partial Float4, results written over the arguments
+static void Batch(){
+    const size_t sizes[] = {0, 1, 3, 4, 5, 1001};
+
+    for(size_t size: sizes){
+        List<float> x, y, sin, cos, result;
+        for(size_t i = 0; i<size; i++){
+            x.Add((Random() + 1.f) * 20.f + 1e-3f);
+            y.Add(Random() * 4.f);
+        }
+        sin.Resize(size);
+        cos.Resize(size);
+        result.Resize(size);
+
+        Math::Fast::SinCos({x.Data(), size}, {sin.Data(), size}, {cos.Data(), size});
+        for(size_t i = 0; i<size; i++){
+            float expected_sin, expected_cos;
+            Math::Fast::SinCos(x[i], expected_sin, expected_cos);
+            SX_TEST_CHECK(IsBitEqual(sin[i], expected_sin) && IsBitEqual(cos[i], expected_cos));
+        }
+
+        const struct{
+            void (*Batch)(ConstSpan<float>, Span<float>);
+            float (*Scalar)(float);
+        } unary[] = {
+            {Math::Fast::Sin, Math::Fast::Sin},
+            {Math::Fast::Cos, Math::Fast::Cos},
+            {Math::Fast::Exp, Math::Fast::Exp},
+            {Math::Fast::Log, Math::Fast::Log},
+            {Math::Fast::Rsqrt, Math::Fast::Rsqrt},
+        };
+        for(const auto &function: unary){
+            function.Batch({x.Data(), size}, {result.Data(), size});
+            for(size_t i = 0; i<size; i++)
+                SX_TEST_CHECK(IsBitEqual(result[i], function.Scalar(x[i])));
+        }
+
+        Math::Fast::Atan2({y.Data(), size}, {x.Data(), size}, {result.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitEqual(result[i], Math::Fast::Atan2(y[i], x[i])));
+
+        List<float> aliased = x;
+        Math::Fast::Pow({aliased.Data(), size}, {y.Data(), size}, {aliased.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsBitEqual(aliased[i], Math::Fast::Pow(x[i], y[i])));
+
+        // Float4 overloads directly, lanes are independent
+        for(size_t i = 0; i + 4 <= size; i += 4){
+            float lanes[4];
+            Math::Fast::Exp(Float4::Load(x.Data() + i)).Store(lanes);
+            for(size_t j = 0; j<4; j++)
+                SX_TEST_CHECK(IsBitEqual(lanes[j], Math::Fast::Exp(x[i + j])));
+        }
+    }
+}
+
+// a table built at compile time, compared with run time results
+struct SinTable{
+    float Values[64];
+
+    constexpr SinTable():
+        Values()
+    {
+        for(int i = 0; i<64; i++)
+            Values[i] = Math::Fast::Constexpr::Sin(i * 0.1f);
+    }
+};
+
+static_assert(Math::Fast::Constexpr::Exp(0.f) == 1.f, "Constexpr::Exp should be usable at compile time");
+static_assert(Math::Fast::Constexpr::Log(1.f) == 0.f, "Constexpr::Log should be usable at compile time");
+static_assert(Math::Fast::Constexpr::Cos(0.f) == 1.f, "Constexpr::Cos should be usable at compile time");
+
+static void Constexpr(){
+    constexpr SinTable table;
+    for(int i = 0; i<64; i++)
+        SX_TEST_CHECK(IsBitEqual(table.Values[i], Math::Fast::Sin(i * 0.1f)));
+
+    // denormals go through the exact scaling path
+    const float arguments[] = {1e-40f, 1e-30f, 0.3f, 1.f, 7.5f, 1e10f, 3e38f};
+    for(float x: arguments){
+        SX_TEST_CHECK(IsBitEqual(Math::Fast::Constexpr::Log(x), Math::Fast::Log(x)));
+        SX_TEST_CHECK(IsBitEqual(Math::Fast::Constexpr::Rsqrt(x), Math::Fast::Rsqrt(x)));
+        SX_TEST_CHECK(IsBitEqual(Math::Fast::Constexpr::Atan2(x, 2.f), Math::Fast::Atan2(x, 2.f)));
+        SX_TEST_CHECK(IsBitEqual(Math::Fast::Constexpr::Pow(x, 0.7f), Math::Fast::Pow(x, 0.7f)));
+    }
+    const float exponents[] = {-103.f, -90.f, -10.f, 0.5f, 80.f};
+    for(float x: exponents)
+        SX_TEST_CHECK(IsBitEqual(Math::Fast::Constexpr::Exp(x), Math::Fast::Exp(x)));
+}
+
+int main(){
+    SinCos();
+    Atan2();
+    Exp();
+    Log();
+    Pow();
+    Rsqrt();
+    Batch();
+    Constexpr();
+
+    return Test::Result();
+}
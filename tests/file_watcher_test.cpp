@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <sys/stat.h>
+#include "core/list.hpp"
+#include "core/format.hpp"
+#include "core/os/file.hpp"
+#include "core/os/clock.hpp"
+#include "core/os/sleep.hpp"
+#include "core/os/directory.hpp"
+#include "core/os/file_watcher.hpp"
+#include "test.hpp"
+
+// 100K writes to 100 files come out as a few batches with one event per file each, the last batch
+// arrives a debounce after the last write. Writes are done at once, and spread over longer than
+// max delay, which still has to deliver batches while writes go on. Created, deleted and renamed files within a batch collapse into what
+// the consumer needs to know
+
+static const char *s_Root = "sx_file_watcher_test";
+
+static constexpr Time Debounce = Milliseconds(50);
+static constexpr Time MaxDelay = Milliseconds(500);
+// scheduling slack for checks of delivery time
+static constexpr Time Slack = Milliseconds(250);
+
+static String PathOf(u32 index){
+    return Format("%/file_%.txt", s_Root, index);
+}
+
+static const FileChangeEvent *Find(ConstSpan<FileChangeEvent> batch, StringView path){
+    for(const FileChangeEvent &event: batch){
+        if(event.Path.View() == path)
+            return &event;
+    }
+    return nullptr;
+}
+
+// pause is taken after every thousand writes
+static void Burst(Time pause){
+    constexpr u32 FilesCount = 100;
+    constexpr u32 WritesCount = 100000;
+
+    List<File> files;
+    for(u32 i = 0; i<FilesCount; i++)
+        files.Add(File(PathOf(i), File::Mode::Write));
+
+    FileWatcher watcher(Debounce, MaxDelay);
+    SX_TEST_CHECK(watcher.IsValid());
+    SX_TEST_CHECK(watcher.Watch(s_Root));
+
+    List<u32> reports;
+    reports.Resize(FilesCount);
+    size_t batches = 0, events = 0;
+    bool is_coalesced = true, is_modified = true;
+    Time first_batch_time;
+
+    const auto consume = [&](ConstSpan<FileChangeEvent> batch){
+        if(!batch.Size())
+            return;
+        if(!batches)
+            first_batch_time = Clock::GetMonotonicTime();
+        batches++;
+        events += batch.Size();
+
+        List<u8> is_seen;
+        is_seen.Resize(FilesCount);
+        for(const FileChangeEvent &event: batch){
+            is_modified = is_modified && event.Change == FileChange::Modified;
+            for(u32 i = 0; i<FilesCount; i++){
+                if(event.Path.View() != PathOf(i).View())
+                    continue;
+                is_coalesced = is_coalesced && !is_seen[i];
+                is_seen[i] = 1;
+                reports[i]++;
+            }
+        }
+    };
+
+    // queue is drained every thousand writes, so the kernel doesn't overflow
+    const Time burst_begin = Clock::GetMonotonicTime();
+    for(u32 i = 0; i<WritesCount; i++){
+        const char byte = char('a' + i % 26);
+        files[i % FilesCount].Write(&byte, 1);
+        if(i % 1000 == 999){
+            consume(watcher.Poll());
+            if(pause > Time() && i + 1 < WritesCount)
+                Sleep(pause);
+        }
+    }
+    const Time last_write = Clock::GetMonotonicTime();
+    const Time burst_time = last_write - burst_begin;
+
+    // a batch taken right before the burst ended may still be pending, the last one waits for debounce
+    Time latency;
+    for(;;){
+        ConstSpan<FileChangeEvent> batch = watcher.Wait(Seconds(2));
+        if(!batch.Size())
+            break;
+        latency = Clock::GetMonotonicTime() - last_write;
+        consume(batch);
+    }
+
+    Println("burst of % writes in % ms: % batches, % events, last batch % ms after the last write",
+        WritesCount, burst_time.AsMilliseconds(), batches, events, latency.AsMilliseconds());
+
+    SX_TEST_CHECK(is_coalesced);
+    SX_TEST_CHECK(is_modified);
+    bool is_reported = true;
+    for(u32 count: reports)
+        is_reported = is_reported && count >= 1;
+    SX_TEST_CHECK(is_reported);
+    // one event per file per batch, and a batch per max delay at most while the burst lasts
+    SX_TEST_CHECK(events <= batches * FilesCount);
+    SX_TEST_CHECK(batches <= size_t(burst_time.AsMicroseconds() / MaxDelay.AsMicroseconds()) + 2);
+    SX_TEST_CHECK(latency >= Debounce && latency < Debounce + Slack);
+    // bursts longer than max delay get a batch before they end
+    if(burst_time > MaxDelay + Slack)
+        SX_TEST_CHECK(first_batch_time - burst_begin < MaxDelay + Slack);
+}
+
+static void Coalescing(){
+    FileWatcher watcher(Debounce, MaxDelay);
+    SX_TEST_CHECK(watcher.Watch(s_Root));
+
+    const String created = Format("%/created.txt", s_Root);
+    const String temporary = Format("%/temporary.txt", s_Root);
+    const String renamed = Format("%/renamed.txt", s_Root);
+    const String moved = Format("%/moved.txt", s_Root);
+    const String existing = PathOf(0);
+
+    // created and written is just created, created and deleted is nothing
+    File::WriteEntire(created, "content");
+    File::WriteEntire(created, "more content");
+    File::WriteEntire(temporary, "content");
+    File::Delete(temporary);
+    // chain of renames is a single rename from the first name
+    rename(existing.Data(), renamed.Data());
+    rename(renamed.Data(), moved.Data());
+
+    ConstSpan<FileChangeEvent> batch = watcher.Wait(Seconds(2));
+    SX_TEST_CHECK(batch.Size() == 2);
+
+    const FileChangeEvent *created_event = Find(batch, created);
+    SX_TEST_CHECK(created_event && created_event->Change == FileChange::Created);
+    SX_TEST_CHECK(!Find(batch, temporary));
+    const FileChangeEvent *moved_event = Find(batch, moved);
+    SX_TEST_CHECK(moved_event && moved_event->Change == FileChange::Renamed && moved_event->OldPath.View() == existing.View());
+
+    // deleted after a rename is the original file deleted
+    File::Delete(moved);
+    batch = watcher.Wait(Seconds(2));
+    SX_TEST_CHECK(batch.Size() == 1 && batch[0].Change == FileChange::Deleted && batch[0].Path.View() == moved.View());
+}
+
+int main(){
+    Directory::Delete(s_Root);
+    mkdir(s_Root, 0755);
+
+    Burst(Time());
+    Burst(Milliseconds(15));
+    Coalescing();
+
+    Directory::Delete(s_Root);
+    return Test::Result();
+}
@@ -0,0 +1,243 @@
+#include <cmath>
+#include "core/format.hpp"
+#include "core/algorithm.hpp"
+#include "core/math/fixed.hpp"
+#include "core/math/vector3.hpp"
+#include "core/math/linear.hpp"
+#include "core/math/matrix4.hpp"
+#include "core/math/transform.hpp"
+#include "test.hpp"
+
+// Accuracy against double, plus checksums of long runs of operations on integer generated
+// inputs. Checksums are fixed constants, every compiler and platform, with or without
+// a native 128 bit integer, is expected to reproduce them bit for bit
+
+static u64 s_RandomState = 0x2545F4914F6CDD1Dull;
+
+static u64 RandomBits(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 7;
+    s_RandomState ^= s_RandomState << 17;
+    return s_RandomState;
+}
+
+// raw value with a random magnitude, so small and large numbers are equally likely
+template<typename FixedType>
+static FixedType RandomFixed(){
+    using RawType = typename FixedType::RawType;
+    const u64 bits = RandomBits();
+    const int shift = int(bits % (sizeof(RawType) * 8));
+    return FixedType::FromRaw(RawType(typename FixedType::UnsignedType(bits >> 8) >> shift));
+}
+
+template<typename FixedType>
+static double Lsb(){
+    return FixedType::Epsilon().ToDouble();
+}
+
+struct Checksum{
+    u64 Hash = 0xCBF29CE484222325ull;
+
+    template<int IntBits, int FracBits>
+    void Add(Fixed<IntBits, FracBits> value){
+        const u64 raw = u64(value.Raw());
+        for(int i = 0; i<64; i += 8)
+            Hash = (Hash ^ ((raw >> i) & 0xFF)) * 0x100000001B3ull;
+    }
+};
+
+template<typename FixedType>
+static void Arithmetic(){
+    const double lsb = Lsb<FixedType>();
+    const double limit = std::sqrt(FixedType::Max().ToDouble());
+
+    for(u32 i = 0; i<100000; i++){
+        const FixedType a = RandomFixed<FixedType>(), b = RandomFixed<FixedType>();
+        if(std::fabs(a.ToDouble()) > limit || std::fabs(b.ToDouble()) > limit || !b)
+            continue;
+
+        // long double keeps the whole product of 64 bit raw values on x86, elsewhere the tolerance covers it
+        const long double product = (long double)a.ToDouble() * b.ToDouble();
+        SX_TEST_CHECK(std::fabs((long double)(a * b).ToDouble() - product) <= lsb * 0.5 + std::fabs(product) * 1e-15);
+
+        const long double quotient = (long double)a.ToDouble() / b.ToDouble();
+        if(std::fabs(quotient) < limit){
+            const double result = (a / b).ToDouble();
+            SX_TEST_CHECK(std::fabs(result) <= std::fabs(quotient) + std::fabs(quotient) * 1e-15);
+            SX_TEST_CHECK(std::fabs(result - quotient) < lsb + std::fabs(quotient) * 1e-15);
+        }
+
+        SX_TEST_CHECK((a + b).ToDouble() == a.ToDouble() + b.ToDouble());
+    }
+
+    // wrapping operators against saturating functions
+    const FixedType max = FixedType::Max(), min = FixedType::Min(), epsilon = FixedType::Epsilon();
+    SX_TEST_CHECK(max + epsilon == min);
+    SX_TEST_CHECK(min - epsilon == max);
+    SX_TEST_CHECK(Math::SaturatingAdd(max, epsilon) == max);
+    SX_TEST_CHECK(Math::SaturatingSub(min, epsilon) == min);
+    SX_TEST_CHECK(Math::SaturatingAdd(max, -epsilon) == max - epsilon);
+    SX_TEST_CHECK(Math::SaturatingMul(max, FixedType(2)) == max);
+    SX_TEST_CHECK(Math::SaturatingMul(max, FixedType(-2)) == min);
+    SX_TEST_CHECK(Math::SaturatingMul(FixedType(3), FixedType(-2)) == FixedType(-6));
+    SX_TEST_CHECK(Math::SaturatingDiv(max, FixedType(1) / FixedType(4)) == max);
+    SX_TEST_CHECK(Math::SaturatingDiv(FixedType(-1), FixedType(0)) == min);
+    SX_TEST_CHECK(Math::SaturatingDiv(FixedType(0), FixedType(0)) == FixedType(0));
+    SX_TEST_CHECK(Math::SaturatingDiv(FixedType(7), FixedType(2)) == FixedType(7) / FixedType(2));
+
+    SX_TEST_CHECK(FixedType(-1.5).ToInt() == -2 && FixedType(1.5).ToInt() == 1);
+    SX_TEST_CHECK(FixedType(0.75f) * FixedType(4) == FixedType(3));
+    SX_TEST_CHECK(Math::Abs(FixedType(-2)) == FixedType(2));
+
+    // the ends of the range convert back, Max() of 64 bit types rounds up to a double that doesn't fit
+    SX_TEST_CHECK(FixedType(FixedType::Min().ToDouble()) == FixedType::Min());
+    SX_TEST_CHECK(FixedType(FixedType::Max().ToDouble()) == FixedType::Max());
+}
+
+// the portable 128 bit helpers against the native type, they are what MSVC builds run
+static void WideIntegers(){
+#ifdef SX_FIXED_INT128
+    for(u32 i = 0; i<200000; i++){
+        const u64 left = RandomBits() >> (RandomBits() % 64), right = RandomBits() >> (RandomBits() % 64);
+        const unsigned __int128 expected = (unsigned __int128)left * right;
+
+        const Details::FixedUInt128 product = Details::FixedMultiplyWide(left, right);
+        SX_TEST_CHECK(product.High == u64(expected >> 64) && product.Low == u64(expected));
+
+        if(right && product.High < right)
+            SX_TEST_CHECK(Details::FixedDivideWide(product, right) == left);
+        if(right && (expected >> 64) < right){
+            const Details::FixedUInt128 dividend = {u64(expected >> 64), u64(expected) + (RandomBits() % right)};
+            if(dividend.Low >= u64(expected))
+                SX_TEST_CHECK(Details::FixedDivideWide(dividend, right) == left);
+        }
+    }
+#endif
+}
+
+template<typename FixedType>
+static void Functions(){
+    const double lsb = Lsb<FixedType>();
+    const double limit = Min(FixedType::Max().ToDouble(), 1e6);
+
+    double sin_error = 0.0, atan_error = 0.0;
+    for(u32 i = 0; i<100000; i++){
+        const FixedType a = RandomFixed<FixedType>(), b = RandomFixed<FixedType>();
+        const double x = a.ToDouble(), y = b.ToDouble();
+
+        if(std::fabs(x) < limit){
+            sin_error = Max(sin_error, std::fabs(Math::Sin(a).ToDouble() - std::sin(x)));
+            sin_error = Max(sin_error, std::fabs(Math::Cos(a).ToDouble() - std::cos(x)));
+        }
+        atan_error = Max(atan_error, std::fabs(Math::Atan2(b, a).ToDouble() - std::atan2(y, x)));
+
+        // exact square root in raw units, rounded to nearest
+        const FixedType positive = Math::Abs(a) == FixedType::Min() ? FixedType::Max() : Math::Abs(a);
+        const long double root = std::sqrt((long double)positive.ToDouble()) / lsb;
+        SX_TEST_CHECK(std::fabs((long double)Math::Sqrt(positive).Raw() - root) <= 0.5L + root * 1e-15L);
+    }
+    SX_TEST_CHECK(sin_error <= 3e-7 + lsb);
+    SX_TEST_CHECK(atan_error <= 1e-7 + lsb);
+
+    SX_TEST_CHECK(Math::Sin(FixedType(0)) == FixedType(0) && Math::Cos(FixedType(0)) == FixedType(1));
+    SX_TEST_CHECK(Math::Atan2(FixedType(0), FixedType(0)) == FixedType(0));
+    SX_TEST_CHECK(Math::Sqrt(FixedType(4)) == FixedType(2) && Math::Sqrt(FixedType(0)) == FixedType(0));
+    SX_TEST_CHECK(std::fabs(Math::Asin(FixedType(1) / FixedType(2)).ToDouble() - 0.5235987756) <= 2e-7 + 2 * lsb);
+    SX_TEST_CHECK(std::fabs(Math::Acos(FixedType(0)).ToDouble() - 1.5707963268) <= 2e-7 + 2 * lsb);
+    SX_TEST_CHECK(std::fabs(Math::Tan(FixedType(1)).ToDouble() - 1.5574077247) <= 1e-6 + 4 * lsb);
+}
+
+static void Templates(){
+    const Vector3<Fixed32> a(Fixed32(3), Fixed32(4), Fixed32(0)), b(Fixed32(1), Fixed32(-2), Fixed32(5));
+    SX_TEST_CHECK(Dot(a, b) == Fixed32(-5));
+    SX_TEST_CHECK(a.Length() == Fixed32(5));
+    // quotients round toward zero
+    const Vector3<Fixed32> normalized = Normalize(a);
+    SX_TEST_CHECK(normalized.x == Fixed32(3) / Fixed32(5) && normalized.y == Fixed32(4) / Fixed32(5) && normalized.z == Fixed32(0));
+    SX_TEST_CHECK(std::fabs(normalized.x.ToDouble() - 0.6) < Lsb<Fixed32>());
+
+    const Matrix4<Fixed64> transform = Math::Translate(Vector3<Fixed64>(Fixed64(1), Fixed64(-2), Fixed64(3)))
+                                     * Math::Rotate<Fixed64>(Vector3<Fixed64>(Fixed64(0.3), Fixed64(-1.2), Fixed64(2)));
+    const Matrix4<Fixed64> identity = transform * transform.GetInverse();
+    for(size_t i = 0; i<4; i++){
+        for(size_t j = 0; j<4; j++)
+            SX_TEST_CHECK(std::fabs(identity[i][j].ToDouble() - (i == j)) < 1e-6);
+    }
+
+    SX_TEST_CHECK(StringView(Format("%", Fixed32(-2.5))) == StringView(Format("%", -2.5)));
+}
+
+// Mixed operations over the whole raw range and a physics run, the kind of code a lockstep
+// simulation runs. Results are reduced to one hash
+template<typename FixedType>
+static u64 Run(){
+    Checksum checksum;
+
+    for(u32 i = 0; i<20000; i++){
+        const FixedType a = RandomFixed<FixedType>(), b = RandomFixed<FixedType>();
+
+        checksum.Add(a + b);
+        checksum.Add(a - b);
+        checksum.Add(a * b);
+        if(b)
+            checksum.Add(a / b);
+        checksum.Add(Math::SaturatingAdd(a, b));
+        checksum.Add(Math::SaturatingMul(a, b));
+        checksum.Add(Math::SaturatingDiv(a, b));
+        checksum.Add(Math::Sin(a));
+        checksum.Add(Math::Cos(b));
+        checksum.Add(Math::Atan2(a, b));
+        checksum.Add(Math::Sqrt(Math::Abs(a) == FixedType::Min() ? FixedType(0) : Math::Abs(a)));
+    }
+
+    // bodies falling on the ground with damping, 1 / 64 s steps
+    const FixedType step = FixedType(1) / FixedType(64), damping = FixedType(0.995), bounce = FixedType(-0.8);
+    const Vector3<FixedType> gravity(FixedType(0), FixedType(-10), FixedType(0));
+    Vector3<FixedType> positions[64], velocities[64];
+    for(int i = 0; i<64; i++){
+        positions[i] = Vector3<FixedType>(FixedType(i % 8), FixedType(10 + i % 5), FixedType(i / 8));
+        velocities[i] = Vector3<FixedType>(Math::Sin(FixedType(i)), FixedType(0), Math::Cos(FixedType(i)));
+    }
+    for(int frame = 0; frame<1000; frame++){
+        for(int i = 0; i<64; i++){
+            velocities[i] = (velocities[i] + gravity * step) * damping;
+            positions[i] = positions[i] + velocities[i] * step;
+            if(positions[i].y < FixedType(0)){
+                positions[i].y = -positions[i].y;
+                velocities[i].y = velocities[i].y * bounce;
+            }
+        }
+    }
+    for(int i = 0; i<64; i++){
+        checksum.Add(positions[i].x);
+        checksum.Add(positions[i].y);
+        checksum.Add(positions[i].z);
+        checksum.Add(Math::Atan2(velocities[i].z, velocities[i].x));
+    }
+    return checksum.Hash;
+}
+
+// expected values are the same with the native and the portable 128 bit paths, at any optimization level
+static void Determinism(){
+    s_RandomState = 0x9E3779B97F4A7C15ull;
+    const u64 fixed32 = Run<Fixed32>();
+    const u64 fixed64 = Run<Fixed64>();
+    const u64 fixed_q8_24 = Run<Fixed<8, 24>>();
+
+    SX_TEST_CHECK(fixed32 == 9500547876111805800ull);
+    SX_TEST_CHECK(fixed64 == 10630828778287393672ull);
+    SX_TEST_CHECK(fixed_q8_24 == 16198985398358502752ull);
+}
+
+int main(){
+    Arithmetic<Fixed32>();
+    Arithmetic<Fixed64>();
+    WideIntegers();
+    Functions<Fixed32>();
+    Functions<Fixed64>();
+    Functions<Fixed<8, 24>>();
+    Templates();
+    Determinism();
+
+    return Test::Result();
+}
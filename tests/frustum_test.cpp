@@ -0,0 +1,144 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/frustum.hpp"
+#include "test.hpp"
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+// right handed, looking down -z, depth is mapped to [0, 1]
+static Matrix4f Perspective(float fov, float aspect, float near, float far){
+    const float f = 1.f / std::tan(fov / 2);
+    return {
+        {f / aspect, 0, 0, 0},
+        {0, f, 0, 0},
+        {0, 0, far / (near - far), near * far / (near - far)},
+        {0, 0, -1, 0}
+    };
+}
+
+static AABB3f Box(const Vector3f &min, const Vector3f &max){
+    return AABB3f(min, max - min);
+}
+
+// identity is the clip volume itself, x and y in [-1, 1] and z in the depth range
+static void ClipVolume(){
+    const Frustum frustum(Matrix4f(), ClipDepth::ZeroToOne);
+    const Frustum gl_frustum(Matrix4f(), ClipDepth::MinusOneToOne);
+
+    for(const Plane &plane: frustum.Planes)
+        SX_TEST_CHECK(std::fabs(plane.Normal.Length() - 1.f) < 1e-6f);
+
+    SX_TEST_CHECK(frustum.Intersects(Box({-0.5f, -0.5f, 0.2f}, {0.5f, 0.5f, 0.8f})));
+    SX_TEST_CHECK(frustum.Intersects(Box({0.5f, 0.5f, 0.5f}, {3, 3, 3})));
+    SX_TEST_CHECK(!frustum.Intersects(Box({2, -0.5f, 0.2f}, {3, 0.5f, 0.8f})));
+    SX_TEST_CHECK(!frustum.Intersects(Box({-0.5f, -3, 0.2f}, {0.5f, -2, 0.8f})));
+    SX_TEST_CHECK(!frustum.Intersects(Box({-0.5f, -0.5f, 1.5f}, {0.5f, 0.5f, 2})));
+
+    // behind the near plane only with zero to one depth
+    const AABB3f near_box = Box({-0.5f, -0.5f, -0.8f}, {0.5f, 0.5f, -0.2f});
+    SX_TEST_CHECK(!frustum.Intersects(near_box));
+    SX_TEST_CHECK(gl_frustum.Intersects(near_box));
+
+    SX_TEST_CHECK(frustum.Intersects(Spheref({0, 0, 0.5f}, 0.1f)));
+    SX_TEST_CHECK(frustum.Intersects(Spheref({1.5f, 0, 0.5f}, 0.6f)));
+    SX_TEST_CHECK(!frustum.Intersects(Spheref({1.5f, 0, 0.5f}, 0.4f)));
+    SX_TEST_CHECK(!frustum.Intersects(Spheref({0, 0, -0.5f}, 0.4f)));
+    SX_TEST_CHECK(gl_frustum.Intersects(Spheref({0, 0, -0.5f}, 0.4f)));
+}
+
+static void PerspectiveProjection(){
+    const Frustum frustum(Perspective(1.5f, 1.f, 0.1f, 100.f));
+
+    SX_TEST_CHECK(frustum.Intersects(Spheref({0, 0, -10}, 1)));
+    SX_TEST_CHECK(!frustum.Intersects(Spheref({0, 0, 10}, 1)));
+    SX_TEST_CHECK(!frustum.Intersects(Spheref({100, 0, -10}, 1)));
+    SX_TEST_CHECK(!frustum.Intersects(Spheref({0, 0, -200}, 1)));
+    SX_TEST_CHECK(frustum.Intersects(Spheref({0, 0, -200}, 150)));
+
+    SX_TEST_CHECK(frustum.Intersects(Box({-1, -1, -11}, {1, 1, -9})));
+    SX_TEST_CHECK(!frustum.Intersects(Box({-1, -1, 9}, {1, 1, 11})));
+    SX_TEST_CHECK(!frustum.Intersects(Box({-1, 50, -11}, {1, 52, -9})));
+    // straddling the camera
+    SX_TEST_CHECK(frustum.Intersects(Box({-1, -1, -1}, {1, 1, 1})));
+}
+
+// batch results against the single element tests, sizes go across StreamLanes blocks
+static void Batch(){
+    const Frustum frustum(Perspective(1.2f, 1.5f, 0.5f, 50.f));
+    const size_t sizes[] = {0, 1, 15, 16, 17, 100, 1000};
+
+    for(size_t size: sizes){
+        List<AABB3f> boxes;
+        List<Spheref> spheres;
+        for(size_t i = 0; i<size; i++){
+            const Vector3f center(Random() * 60, Random() * 60, Random() * 60);
+            boxes.Add(AABB3f(center, {Random() + 1.5f, Random() + 1.5f, Random() + 1.5f}));
+            spheres.Add(Spheref(center, Random() + 1.5f));
+        }
+
+        AABB3Stream stream;
+        stream.FromAoS({boxes.Data(), size});
+
+        List<u8> visibility, stream_visibility, sphere_visibility;
+        visibility.Resize(size);
+        stream_visibility.Resize(size);
+        sphere_visibility.Resize(size);
+
+        // index overloads append to what is there
+        List<u32> indices, stream_indices, sphere_indices;
+        indices.Add(~0u);
+        stream_indices.Add(~0u);
+        sphere_indices.Add(~0u);
+
+        Math::CullAABBs(frustum, {boxes.Data(), size}, {visibility.Data(), size});
+        Math::CullAABBs(frustum, {boxes.Data(), size}, indices);
+        Math::CullAABBs(frustum, stream, {stream_visibility.Data(), size});
+        Math::CullAABBs(frustum, stream, stream_indices);
+        Math::CullSpheres(frustum, {spheres.Data(), size}, {sphere_visibility.Data(), size});
+        Math::CullSpheres(frustum, {spheres.Data(), size}, sphere_indices);
+
+        List<u32> expected, expected_spheres;
+        expected.Add(~0u);
+        expected_spheres.Add(~0u);
+        for(size_t i = 0; i<size; i++){
+            const bool is_visible = frustum.Intersects(boxes[i]);
+            const bool is_sphere_visible = frustum.Intersects(spheres[i]);
+
+            SX_TEST_CHECK(visibility[i] == is_visible);
+            SX_TEST_CHECK(stream_visibility[i] == is_visible);
+            SX_TEST_CHECK(sphere_visibility[i] == is_sphere_visible);
+
+            if(is_visible)
+                expected.Add((u32)i);
+            if(is_sphere_visible)
+                expected_spheres.Add((u32)i);
+        }
+
+        SX_TEST_CHECK(indices.Size() == expected.Size() && stream_indices.Size() == expected.Size());
+        for(size_t i = 0; i<Min(indices.Size(), expected.Size()); i++)
+            SX_TEST_CHECK(indices[i] == expected[i] && stream_indices[i] == expected[i]);
+
+        SX_TEST_CHECK(sphere_indices.Size() == expected_spheres.Size());
+        for(size_t i = 0; i<Min(sphere_indices.Size(), expected_spheres.Size()); i++)
+            SX_TEST_CHECK(sphere_indices[i] == expected_spheres[i]);
+
+        // the random scene is expected to be partially visible
+        if(size >= 100)
+            SX_TEST_CHECK(expected.Size() > 1 && expected.Size() < size + 1);
+    }
+}
+
+int main(){
+    ClipVolume();
+    PerspectiveProjection();
+    Batch();
+
+    return Test::Result();
+}
@@ -0,0 +1,105 @@
+#ifndef STRAITX_LOSSY_LINK_HPP
+#define STRAITX_LOSSY_LINK_HPP
+
+#include <cstring>
+#include "core/list.hpp"
+#include "core/assert.hpp"
+#include "core/net/udp_connection.hpp"
+
+// Simulated one way link for UdpConnection tests and benchmarks. Packets are delivered to the receiving
+// connection after Delay plus a random jitter of up to Jitter, some of them are dropped. Jitter reorders
+// packets, but a packet never arrives before the one sent ReorderWindow packets earlier, so reordering stays
+// within the 32 packets the ack bits cover. Randomness is a fixed xorshift32 sequence, runs are reproducible
+class LossyLink{
+public:
+	static constexpr u32 MaxPacketSize = 1200;
+	static constexpr u32 ReorderWindow = 16;
+private:
+	struct InFlight{
+		Time DeliveryTime;
+		u64 Index = 0;
+		u32 Size = 0;
+		u8 Data[MaxPacketSize];
+	};
+
+	// sorted by delivery time, then by send order
+	List<InFlight> m_InFlight;
+	// of the last ReorderWindow packets, and the latest of all the packets sent before them
+	Time m_RecentDeliveryTimes[ReorderWindow];
+	Time m_EarliestDeliveryTime;
+	u64 m_Sent = 0;
+	u64 m_LastDelivered = 0;
+	u32 m_RandomState = 0x2545F491;
+public:
+	UdpConnection *Receiver = nullptr;
+	Time Now;
+	Time Delay = Milliseconds(30);
+	Time Jitter;
+	// out of 1000 packets
+	u32 LossPermille = 0;
+	// next packets dropped regardless of LossPermille
+	u32 DropNext = 0;
+	// packets delivered after a packet that was sent later
+	u64 Reordered = 0;
+public:
+	void Send(ConstSpan<u8> packet){
+		SX_CORE_ASSERT(packet.Size() <= MaxPacketSize, "LossyLink: Packet is too big");
+
+		const u64 index = ++m_Sent;
+		if(DropNext){
+			DropNext--;
+			return;
+		}
+		if(Random() % 1000 < LossPermille)
+			return;
+
+		Time delivery_time = Now + Delay;
+		if(Jitter > Time())
+			delivery_time += Microseconds(Random() % (Jitter.AsMicroseconds() + 1));
+
+		Time &recent = m_RecentDeliveryTimes[index % ReorderWindow];
+		m_EarliestDeliveryTime = Max(m_EarliestDeliveryTime, recent);
+		delivery_time = Max(delivery_time, m_EarliestDeliveryTime);
+		recent = delivery_time;
+
+		m_InFlight.Add({});
+		size_t position = m_InFlight.Size() - 1;
+		for(; position && m_InFlight[position - 1].DeliveryTime > delivery_time; position--)
+			m_InFlight[position] = m_InFlight[position - 1];
+
+		InFlight &in_flight = m_InFlight[position];
+		in_flight.DeliveryTime = delivery_time;
+		in_flight.Index = index;
+		in_flight.Size = packet.Size();
+		memcpy(in_flight.Data, packet.Pointer(), packet.Size());
+	}
+
+	void Deliver(Time now){
+		Now = now;
+
+		size_t delivered = 0;
+		while(delivered < m_InFlight.Size() && m_InFlight[delivered].DeliveryTime <= now){
+			const InFlight &packet = m_InFlight[delivered++];
+
+			if(packet.Index < m_LastDelivered)
+				Reordered++;
+			m_LastDelivered = Max(m_LastDelivered, packet.Index);
+
+			Receiver->OnPacket({packet.Data, packet.Size}, now);
+		}
+
+		for(size_t i = delivered; i<m_InFlight.Size(); i++)
+			m_InFlight[i - delivered] = m_InFlight[i];
+		for(size_t i = 0; i<delivered; i++)
+			m_InFlight.RemoveLast();
+	}
+private:
+	u32 Random(){
+		m_RandomState ^= m_RandomState << 13;
+		m_RandomState ^= m_RandomState >> 17;
+		m_RandomState ^= m_RandomState << 5;
+		return m_RandomState;
+	}
+};
+
+#endif//STRAITX_LOSSY_LINK_HPP
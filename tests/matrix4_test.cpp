@@ -0,0 +1,156 @@
+#include <cmath>
+#include <cstring>
+#include "core/algorithm.hpp"
+#include "core/math/matrix4.hpp"
+#include "test.hpp"
+
+// Float specializations against the generic templates. Multiplications are compared bitwise,
+// this target is built with -ffp-contract=off so the scalar templates are not fused into FMA
+
+static u32 s_RandomState = 0x2545F491;
+
+// xorshift32, same matrices every run
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector4f RandomVector(){
+    return {Random(), Random(), Random(), Random()};
+}
+
+static Matrix4f RandomMatrix(){
+    return {RandomVector(), RandomVector(), RandomVector(), RandomVector()};
+}
+
+// dominant diagonal keeps it well conditioned
+static Matrix4f RandomInvertible(){
+    Matrix4f matrix = RandomMatrix();
+    for(size_t i = 0; i<4; i++)
+        matrix[i][i] += Random() < 0 ? -4.f : 4.f;
+    return matrix;
+}
+
+static Matrix4f RandomAffine(){
+    Matrix4f matrix = RandomInvertible();
+    matrix[3] = {0, 0, 0, 1};
+    matrix[0][3] = Random() * 100.f;
+    matrix[1][3] = Random() * 100.f;
+    matrix[2][3] = Random() * 100.f;
+    return matrix;
+}
+
+static Matrix4<double> ToDouble(const Matrix4f &matrix){
+    return {Vector4<double>(matrix[0]), Vector4<double>(matrix[1]), Vector4<double>(matrix[2]), Vector4<double>(matrix[3])};
+}
+
+static bool IsBitExact(const Matrix4f &left, const Matrix4f &right){
+    return memcmp(&left, &right, sizeof(Matrix4f)) == 0;
+}
+
+// relative to the magnitude of elements above one, translation of the inverse gets large
+static double MaxError(const Matrix4f &left, const Matrix4<double> &right){
+    double error = 0;
+    for(size_t i = 0; i<16; i++)
+        error = Max(error, std::fabs(left.Flat(i) - right.Flat(i)) / Max(1.0, std::fabs(right.Flat(i))));
+    return error;
+}
+
+// float specializations still work in constant expressions, through the generic templates
+static constexpr Matrix4f s_Scale(2.f);
+static constexpr Matrix4f s_Rows{
+    {1, 2, 3, 4},
+    {5, 6, 7, 8},
+    {0, 0, 1, 0},
+    {0, 0, 0, 1}
+};
+static_assert((s_Scale * s_Rows)[1][0] == 10.f, "constexpr Matrix4f multiply");
+static_assert((s_Rows * Vector4f(1, 1, 1, 1)).x == 10.f, "constexpr Matrix4f transform");
+static_assert(s_Rows.GetTransposed()[0][1] == 5.f, "constexpr Matrix4f transpose");
+static_assert(s_Scale.GetInverse()[2][2] == 0.5f, "constexpr Matrix4f inverse");
+
+static void Layout(){
+    SX_TEST_CHECK(alignof(Vector4f) == 16);
+    SX_TEST_CHECK(sizeof(Matrix4f) == 64);
+}
+
+static void MultiplyBitExact(){
+    for(u32 i = 0; i<10000; i++){
+        const Matrix4f left = RandomMatrix();
+        const Matrix4f right = RandomMatrix();
+        const Vector4f vector = RandomVector();
+
+        SX_TEST_CHECK(IsBitExact(left * right, operator*<float>(left, right)));
+
+        const Vector4f product = left * vector;
+        const Vector4f reference = operator*<float>(left, vector);
+        SX_TEST_CHECK(memcmp(&product, &reference, sizeof(Vector4f)) == 0);
+    }
+}
+
+static void Transpose(){
+    const Matrix4f matrix = RandomMatrix();
+    const Matrix4f transposed = matrix.GetTransposed();
+
+    for(size_t i = 0; i<4; i++){
+        for(size_t j = 0; j<4; j++)
+            SX_TEST_CHECK(transposed[i][j] == matrix[j][i]);
+    }
+}
+
+// against the double precision template, residual of the product with the original is checked as well
+static void Inverse(){
+    double max_error = 0, max_residual = 0;
+
+    for(u32 i = 0; i<10000; i++){
+        const Matrix4f matrix = i % 2 ? RandomAffine() : RandomInvertible();
+        const Matrix4f inverse = matrix.GetInverse();
+
+        max_error = Max(max_error, MaxError(inverse, Details::ScalarInverse(ToDouble(matrix))));
+        max_residual = Max(max_residual, MaxError(matrix * inverse, Matrix4<double>()));
+
+        // within rounding of the float template
+        SX_TEST_CHECK(MaxError(inverse, ToDouble(Details::ScalarInverse(matrix))) < 1e-5);
+    }
+
+    SX_TEST_CHECK(max_error < 1e-5);
+    SX_TEST_CHECK(max_residual < 1e-4);
+
+    // affine path keeps the bottom row exact
+    const Matrix4f affine_inverse = RandomAffine().GetInverse();
+    SX_TEST_CHECK(affine_inverse[3][0] == 0.f && affine_inverse[3][1] == 0.f && affine_inverse[3][2] == 0.f && affine_inverse[3][3] == 1.f);
+}
+
+// small integers, so determinants are exactly zero in both paths
+static void SingularInverse(){
+    const Matrix4f zero(0.f);
+    const Matrix4f general{
+        {1, 2, 3, 4},
+        {2, 4, 6, 8},
+        {0, 1, 0, 1},
+        {1, 0, 1, 0}
+    };
+    const Matrix4f affine{
+        {1, 2, 3, 4},
+        {1, 2, 3, 5},
+        {0, 1, 0, 6},
+        {0, 0, 0, 1}
+    };
+
+    SX_TEST_CHECK(IsBitExact(zero.GetInverse(), Matrix4f()));
+    SX_TEST_CHECK(IsBitExact(general.GetInverse(), Matrix4f()));
+    SX_TEST_CHECK(IsBitExact(affine.GetInverse(), Matrix4f()));
+    SX_TEST_CHECK(general.GetDeterminant() == 0.f && affine.GetDeterminant() == 0.f);
+}
+
+int main(){
+    Layout();
+    MultiplyBitExact();
+    Transpose();
+    Inverse();
+    SingularInverse();
+
+    return Test::Result();
+}
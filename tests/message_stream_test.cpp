@@ -0,0 +1,142 @@
+#include <thread>
+#include "core/net/message_stream.hpp"
+#include "core/net/tcp_listener.hpp"
+#include "test.hpp"
+
+// connected pair of loopback sockets, listening port is the first free one of the range
+static bool ConnectPair(TcpSocket &client, TcpSocket &server){
+	TcpListener listener;
+	listener.SetReuseAddress(true);
+
+	for(u16 port = 42300; port < 42400; port++){
+		if(!listener.Bind(IpAddress::Loopback, port))
+			continue;
+		if(!client.Connect(IpAddress::Loopback, port))
+			return false;
+		server = listener.Accept();
+		return server.IsConnected();
+	}
+	return false;
+}
+
+// letters only, so delimiter framing can carry it too
+static void FillMessage(List<u8> &message, u32 index, u32 size){
+	message.Resize(size);
+	for(u32 i = 0; i<size; i++)
+		message[i] = 'a' + (index * 31 + i) % 26;
+}
+
+static bool IsMessageValid(ConstSpan<u8> message, u32 index, u32 size){
+	if(message.Size() != size)
+		return false;
+	for(u32 i = 0; i<size; i++){
+		if(message[i] != 'a' + (index * 31 + i) % 26)
+			return false;
+	}
+	return true;
+}
+
+// sizes go across the slab size, which is 64KB by default
+static const u32 s_Sizes[] = {0, 1, 100, 4095, 65535, 65536, 70000, 200000, 3, 64};
+static constexpr u32 SizesCount = sizeof(s_Sizes) / sizeof(s_Sizes[0]);
+
+struct Receiver{
+	TcpSocket *Socket = nullptr;
+	SlabPool *Pool = nullptr;
+	MessageStreamConfig Config;
+	u32 MessagesCount = 0;
+
+	u32 Received = 0;
+	u32 Invalid = 0;
+
+	void Run(){
+		MessageStream stream(*Socket, *Pool, Config);
+
+		while(Received < MessagesCount){
+			if(!stream.Receive() && (!Socket->IsConnected() || stream.IsBroken()))
+				break;
+
+			ConstSpan<u8> message;
+			while(stream.NextMessage(message)){
+				if(!IsMessageValid(message, Received, s_Sizes[Received % SizesCount]))
+					Invalid++;
+				Received++;
+			}
+		}
+	}
+};
+
+static void Transfer(MessageFraming framing){
+	constexpr u32 MessagesCount = 500;
+
+	TcpSocket client, server;
+	SX_TEST_CHECK(ConnectPair(client, server));
+
+	SlabPool pool;
+	MessageStreamConfig config;
+	config.Framing = framing;
+
+	Receiver receiver;
+	receiver.Socket = &server;
+	receiver.Pool = &pool;
+	receiver.Config = config;
+	receiver.MessagesCount = MessagesCount;
+	std::thread receiving(&Receiver::Run, &receiver);
+
+	{
+		MessageStream stream(client, pool, config);
+		List<u8> message;
+
+		for(u32 i = 0; i<MessagesCount; i++){
+			FillMessage(message, i, s_Sizes[i % SizesCount]);
+			SX_TEST_CHECK(stream.Send({message.Data(), message.Size()}));
+
+			// several messages per flush, so sends are coalesced
+			if(i % 7 == 6)
+				SX_TEST_CHECK(stream.Flush());
+		}
+		SX_TEST_CHECK(stream.Flush());
+		SX_TEST_CHECK(stream.QueuedSize() == 0);
+	}
+
+	receiving.join();
+
+	SX_TEST_CHECK(receiver.Received == MessagesCount);
+	SX_TEST_CHECK(receiver.Invalid == 0);
+	SX_TEST_CHECK(pool.UsedCount() == 0);
+}
+
+static void MessageSizeLimit(){
+	TcpSocket client, server;
+	SX_TEST_CHECK(ConnectPair(client, server));
+
+	SlabPool pool;
+	MessageStreamConfig limited;
+	limited.MaxMessageSize = 1000;
+
+	MessageStream sender(client, pool);
+	MessageStream limited_sender(client, pool, limited);
+	MessageStream receiver(server, pool, limited);
+
+	List<u8> message;
+	FillMessage(message, 0, 2000);
+	SX_TEST_CHECK(!limited_sender.Send({message.Data(), message.Size()}));
+	SX_TEST_CHECK(limited_sender.QueuedSize() == 0);
+
+	SX_TEST_CHECK(sender.Send({message.Data(), message.Size()}));
+	SX_TEST_CHECK(sender.Flush());
+
+	// oversized length prefix breaks the stream as soon as it is seen
+	ConstSpan<u8> received;
+	while(!receiver.IsBroken() && receiver.Receive())
+		SX_TEST_CHECK(!receiver.NextMessage(received));
+	SX_TEST_CHECK(receiver.IsBroken());
+}
+
+int main(){
+	Transfer(MessageFraming::LengthPrefix);
+	Transfer(MessageFraming::Delimiter);
+	MessageSizeLimit();
+
+	return Test::Result();
+}
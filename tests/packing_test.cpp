@@ -0,0 +1,374 @@
+#include <cmath>
+#include <cstring>
+#include "core/list.hpp"
+#include "core/math/packing.hpp"
+#include "test.hpp"
+
+// Half floats against a double precision reference over every half and a dense sweep of floats,
+// normalized integers over every code, the bounds packing.hpp documents for normals, rotations and
+// positions. Batch versions are expected to match the scalar ones bit for bit, with SX_SIMD_HALF
+// defined the same checks cover F16C and NEON conversions
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static float RandomBits(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    float value = 0.f;
+    memcpy(&value, &s_RandomState, sizeof(value));
+    return value;
+}
+
+static Vector3f RandomNormal(){
+    Vector3f normal;
+    do{
+        normal = Vector3f(Random(), Random(), Random());
+    }while(normal.Length() < 0.1f);
+    return normal / normal.Length();
+}
+
+static Quaternionf RandomRotation(){
+    return Quaternionf(Random(), Random(), Random(), Random()).GetNormalized();
+}
+
+static bool IsBitEqual(float left, float right){
+    return memcmp(&left, &right, sizeof(float)) == 0;
+}
+
+// angle between two directions
+static double Degrees(const Vector3f &left, const Vector3f &right){
+    const double cos = double(left.x) * right.x + double(left.y) * right.y + double(left.z) * right.z;
+    return std::acos(Min(cos / (double(left.Length()) * right.Length()), 1.0)) * 180.0 / 3.14159265358979324;
+}
+
+// decoding a half straight from its fields
+static double ReferenceHalfToFloat(u16 half){
+    const int exponent = (half >> 10) & 0x1F;
+    const int mantissa = half & 0x3FF;
+    const double magnitude = exponent ? std::ldexp(1024 + mantissa, exponent - 25) : std::ldexp(mantissa, -24);
+    return half & 0x8000 ? -magnitude : magnitude;
+}
+
+// nearest half with ties to even, in the units of the last place of the binade value falls into
+static double ReferenceFloatToHalf(float value){
+    if(std::fabs(value) >= 65520.f)
+        return std::copysign(INFINITY, value);
+    int exponent = 0;
+    std::frexp(value, &exponent);
+    const double ulp = std::ldexp(1.0, Max(exponent - 1, -14) - 10);
+    return std::copysign(std::nearbyint(double(value) / ulp) * ulp, value);
+}
+
+static void Half(){
+    // every half decodes exactly and comes back unchanged
+    bool is_decoded = true, is_round_trip = true;
+    for(u32 i = 0; i<0x10000; i++){
+        const u16 half = u16(i);
+        const float value = Math::HalfToFloat(half);
+        if((half & 0x7FFF) > 0x7C00){
+            is_decoded = is_decoded && std::isnan(value);
+            is_round_trip = is_round_trip && (Math::FloatToHalf(value) & 0x7FFF) > 0x7C00;
+        }else{
+            const bool is_exact = (half & 0x7FFF) == 0x7C00 ? std::isinf(value) : double(value) == ReferenceHalfToFloat(half);
+            is_decoded = is_decoded && is_exact && std::signbit(value) == bool(half & 0x8000);
+            is_round_trip = is_round_trip && Math::FloatToHalf(value) == half;
+        }
+    }
+    SX_TEST_CHECK(is_decoded);
+    SX_TEST_CHECK(is_round_trip);
+
+    // every 61st float bit pattern, denormals, overflow and ties included
+    bool is_rounded = true;
+    for(u64 bits = 0; bits<0x100000000; bits += 61){
+        float value = 0.f;
+        const u32 pattern = u32(bits);
+        memcpy(&value, &pattern, sizeof(value));
+        if(std::isnan(value))
+            continue;
+        const float result = Math::HalfToFloat(Math::FloatToHalf(value));
+        is_rounded = is_rounded && double(result) == ReferenceFloatToHalf(value) && std::signbit(result) == std::signbit(value);
+    }
+    SX_TEST_CHECK(is_rounded);
+
+    // halfway between halves goes to the even one, 65520 is the first value to overflow
+    SX_TEST_CHECK(Math::FloatToHalf(1.f + 0x1p-11f) == 0x3C00);
+    SX_TEST_CHECK(Math::FloatToHalf(1.f + 3 * 0x1p-11f) == 0x3C02);
+    SX_TEST_CHECK(Math::FloatToHalf(0x1p-25f) == 0x0000);
+    SX_TEST_CHECK(Math::FloatToHalf(3 * 0x1p-25f) == 0x0002);
+    SX_TEST_CHECK(Math::FloatToHalf(65504.f) == 0x7BFF);
+    SX_TEST_CHECK(Math::FloatToHalf(65519.996f) == 0x7BFF);
+    SX_TEST_CHECK(Math::FloatToHalf(65520.f) == 0x7C00);
+    SX_TEST_CHECK(Math::FloatToHalf(-1e30f) == 0xFC00);
+    SX_TEST_CHECK(Math::FloatToHalf(-0.f) == 0x8000);
+
+    // sizes that leave a tail after the vector loop
+    for(size_t size: {size_t(0), size_t(3), size_t(8), size_t(1003)}){
+        List<float> values, unpacked;
+        List<u16> packed, halves;
+        for(size_t i = 0; i<size; i++){
+            values.Add(i % 2 ? RandomBits() : Random() * 70000.f);
+            halves.Add(u16(s_RandomState));
+        }
+        packed.Resize(size);
+        unpacked.Resize(size);
+
+        Math::FloatToHalf(values, packed);
+        Math::HalfToFloat(halves, unpacked);
+
+        bool is_same = true;
+        for(size_t i = 0; i<size; i++){
+            // hardware conversions may keep NaN payloads
+            if(std::isnan(values[i]))
+                is_same = is_same && (packed[i] & 0x7FFF) > 0x7C00;
+            else
+                is_same = is_same && packed[i] == Math::FloatToHalf(values[i]);
+
+            if((halves[i] & 0x7FFF) > 0x7C00)
+                is_same = is_same && std::isnan(unpacked[i]);
+            else
+                is_same = is_same && IsBitEqual(unpacked[i], Math::HalfToFloat(halves[i]));
+        }
+        SX_TEST_CHECK(is_same);
+    }
+}
+
+template<typename IntegerType, typename PackType, typename UnpackType, typename PackBatchType, typename UnpackBatchType>
+static void Normalized(PackType pack, UnpackType unpack, PackBatchType pack_batch, UnpackBatchType unpack_batch){
+    constexpr bool IsSigned = std::numeric_limits<IntegerType>::is_signed;
+    constexpr s32 Lowest = std::numeric_limits<IntegerType>::min();
+    constexpr s32 Highest = std::numeric_limits<IntegerType>::max();
+
+    // every code comes back, the lowest signed one decodes to -1 and packs as the one above it
+    bool is_round_trip = true;
+    for(s32 i = Lowest; i<=Highest; i++)
+        is_round_trip = is_round_trip && pack(unpack(IntegerType(i))) == (IsSigned && i == Lowest ? Lowest + 1 : i);
+    SX_TEST_CHECK(is_round_trip);
+    SX_TEST_CHECK(unpack(IntegerType(Highest)) == 1.f);
+    SX_TEST_CHECK(unpack(IntegerType(IsSigned ? -Highest : 0)) == (IsSigned ? -1.f : 0.f));
+    SX_TEST_CHECK(unpack(IntegerType(Lowest)) == (IsSigned ? -1.f : 0.f));
+
+    SX_TEST_CHECK(pack(2.f) == Highest);
+    SX_TEST_CHECK(pack(-2.f) == (IsSigned ? -Highest : 0));
+    SX_TEST_CHECK(pack(0.f) == 0);
+
+    // error is half a step plus float rounding of the scaled value, the encoding is symmetric around zero
+    const double step = 1.0 / Highest;
+    double error = 0.0;
+    bool is_symmetric = true;
+    for(u32 i = 0; i<200000; i++){
+        const float value = IsSigned ? Random() : (Random() + 1.f) * 0.5f;
+        error = Max(error, std::fabs(double(unpack(pack(value))) - value));
+        if(IsSigned)
+            is_symmetric = is_symmetric && pack(-value) == -pack(value);
+    }
+    SX_TEST_CHECK(error <= step * (0.5 + Highest * 0x1p-23));
+    SX_TEST_CHECK(is_symmetric);
+
+    for(size_t size: {size_t(0), size_t(3), size_t(8), size_t(1003)}){
+        List<float> values, unpacked;
+        List<IntegerType> packed;
+        for(size_t i = 0; i<size; i++)
+            values.Add(Random() * 1.5f);
+        // exact halves between codes and out of range ones
+        if(size > 8){
+            values[0] = 0.5f / Highest;
+            values[1] = -0.5f / Highest;
+            values[2] = 1.5f / Highest;
+            values[3] = 1.f;
+            values[4] = -1.f;
+        }
+        packed.Resize(size);
+        unpacked.Resize(size);
+
+        pack_batch(values, packed);
+        unpack_batch(packed, unpacked);
+
+        bool is_same = true;
+        for(size_t i = 0; i<size; i++)
+            is_same = is_same && packed[i] == pack(values[i]) && IsBitEqual(unpacked[i], unpack(packed[i]));
+        SX_TEST_CHECK(is_same);
+    }
+}
+
+template<typename PackedType, typename PackType, typename UnpackType, typename PackBatchType, typename UnpackBatchType>
+static void Octahedral(double max_degrees, PackType pack, UnpackType unpack, PackBatchType pack_batch, UnpackBatchType unpack_batch){
+    List<Vector3f> normals;
+    // axes, diagonals and the fold edge where z changes sign
+    for(float x: {-1.f, 0.f, 1.f}){
+        for(float y: {-1.f, 0.f, 1.f}){
+            for(float z: {-1.f, -1e-7f, 0.f, 1e-7f, 1.f}){
+                const Vector3f normal(x, y, z);
+                if(normal.Length() > 0.5f)
+                    normals.Add(normal / normal.Length());
+            }
+        }
+    }
+    for(u32 i = 0; i<200000; i++)
+        normals.Add(RandomNormal());
+
+    double error = 0.0;
+    bool is_unit = true;
+    for(const Vector3f &normal: normals){
+        const Vector3f unpacked = unpack(pack(normal));
+        error = Max(error, Degrees(normal, unpacked));
+        is_unit = is_unit && std::fabs(unpacked.Length() - 1.f) < 1e-6f;
+    }
+    SX_TEST_CHECK(error < max_degrees);
+    SX_TEST_CHECK(is_unit);
+
+    // axes are exact
+    SX_TEST_CHECK(unpack(pack(Vector3f(0, 0, 1))) == Vector3f(0, 0, 1));
+    SX_TEST_CHECK(unpack(pack(Vector3f(0, 0, -1))) == Vector3f(0, 0, -1));
+    SX_TEST_CHECK(unpack(pack(Vector3f(1, 0, 0))) == Vector3f(1, 0, 0));
+    SX_TEST_CHECK(unpack(pack(Vector3f(0, -1, 0))) == Vector3f(0, -1, 0));
+
+    List<PackedType> packed;
+    List<Vector3f> unpacked;
+    packed.Resize(normals.Size());
+    unpacked.Resize(normals.Size());
+    pack_batch(normals, packed);
+    unpack_batch(packed, unpacked);
+
+    bool is_same = true;
+    for(size_t i = 0; i<normals.Size(); i++)
+        is_same = is_same && packed[i] == pack(normals[i]) && unpacked[i] == unpack(packed[i]);
+    SX_TEST_CHECK(is_same);
+}
+
+// rotation angle between two unit quaternions
+static double Degrees(const Quaternionf &left, const Quaternionf &right){
+    const double cos = std::fabs(double(left.x) * right.x + double(left.y) * right.y + double(left.z) * right.z + double(left.w) * right.w);
+    return 2.0 * std::acos(Min(cos, 1.0)) * 180.0 / 3.14159265358979324;
+}
+
+static void Rotations(){
+    List<Quaternionf> rotations;
+    rotations.Add(Quaternionf(0, 0, 0, 1));
+    rotations.Add(Quaternionf(0, 0, 0, -1));
+    rotations.Add(Quaternionf(1, 0, 0, 0));
+    // two largest components of the same size
+    rotations.Add(Quaternionf(0.70710678f, 0, 0, 0.70710678f));
+    rotations.Add(Quaternionf(0.5f, -0.5f, 0.5f, -0.5f));
+    for(u32 i = 0; i<200000; i++)
+        rotations.Add(RandomRotation());
+
+    double error = 0.0;
+    bool is_unit = true, is_negation_same = true;
+    for(const Quaternionf &rotation: rotations){
+        const u32 packed = Math::PackQuaternion(rotation);
+        const Quaternionf unpacked = Math::UnpackQuaternion(packed);
+        error = Max(error, Degrees(rotation, unpacked));
+        is_unit = is_unit && std::fabs(unpacked.Length() - 1.f) < 1e-6f;
+        is_negation_same = is_negation_same && Math::PackQuaternion(Quaternionf(-rotation.x, -rotation.y, -rotation.z, -rotation.w)) == packed;
+    }
+    SX_TEST_CHECK(error < 0.26);
+    SX_TEST_CHECK(is_unit);
+    SX_TEST_CHECK(is_negation_same);
+
+    // components of the identity come back exactly
+    const Quaternionf identity = Math::UnpackQuaternion(Math::PackQuaternion(Quaternionf(0, 0, 0, 1)));
+    SX_TEST_CHECK(identity.x == 0.f && identity.y == 0.f && identity.z == 0.f && identity.w == 1.f);
+
+    List<u32> packed;
+    List<Quaternionf> unpacked;
+    packed.Resize(rotations.Size());
+    unpacked.Resize(rotations.Size());
+    Math::PackQuaternion(rotations, packed);
+    Math::UnpackQuaternion(packed, unpacked);
+
+    bool is_same = true;
+    for(size_t i = 0; i<rotations.Size(); i++){
+        const Quaternionf scalar = Math::UnpackQuaternion(packed[i]);
+        is_same = is_same && packed[i] == Math::PackQuaternion(rotations[i]) && memcmp(&unpacked[i], &scalar, sizeof(Quaternionf)) == 0;
+    }
+    SX_TEST_CHECK(is_same);
+}
+
+static void Positions(){
+    const AABB3f bounds({-100.f, 5.f, -0.25f}, {300.f, 20.f, 0.5f});
+    const Vector3f step = bounds.Size() / 65535.f;
+
+    List<Vector3f> positions;
+    for(u32 i = 0; i<200000; i++){
+        const Vector3f unit((Random() + 1.f) * 0.5f, (Random() + 1.f) * 0.5f, (Random() + 1.f) * 0.5f);
+        positions.Add(bounds.Min + unit * bounds.Size());
+    }
+
+    // error is half a step along every axis, a little more for float rounding of positions far from zero
+    Vector3f error;
+    for(const Vector3f &position: positions){
+        const Vector3f unpacked = Math::DequantizePosition(Math::QuantizePosition(position, bounds), bounds);
+        error.x = Max(error.x, std::fabs(unpacked.x - position.x) / step.x);
+        error.y = Max(error.y, std::fabs(unpacked.y - position.y) / step.y);
+        error.z = Max(error.z, std::fabs(unpacked.z - position.z) / step.z);
+    }
+    SX_TEST_CHECK(error.x < 0.51f && error.y < 0.51f && error.z < 0.51f);
+
+    // corners are exact, positions outside are clamped
+    SX_TEST_CHECK(Math::DequantizePosition(Math::QuantizePosition(bounds.Min, bounds), bounds) == bounds.Min);
+    SX_TEST_CHECK(Math::QuantizePosition(bounds.Max, bounds) == Vector3<u16>(65535, 65535, 65535));
+    SX_TEST_CHECK(Math::QuantizePosition(bounds.Min - Vector3f(1.f), bounds) == Vector3<u16>(0, 0, 0));
+    SX_TEST_CHECK(Math::QuantizePosition(bounds.Max + Vector3f(1.f), bounds) == Vector3<u16>(65535, 65535, 65535));
+
+    // flat axes decode to the bounds
+    const AABB3f flat({1.f, 2.f, 3.f}, {0.f, 10.f, 0.f});
+    const Vector3f unpacked = Math::DequantizePosition(Math::QuantizePosition({7.f, 4.f, -7.f}, flat), flat);
+    SX_TEST_CHECK(unpacked.x == 1.f && unpacked.z == 3.f && std::fabs(unpacked.y - 4.f) < 1e-3f);
+
+    List<Vector3<u16>> packed;
+    List<Vector3f> batch;
+    packed.Resize(positions.Size());
+    batch.Resize(positions.Size());
+    Math::QuantizePosition(positions, bounds, packed);
+    Math::DequantizePosition(packed, bounds, batch);
+
+    bool is_same = true;
+    for(size_t i = 0; i<positions.Size(); i++){
+        const Vector3f scalar = Math::DequantizePosition(packed[i], bounds);
+        is_same = is_same && packed[i] == Math::QuantizePosition(positions[i], bounds) && memcmp(&batch[i], &scalar, sizeof(Vector3f)) == 0;
+    }
+    SX_TEST_CHECK(is_same);
+}
+
+int main(){
+    Half();
+
+    Normalized<u8>(
+        [](float value){ return Math::PackUnorm8(value); }, [](u8 value){ return Math::UnpackUnorm8(value); },
+        [](ConstSpan<float> values, Span<u8> result){ Math::PackUnorm8(values, result); },
+        [](ConstSpan<u8> values, Span<float> result){ Math::UnpackUnorm8(values, result); });
+    Normalized<s8>(
+        [](float value){ return Math::PackSnorm8(value); }, [](s8 value){ return Math::UnpackSnorm8(value); },
+        [](ConstSpan<float> values, Span<s8> result){ Math::PackSnorm8(values, result); },
+        [](ConstSpan<s8> values, Span<float> result){ Math::UnpackSnorm8(values, result); });
+    Normalized<u16>(
+        [](float value){ return Math::PackUnorm16(value); }, [](u16 value){ return Math::UnpackUnorm16(value); },
+        [](ConstSpan<float> values, Span<u16> result){ Math::PackUnorm16(values, result); },
+        [](ConstSpan<u16> values, Span<float> result){ Math::UnpackUnorm16(values, result); });
+    Normalized<s16>(
+        [](float value){ return Math::PackSnorm16(value); }, [](s16 value){ return Math::UnpackSnorm16(value); },
+        [](ConstSpan<float> values, Span<s16> result){ Math::PackSnorm16(values, result); },
+        [](ConstSpan<s16> values, Span<float> result){ Math::UnpackSnorm16(values, result); });
+
+    Octahedral<u16>(1.1,
+        [](const Vector3f &normal){ return Math::PackOctahedral8(normal); }, [](u16 packed){ return Math::UnpackOctahedral8(packed); },
+        [](ConstSpan<Vector3f> normals, Span<u16> result){ Math::PackOctahedral8(normals, result); },
+        [](ConstSpan<u16> packed, Span<Vector3f> result){ Math::UnpackOctahedral8(packed, result); });
+    Octahedral<u32>(0.04,
+        [](const Vector3f &normal){ return Math::PackOctahedral16(normal); }, [](u32 packed){ return Math::UnpackOctahedral16(packed); },
+        [](ConstSpan<Vector3f> normals, Span<u32> result){ Math::PackOctahedral16(normals, result); },
+        [](ConstSpan<u32> packed, Span<Vector3f> result){ Math::UnpackOctahedral16(packed, result); });
+
+    Rotations();
+    Positions();
+
+    return Test::Result();
+}
@@ -0,0 +1,170 @@
+#include <cmath>
+#include <cstring>
+#include "core/list.hpp"
+#include "core/math/quaternion.hpp"
+#include "core/math/transform.hpp"
+#include "test.hpp"
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Quaternionf RandomRotation(){
+    return Quaternionf(Random(), Random(), Random(), Random()).GetNormalized();
+}
+
+static bool IsNear(float left, float right, float tolerance = 1e-5f){
+    return std::fabs(left - right) <= tolerance;
+}
+
+static bool IsNear(const Vector3f &left, const Vector3f &right){
+    return IsNear(left.x, right.x) && IsNear(left.y, right.y) && IsNear(left.z, right.z);
+}
+
+static bool IsNear(const Matrix4f &left, const Matrix4f &right){
+    for(size_t i = 0; i<16; i++){
+        if(!IsNear(left.Flat(i), right.Flat(i)))
+            return false;
+    }
+    return true;
+}
+
+// q and -q are the same rotation
+static bool IsSameRotation(const Quaternionf &left, const Quaternionf &right, float tolerance = 1e-5f){
+    return IsNear(std::fabs(Dot(left, right)), 1.f, tolerance);
+}
+
+static void Product(){
+    for(u32 i = 0; i<10000; i++){
+        const Quaternionf left = RandomRotation(), right = RandomRotation();
+        const Quaternionf product = left * right, reference = operator*<float>(left, right);
+        SX_TEST_CHECK(memcmp(&product, &reference, sizeof(Quaternionf)) == 0);
+
+        // the same order as Matrix4 products
+        SX_TEST_CHECK(IsNear(product.ToMatrix(), left.ToMatrix() * right.ToMatrix()));
+    }
+
+    const Quaternionf rotation = RandomRotation();
+    SX_TEST_CHECK(IsSameRotation(rotation * rotation.GetConjugate(), Quaternionf()));
+    SX_TEST_CHECK(IsSameRotation(rotation * rotation.GetInverse(), Quaternionf()));
+
+    // inverse holds for non unit quaternions as well
+    const Quaternionf scaled(rotation.x * 3, rotation.y * 3, rotation.z * 3, rotation.w * 3);
+    const Quaternionf identity = scaled * scaled.GetInverse();
+    SX_TEST_CHECK(IsNear(identity.w, 1.f) && IsNear(identity.x, 0.f) && IsNear(identity.y, 0.f) && IsNear(identity.z, 0.f));
+}
+
+static void AxisAngle(){
+    const float angle = 0.7f;
+
+    SX_TEST_CHECK(IsNear(Quaternionf::FromAxisAngle({1, 0, 0}, angle).ToMatrix(), Math::RotateX<float>(angle)));
+    SX_TEST_CHECK(IsNear(Quaternionf::FromAxisAngle({0, 0, 1}, angle).ToMatrix(), Math::RotateZ<float>(angle)));
+    // RotateY goes the other way
+    SX_TEST_CHECK(IsNear(Quaternionf::FromAxisAngle({0, 1, 0}, -angle).ToMatrix(), Math::RotateY<float>(angle)));
+
+    Vector3f axis;
+    float radians = 0;
+    const Vector3f expected_axis = Vector3f(1, 2, 3) / Vector3f(1, 2, 3).Length();
+    Quaternionf::FromAxisAngle(expected_axis, 2.f).ToAxisAngle(axis, radians);
+    SX_TEST_CHECK(IsNear(axis, expected_axis) && IsNear(radians, 2.f));
+
+    Quaternionf().ToAxisAngle(axis, radians);
+    SX_TEST_CHECK(axis == Vector3f(1, 0, 0) && radians == 0.f);
+}
+
+// every branch of FromMatrix: positive trace and each of the diagonal elements being the largest
+static void Matrix(){
+    for(u32 i = 0; i<1000; i++){
+        const Quaternionf rotation = RandomRotation();
+        SX_TEST_CHECK(IsSameRotation(Quaternionf::FromMatrix(rotation.ToMatrix()), rotation));
+    }
+
+    const Vector3f axes[] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {0.6f, 0.8f, 0}};
+    for(const Vector3f &axis: axes){
+        const Quaternionf half_turn = Quaternionf::FromAxisAngle(axis, float(Math::Pi));
+        SX_TEST_CHECK(IsSameRotation(Quaternionf::FromMatrix(half_turn.ToMatrix()), half_turn));
+    }
+}
+
+static void Rotate(){
+    for(u32 i = 0; i<1000; i++){
+        const Quaternionf rotation = RandomRotation();
+        const Vector3f vector(Random() * 10, Random() * 10, Random() * 10);
+
+        SX_TEST_CHECK(IsNear(rotation * vector, (rotation.ToMatrix() * Vector4f(vector, 0.f)).XYZ()));
+        SX_TEST_CHECK(IsNear(rotation.GetConjugate().Rotate(rotation.Rotate(vector)), vector));
+    }
+}
+
+static void Interpolation(){
+    const Quaternionf from = Quaternionf::FromAxisAngle({0, 0, 1}, 0.2f);
+    const Quaternionf to = Quaternionf::FromAxisAngle({0, 0, 1}, 1.4f);
+
+    SX_TEST_CHECK(IsSameRotation(Math::Slerp(from, to, 0.f), from));
+    SX_TEST_CHECK(IsSameRotation(Math::Slerp(from, to, 1.f), to));
+    // constant angular velocity
+    SX_TEST_CHECK(IsSameRotation(Math::Slerp(from, to, 0.25f), Quaternionf::FromAxisAngle({0, 0, 1}, 0.5f)));
+
+    // shorter arc, the negated end is the same rotation
+    const Quaternionf negated(-to.x, -to.y, -to.z, -to.w);
+    SX_TEST_CHECK(IsSameRotation(Math::Slerp(from, negated, 0.25f), Quaternionf::FromAxisAngle({0, 0, 1}, 0.5f)));
+    SX_TEST_CHECK(IsSameRotation(Math::NLerp(from, negated, 0.5f), Quaternionf::FromAxisAngle({0, 0, 1}, 0.8f)));
+
+    // nearly parallel ones take NLerp
+    const Quaternionf close = Quaternionf::FromAxisAngle({0, 0, 1}, 0.2001f);
+    SX_TEST_CHECK(IsSameRotation(Math::Slerp(from, close, 0.5f), Quaternionf::FromAxisAngle({0, 0, 1}, 0.20005f)));
+    SX_TEST_CHECK(IsNear(Math::Slerp(from, close, 0.5f).Length(), 1.f));
+}
+
+// sizes go across the four quaternion groups, pairs include opposite hemispheres and nearly parallel ones
+static void BatchSlerp(){
+    const size_t sizes[] = {0, 1, 3, 4, 5, 17, 1000};
+
+    for(size_t size: sizes){
+        List<Quaternionf> left, right, result;
+        for(size_t i = 0; i<size; i++){
+            left.Add(RandomRotation());
+            if(i % 5 == 1)
+                right.Add(Quaternionf(-left[i].x, -left[i].y, -left[i].z, -left[i].w));
+            else if(i % 5 == 2)
+                right.Add((left[i] * Quaternionf::FromAxisAngle({0, 1, 0}, 0.001f)).GetNormalized());
+            else
+                right.Add(RandomRotation());
+        }
+        result.Resize(size);
+
+        for(float t: {0.f, 0.3f, 1.f}){
+            Math::Slerp({left.Data(), size}, {right.Data(), size}, t, {result.Data(), size});
+
+            for(size_t i = 0; i<size; i++){
+                const Quaternionf expected = Math::Slerp(left[i], right[i], t);
+                SX_TEST_CHECK(IsNear(result[i].x, expected.x, 1e-6f) && IsNear(result[i].y, expected.y, 1e-6f)
+                           && IsNear(result[i].z, expected.z, 1e-6f) && IsNear(result[i].w, expected.w, 1e-6f));
+            }
+        }
+
+        // result aliasing the left side
+        List<Quaternionf> expected;
+        for(size_t i = 0; i<size; i++)
+            expected.Add(Math::Slerp(left[i], right[i], 0.6f));
+        Math::Slerp({left.Data(), size}, {right.Data(), size}, 0.6f, {left.Data(), size});
+        for(size_t i = 0; i<size; i++)
+            SX_TEST_CHECK(IsNear(left[i].w, expected[i].w, 1e-6f) && IsNear(left[i].x, expected[i].x, 1e-6f));
+    }
+}
+
+int main(){
+    Product();
+    AxisAngle();
+    Matrix();
+    Rotate();
+    Interpolation();
+    BatchSlerp();
+
+    return Test::Result();
+}
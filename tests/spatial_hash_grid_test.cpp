@@ -0,0 +1,238 @@
+#include <algorithm>
+#include "core/list.hpp"
+#include "core/math/spatial_hash_grid.hpp"
+#include "test.hpp"
+
+// Queries and pairs against brute force over the live elements, while elements are inserted,
+// moved and removed. Results are compared sorted, so duplicates would show up as mismatches
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static AABB2f RandomBox(const Vector2f &center, float size){
+    return AABB2f(center, {(Random() + 1.f) * size, (Random() + 1.f) * size});
+}
+
+static AABB3f RandomBox(const Vector3f &center, float size){
+    return AABB3f(center, {(Random() + 1.f) * size, (Random() + 1.f) * size, (Random() + 1.f) * size});
+}
+
+static Vector2f RandomPoint(Vector2f, float extent){
+    return {Random() * extent, Random() * extent};
+}
+
+static Vector3f RandomPoint(Vector3f, float extent){
+    return {Random() * extent, Random() * extent, Random() * extent};
+}
+
+static bool IsEqual(List<u32> &handles, List<u32> &expected){
+    std::sort(handles.begin(), handles.end());
+    std::sort(expected.begin(), expected.end());
+    if(handles.Size() != expected.Size())
+        return false;
+    for(size_t i = 0; i<handles.Size(); i++){
+        if(handles[i] != expected[i])
+            return false;
+    }
+    return true;
+}
+
+static bool IsEqual(List<Pair<u32, u32>> &pairs, List<Pair<u32, u32>> &expected){
+    const auto less = [](const Pair<u32, u32> &left, const Pair<u32, u32> &right){
+        return left.First < right.First || (left.First == right.First && left.Second < right.Second);
+    };
+    std::sort(pairs.begin(), pairs.end(), less);
+    std::sort(expected.begin(), expected.end(), less);
+    if(pairs.Size() != expected.Size())
+        return false;
+    for(size_t i = 0; i<pairs.Size(); i++){
+        if(pairs[i].First != expected[i].First || pairs[i].Second != expected[i].Second)
+            return false;
+    }
+    return true;
+}
+
+template<size_t Dim>
+struct Reference{
+    using GridType = SpatialHashGrid<Dim>;
+    using AABBType = typename GridType::AABBType;
+    using VectorType = typename GridType::VectorType;
+
+    List<AABBType> Boxes;
+    List<u8> IsAlive;
+
+    void Set(u32 handle, const AABBType &box){
+        while(Boxes.Size() <= handle){
+            Boxes.Add(box);
+            IsAlive.Add(false);
+        }
+        Boxes[handle] = box;
+        IsAlive[handle] = true;
+    }
+
+    void Query(const AABBType &box, List<u32> &handles)const{
+        for(u32 i = 0; i<Boxes.Size(); i++){
+            if(IsAlive[i] && Boxes[i].Intersects(box))
+                handles.Add(i);
+        }
+    }
+
+    void Query(const VectorType &center, float radius, List<u32> &handles)const{
+        for(u32 i = 0; i<Boxes.Size(); i++){
+            if(!IsAlive[i])
+                continue;
+            float distance_squared = 0.f;
+            for(size_t axis = 0; axis<Dim; axis++){
+                const float offset = center.Data[axis] - Math::Clamp(center.Data[axis], Boxes[i].Min.Data[axis], Boxes[i].Max.Data[axis]);
+                distance_squared += offset * offset;
+            }
+            if(distance_squared <= radius * radius)
+                handles.Add(i);
+        }
+    }
+
+    void FindPairs(List<Pair<u32, u32>> &pairs)const{
+        for(u32 i = 0; i<Boxes.Size(); i++){
+            for(u32 j = i + 1; IsAlive[i] && j<Boxes.Size(); j++){
+                if(IsAlive[j] && Boxes[i].Intersects(Boxes[j]))
+                    pairs.Add({i, j});
+            }
+        }
+    }
+};
+
+template<size_t Dim>
+static void Check(const SpatialHashGrid<Dim> &grid, const Reference<Dim> &reference, float extent){
+    using VectorType = typename SpatialHashGrid<Dim>::VectorType;
+
+    for(u32 i = 0; i<50; i++){
+        const auto box = RandomBox(RandomPoint(VectorType(), extent), extent * 0.2f);
+        List<u32> handles, expected;
+        grid.Query(box, handles);
+        reference.Query(box, expected);
+        SX_TEST_CHECK(IsEqual(handles, expected));
+
+        const VectorType center = RandomPoint(VectorType(), extent);
+        const float radius = (Random() + 1.f) * extent * 0.1f;
+        handles.Clear();
+        expected.Clear();
+        grid.Query(center, radius, handles);
+        reference.Query(center, radius, expected);
+        SX_TEST_CHECK(IsEqual(handles, expected));
+    }
+
+    List<Pair<u32, u32>> pairs, expected_pairs;
+    grid.FindPairs(pairs);
+    reference.FindPairs(expected_pairs);
+    SX_TEST_CHECK(IsEqual(pairs, expected_pairs));
+    for(const Pair<u32, u32> &pair: pairs)
+        SX_TEST_CHECK(pair.First < pair.Second);
+}
+
+// cells are a few units wide, elements range from much smaller than a cell to several cells
+template<size_t Dim>
+static void Randomized(){
+    using VectorType = typename SpatialHashGrid<Dim>::VectorType;
+    constexpr float Extent = 100.f;
+
+    SpatialHashGrid<Dim> grid(4.f);
+    Reference<Dim> reference;
+    List<u32> alive;
+
+    for(size_t i = 0; i<2000; i++){
+        const auto box = RandomBox(RandomPoint(VectorType(), Extent), i % 10 ? 2.f : 12.f);
+        const u32 handle = grid.Insert(box);
+        reference.Set(handle, box);
+        alive.Add(handle);
+    }
+    SX_TEST_CHECK(grid.Size() == alive.Size());
+    Check(grid, reference, Extent);
+
+    for(u32 round = 0; round<5; round++){
+        // small moves mostly stay within the same cells, some elements jump across the world
+        for(size_t i = 0; i<alive.Size(); i++){
+            const u32 handle = alive[i];
+            const float step = i % 7 ? 0.5f : Extent;
+            const auto box = RandomBox(reference.Boxes[handle].Min + RandomPoint(VectorType(), step), i % 10 ? 2.f : 12.f);
+            grid.Update(handle, box);
+            reference.Set(handle, box);
+        }
+
+        // handles are reused after removal
+        for(size_t i = 0; i<300; i++){
+            const size_t index = size_t((Random() + 1.f) * 0.5f * alive.Size()) % alive.Size();
+            grid.Remove(alive[index]);
+            reference.IsAlive[alive[index]] = false;
+            alive.UnorderedRemove(index);
+        }
+        for(size_t i = 0; i<200; i++){
+            const auto box = RandomBox(RandomPoint(VectorType(), Extent), 2.f);
+            const u32 handle = grid.Insert(box);
+            SX_TEST_CHECK(handle < reference.Boxes.Size());
+            reference.Set(handle, box);
+            alive.Add(handle);
+        }
+
+        SX_TEST_CHECK(grid.Size() == alive.Size());
+        for(u32 handle: alive){
+            for(size_t axis = 0; axis<Dim; axis++)
+                SX_TEST_CHECK(grid.Bounds(handle).Min.Data[axis] == reference.Boxes[handle].Min.Data[axis]);
+        }
+        Check(grid, reference, Extent);
+    }
+
+    for(u32 handle: alive)
+        grid.Remove(handle);
+    SX_TEST_CHECK(grid.Size() == 0 && grid.CellsCount() == 0);
+}
+
+static void Boundaries(){
+    SpatialHashGrid2D grid(10.f);
+
+    // touching boxes intersect, as with AABB2::Intersects, also across a cell border
+    const u32 a = grid.Insert(AABB2f({0, 0}, {10, 10}));
+    const u32 b = grid.Insert(AABB2f({10, 0}, {5, 5}));
+    const u32 c = grid.Insert(AABB2f({-10, -10}, {5, 5}));
+    SX_TEST_CHECK(grid.CellsCount() == 5);
+
+    List<Pair<u32, u32>> pairs;
+    grid.FindPairs(pairs);
+    SX_TEST_CHECK(pairs.Size() == 1 && pairs[0].First == Min(a, b) && pairs[0].Second == Max(a, b));
+
+    List<u32> handles;
+    grid.Query(AABB2f({-12, -12}, {4, 4}), handles);
+    SX_TEST_CHECK(handles.Size() == 1 && handles[0] == c);
+
+    // the corner of c is at distance sqrt(50) from the origin
+    handles.Clear();
+    grid.Query(Vector2f(0, 0), 7.f, handles);
+    SX_TEST_CHECK(handles.Size() == 1 && handles[0] == a);
+    handles.Clear();
+    grid.Query(Vector2f(0, 0), 7.1f, handles);
+    SX_TEST_CHECK(handles.Size() == 2);
+
+    // far away coordinates are clamped, not overflowed
+    const u32 far = grid.Insert(AABB2f({1e30f, -1e30f}, {1, 1}));
+    handles.Clear();
+    grid.Query(AABB2f({1e30f, -1e30f}, {1, 1}), handles);
+    SX_TEST_CHECK(handles.Size() == 1 && handles[0] == far);
+
+    SpatialHashGrid2D moved(Move(grid));
+    SX_TEST_CHECK(moved.Size() == 4 && grid.Size() == 0);
+    moved.Clear();
+    SX_TEST_CHECK(moved.Size() == 0 && moved.CellsCount() == 0);
+}
+
+int main(){
+    Randomized<2>();
+    Randomized<3>();
+    Boundaries();
+
+    return Test::Result();
+}
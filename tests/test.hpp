@@ -0,0 +1,27 @@
+#ifndef STRAITX_TEST_HPP
+#define STRAITX_TEST_HPP
+
+#include "core/print.hpp"
+
+// Every test is an executable of its own, checks report failures and keep going,
+// main returns Test::Result() so ctest sees a failed check as a failed test
+
+namespace Test{
+
+inline int s_FailedChecks = 0;
+
+inline int Result(){
+    return s_FailedChecks ? 1 : 0;
+}
+
+}//namespace Test::
+
+#define SX_TEST_CHECK(condition) \
+    do{ \
+        if(!(condition)){ \
+            Test::s_FailedChecks++; \
+            Errorln("%:%: check failed: %", __FILE__, __LINE__, #condition); \
+        } \
+    }while(0)
+
+#endif//STRAITX_TEST_HPP
@@ -0,0 +1,204 @@
+#include <cmath>
+#include <cstring>
+#include "core/list.hpp"
+#include "core/math/transform.hpp"
+#include "core/math/transform_hierarchy.hpp"
+#include "core/os/thread_pool.hpp"
+#include "test.hpp"
+
+// World matrices against ones computed by walking parent chains, after random edits that
+// reorder the array. Destroy and SetParent used to lose pending edits of nodes they moved
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static u32 RandomIndex(size_t count){
+    return u32((Random() + 1.f) * 0.5f * count) % u32(count);
+}
+
+static Vector3f RandomVector(){
+    return {Random(), Random(), Random()};
+}
+
+static Quaternionf RandomRotation(){
+    return Quaternionf(Random(), Random(), Random(), Random()).GetNormalized();
+}
+
+static Matrix4f Reference(const TransformHierarchy &hierarchy, u32 handle){
+    const Matrix4f local = Math::Translate(hierarchy.Position(handle)) * hierarchy.Rotation(handle).ToMatrix() * Math::Scale(hierarchy.Scale(handle));
+    const u32 parent = hierarchy.Parent(handle);
+    return parent == TransformHierarchy::InvalidHandle ? local : Reference(hierarchy, parent) * local;
+}
+
+static bool IsNear(const Matrix4f &left, const Matrix4f &right){
+    for(size_t i = 0; i<4; i++){
+        for(size_t j = 0; j<4; j++){
+            if(std::fabs(left[i][j] - right[i][j]) > 1e-4f * Max(1.f, std::fabs(right[i][j])))
+                return false;
+        }
+    }
+    return true;
+}
+
+// every node matches the reference and parents go before their children
+static bool IsValid(const TransformHierarchy &hierarchy){
+    const ConstSpan<u32> handles = hierarchy.Handles();
+    List<u32> positions;
+    for(size_t i = 0; i<handles.Size(); i++){
+        if(positions.Size() <= handles[i])
+            positions.Resize(handles[i] + 1);
+        positions[handles[i]] = u32(i);
+    }
+
+    for(size_t i = 0; i<handles.Size(); i++){
+        const u32 parent = hierarchy.Parent(handles[i]);
+        if(parent != TransformHierarchy::InvalidHandle && positions[parent] >= i)
+            return false;
+        if(!IsNear(hierarchy.World(handles[i]), Reference(hierarchy, handles[i])))
+            return false;
+        if(&hierarchy.World(handles[i]) != &hierarchy.WorldMatrices()[i])
+            return false;
+    }
+    return true;
+}
+
+// Destroy shifts nodes after the subtree down, a node edited after the last Update has to stay dirty
+static void DestroyKeepsPendingEdits(){
+    TransformHierarchy hierarchy;
+    const u32 a = hierarchy.Create();
+    hierarchy.Create();
+    const u32 c = hierarchy.Create();
+    hierarchy.Update();
+
+    hierarchy.SetPosition(c, {5, 0, 0});
+    hierarchy.Destroy(a);
+    hierarchy.Update();
+
+    SX_TEST_CHECK(hierarchy.World(c)[0][3] == 5.f);
+    SX_TEST_CHECK(IsValid(hierarchy));
+}
+
+// parenting to a later node moves the subtree to the end, nodes after it shift down
+static void SetParentKeepsPendingEdits(){
+    TransformHierarchy hierarchy;
+    const u32 a = hierarchy.Create();
+    const u32 b = hierarchy.Create();
+    const u32 c = hierarchy.Create(Vector3f(0, 1, 0), Quaternionf(), Vector3f(1));
+    hierarchy.Update();
+
+    hierarchy.SetPosition(b, {5, 0, 0});
+    hierarchy.SetParent(a, c);
+    hierarchy.Update();
+
+    SX_TEST_CHECK(hierarchy.World(b)[0][3] == 5.f);
+    SX_TEST_CHECK(hierarchy.World(a)[1][3] == 1.f);
+    SX_TEST_CHECK(hierarchy.Parent(a) == c);
+    SX_TEST_CHECK(IsValid(hierarchy));
+}
+
+static void Randomized(){
+    TransformHierarchy hierarchy;
+    List<u32> alive;
+
+    for(u32 round = 0; round<30; round++){
+        for(u32 i = 0; i<100; i++){
+            const u32 parent = alive.Size() && Random() > -0.6f ? alive[RandomIndex(alive.Size())] : TransformHierarchy::InvalidHandle;
+            alive.Add(hierarchy.Create(RandomVector() * 10.f, RandomRotation(), RandomVector() * 0.2f + Vector3f(1.f), parent));
+        }
+
+        // edits, reparenting and removal are mixed between updates
+        for(u32 i = 0; i<100; i++){
+            const u32 handle = alive[RandomIndex(alive.Size())];
+            const float action = Random();
+
+            if(action < -0.5f){
+                hierarchy.SetPosition(handle, RandomVector() * 10.f);
+            }else if(action < 0.f){
+                hierarchy.SetRotation(handle, RandomRotation());
+            }else if(action < 0.3f){
+                hierarchy.SetLocal(handle, RandomVector(), RandomRotation(), RandomVector() * 0.2f + Vector3f(1.f));
+            }else if(action < 0.8f){
+                // any node that isn't in the subtree of the handle
+                const u32 parent = alive[RandomIndex(alive.Size())];
+                bool is_descendant = false;
+                for(u32 ancestor = parent; ancestor != TransformHierarchy::InvalidHandle; ancestor = hierarchy.Parent(ancestor))
+                    is_descendant = is_descendant || ancestor == handle;
+                hierarchy.SetParent(handle, is_descendant ? TransformHierarchy::InvalidHandle : parent);
+            }else if(alive.Size() > 10){
+                hierarchy.Destroy(handle);
+
+                // destroyed descendants are gone too
+                List<u8> is_alive;
+                for(u32 existing: hierarchy.Handles()){
+                    if(is_alive.Size() <= existing)
+                        is_alive.Resize(existing + 1);
+                    is_alive[existing] = 1;
+                }
+                for(size_t j = 0; j<alive.Size();){
+                    if(alive[j] < is_alive.Size() && is_alive[alive[j]])
+                        j++;
+                    else
+                        alive.UnorderedRemove(j);
+                }
+            }
+        }
+
+        hierarchy.Update();
+        SX_TEST_CHECK(hierarchy.Size() == alive.Size());
+        SX_TEST_CHECK(IsValid(hierarchy));
+    }
+
+    TransformHierarchy moved(Move(hierarchy));
+    SX_TEST_CHECK(moved.Size() == alive.Size() && hierarchy.Size() == 0);
+    SX_TEST_CHECK(IsValid(moved));
+    moved.Clear();
+    SX_TEST_CHECK(moved.Size() == 0);
+}
+
+// level by level update gives exactly the serial results
+static void ParallelUpdate(){
+    TransformHierarchy serial, parallel;
+    List<u32> handles;
+
+    for(size_t i = 0; i<TransformHierarchy::ParallelUpdateThreshold * 3; i++){
+        const u32 parent = i > 16 ? handles[RandomIndex(i)] : TransformHierarchy::InvalidHandle;
+        const Vector3f position = RandomVector() * 10.f;
+        const Quaternionf rotation = RandomRotation();
+
+        handles.Add(serial.Create(position, rotation, Vector3f(1.f), parent));
+        SX_TEST_CHECK(parallel.Create(position, rotation, Vector3f(1.f), parent) == handles[i]);
+    }
+
+    ThreadPool pool(4);
+    for(u32 round = 0; round<3; round++){
+        serial.Update();
+        parallel.Update(pool);
+
+        bool is_same = true;
+        for(u32 handle: handles)
+            is_same = is_same && memcmp(&serial.World(handle), &parallel.World(handle), sizeof(Matrix4f)) == 0;
+        SX_TEST_CHECK(is_same);
+
+        // a few roots move, their subtrees only are recomputed
+        for(u32 i = 0; i<16; i++){
+            const Vector3f position = RandomVector();
+            serial.SetPosition(handles[i], position);
+            parallel.SetPosition(handles[i], position);
+        }
+    }
+}
+
+int main(){
+    DestroyKeepsPendingEdits();
+    SetParentKeepsPendingEdits();
+    Randomized();
+    ParallelUpdate();
+
+    return Test::Result();
+}
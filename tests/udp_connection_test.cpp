@@ -0,0 +1,181 @@
+#include <cstring>
+#include "core/net/udp_connection.hpp"
+#include "test.hpp"
+#include "lossy_link.hpp"
+
+// Two connections talk over simulated links with delay, loss and reordering, every message has to arrive
+// intact and exactly once, ordered ones in send order
+
+// message is its index followed by bytes derived from it
+static u32 MakeMessage(u32 index, u8 *buffer, u32 size){
+	memcpy(buffer, &index, sizeof(index));
+	for(u32 i = sizeof(index); i<size; i++)
+		buffer[i] = u8(index + i);
+	return size;
+}
+
+struct MessageChecker{
+	u32 NextOrdered = 0;
+	u32 UnorderedCount = 0;
+	bool IsCorrupted = false;
+
+	void OnMessage(UdpChannel channel, ConstSpan<u8> message){
+		u32 index = 0;
+		if(message.Size() < sizeof(index)){
+			IsCorrupted = true;
+			return;
+		}
+		memcpy(&index, message.Pointer(), sizeof(index));
+
+		for(size_t i = sizeof(index); i<message.Size(); i++)
+			IsCorrupted |= message[i] != u8(index + i);
+
+		if(channel == UdpChannel::ReliableOrdered)
+			IsCorrupted |= index != NextOrdered++;
+		else
+			UnorderedCount++;
+	}
+};
+
+struct Peers{
+	LossyLink ToA;
+	LossyLink ToB;
+	UdpConnection A;
+	UdpConnection B;
+	MessageChecker ReceivedByA;
+	MessageChecker ReceivedByB;
+	Time Now;
+
+	Peers():
+		A(UdpConnection::PacketSender(&ToB, &LossyLink::Send)),
+		B(UdpConnection::PacketSender(&ToA, &LossyLink::Send))
+	{
+		ToA.Receiver = &A;
+		ToB.Receiver = &B;
+		A.OnMessage.Bind(&ReceivedByA, &MessageChecker::OnMessage);
+		B.OnMessage.Bind(&ReceivedByB, &MessageChecker::OnMessage);
+	}
+
+	// 1ms steps, connections are updated at 60Hz
+	void Run(Time duration){
+		const Time end = Now + duration;
+
+		for(; Now < end; Now += Milliseconds(1)){
+			ToA.Deliver(Now);
+			ToB.Deliver(Now);
+
+			if(Now.AsMilliseconds() % 16 == 0){
+				A.Update(Now);
+				B.Update(Now);
+			}
+		}
+	}
+};
+
+// Peer sends before it has received anything, its acks used to look like an ack of packet 0
+static void FirstPacketLost(){
+	Peers peers;
+	u8 message[64];
+
+	SX_TEST_CHECK(peers.A.Send(UdpChannel::ReliableOrdered, {message, MakeMessage(0, message, sizeof(message))}));
+	SX_TEST_CHECK(peers.B.Send(UdpChannel::ReliableOrdered, {message, MakeMessage(0, message, sizeof(message))}));
+
+	peers.ToB.DropNext = 1;
+	peers.Run(Seconds(2));
+
+	SX_TEST_CHECK(peers.ReceivedByB.NextOrdered == 1);
+	SX_TEST_CHECK(peers.ReceivedByA.NextOrdered == 1);
+	SX_TEST_CHECK(!peers.ReceivedByA.IsCorrupted && !peers.ReceivedByB.IsCorrupted);
+}
+
+// fragmented and single packet messages in both directions, every channel is used
+static void LossyTransfer(){
+	constexpr u32 MessagesCount = 2000;
+
+	Peers peers;
+	peers.ToA.LossPermille = 200;
+	peers.ToB.LossPermille = 200;
+
+	static u8 message[4000];
+	u32 ordered_sent = 0;
+	u32 unordered_sent = 0;
+
+	while(ordered_sent < MessagesCount || unordered_sent < MessagesCount){
+		const u32 size = 4 + (ordered_sent * 97) % (sizeof(message) - 4);
+
+		if(ordered_sent < MessagesCount && peers.A.Send(UdpChannel::ReliableOrdered, {message, MakeMessage(ordered_sent, message, size)}))
+			ordered_sent++;
+		if(unordered_sent < MessagesCount && peers.B.Send(UdpChannel::ReliableUnordered, {message, MakeMessage(unordered_sent, message, 100)}))
+			unordered_sent++;
+		// unreliable ones may be lost, they just shouldn't break anything
+		peers.A.Send(UdpChannel::Unreliable, {message, MakeMessage(0, message, 2000)});
+
+		peers.Run(Milliseconds(16));
+	}
+
+	peers.ToA.LossPermille = 0;
+	peers.ToB.LossPermille = 0;
+	peers.Run(Seconds(5));
+
+	SX_TEST_CHECK(peers.ReceivedByB.NextOrdered == MessagesCount);
+	SX_TEST_CHECK(peers.ReceivedByA.UnorderedCount == MessagesCount);
+	SX_TEST_CHECK(!peers.ReceivedByA.IsCorrupted && !peers.ReceivedByB.IsCorrupted);
+	SX_TEST_CHECK(peers.A.Stats().FragmentsResent > 0);
+}
+
+// one Update sends more packets than the ack bits cover, none of them should be resent on a lossless link
+static void BurstAcks(){
+	Peers peers;
+	static u8 message[4000];
+
+	for(u32 i = 0; i<64; i++)
+		SX_TEST_CHECK(peers.A.Send(UdpChannel::ReliableOrdered, {message, MakeMessage(i, message, sizeof(message))}));
+
+	peers.Run(Seconds(1));
+
+	SX_TEST_CHECK(peers.ReceivedByB.NextOrdered == 64);
+	SX_TEST_CHECK(peers.A.Stats().FragmentsResent == 0);
+}
+
+// jitter reorders packets within the ack bits, they are all acked and ordered messages keep send order
+static void ReorderedTransfer(){
+	constexpr u32 MessagesCount = 2000;
+
+	Peers peers;
+	peers.ToA.Jitter = Milliseconds(20);
+	peers.ToB.Jitter = Milliseconds(20);
+
+	static u8 message[4000];
+	u32 ordered_sent = 0;
+	u32 unordered_sent = 0;
+
+	while(ordered_sent < MessagesCount || unordered_sent < MessagesCount){
+		// enough packets per tick for the late ones to be pushed out of the ack bits by the next tick
+		for(u32 i = 0; i<8 && ordered_sent < MessagesCount; i++){
+			const u32 size = 4 + (ordered_sent * 97) % (sizeof(message) - 4);
+			if(!peers.A.Send(UdpChannel::ReliableOrdered, {message, MakeMessage(ordered_sent, message, size)}))
+				break;
+			ordered_sent++;
+		}
+		if(unordered_sent < MessagesCount && peers.B.Send(UdpChannel::ReliableUnordered, {message, MakeMessage(unordered_sent, message, 100)}))
+			unordered_sent++;
+
+		peers.Run(Milliseconds(16));
+	}
+	peers.Run(Seconds(2));
+
+	SX_TEST_CHECK(peers.ToA.Reordered > 0 && peers.ToB.Reordered > 0);
+	SX_TEST_CHECK(peers.ReceivedByB.NextOrdered == MessagesCount);
+	SX_TEST_CHECK(peers.ReceivedByA.UnorderedCount == MessagesCount);
+	SX_TEST_CHECK(!peers.ReceivedByA.IsCorrupted && !peers.ReceivedByB.IsCorrupted);
+	SX_TEST_CHECK(peers.A.Stats().PacketsLost == 0 && peers.B.Stats().PacketsLost == 0);
+}
+
+int main(){
+	FirstPacketLost();
+	LossyTransfer();
+	BurstAcks();
+	ReorderedTransfer();
+
+	return Test::Result();
+}
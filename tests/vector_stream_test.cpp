@@ -0,0 +1,192 @@
+#include <cmath>
+#include "core/list.hpp"
+#include "core/math/vector_stream.hpp"
+#include "core/math/linear.hpp"
+#include "test.hpp"
+
+// Streams against the same operations on AoS vectors, sizes are not multiples of StreamLanes
+// so the padding of the last block is exercised
+
+static u32 s_RandomState = 0x2545F491;
+
+static float Random(){
+    s_RandomState ^= s_RandomState << 13;
+    s_RandomState ^= s_RandomState >> 17;
+    s_RandomState ^= s_RandomState << 5;
+    return (s_RandomState & 0xFFFFFF) / float(0x800000) - 1.f;
+}
+
+static Vector3f RandomVector(){
+    return {Random(), Random(), Random()};
+}
+
+// kernels may be vectorized and contracted differently from the scalar code
+static bool IsNear(float left, float right){
+    return std::fabs(left - right) <= 1e-6f * Max(1.f, std::fabs(right));
+}
+
+static bool IsNear(const Vector3f &left, const Vector3f &right){
+    return IsNear(left.x, right.x) && IsNear(left.y, right.y) && IsNear(left.z, right.z);
+}
+
+static void Storage(){
+    Vector3Stream stream(37);
+    SX_TEST_CHECK(stream.Size() == 37);
+    SX_TEST_CHECK(stream.PaddedSize() == 48);
+    SX_TEST_CHECK(stream.Capacity() % StreamLanes == 0);
+
+    for(size_t i = 0; i<3; i++){
+        SX_TEST_CHECK((size_t)stream.Component(i) % StreamAlignment == 0);
+        for(size_t j = 0; j<37; j++)
+            SX_TEST_CHECK(stream.Component(i)[j] == 0.f);
+    }
+
+    for(size_t i = 0; i<37; i++)
+        stream.Set(i, {float(i), float(i) * 2, float(i) * 3});
+
+    // growing keeps the elements and zeroes the new ones
+    stream.Resize(1000);
+    SX_TEST_CHECK(stream.Get(36) == Vector3f(36, 72, 108));
+    SX_TEST_CHECK(stream.Get(37) == Vector3f(0, 0, 0) && stream.Get(999) == Vector3f(0, 0, 0));
+    SX_TEST_CHECK((size_t)stream.Z() % StreamAlignment == 0);
+
+    Vector3Stream moved(Move(stream));
+    SX_TEST_CHECK(stream.Size() == 0 && moved.Size() == 1000);
+    SX_TEST_CHECK(moved.Get(10) == Vector3f(10, 20, 30));
+
+    moved.Clear();
+    SX_TEST_CHECK(moved.Size() == 0 && moved.PaddedSize() == 0);
+}
+
+static void Conversion(){
+    constexpr size_t Count = 37;
+
+    List<Vector3f> vectors3, read3;
+    List<Vector4f> vectors4, read4;
+    List<AABB3f> boxes, read_boxes;
+    for(size_t i = 0; i<Count; i++){
+        vectors3.Add(RandomVector());
+        vectors4.Add({Random(), Random(), Random(), Random()});
+        boxes.Add(AABB3f(RandomVector(), {1, 2, 3}));
+        read_boxes.Add(AABB3f({}, {}));
+    }
+    read3.Resize(Count);
+    read4.Resize(Count);
+
+    Vector3Stream stream3;
+    stream3.FromAoS({vectors3.Data(), Count});
+    stream3.ToAoS({read3.Data(), Count});
+
+    Vector4Stream stream4;
+    stream4.FromAoS({vectors4.Data(), Count});
+    stream4.ToAoS({read4.Data(), Count});
+
+    AABB3Stream box_stream;
+    box_stream.FromAoS({boxes.Data(), Count});
+    box_stream.ToAoS({read_boxes.Data(), Count});
+
+    for(size_t i = 0; i<Count; i++){
+        SX_TEST_CHECK(read3[i] == vectors3[i] && stream3.Get(i) == vectors3[i]);
+        SX_TEST_CHECK(read4[i] == vectors4[i] && stream4.Get(i) == vectors4[i]);
+        SX_TEST_CHECK(read_boxes[i].Min == boxes[i].Min && read_boxes[i].Max == boxes[i].Max);
+        SX_TEST_CHECK(box_stream.Component(3)[i] == boxes[i].Max.x);
+    }
+}
+
+static void Kernels(){
+    constexpr size_t Count = 100;
+
+    List<Vector3f> left, right;
+    Vector3Stream left_stream(Count), right_stream(Count);
+    for(size_t i = 0; i<Count; i++){
+        left.Add(RandomVector());
+        right.Add(RandomVector());
+        left_stream.Set(i, left[i]);
+        right_stream.Set(i, right[i]);
+    }
+
+    Vector3Stream result;
+    Math::Add(left_stream, right_stream, result);
+    SX_TEST_CHECK(result.Size() == Count);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(result.Get(i) == left[i] + right[i]);
+
+    Math::Subtract(left_stream, right_stream, result);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(result.Get(i) == left[i] - right[i]);
+
+    Math::Multiply(left_stream, right_stream, result);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(result.Get(i) == left[i] * right[i]);
+
+    Math::MultiplyAdd(left_stream, 0.5f, right_stream, result);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(IsNear(result.Get(i), left[i] * 0.5f + right[i]));
+
+    Math::Min(left_stream, right_stream, result);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(result.Get(i) == Vector3f(Min(left[i].x, right[i].x), Min(left[i].y, right[i].y), Min(left[i].z, right[i].z)));
+
+    Math::Max(left_stream, right_stream, result);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(result.Get(i) == Vector3f(Max(left[i].x, right[i].x), Max(left[i].y, right[i].y), Max(left[i].z, right[i].z)));
+
+    Math::Cross(left_stream, right_stream, result);
+    for(size_t i = 0; i<Count; i++){
+        const Vector3f &l = left[i], &r = right[i];
+        SX_TEST_CHECK(IsNear(result.Get(i), {l.y * r.z - l.z * r.y, l.z * r.x - l.x * r.z, l.x * r.y - l.y * r.x}));
+    }
+
+    Math::Normalize(left_stream, result);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(IsNear(result.Get(i), Normalize(left[i])));
+
+    // exactly Count values are written, the guard past them stays
+    List<float> dots;
+    dots.Resize(Count + 1);
+    dots[Count] = 42.f;
+    Math::Dot(left_stream, right_stream, {dots.Data(), Count});
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(IsNear(dots[i], Dot(left[i], right[i])));
+    SX_TEST_CHECK(dots[Count] == 42.f);
+
+    // result aliasing an argument
+    Math::Add(left_stream, right_stream, left_stream);
+    for(size_t i = 0; i<Count; i++)
+        SX_TEST_CHECK(left_stream.Get(i) == left[i] + right[i]);
+}
+
+static void Overlaps(){
+    constexpr size_t Count = 50;
+
+    List<AABB3f> boxes;
+    for(size_t i = 0; i<Count; i++)
+        boxes.Add(AABB3f(RandomVector() * 4.f, {Random() + 1, Random() + 1, Random() + 1}));
+
+    AABB3Stream stream;
+    stream.FromAoS({boxes.Data(), Count});
+
+    const AABB3f query({-1, -1, -1}, {2, 2, 2});
+    List<bool> result;
+    result.Resize(Count + 1);
+    result[Count] = true;
+    Math::Overlaps(stream, query, {result.Data(), Count});
+
+    size_t overlapping = 0;
+    for(size_t i = 0; i<Count; i++){
+        SX_TEST_CHECK(result[i] == boxes[i].Intersects(query));
+        overlapping += result[i];
+    }
+    // the random boxes are expected to give both outcomes
+    SX_TEST_CHECK(overlapping > 0 && overlapping < Count);
+    SX_TEST_CHECK(result[Count]);
+}
+
+int main(){
+    Storage();
+    Conversion();
+    Kernels();
+    Overlaps();
+
+    return Test::Result();
+}
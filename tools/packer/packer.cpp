@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <mutex>
+#include "core/print.hpp"
+#include "core/list.hpp"
+#include "core/string.hpp"
+#include "core/os/directory.hpp"
+#include "core/vfs/pack.hpp"
+
+// Usage: sx_packer [-c] <output pack> <input directory>
+// Every file under the input directory is packed under its path relative to that directory,
+// -c compresses entries that get smaller with it
+
+class Packer{
+private:
+	size_t m_RootSize = 0;
+	std::mutex m_Lock;
+public:
+	List<String> Files;
+public:
+	Packer(StringView root):
+		m_RootSize(root.Size())
+	{}
+
+	void OnEntry(const DirectoryWalkEntry &entry){
+		if(!entry.IsFile)
+			return;
+
+		std::unique_lock<std::mutex> lock(m_Lock);
+		Files.Add(entry.Path);
+	}
+
+	StringView RelativePath(const String &path)const{
+		return {path.Data() + m_RootSize, path.Size() - m_RootSize};
+	}
+};
+
+int main(int argc, char **argv){
+	const bool is_compressed = argc == 4 && StringView(argv[1]) == StringView("-c");
+
+	if(argc != 3 && !is_compressed)
+		return Errorln("Usage: sx_packer [-c] <output pack> <input directory>");
+
+	const StringView output = argv[argc - 2];
+	const StringView input = argv[argc - 1];
+	const PackCompression compression = is_compressed ? PackCompression::Lz : PackCompression::None;
+
+	Packer packer(input);
+	Result result = Directory::Walk(input, Directory::WalkCallback(&packer, &Packer::OnEntry));
+	if(!result)
+		return Errorln("Can't walk directory '%': %", input, result.Name());
+
+	// walk order is not deterministic, sorting keeps packs reproducible
+	std::sort(packer.Files.begin(), packer.Files.end());
+
+	PackWriter writer;
+	result = writer.Open(output);
+	if(!result)
+		return Errorln("Can't open '%': %", output, result.Name());
+
+	for(const String &file: packer.Files){
+		result = writer.AddFile(packer.RelativePath(file), file, compression);
+		if(!result)
+			return Errorln("Can't pack '%': %", file, result.Name());
+	}
+
+	result = writer.Finish();
+	if(!result)
+		return Errorln("Can't finish '%': %", output, result.Name());
+
+	Println("Packed % files into %", packer.Files.Size(), output);
+	return 0;
+}